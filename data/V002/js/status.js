@@ -204,6 +204,9 @@ export function updateOperatingMode(mode, data) {
         } else if (mode === 'CP') {
             modeDisplayValue.textContent = 'CP';
             modeDisplayValue.classList.add('text-power'); // Tailwind power color
+        } else if (mode === 'CR') {
+            modeDisplayValue.textContent = 'CR';
+            modeDisplayValue.classList.add('text-power'); // Emulated on top of CV
         } else {
             modeDisplayValue.textContent = '--';
             modeDisplayValue.classList.add('text-gray-500'); // Tailwind gray
@@ -221,6 +224,8 @@ export function updateOperatingMode(mode, data) {
             displayHtml = `<span class="text-current">CC ${parseFloat(data.current).toFixed(3)}A</span>`;
         } else if (mode === 'CP' && data && data.power !== undefined) {
             displayHtml = `<span class="text-power">CP ${parseFloat(data.power).toFixed(1)}W</span>`;
+        } else if (mode === 'CR' && data && data.setValue !== undefined) {
+            displayHtml = `<span class="text-power">CR ${parseFloat(data.setValue).toFixed(2)}Ω</span>`;
         } else {
             displayHtml = `<span class="text-gray-500">--</span>`;
         }
@@ -7,40 +7,30 @@
 
 /* Basic device information */
 uint16_t XY_SKxxx::getModel() {
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.readHoldingRegisters(REG_MODEL, 1);
-  if (result == modbus.ku8MBSuccess) {
-    _lastCommsTime = millis();
-    return modbus.getResponseBuffer(0);
+  uint16_t model;
+  if (readRegister(REG_MODEL, model)) {
+    const xy_sk::ModelInfo* detected = xy_sk::findModel(model);
+    if (detected != nullptr && !_modelFixed) {
+      _model = detected;
+    }
+    return model;
   }
-  
-  _lastCommsTime = millis();
   return 0;
 }
 
 uint16_t XY_SKxxx::getVersion() {
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.readHoldingRegisters(REG_VERSION, 1);
-  if (result == modbus.ku8MBSuccess) {
-    _lastCommsTime = millis();
-    return modbus.getResponseBuffer(0);
+  uint16_t version;
+  if (readRegister(REG_VERSION, version)) {
+    return version;
   }
-  
-  _lastCommsTime = millis();
   return 0;
 }
 
 /* Basic output settings */
 bool XY_SKxxx::setVoltage(float voltage) {
-  if (voltage >= 0.0f && voltage <= 30.0f) { // Adjust based on your device's specifications
-    uint16_t voltageValue = (uint16_t)(voltage * 100);
-    waitForSilentInterval();
-    uint8_t result = modbus.writeSingleRegister(REG_V_SET, voltageValue);
-    _lastCommsTime = millis();
-    
-    if (result == modbus.ku8MBSuccess) {
+  if (voltage >= 0.0f && voltage <= _model->maxVoltage) {
+    uint16_t voltageValue = (uint16_t)(voltage * _model->voltageScale);
+    if (writeRegister(REG_V_SET, voltageValue)) {
       _status.setVoltage = voltage;
       return true;
     }
@@ -49,13 +39,9 @@ bool XY_SKxxx::setVoltage(float voltage) {
 }
 
 bool XY_SKxxx::setCurrent(float current) {
-  if (current >= 0.0f && current <= 5.1f) { // Adjust based on your device's specifications
-    uint16_t currentValue = (uint16_t)(current * 1000);
-    waitForSilentInterval();
-    uint8_t result = modbus.writeSingleRegister(REG_I_SET, currentValue);
-    _lastCommsTime = millis();
-    
-    if (result == modbus.ku8MBSuccess) {
+  if (current >= 0.0f && current <= _model->maxCurrent) {
+    uint16_t currentValue = (uint16_t)(current * _model->currentScale);
+    if (writeRegister(REG_I_SET, currentValue)) {
       _status.setCurrent = current;
       return true;
     }
@@ -65,22 +51,12 @@ bool XY_SKxxx::setCurrent(float current) {
 
 /* Combined measurement method for convenience */
 bool XY_SKxxx::getOutput(float &voltage, float &current, float &power) {
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.readHoldingRegisters(REG_VOUT, 3);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
-    voltage = modbus.getResponseBuffer(0) / 100.0f;
-    current = modbus.getResponseBuffer(1) / 1000.0f;
-    power = modbus.getResponseBuffer(2) / 100.0f;
-    
-    // Update cache with new values
-    _status.outputVoltage = voltage;
-    _status.outputCurrent = current;
-    _status.outputPower = power;
-    
-    _lastOutputUpdate = millis();
+  // The read updates the cached output values and runs the sample hooks
+  uint16_t values[3];
+  if (readRegisters(REG_VOUT, 3, values)) {
+    voltage = values[0] / (float)_model->voltageScale;
+    current = values[1] / (float)_model->currentScale;
+    power = values[2] / (float)_model->powerScale;
     return true;
   }
   
@@ -101,42 +77,18 @@ bool XY_SKxxx::setVoltageAndCurrent(float voltage, float current) {
   postTransmission();
   
   // Wait between commands
-  delay(_silentIntervalTime * 3);
+  delay(_bus->getSilentInterval() * 3);
   
   // Set current with proper timing
   preTransmission();
   currentSuccess = setCurrent(current);
   postTransmission();
   
-  // If either operation failed, try again
-  if (!voltageSuccess || !currentSuccess) {
-    // If voltage failed, retry
-    if (!voltageSuccess) {
-      delay(_silentIntervalTime * 3);
-      preTransmission();
-      voltageSuccess = setVoltage(voltage);
-      postTransmission();
-    }
-    
-    // If current failed, retry
-    if (!currentSuccess) {
-      delay(_silentIntervalTime * 3);
-      preTransmission();
-      currentSuccess = setCurrent(current);
-      postTransmission();
-    }
-  }
-  
   return voltageSuccess && currentSuccess;
 }
 
 bool XY_SKxxx::setOutputState(bool on) {
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.writeSingleRegister(REG_ONOFF, on ? 1 : 0);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
+  if (writeRegister(REG_ONOFF, on ? 1 : 0)) {
     _status.outputEnabled = on;
     return true;
   }
@@ -148,17 +100,10 @@ bool XY_SKxxx::turnOutputOn() {
   waitForSilentInterval();
   
   preTransmission();
+  // Failed writes are retried by retryPolicy
   bool success = setOutputState(true);
   postTransmission();
   
-  // Retry once if failed
-  if (!success) {
-    delay(_silentIntervalTime * 3);
-    preTransmission();
-    success = setOutputState(true);
-    postTransmission();
-  }
-  
   return success;
 }
 
@@ -166,17 +111,10 @@ bool XY_SKxxx::turnOutputOff() {
   waitForSilentInterval();
   
   preTransmission();
+  // Failed writes are retried by retryPolicy
   bool success = setOutputState(false);
   postTransmission();
   
-  // Retry once if failed
-  if (!success) {
-    delay(_silentIntervalTime * 3);
-    preTransmission();
-    success = setOutputState(false);
-    postTransmission();
-  }
-  
   return success;
 }
 
@@ -195,12 +133,7 @@ bool XY_SKxxx::getOutputStatus(float &voltage, float &current, float &power, boo
 }
 
 bool XY_SKxxx::setKeyLock(bool lock) {
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.writeSingleRegister(REG_LOCK, lock ? 1 : 0);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
+  if (writeRegister(REG_LOCK, lock ? 1 : 0)) {
     _status.keyLocked = lock;
     return true;
   }
@@ -209,13 +142,8 @@ bool XY_SKxxx::setKeyLock(bool lock) {
 }
 
 bool XY_SKxxx::setConstantVoltage(float voltage) {
-  uint16_t voltageValue = (uint16_t)(voltage * 100);
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.writeSingleRegister(REG_CV_SET, voltageValue);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
+  uint16_t voltageValue = (uint16_t)(voltage * _model->voltageScale);
+  if (writeRegister(REG_CV_SET, voltageValue)) {
     _protection.constantVoltage = voltage;
     return true;
   }
@@ -224,13 +152,8 @@ bool XY_SKxxx::setConstantVoltage(float voltage) {
 }
 
 bool XY_SKxxx::setConstantCurrent(float current) {
-  uint16_t currentValue = (uint16_t)(current * 1000);
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.writeSingleRegister(REG_CC_SET, currentValue);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
+  uint16_t currentValue = (uint16_t)(current * _model->currentScale);
+  if (writeRegister(REG_CC_SET, currentValue)) {
     _protection.constantCurrent = current;
     return true;
   }
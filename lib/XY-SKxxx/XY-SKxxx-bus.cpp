@@ -0,0 +1,238 @@
+#include "XY-SKxxx-bus.h"
+
+namespace xy_sk {
+
+namespace {
+
+void busPreTransmission(void* context) {
+    static_cast<RtuBus*>(context)->waitForSilentInterval();
+}
+
+void busPostTransmission(void* context) {
+    static_cast<RtuBus*>(context)->markActivity();
+}
+
+} // namespace
+
+RtuBus::RtuBus()
+    : _port(nullptr), _rxPin(-1), _txPin(-1), _baudRate(115200),
+      _silentInterval(silentInterval(115200)), _lastActivity(0) {
+#if defined(ESP32)
+    _mutex = nullptr;
+    _lockDepth = 0;
+#endif
+    memset(_devices, 0, sizeof(_devices));
+    resetSlaveStats();
+}
+
+void RtuBus::begin(HardwareSerial& port, unsigned long baudRate, int8_t rxPin, int8_t txPin) {
+#if defined(ESP32)
+    if (_mutex == nullptr) {
+        _mutex = xSemaphoreCreateRecursiveMutex();
+    }
+#endif
+    _port = &port;
+    _rxPin = rxPin;
+    _txPin = txPin;
+    _baudRate = baudRate;
+    _silentInterval = silentInterval(baudRate);
+
+    _port->begin(baudRate, SERIAL_8N1, _rxPin, _txPin);
+    _master.begin(*_port, baudRate);
+    _master.setTransmissionCallbacks(busPreTransmission, busPostTransmission, this);
+}
+
+void RtuBus::setBaudRate(unsigned long baudRate) {
+    if (baudRate == 0) {
+        return;
+    }
+    _baudRate = baudRate;
+    _silentInterval = silentInterval(baudRate);
+
+    if (_port != nullptr) {
+        _port->flush();
+        _port->begin(baudRate, SERIAL_8N1, _rxPin, _txPin);
+    }
+    _master.setBaudRate(baudRate);
+}
+
+unsigned long RtuBus::silentInterval(unsigned long baudRate) {
+    // 3.5 character times = 3.5 * (11 bits/character)
+    // 11 bits = 1 start bit + 8 data bits + 1 parity bit + 1 stop bit in Modbus-RTU asynchronous transmission
+    float characterTime = 1000.0 / (float)(baudRate / 11.0); // Milliseconds per character
+    return (unsigned long)(3.5 * characterTime);
+}
+
+void RtuBus::waitForSilentInterval() {
+    unsigned long elapsed = millis() - _lastActivity;
+    // Use a longer wait time to ensure devices are ready
+    if (elapsed < (_silentInterval * 2) && _lastActivity > 0) {
+        delay((_silentInterval * 2) - elapsed);
+    }
+}
+
+void RtuBus::lock() {
+#if defined(ESP32)
+    if (_mutex != nullptr) {
+        xSemaphoreTakeRecursive(_mutex, portMAX_DELAY);
+        _lockDepth++;
+    }
+#endif
+}
+
+void RtuBus::unlock() {
+#if defined(ESP32)
+    if (_mutex != nullptr) {
+        _lockDepth--;
+        xSemaphoreGiveRecursive(_mutex);
+    }
+#endif
+}
+
+void RtuBus::pause(unsigned long ms) {
+#if defined(ESP32)
+    if (_mutex != nullptr && _lockDepth == 1) {
+        unlock();
+        delay(ms);
+        lock();
+        return;
+    }
+#endif
+    delay(ms);
+}
+
+RtuStatus RtuBus::execute(const RtuRequest& request) {
+    lock();
+    waitForSilentInterval();
+    RtuStatus status = _master.execute(request);
+    markActivity();
+
+    SlaveBusStats* stats = statsFor(request.slave);
+    if (stats != nullptr) {
+        stats->transactions++;
+        if (status != RtuStatus::SUCCESS) {
+            stats->failures++;
+        } else {
+            stats->registers += request.readCount + request.writeCount;
+        }
+        stats->busMicros += _master.getStats().lastLatencyMicros;
+    }
+    unlock();
+    return status;
+}
+
+bool RtuBus::attach(uint8_t slave, ServiceCallback callback, void* context, uint8_t weight) {
+    if (context == nullptr) {
+        return false;
+    }
+    if (weight == 0) {
+        weight = 1;
+    }
+
+    DeviceSlot* freeSlot = nullptr;
+    for (uint8_t i = 0; i < BUS_MAX_DEVICES; i++) {
+        DeviceSlot& slot = _devices[i];
+        if (slot.context == context) {
+            slot.slave = slave;
+            slot.callback = callback;
+            slot.weight = weight;
+            return true;
+        }
+        if (slot.context == nullptr && freeSlot == nullptr) {
+            freeSlot = &slot;
+        }
+    }
+
+    if (freeSlot == nullptr) {
+        return false;
+    }
+    freeSlot->context = context;
+    freeSlot->callback = callback;
+    freeSlot->slave = slave;
+    freeSlot->weight = weight;
+    freeSlot->currentWeight = 0;
+    return true;
+}
+
+void RtuBus::detach(void* context) {
+    for (uint8_t i = 0; i < BUS_MAX_DEVICES; i++) {
+        if (_devices[i].context == context) {
+            memset(&_devices[i], 0, sizeof(DeviceSlot));
+        }
+    }
+}
+
+uint8_t RtuBus::getDeviceCount() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < BUS_MAX_DEVICES; i++) {
+        if (_devices[i].context != nullptr) {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool RtuBus::service() {
+    // Smooth weighted round-robin: every device gains its weight, the one
+    // with the highest credit runs and pays back the total. Turns are spread
+    // evenly instead of handing a heavy device a burst of consecutive turns.
+    DeviceSlot* selected = nullptr;
+    int16_t totalWeight = 0;
+
+    for (uint8_t i = 0; i < BUS_MAX_DEVICES; i++) {
+        DeviceSlot& slot = _devices[i];
+        if (slot.context == nullptr || slot.callback == nullptr) {
+            continue;
+        }
+        slot.currentWeight += slot.weight;
+        totalWeight += slot.weight;
+        if (selected == nullptr || slot.currentWeight > selected->currentWeight) {
+            selected = &slot;
+        }
+    }
+
+    if (selected == nullptr) {
+        return false;
+    }
+    selected->currentWeight -= totalWeight;
+
+    SlaveBusStats* stats = statsFor(selected->slave);
+    if (stats != nullptr) {
+        stats->serviceSteps++;
+    }
+    return selected->callback(selected->context);
+}
+
+bool RtuBus::getSlaveStats(uint8_t index, SlaveBusStats& stats) const {
+    if (index >= BUS_MAX_DEVICES || _slaveStats[index].since == 0) {
+        return false;
+    }
+    stats = _slaveStats[index];
+    return true;
+}
+
+void RtuBus::resetSlaveStats() {
+    memset(_slaveStats, 0, sizeof(_slaveStats));
+}
+
+SlaveBusStats* RtuBus::statsFor(uint8_t slave) {
+    SlaveBusStats* freeSlot = nullptr;
+    for (uint8_t i = 0; i < BUS_MAX_DEVICES; i++) {
+        SlaveBusStats& stats = _slaveStats[i];
+        if (stats.since != 0 && stats.slave == slave) {
+            return &stats;
+        }
+        if (stats.since == 0 && freeSlot == nullptr) {
+            freeSlot = &stats;
+        }
+    }
+
+    if (freeSlot != nullptr) {
+        freeSlot->slave = slave;
+        // since doubles as the "slot in use" marker, so it must not be 0
+        freeSlot->since = millis() | 1;
+    }
+    return freeSlot;
+}
+
+} // namespace xy_sk
@@ -0,0 +1,159 @@
+#ifndef XY_SKXXX_BUS_H
+#define XY_SKXXX_BUS_H
+
+#include <Arduino.h>
+#include "XY-SKxxx-rtu.h"
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#endif
+
+namespace xy_sk {
+
+constexpr uint8_t BUS_MAX_DEVICES = 8;  // Device handles and per-slave statistics slots
+
+// Traffic counters for one slave address on the bus
+struct SlaveBusStats {
+    uint8_t slave;
+    uint32_t transactions;
+    uint32_t failures;
+    uint32_t registers;      // Registers read plus registers written
+    uint32_t busMicros;      // Time the wire was busy for this slave
+    uint32_t serviceSteps;   // Scheduled service() turns given to the device
+    unsigned long since;     // millis() when counting started
+};
+
+/**
+ * Shared RS485/TTL Modbus line
+ *
+ * Owns the UART, the RTU master and the inter-frame timing so several
+ * XY-SK devices with different slave addresses can share one wire. Device
+ * handles attach with a service callback and a weight; service() hands the
+ * wire to them in smooth weighted round-robin order, so a heavily polled
+ * unit cannot starve the others.
+ */
+class RtuBus {
+public:
+    typedef bool (*ServiceCallback)(void* context);
+
+    RtuBus();
+
+    /**
+     * Start the UART and the RTU master
+     *
+     * @param port Serial port wired to the bus
+     * @param baudRate Line speed
+     * @param rxPin RX pin (-1 keeps the default)
+     * @param txPin TX pin (-1 keeps the default)
+     */
+    void begin(HardwareSerial& port, unsigned long baudRate, int8_t rxPin = -1, int8_t txPin = -1);
+
+    /**
+     * Change the line speed of the UART and the frame timing
+     */
+    void setBaudRate(unsigned long baudRate);
+    unsigned long getBaudRate() const { return _baudRate; }
+
+    /**
+     * Inter-frame silent interval in milliseconds (3.5 character times)
+     */
+    unsigned long getSilentInterval() const { return _silentInterval; }
+    static unsigned long silentInterval(unsigned long baudRate);
+
+    /**
+     * Block until the line has been idle long enough for the next frame
+     */
+    void waitForSilentInterval();
+
+    /**
+     * Mark the end of bus activity (start of the next silent interval)
+     */
+    void markActivity() { _lastActivity = millis(); }
+
+    /**
+     * Run one transaction on the wire, observing the silent interval
+     */
+    RtuStatus execute(const RtuRequest& request);
+
+    /**
+     * Exclusive use of the wire for tasks other than loop()
+     *
+     * Recursive; execute() takes it for every transaction. On ESP32 the
+     * mutex exists once begin() has run, elsewhere these are no-ops.
+     */
+    void lock();
+    void unlock();
+
+    /**
+     * Wait between attempts of one operation. The lock is released
+     * meanwhile if the calling task holds it only once; an enclosing lock
+     * (a transaction builder commit, a recovery) keeps the bus.
+     */
+    void pause(unsigned long ms);
+
+    RtuMaster& master() { return _master; }
+    const RtuMaster& master() const { return _master; }
+
+    /**
+     * Register a device for scheduled service
+     *
+     * Attaching a context again updates its slave address and weight.
+     *
+     * @param slave Slave address of the device
+     * @param callback Performs one unit of background work, returns false on a bus error
+     * @param context Passed to the callback (the device handle)
+     * @param weight Relative share of service turns (1-255)
+     * @return false if all device slots are taken
+     */
+    bool attach(uint8_t slave, ServiceCallback callback, void* context, uint8_t weight = 1);
+    void detach(void* context);
+    uint8_t getDeviceCount() const;
+
+    /**
+     * Give the next device in weighted round-robin order one service turn
+     *
+     * @return false if no device is attached or its service step failed
+     */
+    bool service();
+
+    /**
+     * Read the traffic counters of a slot
+     *
+     * @param index Slot index (0 to BUS_MAX_DEVICES - 1)
+     * @param stats Receives the counters
+     * @return true if the slot is in use
+     */
+    bool getSlaveStats(uint8_t index, SlaveBusStats& stats) const;
+    void resetSlaveStats();
+
+private:
+    struct DeviceSlot {
+        void* context;
+        ServiceCallback callback;
+        uint8_t slave;
+        uint8_t weight;
+        int16_t currentWeight;  // Smooth weighted round-robin state
+    };
+
+    SlaveBusStats* statsFor(uint8_t slave);
+
+    HardwareSerial* _port;
+    int8_t _rxPin;
+    int8_t _txPin;
+    unsigned long _baudRate;
+    unsigned long _silentInterval;
+    unsigned long _lastActivity;
+#if defined(ESP32)
+    SemaphoreHandle_t _mutex;
+    uint8_t _lockDepth;      // Nesting depth of the holder, only touched by it
+#endif
+
+    RtuMaster _master;
+    DeviceSlot _devices[BUS_MAX_DEVICES];
+    SlaveBusStats _slaveStats[BUS_MAX_DEVICES];
+};
+
+} // namespace xy_sk
+
+#endif // XY_SKXXX_BUS_H
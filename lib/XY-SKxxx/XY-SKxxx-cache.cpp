@@ -13,21 +13,23 @@ bool XY_SKxxx::updateAllStatus(bool force) {
   
   // Update all status components
   success &= updateOutputStatus(force);
-  delay(_silentIntervalTime * 2);
+  delay(_bus->getSilentInterval() * 2);
   
   success &= updateDeviceSettings(force);
-  delay(_silentIntervalTime * 2);
+  delay(_bus->getSilentInterval() * 2);
   
   success &= updateEnergyMeters(force);
-  delay(_silentIntervalTime * 2);
+  delay(_bus->getSilentInterval() * 2);
   
   success &= updateTemperatures(force);
-  delay(_silentIntervalTime * 2);
+  delay(_bus->getSilentInterval() * 2);
   
   success &= updateDeviceState(force);
-  delay(_silentIntervalTime * 2);
   
-  success &= updateConstantPowerSettings(force);
+  if (hasFeature(xy_sk::FEATURE_CONSTANT_POWER)) {
+    delay(_bus->getSilentInterval() * 2);
+    success &= updateConstantPowerSettings(force);
+  }
   
   _cacheValid = success;
   
@@ -41,75 +43,28 @@ bool XY_SKxxx::updateDeviceState(bool force) {
     return true;
   }
   
-  bool success = true;  // Add success flag to track overall operation success
-  waitForSilentInterval();
-  
-  // Read output state
-  uint8_t outputResult = modbus.readHoldingRegisters(REG_ONOFF, 1);
-  if (outputResult == modbus.ku8MBSuccess) {
-    _status.outputEnabled = (modbus.getResponseBuffer(0) != 0);
-  } else {
-    _lastCommsTime = millis();
+  // Output state, key lock, protection status, CC/CV mode and system
+  // status, one block read from LOCK to SYS_STATUS
+  uint16_t registers[5] = {REG_ONOFF, REG_LOCK, REG_PROTECT, REG_CVCC, REG_SYS_STATUS};
+  if (!refreshShadow(registers, hasFeature(xy_sk::FEATURE_SYSTEM_STATUS) ? 5 : 4)) {
     return false;
   }
   
-  delay(_silentIntervalTime * 2);
-  
-  // Read key lock status
-  preTransmission();
-  uint8_t lockResult = modbus.readHoldingRegisters(REG_LOCK, 1);
-  postTransmission();
-  
-  if (lockResult == modbus.ku8MBSuccess) {
-    _status.keyLocked = (modbus.getResponseBuffer(0) != 0);
-  } else {
-    success = false;
-  }
-  
-  delay(_silentIntervalTime * 2);
-  
-  // Read protection status
-  preTransmission();
-  uint8_t protResult = modbus.readHoldingRegisters(REG_PROTECT, 1);
-  postTransmission();
-  
-  if (protResult == modbus.ku8MBSuccess) {
-    _status.protectionStatus = modbus.getResponseBuffer(0);
-  } else {
-    success = false;
-  }
-  
-  delay(_silentIntervalTime * 2);
-  
-  // Read CC/CV mode
-  preTransmission();
-  uint8_t cvccResult = modbus.readHoldingRegisters(REG_CVCC, 1);
-  postTransmission();
-  
-  if (cvccResult == modbus.ku8MBSuccess) {
-    _status.cvccMode = modbus.getResponseBuffer(0);
-  } else {
-    success = false;
-  }
-  
-  delay(_silentIntervalTime * 2);
-  
-  // Read system status
-  preTransmission();
-  uint8_t sysResult = modbus.readHoldingRegisters(REG_SYS_STATUS, 1);
-  postTransmission();
-  
-  if (sysResult == modbus.ku8MBSuccess) {
-    _status.systemStatus = modbus.getResponseBuffer(0);
-  } else {
-    success = false;
-  }
-  
-  if (success) {
-    _lastStateUpdate = now;
+  decodeDeviceState(now);
+  return true;
+}
+
+void XY_SKxxx::decodeDeviceState(unsigned long now) {
+  _status.outputEnabled = (_shadow[REG_ONOFF] != 0);
+  _status.keyLocked = (_shadow[REG_LOCK] != 0);
+  _status.protectionStatus = _shadow[REG_PROTECT];
+  _status.cvccMode = _shadow[REG_CVCC];
+  if (hasFeature(xy_sk::FEATURE_SYSTEM_STATUS)) {
+    _status.systemStatus = _shadow[REG_SYS_STATUS];
   }
   
-  return success;
+  _lastStateUpdate = now;
+  notifySubscribers(xy_sk::POLL_STATE);
 }
 
 bool XY_SKxxx::updateOutputStatus(bool force) {
@@ -119,26 +74,45 @@ bool XY_SKxxx::updateOutputStatus(bool force) {
     return true;
   }
   
-  waitForSilentInterval();
-  
   // Read output voltage, current, power, and input voltage
-  uint8_t result = modbus.readHoldingRegisters(REG_VOUT, 4);
-  if (result == modbus.ku8MBSuccess) {
-    _status.outputVoltage = modbus.getResponseBuffer(0) / 100.0f;
-    _status.outputCurrent = modbus.getResponseBuffer(1) / 1000.0f;
-    _status.outputPower = modbus.getResponseBuffer(2) / 100.0f;
-    _status.inputVoltage = modbus.getResponseBuffer(3) / 100.0f;
-    
-    _lastOutputUpdate = now;
-    _cacheValid = true;
-    _lastCommsTime = millis();
+  uint16_t values[4];
+  if (readRegisters(REG_VOUT, 4, values)) {
+    decodeOutputStatus(now);
     return true;
   }
   
-  _lastCommsTime = millis();
   return false;
 }
 
+void XY_SKxxx::decodeOutputStatus(unsigned long now) {
+  // The sample hooks already ran when the block was read
+  _status.outputVoltage = _shadow[REG_VOUT] / (float)_model->voltageScale;
+  _status.outputCurrent = _shadow[REG_IOUT] / (float)_model->currentScale;
+  _status.outputPower = _shadow[REG_POWER] / (float)_model->powerScale;
+  _status.inputVoltage = _shadow[REG_UIN] / (float)_model->voltageScale;
+  
+  _lastOutputUpdate = now;
+  _cacheValid = true;
+  notifySubscribers(xy_sk::POLL_OUTPUT);
+}
+
+void XY_SKxxx::decodeOutputSample(uint16_t addr, uint16_t count, uint32_t sampleMicros) {
+  _status.outputVoltage = _shadow[REG_VOUT] / (float)_model->voltageScale;
+  _status.outputCurrent = _shadow[REG_IOUT] / (float)_model->currentScale;
+  _status.outputPower = (addr + count > REG_POWER) ? _shadow[REG_POWER] / (float)_model->powerScale
+                                                   : _status.outputVoltage * _status.outputCurrent;
+  if (addr + count > REG_UIN) {
+    _status.inputVoltage = _shadow[REG_UIN] / (float)_model->voltageScale;
+  }
+  _lastOutputUpdate = millis();
+  
+  for (uint8_t i = 0; i < XY_SKXXX_MAX_SAMPLE_HOOKS; i++) {
+    if (_sampleHooks[i].callback != nullptr) {
+      _sampleHooks[i].callback(_sampleHooks[i].context, *this, _status, sampleMicros);
+    }
+  }
+}
+
 bool XY_SKxxx::updateDeviceSettings(bool force) {
   // Check if update is needed based on timeout or force flag
   unsigned long now = millis();
@@ -146,29 +120,24 @@ bool XY_SKxxx::updateDeviceSettings(bool force) {
     return true;
   }
   
-  waitForSilentInterval();
-  
-  // Read voltage and current settings
-  uint8_t result = modbus.readHoldingRegisters(REG_V_SET, 2);
-  if (result == modbus.ku8MBSuccess) {
-    _status.setVoltage = modbus.getResponseBuffer(0) / 100.0f;
-    _status.setCurrent = modbus.getResponseBuffer(1) / 1000.0f;
-    
-    // Also read backlight and sleep timeout settings
-    delay(_silentIntervalTime * 2);
-    result = modbus.readHoldingRegisters(REG_B_LED, 2);
-    if (result == modbus.ku8MBSuccess) {
-      _status.backlightLevel = modbus.getResponseBuffer(0);
-      _status.sleepTimeout = modbus.getResponseBuffer(1);
-      
-      _lastSettingsUpdate = now;
-      _lastCommsTime = millis();
-      return true;
-    }
+  // Voltage and current settings with backlight and sleep timeout, one block read
+  uint16_t registers[4] = {REG_V_SET, REG_I_SET, REG_B_LED, REG_SLEEP};
+  if (!refreshShadow(registers, 4)) {
+    return false;
   }
   
-  _lastCommsTime = millis();
-  return false;
+  decodeDeviceSettings(now);
+  return true;
+}
+
+void XY_SKxxx::decodeDeviceSettings(unsigned long now) {
+  _status.setVoltage = _shadow[REG_V_SET] / (float)_model->voltageScale;
+  _status.setCurrent = _shadow[REG_I_SET] / (float)_model->currentScale;
+  _status.backlightLevel = _shadow[REG_B_LED];
+  _status.sleepTimeout = _shadow[REG_SLEEP];
+  
+  _lastSettingsUpdate = now;
+  notifySubscribers(xy_sk::POLL_SETTINGS);
 }
 
 bool XY_SKxxx::updateEnergyMeters(bool force) {
@@ -178,47 +147,92 @@ bool XY_SKxxx::updateEnergyMeters(bool force) {
     return true;
   }
   
-  waitForSilentInterval();
-  
-  // Read amp-hour counter (low and high registers)
-  uint8_t result = modbus.readHoldingRegisters(REG_AH_LOW, 2);
-  if (result != modbus.ku8MBSuccess) {
-    _lastCommsTime = millis();
+  // Amp-hour and watt-hour counters (low and high words) and output time
+  // (hours, minutes, seconds) in one block read, so every part of a counter
+  // comes from the same reply
+  uint16_t values[REG_OUT_S - REG_AH_LOW + 1];
+  if (!readRegisters(REG_AH_LOW, REG_OUT_S - REG_AH_LOW + 1, values)) {
     return false;
   }
   
-  uint16_t ahLow = modbus.getResponseBuffer(0);
-  uint16_t ahHigh = modbus.getResponseBuffer(1);
-  _status.ampHours = (uint32_t)ahHigh << 16 | ahLow;
-  
-  // Read watt-hour counter (low and high registers)
-  delay(_silentIntervalTime * 2);
-  result = modbus.readHoldingRegisters(REG_WH_LOW, 2);
-  if (result != modbus.ku8MBSuccess) {
-    _lastCommsTime = millis();
-    return false;
+  decodeEnergyMeters(now);
+  return true;
+}
+
+// Check a counter assembled from several registers against its last value.
+// The device may update the registers of a counter one after the other, so
+// a read can still catch a carry half done: the low part rolled over and the
+// high part not yet (the value drops by one carry) or the other way round
+// (it jumps ahead by one). Such a value is repaired by the carry. Anything
+// else going backwards means the device cleared the counter.
+// Returns the step to add to the extended counter.
+static uint32_t checkCounter(uint32_t previous, uint32_t& value, uint32_t maxStep,
+                             const uint32_t* carries, uint8_t carryCount, EnergyCounters& counters) {
+  // Modulo 2^32, so a wrap of the 32-bit counter is a small step
+  uint32_t step = value - previous;
+  if (step <= maxStep) {
+    return step;
+  }
+  
+  for (uint8_t i = 0; i < carryCount; i++) {
+    uint32_t carry = carries[i];
+    if (value / carry == previous / carry && value + carry - previous <= maxStep) {
+      value += carry;
+      counters.repaired++;
+      return value - previous;
+    }
+    if (value / carry == previous / carry + 1 && value - carry - previous <= maxStep) {
+      value -= carry;
+      counters.repaired++;
+      return value - previous;
+    }
   }
   
-  uint16_t whLow = modbus.getResponseBuffer(0);
-  uint16_t whHigh = modbus.getResponseBuffer(1);
-  _status.wattHours = (uint32_t)whHigh << 16 | whLow;
-  
-  // Read output time (hours, minutes, seconds)
-  delay(_silentIntervalTime * 2);
-  result = modbus.readHoldingRegisters(REG_OUT_H, 3);
-  if (result != modbus.ku8MBSuccess) {
-    _lastCommsTime = millis();
-    return false;
+  if ((int32_t)step < 0) {
+    counters.resets++;
+    return value; // Counting from zero again
   }
+  return step; // A long gap between reads, nothing to repair
+}
+
+void XY_SKxxx::decodeEnergyMeters(unsigned long now) {
+  uint32_t ampHours = (uint32_t)_shadow[REG_AH_HIGH] << 16 | _shadow[REG_AH_LOW];
+  uint32_t wattHours = (uint32_t)_shadow[REG_WH_HIGH] << 16 | _shadow[REG_WH_LOW];
+  uint32_t outputTime = _shadow[REG_OUT_H] * 3600UL + _shadow[REG_OUT_M] * 60UL + _shadow[REG_OUT_S];
+  
+  if (_energy.samples == 0) {
+    // The first read takes over the device counters, the first one after
+    // resetEnergyCounters() is the new zero
+    _energy.ampHours = _energyFromZero ? 0 : ampHours;
+    _energy.wattHours = _energyFromZero ? 0 : wattHours;
+    _energy.outputTime = _energyFromZero ? 0 : outputTime;
+  } else {
+    // Twice the most the counters can advance at full current and power
+    // since the last read, with two seconds of slack for the device clock
+    static const uint32_t WORD_CARRY[] = {0x10000UL};
+    static const uint32_t TIME_CARRIES[] = {60, 3600};
+    float seconds = (now - _lastEnergyUpdate) / 1000.0f + 2.0f;
+    uint32_t maxAh = (uint32_t)(_model->maxCurrent * seconds * (2000.0f / 3600.0f)) + 1;
+    uint32_t maxWh = (uint32_t)(_model->maxPower * seconds * (2000.0f / 3600.0f)) + 1;
+    
+    _energy.ampHours += checkCounter(_status.ampHours, ampHours, maxAh, WORD_CARRY, 1, _energy);
+    _energy.wattHours += checkCounter(_status.wattHours, wattHours, maxWh, WORD_CARRY, 1, _energy);
+    _energy.outputTime += checkCounter(_status.outputTime, outputTime, (uint32_t)seconds, TIME_CARRIES, 2, _energy);
+  }
+  _energy.samples++;
   
-  uint16_t hours = modbus.getResponseBuffer(0);
-  uint16_t minutes = modbus.getResponseBuffer(1);
-  uint16_t seconds = modbus.getResponseBuffer(2);
-  _status.outputTime = hours * 3600 + minutes * 60 + seconds;
+  _status.ampHours = ampHours;
+  _status.wattHours = wattHours;
+  _status.outputTime = outputTime;
   
   _lastEnergyUpdate = now;
-  _lastCommsTime = millis();
-  return true;
+  notifySubscribers(xy_sk::POLL_ENERGY);
+}
+
+void XY_SKxxx::resetEnergyCounters() {
+  // The next read is the new zero, later reads add the device's steps
+  memset(&_energy, 0, sizeof(_energy));
+  _energyFromZero = true;
 }
 
 bool XY_SKxxx::updateTemperatures(bool force) {
@@ -228,228 +242,225 @@ bool XY_SKxxx::updateTemperatures(bool force) {
     return true;
   }
   
-  waitForSilentInterval();
-  
   // Read internal and external temperatures
-  uint8_t result = modbus.readHoldingRegisters(REG_T_IN, 2);
-  if (result == modbus.ku8MBSuccess) {
-    _status.internalTemp = modbus.getResponseBuffer(0) / 10.0f;
-    _status.externalTemp = modbus.getResponseBuffer(1) / 10.0f;
-    
-    _lastTempUpdate = now;
-    _lastCommsTime = millis();
+  uint16_t values[2];
+  if (readRegisters(REG_T_IN, 2, values)) {
+    decodeTemperatures(now);
     return true;
   }
   
-  _lastCommsTime = millis();
   return false;
 }
 
-bool XY_SKxxx::updateCalibrationSettings(bool force) {
-  unsigned long now = millis();
-  if (!force && (now - _lastCalibrationUpdate < _cacheTimeout)) {
-    return true;
-  }
-  
-  waitForSilentInterval();
-  
-  // Read internal temperature calibration
-  uint8_t result = modbus.readHoldingRegisters(REG_T_IN_CAL, 1);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
-    _internalTempCalibration = (int16_t)modbus.getResponseBuffer(0) / 10.0f;
-  }
-  
-  delay(_silentIntervalTime * 2);
-  
-  // Read external temperature calibration
-  result = modbus.readHoldingRegisters(REG_T_EXT_CAL, 1);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
-    _externalTempCalibration = (int16_t)modbus.getResponseBuffer(0) / 10.0f;
-  }
-  
-  delay(_silentIntervalTime * 2);
-  
-  // Read beeper setting
-  result = modbus.readHoldingRegisters(REG_BEEPER, 1);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
-    _beeperEnabled = (modbus.getResponseBuffer(0) != 0);
-  }
+void XY_SKxxx::decodeTemperatures(unsigned long now) {
+  _status.internalTemp = _shadow[REG_T_IN] / 10.0f;
+  _status.externalTemp = _shadow[REG_T_EX] / 10.0f;
   
-  // Read selected data group
-  delay(_silentIntervalTime * 2);
-  result = modbus.readHoldingRegisters(REG_EXTRACT_M, 1);
-  if (result != modbus.ku8MBSuccess) {
-    _lastCommsTime = millis();
+  _lastTempUpdate = now;
+  notifySubscribers(xy_sk::POLL_TEMPERATURES);
+}
+
+bool XY_SKxxx::updateCalibrationSettings(bool force) {
+  // Temperature calibration, beeper, selected data group and MPPT settings
+  uint16_t registers[6] = {REG_T_IN_CAL, REG_T_EXT_CAL, REG_BEEPER, REG_EXTRACT_M,
+                           REG_MPPT_ENABLE, REG_MPPT_THRESHOLD};
+  bool mppt = hasFeature(xy_sk::FEATURE_MPPT);
+  if (!refreshShadow(registers, mppt ? 6 : 4, force ? 0 : _cacheTimeout)) {
     return false;
   }
   
-  _selectedDataGroup = modbus.getResponseBuffer(0);
-  
-  // Read MPPT enable state
-  delay(_silentIntervalTime * 2);
-  result = modbus.readHoldingRegisters(REG_MPPT_ENABLE, 1);
-  if (result == modbus.ku8MBSuccess) {
-    _mpptEnabled = (modbus.getResponseBuffer(0) != 0);
-  }
-  
-  // Read MPPT threshold
-  delay(_silentIntervalTime * 2);
-  result = modbus.readHoldingRegisters(REG_MPPT_THRESHOLD, 1);
-  if (result == modbus.ku8MBSuccess) {
-    _mpptThreshold = modbus.getResponseBuffer(0) / 100.0f;
+  _internalTempCalibration = (int16_t)_shadow[REG_T_IN_CAL] / 10.0f;
+  _externalTempCalibration = (int16_t)_shadow[REG_T_EXT_CAL] / 10.0f;
+  _beeperEnabled = (_shadow[REG_BEEPER] != 0);
+  _selectedDataGroup = _shadow[REG_EXTRACT_M];
+  if (mppt) {
+    _mpptEnabled = (_shadow[REG_MPPT_ENABLE] != 0);
+    _mpptThreshold = _shadow[REG_MPPT_THRESHOLD] / 100.0f;
   }
-  
-  _lastCalibrationUpdate = now;
-  _lastCommsTime = millis();
   return true;
 }
 
 // Battery cutoff current methods
 bool XY_SKxxx::updateBatteryCutoffCurrent(bool force) {
-  unsigned long now = millis();
-  if (!force && (now - _lastBatteryCutoffUpdate < _cacheTimeout)) {
-    return true;
+  if (!hasFeature(xy_sk::FEATURE_BATTERY_CUTOFF)) {
+    return false;
   }
-
-  waitForSilentInterval();
-  
-  // Read battery cutoff current
-  uint8_t result = modbus.readHoldingRegisters(REG_BTF, 1);
-  if (result == modbus.ku8MBSuccess) {
-    _protection.batteryCutoffCurrent = modbus.getResponseBuffer(0) / 1000.0f; // 3 decimal places
-    _lastBatteryCutoffUpdate = now;
-    _lastCommsTime = millis();
-    return true;
+  
+  if (!refreshShadow(REG_BTF, 1, force ? 0 : _cacheTimeout)) {
+    return false;
   }
   
-  _lastCommsTime = millis();
-  return false;
+  _protection.batteryCutoffCurrent = _shadow[REG_BTF] / 1000.0f; // 3 decimal places
+  return true;
 }
 
 float XY_SKxxx::getCachedBatteryCutoffCurrent(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_BATTERY_CUTOFF, refresh);
   if (refresh) {
     updateBatteryCutoffCurrent(true);
   }
+  endCacheAccess(CACHE_BATTERY_CUTOFF, refresh, mark);
   return _protection.batteryCutoffCurrent;
 }
 
 // Communication settings (slave address and baudrate)
 bool XY_SKxxx::updateCommunicationSettings(bool force) {
-  unsigned long now = millis();
-  if (!force && (now - _lastCommunicationSettingsUpdate < _cacheTimeout)) {
-    return true;
-  }
-  
-  waitForSilentInterval();
-  
-  // Read slave address
-  uint8_t result = modbus.readHoldingRegisters(REG_SLAVE_ADDR, 1);
-  if (result == modbus.ku8MBSuccess) {
-    _cachedSlaveAddress = modbus.getResponseBuffer(0);
-    
-    // Read baudrate code
-    delay(_silentIntervalTime * 2);
-    result = modbus.readHoldingRegisters(REG_BAUDRATE_L, 1);
-    if (result == modbus.ku8MBSuccess) {
-      _cachedBaudRateCode = modbus.getResponseBuffer(0);
-      _lastCommunicationSettingsUpdate = now;
-      _lastCommsTime = millis();
-      return true;
-    }
+  // Slave address and baudrate code
+  if (!refreshShadow(REG_SLAVE_ADDR, 2, force ? 0 : _cacheTimeout)) {
+    return false;
   }
   
-  _lastCommsTime = millis();
-  return false;
+  _cachedSlaveAddress = _shadow[REG_SLAVE_ADDR];
+  _cachedBaudRateCode = _shadow[REG_BAUDRATE_L];
+  return true;
 }
 
 // Device state access methods
 bool XY_SKxxx::isOutputEnabled(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_OUTPUT_ENABLED, refresh);
   if (refresh) {
     updateDeviceState(true);
   }
+  endCacheAccess(CACHE_OUTPUT_ENABLED, refresh, mark);
   return _status.outputEnabled;
 }
 
 bool XY_SKxxx::isKeyLocked(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_KEY_LOCKED, refresh);
   if (refresh) {
     updateDeviceState(true);
   }
+  endCacheAccess(CACHE_KEY_LOCKED, refresh, mark);
   return _status.keyLocked;
 }
 
 uint16_t XY_SKxxx::getSystemStatus(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_SYSTEM_STATUS, refresh);
   if (refresh) {
     updateDeviceState(true);
   }
+  endCacheAccess(CACHE_SYSTEM_STATUS, refresh, mark);
   return _status.systemStatus;
 }
 
 // Device settings access methods
 float XY_SKxxx::getSetVoltage(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_SET_VOLTAGE, refresh);
   if (refresh) {
     updateDeviceSettings(true);
   }
+  endCacheAccess(CACHE_SET_VOLTAGE, refresh, mark);
   return _status.setVoltage;
 }
 
 float XY_SKxxx::getSetCurrent(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_SET_CURRENT, refresh);
   if (refresh) {
     updateDeviceSettings(true);
   }
+  endCacheAccess(CACHE_SET_CURRENT, refresh, mark);
   return _status.setCurrent;
 }
 
 // Calibration settings access methods
 float XY_SKxxx::getInternalTempCalibration(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_TEMP_CALIBRATION, refresh);
   if (refresh) {
     updateCalibrationSettings(true);
   }
+  endCacheAccess(CACHE_TEMP_CALIBRATION, refresh, mark);
   return _internalTempCalibration;
 }
 
 float XY_SKxxx::getExternalTempCalibration(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_TEMP_CALIBRATION, refresh);
   if (refresh) {
     updateCalibrationSettings(true);
   }
+  endCacheAccess(CACHE_TEMP_CALIBRATION, refresh, mark);
   return _externalTempCalibration;
 }
 
 // Constant Power settings update method
 bool XY_SKxxx::updateConstantPowerSettings(bool force) {
+  if (!hasFeature(xy_sk::FEATURE_CONSTANT_POWER)) {
+    return false;
+  }
+  
   unsigned long now = millis();
   if (!force && (now - _lastConstantPowerUpdate < _cacheTimeout)) {
     return true;
   }
   
-  waitForSilentInterval();
-  
-  // Read CP mode enable state
-  uint8_t result = modbus.readHoldingRegisters(REG_CP_ENABLE, 1);
-  if (result != modbus.ku8MBSuccess) {
-    _lastCommsTime = millis();
+  // CP mode enable state and CP value
+  if (!refreshShadow(REG_CP_ENABLE, 2)) {
     return false;
   }
   
-  _status.cpModeEnabled = (modbus.getResponseBuffer(0) != 0);
-  
-  // Read CP value
-  delay(_silentIntervalTime * 2);
-  result = modbus.readHoldingRegisters(REG_CP_SET, 1);
-  if (result != modbus.ku8MBSuccess) {
-    _lastCommsTime = millis();
+  decodeConstantPowerSettings(now);
+  return true;
+}
+
+void XY_SKxxx::decodeConstantPowerSettings(unsigned long now) {
+  _status.cpModeEnabled = (_shadow[REG_CP_ENABLE] != 0);
+  _status.constantPower = _shadow[REG_CP_SET] / 10.0f;
+  _lastConstantPowerUpdate = now;
+  notifySubscribers(xy_sk::POLL_CONSTANT_POWER);
+}
+
+/* Whole cache invalidation and reload */
+void XY_SKxxx::invalidateCaches() {
+  invalidateShadow();
+  for (int i = 0; i < 10; i++) {
+    groupCache[i].valid = false;
+  }
+  
+  // Every poll group is due on the next pollCache() turn
+  unsigned long stale = millis() - _cacheTimeout;
+  _lastOutputUpdate = stale;
+  _lastStateUpdate = stale;
+  _lastSettingsUpdate = stale;
+  _lastEnergyUpdate = stale;
+  _lastTempUpdate = stale;
+  _lastConstantPowerUpdate = stale;
+  _cacheValid = false;
+}
+
+bool XY_SKxxx::reloadCaches() {
+  invalidateCaches();
+  
+  // Every register the model answers in 0x0000-0x0023 and M0, which
+  // refreshShadow() reads as two blocks
+  uint16_t registers[REG_CP_SET + 1 + xy_sk::DATA_GROUP_REGISTERS];
+  uint8_t count = 0;
+  for (uint16_t reg = REG_V_SET; reg <= REG_CP_SET; reg++) {
+    if (isShadowReadable(reg)) {
+      registers[count++] = reg;
+    }
+  }
+  for (uint16_t i = 0; i < xy_sk::DATA_GROUP_REGISTERS; i++) {
+    registers[count++] = xy_sk::DATA_GROUP_BASE_ADDR + i;
+  }
+  if (!refreshShadow(registers, count)) {
     return false;
   }
   
-  _status.constantPower = modbus.getResponseBuffer(0) / 10.0f;
-  _lastConstantPowerUpdate = now;
-  _lastCommsTime = millis();
-  return true;
+  // Decode everything from the fresh shadow, the update methods below
+  // find their registers younger than the cache timeout
+  unsigned long now = millis();
+  decodeOutputStatus(now);
+  decodeDeviceState(now);
+  decodeDeviceSettings(now);
+  decodeEnergyMeters(now);
+  decodeTemperatures(now);
+  if (hasFeature(xy_sk::FEATURE_CONSTANT_POWER)) {
+    decodeConstantPowerSettings(now);
+  }
+  bool success = updateAllProtectionSettings(false);
+  success &= updateCalibrationSettings(false);
+  success &= updateCommunicationSettings(false);
+  _cacheValid = success;
+  return success;
 }
 
 #endif // XY_SKXXX_CACHE_IMPL
@@ -0,0 +1,119 @@
+#include "XY-SKxxx-internal.h"
+
+static const unsigned long CACHE_AGE_LIMITS[XY_SKXXX_CACHE_AGE_BUCKETS - 1] = {100, 1000, 5000, 30000, 300000};
+
+static const char* const CACHE_FIELD_NAMES[CACHE_FIELD_COUNT] = {
+  "outputVoltage", "outputCurrent", "outputPower", "inputVoltage", "measurements", "energy",
+  "temperatures", "internalTemp", "externalTemp", "outputEnabled", "keyLocked", "protectionStatus",
+  "cvccMode", "systemStatus", "setVoltage", "setCurrent", "operatingMode", "cpModeEnabled",
+  "constantPower", "tempCalibration", "constantVoltage", "constantCurrent", "lowVoltageProtection",
+  "overVoltageProtection", "overCurrentProtection", "overPowerProtection", "highPowerTime",
+  "overAmpHours", "overWattHours", "overTemperature", "powerOnInit", "batteryCutoff", "memoryGroup"
+};
+
+const char* XY_SKxxx::getCacheFieldName(CacheField field) {
+  return (field < CACHE_FIELD_COUNT) ? CACHE_FIELD_NAMES[field] : "unknown";
+}
+
+unsigned long XY_SKxxx::getCacheAgeLimit(uint8_t bucket) {
+  return (bucket < XY_SKXXX_CACHE_AGE_BUCKETS - 1) ? CACHE_AGE_LIMITS[bucket] : XY_SKXXX_SHADOW_FOREVER;
+}
+
+void XY_SKxxx::resetCacheStats() {
+  memset(_cacheStats, 0, sizeof(_cacheStats));
+}
+
+unsigned long XY_SKxxx::decodedAge(uint16_t addr, unsigned long decoded) const {
+  // Never read, or dropped by invalidateCaches()
+  if (getShadowAge(addr) == XY_SKXXX_SHADOW_FOREVER) {
+    return XY_SKXXX_SHADOW_FOREVER;
+  }
+  return millis() - decoded;
+}
+
+unsigned long XY_SKxxx::cacheFieldAge(CacheField field) const {
+  // Decoded status groups carry their own timestamp, the other values are
+  // decoded from the shadow register they come from
+  switch (field) {
+    case CACHE_OUTPUT_VOLTAGE:
+    case CACHE_OUTPUT_CURRENT:
+    case CACHE_OUTPUT_POWER:
+    case CACHE_INPUT_VOLTAGE:
+    case CACHE_MEASUREMENTS:
+      return decodedAge(REG_VOUT, _lastOutputUpdate);
+    case CACHE_ENERGY:
+      return decodedAge(REG_AH_LOW, _lastEnergyUpdate);
+    case CACHE_TEMPERATURES:
+    case CACHE_INTERNAL_TEMP:
+    case CACHE_EXTERNAL_TEMP:
+      return decodedAge(REG_T_IN, _lastTempUpdate);
+    case CACHE_OUTPUT_ENABLED:
+    case CACHE_KEY_LOCKED:
+    case CACHE_PROTECTION_STATUS:
+    case CACHE_CVCC_MODE:
+    case CACHE_SYSTEM_STATUS:
+    case CACHE_OPERATING_MODE:
+      return decodedAge(REG_ONOFF, _lastStateUpdate);
+    case CACHE_SET_VOLTAGE:
+    case CACHE_SET_CURRENT:
+      return decodedAge(REG_V_SET, _lastSettingsUpdate);
+    case CACHE_CP_MODE_ENABLED:
+    case CACHE_CONSTANT_POWER:
+      return decodedAge(REG_CP_SET, _lastConstantPowerUpdate);
+    case CACHE_TEMP_CALIBRATION: return getShadowAge(REG_T_IN_CAL);
+    case CACHE_CONSTANT_VOLTAGE: return getShadowAge(REG_CV_SET);
+    case CACHE_CONSTANT_CURRENT: return getShadowAge(REG_CC_SET);
+    case CACHE_LOW_VOLTAGE_PROTECTION: return getShadowAge(REG_S_LVP);
+    case CACHE_OVER_VOLTAGE_PROTECTION: return getShadowAge(REG_S_OVP);
+    case CACHE_OVER_CURRENT_PROTECTION: return getShadowAge(REG_S_OCP);
+    case CACHE_OVER_POWER_PROTECTION: return getShadowAge(REG_S_OPP);
+    case CACHE_HIGH_POWER_TIME: return getShadowAge(REG_S_OHP_H);
+    case CACHE_OVER_AMP_HOURS: return getShadowAge(REG_S_OAH_L);
+    case CACHE_OVER_WATT_HOURS: return getShadowAge(REG_S_OWH_L);
+    case CACHE_OVER_TEMPERATURE: return getShadowAge(REG_S_OTP);
+    case CACHE_POWER_ON_INIT: return getShadowAge(REG_S_INI);
+    case CACHE_BATTERY_CUTOFF: return getShadowAge(REG_BTF);
+    default:
+      return XY_SKXXX_SHADOW_FOREVER;
+  }
+}
+
+uint32_t XY_SKxxx::beginCacheAccess(CacheField field, bool refresh) {
+  return beginCacheAccess(field, refresh, refresh ? cacheFieldAge(field) : 0);
+}
+
+uint32_t XY_SKxxx::beginCacheAccess(CacheField field, bool refresh, unsigned long age) {
+  if (refresh) {
+    CacheFieldStats& stats = _cacheStats[field];
+    stats.refreshes++;
+    if (age < _cacheTimeout) {
+      stats.redundantRefreshes++;
+    }
+  }
+  return _readFrames;
+}
+
+void XY_SKxxx::endCacheAccess(CacheField field, bool refresh, uint32_t mark) {
+  endCacheAccess(field, refresh, mark, cacheFieldAge(field));
+}
+
+void XY_SKxxx::endCacheAccess(CacheField field, bool refresh, uint32_t mark, unsigned long age) {
+  CacheFieldStats& stats = _cacheStats[field];
+  uint32_t frames = _readFrames - mark;
+  stats.busReads += frames;
+  if (!refresh) {
+    if (frames > 0) {
+      stats.misses++;
+    } else if (age < _cacheTimeout) {
+      stats.hits++;
+    } else {
+      stats.staleHits++;
+    }
+  }
+
+  uint8_t bucket = 0;
+  while (bucket < XY_SKXXX_CACHE_AGE_BUCKETS - 1 && age >= CACHE_AGE_LIMITS[bucket]) {
+    bucket++;
+  }
+  stats.ageHistogram[bucket]++;
+}
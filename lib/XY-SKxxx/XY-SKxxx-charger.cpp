@@ -0,0 +1,380 @@
+#include "XY-SKxxx-internal.h"
+#include "XY-SKxxx-charger.h"
+
+#define CHARGER_TEMPERATURE_INTERVAL 2000  // ms between REG_T_EX reads
+#define CHARGER_ENERGY_INTERVAL 5000       // ms between energy meter reads
+#define CHARGER_TAPER_SAMPLES 3            // Samples below the termination current that end absorb
+#define CHARGER_MAX_READ_FAILURES 5        // Consecutive failed reads before a fault
+#define CHARGER_TEMPERATURE_HYSTERESIS 2.0f
+#define CHARGER_OVERVOLTAGE_MARGIN 0.05f   // Fraction above the target that faults
+
+ChargeProfile chargeProfileFor(BatteryChemistry chemistry, uint8_t cells, float chargeCurrent) {
+  ChargeProfile profile;
+  profile.chemistry = chemistry;
+  profile.cells = cells;
+  profile.chargeCurrent = chargeCurrent;
+  profile.maxDurationMs = 12UL * 3600UL * 1000UL;
+
+  switch (chemistry) {
+    case CHEM_LIFEPO4:
+      profile.absorbVoltage = 3.60f;
+      profile.floatVoltage = 0.0f;
+      profile.terminationCurrent = chargeCurrent * 0.05f;
+      profile.prechargeVoltage = 2.50f;
+      profile.prechargeCurrent = chargeCurrent * 0.1f;
+      profile.tempCoefficient = 0.0f;
+      profile.minTemperature = 0.0f;
+      profile.maxTemperature = 45.0f;
+      profile.absorbTimeoutMs = 2UL * 3600UL * 1000UL;
+      break;
+    case CHEM_LEAD_ACID:
+      profile.absorbVoltage = 2.45f;
+      profile.floatVoltage = 2.25f;
+      profile.terminationCurrent = chargeCurrent * 0.1f;
+      profile.prechargeVoltage = 0.0f;
+      profile.prechargeCurrent = 0.0f;
+      profile.tempCoefficient = -0.004f;
+      profile.minTemperature = -10.0f;
+      profile.maxTemperature = 50.0f;
+      profile.absorbTimeoutMs = 4UL * 3600UL * 1000UL;
+      profile.maxDurationMs = 0; // Float has no end
+      break;
+    case CHEM_LI_ION:
+    default:
+      profile.absorbVoltage = 4.20f;
+      profile.floatVoltage = 0.0f;
+      profile.terminationCurrent = chargeCurrent * 0.1f;
+      profile.prechargeVoltage = 3.00f;
+      profile.prechargeCurrent = chargeCurrent * 0.1f;
+      profile.tempCoefficient = 0.0f;
+      profile.minTemperature = 0.0f;
+      profile.maxTemperature = 45.0f;
+      profile.absorbTimeoutMs = 2UL * 3600UL * 1000UL;
+      break;
+  }
+  return profile;
+}
+
+XY_SKxxxCharger::XY_SKxxxCharger(XY_SKxxx& device)
+  : _device(device), _intervalMs(250), _useSensor(true), _active(false), _stopRequested(false),
+    _celsius(true), _restoreCutoff(false), _previousCutoff(0.0f), _voltageRaw(0), _currentRaw(0),
+    _taperCount(0), _failureCount(0), _startMah(0), _startMwh(0), _start(0), _stageStart(0), _nextDue(0),
+    _nextTemperature(0), _nextEnergy(0) {
+  memset(&_profile, 0, sizeof(_profile));
+  memset(&_session, 0, sizeof(_session));
+  _session.temperature = NAN;
+}
+
+XY_SKxxxCharger::~XY_SKxxxCharger() {
+  stop();
+#if defined(ESP32)
+  _task.join();
+#endif
+  if (_active) {
+    finish(CHARGE_IDLE);
+  }
+}
+
+void XY_SKxxxCharger::setLoopInterval(uint32_t intervalMs) {
+  if (!_active) {
+    _intervalMs = (intervalMs < 20) ? 20 : intervalMs;
+  }
+}
+
+const char* XY_SKxxxCharger::stateName(ChargeState state) {
+  static const char* const names[] = {"idle", "precharge", "bulk", "absorb", "float", "done", "paused", "fault"};
+  return (state <= CHARGE_FAULT) ? names[state] : "unknown";
+}
+
+float XY_SKxxxCharger::compensatedVoltage(float perCell) const {
+  float compensation = 0.0f;
+  if (!isnan(_session.temperature)) {
+    compensation = _profile.tempCoefficient * (_session.temperature - 25.0f);
+  }
+  return _profile.cells * (perCell + compensation);
+}
+
+bool XY_SKxxxCharger::applySetpoint(float voltage, float current) {
+  // Same truncation as setVoltage()/setCurrent(), only what changed is written
+  const xy_sk::ModelInfo& model = _device.getModelInfo();
+  uint16_t voltageRaw = (uint16_t)(voltage * model.voltageScale);
+  uint16_t currentRaw = (uint16_t)(current * model.currentScale);
+  _session.targetVoltage = voltage;
+
+  bool success = true;
+  if (voltageRaw != _voltageRaw) {
+    if (_device.setVoltage(voltage)) {
+      _voltageRaw = voltageRaw;
+    } else {
+      success = false;
+    }
+  }
+  if (currentRaw != _currentRaw) {
+    if (_device.setCurrent(current)) {
+      _currentRaw = currentRaw;
+    } else {
+      success = false;
+    }
+  }
+  if (!success) {
+    _session.writeFailures++;
+  }
+  return success;
+}
+
+void XY_SKxxxCharger::enterState(ChargeState state, unsigned long now) {
+  _session.state = state;
+  _stageStart = now;
+  _taperCount = 0;
+}
+
+bool XY_SKxxxCharger::start(const ChargeProfile& profile) {
+  const xy_sk::ModelInfo& model = _device.getModelInfo();
+  if (_active || profile.cells == 0 || profile.chargeCurrent <= 0.0f ||
+      profile.chargeCurrent > model.maxCurrent || profile.absorbVoltage <= 0.0f) {
+    return false;
+  }
+  _profile = profile;
+
+  memset(&_session, 0, sizeof(_session));
+  _session.temperature = NAN;
+  _celsius = true;
+  if (_useSensor) {
+    _device.getTemperatureUnit(_celsius);
+    readTemperature();
+  }
+  // The compensated target must stay within the model even at the coldest
+  float coldest = _profile.cells * (_profile.absorbVoltage +
+                  _profile.tempCoefficient * (_profile.minTemperature - 25.0f));
+  if (compensatedVoltage(_profile.absorbVoltage) > model.maxVoltage || coldest > model.maxVoltage) {
+    return false;
+  }
+
+  if (!_device.updateOutputStatus(true)) {
+    return false;
+  }
+
+  // REG_BTF terminates in hardware if the firmware loop stops running
+  _restoreCutoff = false;
+  if (_device.hasFeature(xy_sk::FEATURE_BATTERY_CUTOFF) && _device.getBatteryCutoffCurrent(_previousCutoff)) {
+    float cutoff = (_profile.floatVoltage > 0.0f) ? 0.0f : _profile.terminationCurrent;
+    _restoreCutoff = _device.setBatteryCutoffCurrent(cutoff);
+  }
+
+  unsigned long now = millis();
+  _start = now;
+  _voltageRaw = 0xFFFF;
+  _currentRaw = 0xFFFF;
+  _failureCount = 0;
+
+  float battery = _device.getStatusSnapshot().outputVoltage;
+  bool precharge = _profile.prechargeVoltage > 0.0f && battery < _profile.cells * _profile.prechargeVoltage;
+  enterState(precharge ? CHARGE_PRECHARGE : CHARGE_BULK, now);
+  if (!applySetpoint(compensatedVoltage(_profile.absorbVoltage),
+                     precharge ? _profile.prechargeCurrent : _profile.chargeCurrent) ||
+      !_device.setOutputState(true)) {
+    finish(CHARGE_FAULT);
+    return false;
+  }
+
+  // Session capacity is the meter increase after the output came on
+  readEnergy();
+  _startMah = _device.getStatusSnapshot().ampHours;
+  _startMwh = _device.getStatusSnapshot().wattHours;
+  _session.chargedMah = 0;
+  _session.chargedMwh = 0;
+
+  _nextDue = now;
+  _nextTemperature = now + CHARGER_TEMPERATURE_INTERVAL;
+  _nextEnergy = now + CHARGER_ENERGY_INTERVAL;
+  _stopRequested = false;
+  _active = true;
+  return true;
+}
+
+void XY_SKxxxCharger::stop() {
+  if (_active) {
+    _stopRequested = true;
+  }
+}
+
+bool XY_SKxxxCharger::update() {
+  if (!_active) {
+    return false;
+  }
+  if (_stopRequested) {
+    finish(CHARGE_IDLE);
+    return false;
+  }
+
+  unsigned long now = millis();
+  if ((long)(now - _nextDue) < 0) {
+    return true;
+  }
+  iterate(now);
+
+  _nextDue += _intervalMs;
+  if ((long)(now - _nextDue) >= 0) {
+    _nextDue = now + _intervalMs;
+  }
+  return _active;
+}
+
+void XY_SKxxxCharger::readTemperature() {
+  if (!_useSensor || !_device.updateTemperatures(true)) {
+    return;
+  }
+  float temperature = _device.getStatusSnapshot().externalTemp;
+  _session.temperature = _celsius ? temperature : (temperature - 32.0f) * 5.0f / 9.0f;
+}
+
+void XY_SKxxxCharger::readEnergy() {
+  if (!_device.updateEnergyMeters(true)) {
+    return;
+  }
+  const DeviceStatus& status = _device.getStatusSnapshot();
+  // The meters restart with the output, never report a negative session
+  _session.chargedMah = (status.ampHours >= _startMah) ? status.ampHours - _startMah : status.ampHours;
+  _session.chargedMwh = (status.wattHours >= _startMwh) ? status.wattHours - _startMwh : status.wattHours;
+}
+
+void XY_SKxxxCharger::iterate(unsigned long now) {
+  _session.elapsedMs = now - _start;
+  _session.stageMs = now - _stageStart;
+
+  if (!_device.updateOutputStatus(true)) {
+    _session.readFailures++;
+    if (++_failureCount >= CHARGER_MAX_READ_FAILURES) {
+      finish(CHARGE_FAULT);
+    }
+    return;
+  }
+  _failureCount = 0;
+  _session.iterations++;
+  _session.loopRate = (_session.elapsedMs > 0) ? _session.iterations * 1000.0f / _session.elapsedMs : 0.0f;
+
+  const DeviceStatus& status = _device.getStatusSnapshot();
+  _session.voltage = status.outputVoltage;
+  _session.current = status.outputCurrent;
+
+  if ((long)(now - _nextTemperature) >= 0) {
+    readTemperature();
+    _nextTemperature = now + CHARGER_TEMPERATURE_INTERVAL;
+  }
+  if ((long)(now - _nextEnergy) >= 0) {
+    readEnergy();
+    _nextEnergy = now + CHARGER_ENERGY_INTERVAL;
+  }
+
+  if (_profile.maxDurationMs != 0 && _session.elapsedMs > _profile.maxDurationMs) {
+    finish(CHARGE_FAULT);
+    return;
+  }
+
+  // Temperature window, with hysteresis on the way back
+  if (!isnan(_session.temperature)) {
+    float t = _session.temperature;
+    if (_session.state == CHARGE_PAUSED) {
+      if (t > _profile.minTemperature + CHARGER_TEMPERATURE_HYSTERESIS &&
+          t < _profile.maxTemperature - CHARGER_TEMPERATURE_HYSTERESIS) {
+        // Resume in bulk; the voltage check below moves on to absorb if needed
+        enterState(CHARGE_BULK, now);
+        if (!applySetpoint(compensatedVoltage(_profile.absorbVoltage), _profile.chargeCurrent) ||
+            !_device.setOutputState(true)) {
+          finish(CHARGE_FAULT);
+        }
+      }
+      return;
+    }
+    if (t < _profile.minTemperature || t > _profile.maxTemperature) {
+      _device.setOutputState(false);
+      enterState(CHARGE_PAUSED, now);
+      return;
+    }
+  } else if (_session.state == CHARGE_PAUSED) {
+    return;
+  }
+
+  float absorbTarget = compensatedVoltage(_profile.absorbVoltage);
+  if (_session.voltage > absorbTarget * (1.0f + CHARGER_OVERVOLTAGE_MARGIN)) {
+    finish(CHARGE_FAULT);
+    return;
+  }
+
+  switch (_session.state) {
+    case CHARGE_PRECHARGE:
+      if (_session.voltage >= _profile.cells * _profile.prechargeVoltage) {
+        enterState(CHARGE_BULK, now);
+      }
+      applySetpoint(absorbTarget, (_session.state == CHARGE_PRECHARGE) ? _profile.prechargeCurrent
+                                                                         : _profile.chargeCurrent);
+      break;
+
+    case CHARGE_BULK:
+      // The supply leaves CC once the battery reaches the CV target
+      if (_session.voltage >= absorbTarget * 0.995f) {
+        enterState(CHARGE_ABSORB, now);
+      }
+      applySetpoint(absorbTarget, _profile.chargeCurrent);
+      break;
+
+    case CHARGE_ABSORB: {
+      _taperCount = (_session.current <= _profile.terminationCurrent) ? _taperCount + 1 : 0;
+      bool timedOut = _profile.absorbTimeoutMs != 0 && _session.stageMs > _profile.absorbTimeoutMs;
+      if (_taperCount >= CHARGER_TAPER_SAMPLES || timedOut) {
+        if (_profile.floatVoltage > 0.0f) {
+          enterState(CHARGE_FLOAT, now);
+          applySetpoint(compensatedVoltage(_profile.floatVoltage), _profile.chargeCurrent);
+        } else {
+          finish(CHARGE_DONE);
+        }
+        return;
+      }
+      applySetpoint(absorbTarget, _profile.chargeCurrent);
+      break;
+    }
+
+    case CHARGE_FLOAT:
+      applySetpoint(compensatedVoltage(_profile.floatVoltage), _profile.chargeCurrent);
+      break;
+
+    default:
+      break;
+  }
+}
+
+void XY_SKxxxCharger::finish(ChargeState state) {
+  _device.setOutputState(false);
+  readEnergy();
+  if (_restoreCutoff) {
+    _device.setBatteryCutoffCurrent(_previousCutoff);
+    _restoreCutoff = false;
+  }
+  _session.state = state;
+  _session.elapsedMs = millis() - _start;
+  _stopRequested = false;
+  _active = false;
+}
+
+#if defined(ESP32)
+bool XY_SKxxxCharger::startTask(const ChargeProfile& profile, UBaseType_t priority, BaseType_t core) {
+  if (_task.isRunning() || !start(profile)) {
+    return false;
+  }
+
+  if (!_task.start("xy_charger", taskTurn, this, priority, core)) {
+    finish(CHARGE_IDLE);
+    return false;
+  }
+  return true;
+}
+
+bool XY_SKxxxCharger::taskTurn(void* context, uint32_t& sleepMs) {
+  XY_SKxxxCharger* charger = static_cast<XY_SKxxxCharger*>(context);
+  if (!charger->update()) {
+    return false;
+  }
+  sleepMs = xy_sk::HelperTask::msUntil(charger->_nextDue);
+  return true;
+}
+#endif
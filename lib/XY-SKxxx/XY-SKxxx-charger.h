@@ -0,0 +1,166 @@
+#ifndef XY_SKXXX_CHARGER_H
+#define XY_SKXXX_CHARGER_H
+
+#include <Arduino.h>
+#include "XY-SKxxx.h"
+#include "XY-SKxxx-task.h"
+
+enum BatteryChemistry {
+  CHEM_LI_ION = 0,     // CC-CV to 4.20 V/cell, taper termination, no float
+  CHEM_LIFEPO4 = 1,    // CC-CV to 3.60 V/cell, taper termination, no float
+  CHEM_LEAD_ACID = 2   // Bulk, absorb at 2.45 V/cell, float at 2.25 V/cell
+};
+
+// Charge parameters, voltages are per cell at 25 °C
+struct ChargeProfile {
+  BatteryChemistry chemistry;
+  uint8_t cells;
+  float chargeCurrent;          // Bulk (CC) current (A)
+  float absorbVoltage;          // CV target (V/cell)
+  float floatVoltage;           // Float target (V/cell), 0 ends the charge after absorb
+  float terminationCurrent;     // Absorb ends when the current tapers below this (A)
+  float prechargeVoltage;       // Below this the battery is charged at prechargeCurrent (V/cell), 0 disables
+  float prechargeCurrent;       // (A)
+  float tempCoefficient;        // Compensation (V/°C/cell), negative for lead-acid
+  float minTemperature;         // Charging pauses outside this range (°C)
+  float maxTemperature;
+  uint32_t absorbTimeoutMs;     // Longest absorb stage, 0 for no limit
+  uint32_t maxDurationMs;       // Safety timer for the whole session, 0 for no limit
+};
+
+/**
+ * Default profile for a chemistry, cell count and bulk current
+ */
+ChargeProfile chargeProfileFor(BatteryChemistry chemistry, uint8_t cells, float chargeCurrent);
+
+enum ChargeState {
+  CHARGE_IDLE = 0,
+  CHARGE_PRECHARGE = 1,  // Deeply discharged, reduced current
+  CHARGE_BULK = 2,       // Constant current
+  CHARGE_ABSORB = 3,     // Constant voltage, current tapering
+  CHARGE_FLOAT = 4,      // Held at the float voltage until stop()
+  CHARGE_DONE = 5,       // Terminated, output off
+  CHARGE_PAUSED = 6,     // Battery temperature out of range, output off
+  CHARGE_FAULT = 7       // Communication loss, over-voltage or safety timer, output off
+};
+
+struct ChargeSession {
+  ChargeState state;
+  float voltage;              // Battery voltage (V)
+  float current;              // Charge current (A)
+  float temperature;          // External sensor (°C), NAN without a sensor
+  float targetVoltage;        // Compensated V_SET in use (V)
+  uint32_t chargedMah;        // Device amp-hour meter since start()
+  uint32_t chargedMwh;        // Device watt-hour meter since start()
+  uint32_t elapsedMs;
+  uint32_t stageMs;           // Time in the present state
+  uint32_t iterations;
+  uint32_t readFailures;
+  uint32_t writeFailures;
+  float loopRate;             // Achieved iterations per second
+};
+
+/**
+ * Multi-stage battery charger
+ *
+ * Drives precharge, bulk (CC), absorb (CV with taper detection) and either
+ * float or termination from a profile. Every loop interval the output
+ * block (VOUT, IOUT, POWER, UIN) is refreshed into the status snapshot and
+ * the stage logic runs on it; temperatures and the energy meters are read
+ * on slower intervals. V_SET is written only when the temperature
+ * compensated target changes at register resolution. REG_BTF is set to the
+ * termination current as a hardware backstop for profiles without float
+ * and restored when the session ends.
+ *
+ * The loop does not depend on the web interface: update() is called from
+ * loop(), or on ESP32 startTask() runs it in its own FreeRTOS task. The
+ * output is switched off on termination, fault and temperature pause.
+ */
+class XY_SKxxxCharger {
+public:
+  explicit XY_SKxxxCharger(XY_SKxxx& device);
+  ~XY_SKxxxCharger();
+  XY_SKxxxCharger(const XY_SKxxxCharger&) = delete;
+  XY_SKxxxCharger& operator=(const XY_SKxxxCharger&) = delete;
+
+  /**
+   * Time between control iterations (default 250 ms, minimum 20 ms)
+   */
+  void setLoopInterval(uint32_t intervalMs);
+  uint32_t getLoopInterval() const { return _intervalMs; }
+
+  /**
+   * Use REG_T_EX for compensation and temperature limits (default on)
+   */
+  void setTemperatureSensor(bool enabled) { if (!isRunning()) _useSensor = enabled; }
+
+  /**
+   * Check the profile against the model limits, set the first stage and
+   * turn the output on
+   */
+  bool start(const ChargeProfile& profile);
+
+  /**
+   * End the session: output off, REG_BTF restored
+   */
+  void stop();
+
+  /**
+   * Run the iteration that is due, if any
+   *
+   * @return true while the session is active (including float and pause)
+   */
+  bool update();
+
+#if defined(ESP32)
+  bool startTask(const ChargeProfile& profile, UBaseType_t priority = 2, BaseType_t core = -1);
+  bool isTaskRunning() const { return _task.isRunning(); }
+#endif
+
+  bool isRunning() const { return _active; }
+  ChargeState getState() const { return _session.state; }
+  const ChargeProfile& getProfile() const { return _profile; }
+  const ChargeSession& getSession() const { return _session; }
+  static const char* stateName(ChargeState state);
+
+private:
+  void iterate(unsigned long now);
+  void readTemperature();
+  void readEnergy();
+  float compensatedVoltage(float perCell) const;
+  bool applySetpoint(float voltage, float current);
+  void enterState(ChargeState state, unsigned long now);
+  void finish(ChargeState state);
+
+#if defined(ESP32)
+  static bool taskTurn(void* context, uint32_t& sleepMs);
+  xy_sk::HelperTask _task;
+#endif
+
+  XY_SKxxx& _device;
+  ChargeProfile _profile;
+  uint32_t _intervalMs;
+  bool _useSensor;
+
+  // Run state
+  volatile bool _active;
+  volatile bool _stopRequested;
+  bool _celsius;
+  bool _restoreCutoff;
+  float _previousCutoff;
+  uint16_t _voltageRaw;      // V_SET / I_SET last written
+  uint16_t _currentRaw;
+  uint8_t _taperCount;       // Consecutive samples below the termination current
+  uint8_t _failureCount;     // Consecutive read failures
+  uint32_t _startMah;
+  uint32_t _startMwh;
+  unsigned long _start;
+  unsigned long _stageStart;
+  unsigned long _nextDue;
+  unsigned long _nextTemperature;
+  unsigned long _nextEnergy;
+
+  ChargeSession _session;
+};
+
+#endif // XY_SKXXX_CHARGER_H
@@ -0,0 +1,230 @@
+#include "XY-SKxxx-internal.h"
+#include "XY-SKxxx-derating.h"
+
+XY_SKxxxDerating::XY_SKxxxDerating(XY_SKxxx& device, DeratingTarget target, DeratingSensor sensor)
+  : _device(device), _target(target), _sensor(sensor), _points(0), _hysteresis(2.0f), _recoveryStep(0.05f),
+    _intervalMs(1000), _running(false), _stopRequested(false), _celsius(true), _nominal(0.0f), _raw(0),
+    _haveEffective(false), _start(0), _nextDue(0), _lastIteration(0) {
+  memset(&_stats, 0, sizeof(_stats));
+  // 100 % up to 60 °C, 30 % at 80 °C
+  setLinearCurve(60.0f, 80.0f, 0.3f);
+}
+
+XY_SKxxxDerating::~XY_SKxxxDerating() {
+  stop();
+#if defined(ESP32)
+  _task.join();
+#endif
+  if (_running) {
+    finish();
+  }
+}
+
+bool XY_SKxxxDerating::setLinearCurve(float startTemp, float endTemp, float minFactor) {
+  if (_running || endTemp <= startTemp || minFactor < 0.0f || minFactor > 1.0f) {
+    return false;
+  }
+  clearCurve();
+  addCurvePoint(startTemp, 1.0f);
+  addCurvePoint(endTemp, minFactor);
+  return true;
+}
+
+void XY_SKxxxDerating::clearCurve() {
+  if (!_running) {
+    _points = 0;
+  }
+}
+
+bool XY_SKxxxDerating::addCurvePoint(float temperature, float factor) {
+  if (_running || _points >= DERATING_MAX_POINTS || factor < 0.0f || factor > 1.0f ||
+      (_points > 0 && temperature <= _curveTemp[_points - 1])) {
+    return false;
+  }
+  _curveTemp[_points] = temperature;
+  _curveFactor[_points] = factor;
+  _points++;
+  return true;
+}
+
+float XY_SKxxxDerating::factorAt(float temperature) const {
+  if (_points == 0 || temperature <= _curveTemp[0]) {
+    // Below the curve the setpoint is not derated
+    return (_points == 0) ? 1.0f : _curveFactor[0];
+  }
+  for (uint8_t i = 1; i < _points; i++) {
+    if (temperature <= _curveTemp[i]) {
+      float span = (temperature - _curveTemp[i - 1]) / (_curveTemp[i] - _curveTemp[i - 1]);
+      return _curveFactor[i - 1] + span * (_curveFactor[i] - _curveFactor[i - 1]);
+    }
+  }
+  return _curveFactor[_points - 1];
+}
+
+bool XY_SKxxxDerating::start() {
+  if (_running || _points == 0) {
+    return false;
+  }
+  if (_target == DERATE_POWER && !_device.hasFeature(xy_sk::FEATURE_CONSTANT_POWER)) {
+    return false;
+  }
+
+  uint16_t raw;
+  if (!_device.readRegister((_target == DERATE_CURRENT) ? REG_I_SET : REG_CP_SET, raw)) {
+    return false;
+  }
+  _raw = raw;
+  _nominal = (_target == DERATE_CURRENT) ? raw / (float)_device.getModelInfo().currentScale : raw / 10.0f;
+  _celsius = true;
+  _device.getTemperatureUnit(_celsius);
+
+  memset(&_stats, 0, sizeof(_stats));
+  _stats.factor = 1.0f;
+  _stats.minFactor = 1.0f;
+  _stats.setpoint = _nominal;
+  _haveEffective = false;
+  _stopRequested = false;
+  _start = millis();
+  _lastIteration = _start;
+  _nextDue = _start;
+  _running = true;
+  return true;
+}
+
+bool XY_SKxxxDerating::setNominal(float value) {
+  if (value < 0.0f) {
+    return false;
+  }
+  _nominal = value;
+  if (!_running) {
+    return true;
+  }
+  return writeSetpoint(_nominal * _stats.factor);
+}
+
+void XY_SKxxxDerating::stop() {
+  if (_running) {
+    _stopRequested = true;
+  }
+}
+
+bool XY_SKxxxDerating::update() {
+  if (!_running) {
+    return false;
+  }
+  if (_stopRequested) {
+    finish();
+    return false;
+  }
+
+  unsigned long now = millis();
+  if ((long)(now - _nextDue) < 0) {
+    return true;
+  }
+  iterate(now);
+  _nextDue = now + _intervalMs;
+  return true;
+}
+
+bool XY_SKxxxDerating::readTemperature(float& temperature) {
+  // Both sensors in one block read
+  if (!_device.updateTemperatures(true)) {
+    return false;
+  }
+  const DeviceStatus& status = _device.getStatusSnapshot();
+  float value = (_sensor == DERATE_INTERNAL) ? status.internalTemp
+              : (_sensor == DERATE_EXTERNAL) ? status.externalTemp
+              : fmaxf(status.internalTemp, status.externalTemp);
+  temperature = _celsius ? value : (value - 32.0f) * 5.0f / 9.0f;
+  return true;
+}
+
+bool XY_SKxxxDerating::writeSetpoint(float value) {
+  // Same truncation as setCurrent()/setConstantPower(), unchanged values are not written
+  uint16_t raw = (_target == DERATE_CURRENT) ? (uint16_t)(value * _device.getModelInfo().currentScale)
+                                             : (uint16_t)(value * 10);
+  if (raw == _raw) {
+    return true;
+  }
+  bool success = (_target == DERATE_CURRENT) ? _device.setCurrent(value) : _device.setConstantPower(value);
+  if (!success) {
+    _stats.writeFailures++;
+    return false;
+  }
+  _raw = raw;
+  _stats.writes++;
+  _stats.setpoint = value;
+  return true;
+}
+
+void XY_SKxxxDerating::iterate(unsigned long now) {
+  // Time at the previous factor counts towards throttling
+  if (_stats.factor < 1.0f) {
+    _stats.throttledMs += now - _lastIteration;
+  }
+  _lastIteration = now;
+  _stats.elapsedMs = now - _start;
+
+  float temperature;
+  if (!readTemperature(temperature)) {
+    _stats.readFailures++;
+    return;
+  }
+  _stats.iterations++;
+  _stats.temperature = temperature;
+  if (_stats.iterations == 1 || temperature > _stats.peakTemperature) {
+    _stats.peakTemperature = temperature;
+  }
+
+  // Follow rises at once, falls only once they exceed the hysteresis
+  if (!_haveEffective || temperature > _stats.effectiveTemperature) {
+    _stats.effectiveTemperature = temperature;
+    _haveEffective = true;
+  } else if (temperature < _stats.effectiveTemperature - _hysteresis) {
+    _stats.effectiveTemperature = temperature + _hysteresis;
+  }
+
+  float factor = factorAt(_stats.effectiveTemperature);
+  if (factor > _stats.factor + _recoveryStep) {
+    factor = _stats.factor + _recoveryStep;
+  }
+  if (_stats.factor >= 1.0f && factor < 1.0f) {
+    _stats.throttleEvents++;
+  }
+  _stats.factor = factor;
+  if (factor < _stats.minFactor) {
+    _stats.minFactor = factor;
+  }
+
+  writeSetpoint(_nominal * factor);
+}
+
+void XY_SKxxxDerating::finish() {
+  unsigned long now = millis();
+  if (_stats.factor < 1.0f) {
+    _stats.throttledMs += now - _lastIteration;
+  }
+  _stats.elapsedMs = now - _start;
+  _stats.factor = 1.0f;
+  writeSetpoint(_nominal);
+  _stopRequested = false;
+  _running = false;
+}
+
+#if defined(ESP32)
+bool XY_SKxxxDerating::startTask(UBaseType_t priority, BaseType_t core) {
+  if (_task.isRunning() || !start()) {
+    return false;
+  }
+
+  if (!_task.start("xy_derating", taskTurn, this, priority, core)) {
+    finish();
+    return false;
+  }
+  return true;
+}
+
+bool XY_SKxxxDerating::taskTurn(void* context, uint32_t& /*sleepMs*/) {
+  return static_cast<XY_SKxxxDerating*>(context)->update();
+}
+#endif
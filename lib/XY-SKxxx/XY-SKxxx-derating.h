@@ -0,0 +1,165 @@
+#ifndef XY_SKXXX_DERATING_H
+#define XY_SKXXX_DERATING_H
+
+#include <Arduino.h>
+#include "XY-SKxxx.h"
+#include "XY-SKxxx-task.h"
+
+#define DERATING_MAX_POINTS 8
+
+// Temperature the curve is applied to
+enum DeratingSensor {
+  DERATE_INTERNAL = 0,  // REG_T_IN
+  DERATE_EXTERNAL = 1,  // REG_T_EX
+  DERATE_HOTTEST = 2    // Higher of the two
+};
+
+// Setpoint that is scaled down
+enum DeratingTarget {
+  DERATE_CURRENT = 0,   // REG_I_SET
+  DERATE_POWER = 1      // REG_CP_SET, for soak tests in CP mode
+};
+
+struct DeratingStats {
+  float temperature;        // Last reading of the selected sensor (°C)
+  float effectiveTemperature; // Temperature the curve was applied to, after hysteresis
+  float peakTemperature;
+  float factor;             // Applied fraction of the nominal setpoint
+  float minFactor;          // Lowest factor applied since start()
+  float setpoint;           // Setpoint last written (A or W)
+  uint32_t throttledMs;     // Total time spent below the nominal setpoint
+  uint32_t throttleEvents;  // Times derating started from the full setpoint
+  uint32_t elapsedMs;
+  uint32_t iterations;
+  uint32_t writes;
+  uint32_t readFailures;
+  uint32_t writeFailures;
+};
+
+/**
+ * Temperature derating
+ *
+ * Scales I_SET (or the CP setpoint) down as the internal or external
+ * temperature approaches a limit, so long soak tests keep running at
+ * reduced power instead of hitting the hard OTP cutoff. The curve is a
+ * piecewise linear table of temperature to fraction of the nominal
+ * setpoint. On the way down the temperature has to fall by the hysteresis
+ * before the setpoint is raised again, and recovery is rate limited, so
+ * the output does not hunt around a curve point.
+ *
+ * Temperatures move slowly: the default loop reads both sensors in one
+ * block once a second from update() (or, on ESP32, its own task). The
+ * setpoint is written only when it changes at register resolution and the
+ * nominal setpoint is restored by stop().
+ */
+class XY_SKxxxDerating {
+public:
+  explicit XY_SKxxxDerating(XY_SKxxx& device, DeratingTarget target = DERATE_CURRENT,
+                            DeratingSensor sensor = DERATE_HOTTEST);
+  ~XY_SKxxxDerating();
+  XY_SKxxxDerating(const XY_SKxxxDerating&) = delete;
+  XY_SKxxxDerating& operator=(const XY_SKxxxDerating&) = delete;
+
+  // Configuration, ignored while running
+  void setTarget(DeratingTarget target) { if (!_running) _target = target; }
+  DeratingTarget getTarget() const { return _target; }
+  void setSensor(DeratingSensor sensor) { if (!_running) _sensor = sensor; }
+  DeratingSensor getSensor() const { return _sensor; }
+
+  /**
+   * Full setpoint up to startTemp, falling linearly to minFactor at
+   * endTemp and held there above it (°C)
+   */
+  bool setLinearCurve(float startTemp, float endTemp, float minFactor);
+
+  /**
+   * Custom curve: points in rising temperature order, factors 0-1
+   */
+  void clearCurve();
+  bool addCurvePoint(float temperature, float factor);
+  uint8_t getCurveSize() const { return _points; }
+  float factorAt(float temperature) const;
+
+  /**
+   * Temperature drop needed before the setpoint is raised again (default 2 °C)
+   */
+  void setHysteresis(float degrees) { _hysteresis = fabsf(degrees); }
+
+  /**
+   * Largest factor increase per iteration while recovering (default 0.05)
+   */
+  void setRecoveryStep(float step) { _recoveryStep = (step > 0.0f) ? step : 0.05f; }
+
+  /**
+   * Time between temperature reads (default 1000 ms, minimum 100 ms)
+   */
+  void setLoopInterval(uint32_t intervalMs) { if (!_running) _intervalMs = (intervalMs < 100) ? 100 : intervalMs; }
+
+  /**
+   * Start from the present setpoint as the nominal (100 %) value
+   */
+  bool start();
+
+  /**
+   * Change the nominal setpoint while running, the present factor applies
+   */
+  bool setNominal(float value);
+  float getNominal() const { return _nominal; }
+
+  /**
+   * Stop and restore the nominal setpoint
+   */
+  void stop();
+
+  /**
+   * Run the iteration that is due, if any
+   *
+   * @return true while running
+   */
+  bool update();
+
+#if defined(ESP32)
+  bool startTask(UBaseType_t priority = 1, BaseType_t core = -1);
+  bool isTaskRunning() const { return _task.isRunning(); }
+#endif
+
+  bool isRunning() const { return _running; }
+  bool isThrottling() const { return _stats.factor < 1.0f; }
+  const DeratingStats& getStats() const { return _stats; }
+
+private:
+  void iterate(unsigned long now);
+  bool readTemperature(float& temperature);
+  bool writeSetpoint(float value);
+  void finish();
+
+#if defined(ESP32)
+  static bool taskTurn(void* context, uint32_t& sleepMs);
+  xy_sk::HelperTask _task;
+#endif
+
+  XY_SKxxx& _device;
+  DeratingTarget _target;
+  DeratingSensor _sensor;
+  float _curveTemp[DERATING_MAX_POINTS];
+  float _curveFactor[DERATING_MAX_POINTS];
+  uint8_t _points;
+  float _hysteresis;
+  float _recoveryStep;
+  uint32_t _intervalMs;
+
+  // Run state
+  volatile bool _running;
+  volatile bool _stopRequested;
+  bool _celsius;
+  float _nominal;
+  uint16_t _raw;            // Setpoint register value last written
+  bool _haveEffective;
+  unsigned long _start;
+  unsigned long _nextDue;
+  unsigned long _lastIteration;
+
+  DeratingStats _stats;
+};
+
+#endif // XY_SKXXX_DERATING_H
@@ -0,0 +1,143 @@
+#include "XY-SKxxx-discovery.h"
+#include "XY-SKxxx.h"
+
+namespace xy_sk {
+
+namespace {
+
+// Likely settings first: the factory default, then the common rates
+const uint8_t SWEEP_ORDER[DISCOVERY_BAUD_CODES] = {6, 0, 2, 3, 4, 1, 5, 8, 7};
+
+const uint16_t PROBE_REQUEST_BYTES = 8;  // FC03 request frame
+const uint16_t PROBE_REPLY_BYTES = 9;    // FC03 reply with 2 registers
+
+unsigned long characterMicros(unsigned long baudRate, uint16_t characters) {
+    // 11 bits per character, same as RtuMaster
+    return (unsigned long)(((uint64_t)characters * 11UL * 1000000UL) / baudRate);
+}
+
+} // namespace
+
+BusDiscovery::BusDiscovery(RtuBus& bus)
+    : _bus(bus), _firstSlave(1), _lastSlave(247), _baudMask(DISCOVERY_ALL_BAUDS),
+      _turnaroundMicros(10000), _stopAtFirstBaud(false), _progress(nullptr), _progressContext(nullptr),
+      _count(0), _probes(0), _elapsedMs(0) {
+    memset(_results, 0, sizeof(_results));
+}
+
+void BusDiscovery::setSlaveRange(uint8_t first, uint8_t last) {
+    // 0 is the broadcast address and 248-255 are reserved
+    _firstSlave = constrain(first, 1, 247);
+    _lastSlave = constrain(last, _firstSlave, 247);
+}
+
+void BusDiscovery::setProgressCallback(ProgressCallback callback, void* context) {
+    _progress = callback;
+    _progressContext = context;
+}
+
+unsigned long BusDiscovery::estimateDurationMs() const {
+    uint16_t slaves = _lastSlave - _firstSlave + 1;
+    unsigned long total = 0;
+    for (uint8_t code = 0; code < DISCOVERY_BAUD_CODES; code++) {
+        if (!(_baudMask & (1 << code))) {
+            continue;
+        }
+        unsigned long baudRate = XY_SKxxx::baudRateFromCode(code);
+        unsigned long probeMicros = characterMicros(baudRate, PROBE_REQUEST_BYTES) + _turnaroundMicros +
+                                    characterMicros(baudRate, 2);
+        // The bus keeps twice the silent interval between frames
+        unsigned long gapMicros = RtuBus::silentInterval(baudRate) * 2000UL;
+        unsigned long waitedMicros = probeMicros - characterMicros(baudRate, PROBE_REQUEST_BYTES);
+        if (gapMicros > waitedMicros) {
+            probeMicros += gapMicros - waitedMicros;
+        }
+        total += (probeMicros * slaves) / 1000UL;
+    }
+    return total;
+}
+
+uint8_t BusDiscovery::run() {
+    // Nobody else may talk on the bus while it runs at another baud rate
+    _bus.lock();
+    RtuMaster& master = _bus.master();
+    unsigned long originalBaud = _bus.getBaudRate();
+    unsigned long originalTimeout = master.getResponseTimeout();
+    unsigned long originalReplyStart = master.getReplyStartTimeout();
+    bool adaptive = master.adaptiveTimeout().isEnabled();
+
+    // Fixed short windows: the learned timings belong to the original baud rate
+    master.adaptiveTimeout().setEnabled(false);
+
+    _count = 0;
+    _probes = 0;
+    memset(_results, 0, sizeof(_results));
+    unsigned long start = millis();
+
+    for (uint8_t i = 0; i < DISCOVERY_BAUD_CODES; i++) {
+        uint8_t code = SWEEP_ORDER[i];
+        if (!(_baudMask & (1 << code))) {
+            continue;
+        }
+        unsigned long baudRate = XY_SKxxx::baudRateFromCode(code);
+        _bus.setBaudRate(baudRate);
+
+        // Give up once the first reply byte is overdue, allow the full
+        // reply to arrive once it has started
+        unsigned long replyStart = _turnaroundMicros + characterMicros(baudRate, 2);
+        unsigned long replyEnd = replyStart + characterMicros(baudRate, PROBE_REPLY_BYTES);
+        master.setReplyStartTimeout(replyStart);
+        master.setResponseTimeout((replyEnd + 999) / 1000 + 1);
+
+        uint8_t foundBefore = _count;
+        for (uint16_t slave = _firstSlave; slave <= _lastSlave; slave++) {
+            bool found = probe(slave, code, baudRate);
+            if (_progress) {
+                _progress(_progressContext, baudRate, slave, found);
+            }
+        }
+
+        if (_stopAtFirstBaud && _count > foundBefore) {
+            break;
+        }
+    }
+
+    _elapsedMs = millis() - start;
+
+    _bus.setBaudRate(originalBaud);
+    master.setResponseTimeout(originalTimeout);
+    master.setReplyStartTimeout(originalReplyStart);
+    master.adaptiveTimeout().setEnabled(adaptive);
+    _bus.unlock();
+    return _count;
+}
+
+bool BusDiscovery::probe(uint8_t slave, uint8_t baudCode, unsigned long baudRate) {
+    RtuMaster& master = _bus.master();
+    uint16_t regs[2] = {0, 0};
+    RtuRequest request = {slave, RtuFunction::READ_HOLDING_REGISTERS, REG_MODEL, 2, regs, 0, 0, nullptr};
+
+    // Straight to the master: no retries and no per-slave bus statistics
+    // for addresses that are not attached
+    _probes++;
+    RtuStatus status = master.execute(request);
+
+    // An exception reply still proves a slave with this address listens at this rate
+    bool exception = isRtuException(status);
+    if (status != RtuStatus::SUCCESS && !exception) {
+        return false;
+    }
+
+    if (_count < DISCOVERY_MAX_RESULTS) {
+        DiscoveredDevice& device = _results[_count++];
+        device.slave = slave;
+        device.baudCode = baudCode;
+        device.baudRate = baudRate;
+        device.model = exception ? 0 : regs[0];
+        device.version = exception ? 0 : regs[1];
+        device.replyMicros = master.getStats().lastLatencyMicros;
+    }
+    return true;
+}
+
+} // namespace xy_sk
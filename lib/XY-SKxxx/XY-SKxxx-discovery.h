@@ -0,0 +1,98 @@
+#ifndef XY_SKXXX_DISCOVERY_H
+#define XY_SKXXX_DISCOVERY_H
+
+#include <Arduino.h>
+#include "XY-SKxxx-bus.h"
+
+namespace xy_sk {
+
+constexpr uint8_t DISCOVERY_MAX_RESULTS = 16;
+constexpr uint8_t DISCOVERY_BAUD_CODES = 9;      // REG_BAUDRATE_L codes 0-8
+constexpr uint16_t DISCOVERY_ALL_BAUDS = 0x01FF; // One bit per baud code
+
+// A slave that answered the probe
+struct DiscoveredDevice {
+    uint8_t slave;
+    uint8_t baudCode;          // REG_BAUDRATE_L code
+    unsigned long baudRate;
+    uint16_t model;            // REG_MODEL, 0 if the slave answered with an exception
+    uint16_t version;          // REG_VERSION
+    uint32_t replyMicros;      // Request start to end of reply
+};
+
+/**
+ * Slave address and baud rate sweep
+ *
+ * Probes every slave address of the range at every selected baud rate with
+ * one FC03 read of REG_MODEL/REG_VERSION. RTU is half-duplex, so probes to
+ * different addresses cannot overlap on the wire; the sweep is fast because
+ * a probe is abandoned as soon as the first reply byte is overdue (request
+ * frame + turnaround + 2 character times) instead of waiting for a response
+ * timeout. The most common baud rates are swept first.
+ */
+class BusDiscovery {
+public:
+    typedef void (*ProgressCallback)(void* context, unsigned long baudRate, uint8_t slave, bool found);
+
+    explicit BusDiscovery(RtuBus& bus);
+
+    void setSlaveRange(uint8_t first, uint8_t last);
+
+    /**
+     * Select the baud codes to sweep, bit n enables code n (default: all)
+     */
+    void setBaudCodes(uint16_t mask) { _baudMask = mask & DISCOVERY_ALL_BAUDS; }
+
+    /**
+     * Longest time a slave may take to start its reply (default 10 ms)
+     */
+    void setTurnaround(unsigned long turnaroundMicros) { _turnaroundMicros = turnaroundMicros; }
+
+    /**
+     * Stop after the first baud rate at which any device answered
+     */
+    void setStopAtFirstBaud(bool stop) { _stopAtFirstBaud = stop; }
+
+    void setProgressCallback(ProgressCallback callback, void* context);
+
+    /**
+     * Run the sweep; the bus baud rate and timeouts are restored afterwards
+     *
+     * The bus lock is held throughout, other tasks wait for the sweep. The
+     * progress callback runs with the lock held.
+     *
+     * @return Number of devices found
+     */
+    uint8_t run();
+
+    uint8_t getCount() const { return _count; }
+    const DiscoveredDevice& getDevice(uint8_t index) const { return _results[index]; }
+    uint16_t getProbeCount() const { return _probes; }
+    unsigned long getElapsedMs() const { return _elapsedMs; }
+
+    /**
+     * Estimated sweep duration with the current settings when nobody answers
+     */
+    unsigned long estimateDurationMs() const;
+
+private:
+    bool probe(uint8_t slave, uint8_t baudCode, unsigned long baudRate);
+
+    RtuBus& _bus;
+    uint8_t _firstSlave;
+    uint8_t _lastSlave;
+    uint16_t _baudMask;
+    unsigned long _turnaroundMicros;
+    bool _stopAtFirstBaud;
+    ProgressCallback _progress;
+    void* _progressContext;
+
+    DiscoveredDevice _results[DISCOVERY_MAX_RESULTS];
+    uint8_t _count;
+    uint16_t _probes;
+    unsigned long _elapsedMs;
+};
+
+} // namespace xy_sk
+
+#endif // XY_SKXXX_DISCOVERY_H
@@ -0,0 +1,295 @@
+#include "XY-SKxxx-internal.h"
+#include "XY-SKxxx-gang.h"
+
+XY_SKxxxGang::XY_SKxxxGang(GangTopology topology)
+  : _topology(topology), _setVoltage(0.0f), _setCurrent(0.0f),
+    _tolerance(0.10f), _gain(0.02f), _maxTrim(0.03f),
+    _intervalMs(100), _iterationLimit(50), _running(false), _nextDue(0),
+    _iterations(0), _converged(false), _stalled(false) {
+  memset(_trim, 0, sizeof(_trim));
+  memset(&_measurement, 0, sizeof(_measurement));
+}
+
+XY_SKxxxGang::~XY_SKxxxGang() {
+  stop();
+#if defined(ESP32)
+  _task.join();
+#endif
+}
+
+bool XY_SKxxxGang::add(XY_SKxxx& unit) {
+  return _group.add(unit);
+}
+
+void XY_SKxxxGang::setBalancing(float tolerance, float gain, float maxTrim) {
+  _tolerance = tolerance;
+  _gain = gain;
+  _maxTrim = maxTrim;
+}
+
+void XY_SKxxxGang::setBalanceLoop(uint32_t intervalMs, uint16_t iterationLimit) {
+  _intervalMs = intervalMs;
+  _iterationLimit = (iterationLimit > 0) ? iterationLimit : 1;
+}
+
+void XY_SKxxxGang::restartBalancing() {
+  memset(_trim, 0, sizeof(_trim));
+  _iterations = 0;
+  _converged = false;
+  _stalled = false;
+}
+
+float XY_SKxxxGang::unitVoltage() const {
+  uint8_t units = _group.size();
+  if (units == 0) {
+    return 0.0f;
+  }
+  return (_topology == GANG_SERIES) ? _setVoltage / units : _setVoltage;
+}
+
+float XY_SKxxxGang::unitCurrent() const {
+  uint8_t units = _group.size();
+  if (units == 0) {
+    return 0.0f;
+  }
+  return (_topology == GANG_PARALLEL) ? _setCurrent / units : _setCurrent;
+}
+
+bool XY_SKxxxGang::setVoltage(float voltage) {
+  if (_group.size() == 0) {
+    return false;
+  }
+  float previous = _setVoltage;
+  _setVoltage = voltage;
+  float perUnit = unitVoltage();
+  if (!_group.acceptsSetpoint(perUnit, 0.0f)) {
+    _setVoltage = previous;
+    return false;
+  }
+
+  // A new setpoint starts balancing from scratch
+  restartBalancing();
+  uint16_t value = (uint16_t)(perUnit * _group.getDevice(0)->getModelInfo().voltageScale);
+  return _group.writeRegisters(REG_V_SET, 1, &value);
+}
+
+bool XY_SKxxxGang::setCurrent(float current) {
+  if (_group.size() == 0) {
+    return false;
+  }
+  float previous = _setCurrent;
+  _setCurrent = current;
+  float perUnit = unitCurrent();
+  if (!_group.acceptsSetpoint(0.0f, perUnit)) {
+    _setCurrent = previous;
+    return false;
+  }
+
+  // The load split changes with the limit in parallel
+  if (_topology == GANG_PARALLEL) {
+    _iterations = 0;
+    _stalled = false;
+  }
+  uint16_t value = (uint16_t)(perUnit * _group.getDevice(0)->getModelInfo().currentScale);
+  return _group.writeRegisters(REG_I_SET, 1, &value);
+}
+
+bool XY_SKxxxGang::setVoltageAndCurrent(float voltage, float current) {
+  if (_group.size() == 0) {
+    return false;
+  }
+  float previousVoltage = _setVoltage;
+  float previousCurrent = _setCurrent;
+  _setVoltage = voltage;
+  _setCurrent = current;
+
+  if (!_group.acceptsSetpoint(unitVoltage(), unitCurrent())) {
+    _setVoltage = previousVoltage;
+    _setCurrent = previousCurrent;
+    return false;
+  }
+
+  restartBalancing();
+  return _group.setVoltageAndCurrent(unitVoltage(), unitCurrent());
+}
+
+bool XY_SKxxxGang::setOutputState(bool on) {
+  return _group.setOutputState(on);
+}
+
+bool XY_SKxxxGang::update() {
+  uint8_t units = _group.size();
+  GangMeasurement m;
+  memset(&m, 0, sizeof(m));
+  m.units = units;
+  m.valid = (units > 0);
+
+  // One poll cycle: the units are read back to back
+  float power = 0.0f;
+  for (uint8_t i = 0; i < units; i++) {
+    float voltage = 0.0f, current = 0.0f, unitPower = 0.0f, inputVoltage = 0.0f;
+    if (!_group.getDevice(i)->getMeasurements(voltage, current, unitPower, inputVoltage, true)) {
+      m.valid = false;
+    }
+    m.unitVoltage[i] = voltage;
+    m.unitCurrent[i] = current;
+    power += unitPower;
+  }
+
+  float totalVoltage = 0.0f;
+  float totalCurrent = 0.0f;
+  for (uint8_t i = 0; i < units; i++) {
+    totalVoltage += m.unitVoltage[i];
+    totalCurrent += m.unitCurrent[i];
+  }
+
+  if (units > 0) {
+    if (_topology == GANG_SERIES) {
+      m.voltage = totalVoltage;
+      m.current = totalCurrent / units; // Same current flows through every unit
+    } else {
+      m.voltage = totalVoltage / units; // Same voltage on every unit
+      m.current = totalCurrent;
+    }
+  }
+  m.power = power;
+
+  // Shares of the quantity the units split between them
+  float total = (_topology == GANG_SERIES) ? totalVoltage : totalCurrent;
+  for (uint8_t i = 0; i < units; i++) {
+    float quantity = (_topology == GANG_SERIES) ? m.unitVoltage[i] : m.unitCurrent[i];
+    m.unitShare[i] = (total > 0.001f) ? quantity / total : 1.0f / units;
+  }
+
+  m.timestamp = millis();
+  _measurement = m;
+  return m.valid;
+}
+
+bool XY_SKxxxGang::isBalanced() const {
+  uint8_t units = _measurement.units;
+  for (uint8_t i = 0; i < units; i++) {
+    float deviation = _measurement.unitShare[i] * units - 1.0f;
+    if (fabsf(deviation) > _tolerance) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool XY_SKxxxGang::balance() {
+  if (!update()) {
+    return false;
+  }
+
+  uint8_t units = _measurement.units;
+  if (units < 2) {
+    return true;
+  }
+
+  // Without load current there is nothing to share in parallel
+  if (_topology == GANG_PARALLEL && _measurement.current < 0.02f) {
+    return true;
+  }
+
+  float perUnit = unitVoltage();
+  float trimLimit = _maxTrim * perUnit;
+  bool balanced = true;
+
+  for (uint8_t i = 0; i < units; i++) {
+    // Positive: the unit carries more than its fair share
+    float deviation = _measurement.unitShare[i] * units - 1.0f;
+    if (fabsf(deviation) <= _tolerance) {
+      continue;
+    }
+
+    // A unit carrying too much gets a lower voltage setpoint
+    float trim = constrain(_trim[i] - _gain * deviation * perUnit, -trimLimit, trimLimit);
+
+    // Only write when the change is visible at the register resolution,
+    // truncated the same way setVoltage() encodes it
+    XY_SKxxx* unit = _group.getDevice(i);
+    uint16_t scale = (unit != nullptr) ? unit->getModelInfo().voltageScale : 100;
+    if ((uint16_t)((perUnit + trim) * scale) != (uint16_t)((perUnit + _trim[i]) * scale)) {
+      _trim[i] = trim;
+      if (!applyUnitVoltage(i)) {
+        balanced = false;
+        continue;
+      }
+    }
+
+    // Still out of tolerance until the next poll cycle shows otherwise
+    balanced = false;
+  }
+
+  return balanced;
+}
+
+bool XY_SKxxxGang::applyUnitVoltage(uint8_t index) {
+  XY_SKxxx* unit = _group.getDevice(index);
+  if (unit == nullptr) {
+    return false;
+  }
+  return unit->setVoltage(unitVoltage() + _trim[index]);
+}
+
+bool XY_SKxxxGang::start() {
+  if (_running || _group.size() == 0) {
+    return false;
+  }
+  _iterations = 0;
+  _converged = false;
+  _stalled = false;
+  _nextDue = millis();
+  _running = true;
+  return true;
+}
+
+bool XY_SKxxxGang::service() {
+  if (!_running) {
+    return false;
+  }
+  unsigned long now = millis();
+  if ((long)(now - _nextDue) < 0) {
+    return true;
+  }
+  _nextDue = now + _intervalMs;
+
+  // Stalled: keep the measurement fresh, leave the trims alone
+  if (_stalled) {
+    update();
+    return true;
+  }
+
+  bool balanced = balance();
+  if (!_measurement.valid) {
+    return true; // A unit did not answer, not an iteration
+  }
+  _converged = balanced;
+  if (balanced) {
+    _iterations = 0;
+  } else if (++_iterations >= _iterationLimit) {
+    _stalled = true;
+  }
+  return true;
+}
+
+#if defined(ESP32)
+bool XY_SKxxxGang::startTask(UBaseType_t priority, BaseType_t core) {
+  if (_task.isRunning() || !start()) {
+    return false;
+  }
+
+  if (!_task.start("xy_gang", taskTurn, this, priority, core)) {
+    _running = false;
+    return false;
+  }
+  return true;
+}
+
+bool XY_SKxxxGang::taskTurn(void* context, uint32_t& sleepMs) {
+  XY_SKxxxGang* gang = static_cast<XY_SKxxxGang*>(context);
+  sleepMs = gang->_intervalMs;
+  return gang->service();
+}
+#endif
@@ -0,0 +1,158 @@
+#ifndef XY_SKXXX_GANG_H
+#define XY_SKXXX_GANG_H
+
+#include <Arduino.h>
+#include "XY-SKxxx.h"
+#include "XY-SKxxx-group.h"
+#include "XY-SKxxx-task.h"
+
+// How the physical outputs are wired together
+enum GangTopology {
+  GANG_SERIES = 0,   // Outputs stacked: voltages add, the current is shared
+  GANG_PARALLEL = 1  // Outputs paralleled: currents add, the voltage is shared
+};
+
+// Aggregated readings of one poll cycle
+struct GangMeasurement {
+  float voltage;       // Gang output voltage (V)
+  float current;       // Gang output current (A)
+  float power;         // Gang output power (W)
+  float unitVoltage[xy_sk::BUS_MAX_DEVICES];
+  float unitCurrent[xy_sk::BUS_MAX_DEVICES];
+  float unitShare[xy_sk::BUS_MAX_DEVICES]; // Fraction of the shared quantity carried by each unit
+  uint8_t units;
+  bool valid;          // Every unit answered in this cycle
+  unsigned long timestamp;
+};
+
+/**
+ * Several XY-SK supplies presented as one virtual supply
+ *
+ * In series the voltage setpoint is split evenly and every unit gets the
+ * full current limit; in parallel every unit gets the full voltage and an
+ * even share of the current limit. balance() runs one iteration of a
+ * proportional loop on a fresh poll cycle: units carrying more than their
+ * share (voltage in series, current in parallel) get their voltage trimmed
+ * down, units carrying less get it trimmed up, within a bounded range.
+ *
+ * start() and service() (or startTask() on ESP32) run balance() at a fixed
+ * interval. The loop counts the iterations that still found a unit out of
+ * tolerance; when the limit is reached without converging it stops
+ * trimming and only keeps polling, until the next setpoint or start().
+ */
+class XY_SKxxxGang {
+public:
+  explicit XY_SKxxxGang(GangTopology topology);
+  ~XY_SKxxxGang();
+  XY_SKxxxGang(const XY_SKxxxGang&) = delete;
+  XY_SKxxxGang& operator=(const XY_SKxxxGang&) = delete;
+
+  /**
+   * Add a unit, all units must share one bus
+   */
+  bool add(XY_SKxxx& unit);
+  uint8_t size() const { return _group.size(); }
+  GangTopology getTopology() const { return _topology; }
+
+  // Setpoints of the virtual supply
+  bool setVoltage(float voltage);
+  bool setCurrent(float current);
+  bool setVoltageAndCurrent(float voltage, float current);
+  bool setOutputState(bool on);
+  float getSetVoltage() const { return _setVoltage; }
+  float getSetCurrent() const { return _setCurrent; }
+
+  /**
+   * Read V/I/P of every unit back to back and aggregate them
+   *
+   * @return true if every unit answered
+   */
+  bool update();
+  const GangMeasurement& getMeasurement() const { return _measurement; }
+  float getVoltage() const { return _measurement.voltage; }
+  float getCurrent() const { return _measurement.current; }
+  float getPower() const { return _measurement.power; }
+
+  /**
+   * Configure the balancing loop
+   *
+   * @param tolerance Allowed deviation of a unit's share from 1/N (0.05 = 5 %)
+   * @param gain Proportional gain, fraction of the share error applied per iteration
+   * @param maxTrim Largest voltage trim as a fraction of the unit setpoint
+   */
+  void setBalancing(float tolerance, float gain, float maxTrim);
+
+  /**
+   * Poll all units and correct the ones outside the share tolerance
+   *
+   * @return true if all units are within tolerance after this iteration
+   */
+  bool balance();
+
+  /**
+   * Check the share of every unit from the last poll cycle
+   */
+  bool isBalanced() const;
+
+  /**
+   * Configure the balancing driver
+   *
+   * @param intervalMs Time between two iterations (default 100 ms)
+   * @param iterationLimit Iterations out of tolerance before trimming stops (default 50)
+   */
+  void setBalanceLoop(uint32_t intervalMs, uint16_t iterationLimit);
+
+  bool start();
+  void stop() { _running = false; }
+
+  /**
+   * Run one balancing iteration when it is due
+   *
+   * @return true while the driver is running
+   */
+  bool service();
+
+#if defined(ESP32)
+  bool startTask(UBaseType_t priority = 2, BaseType_t core = -1);
+  bool isTaskRunning() const { return _task.isRunning(); }
+#endif
+
+  bool isRunning() const { return _running; }
+  // Every unit within tolerance at the last iteration
+  bool isConverged() const { return _converged; }
+  // Iteration limit reached without converging, trims are frozen
+  bool isStalled() const { return _stalled; }
+  // Iterations out of tolerance since the last convergence, setpoint or start()
+  uint16_t getIterations() const { return _iterations; }
+
+private:
+  float unitVoltage() const;
+  float unitCurrent() const;
+  bool applyUnitVoltage(uint8_t index);
+  void restartBalancing();
+
+#if defined(ESP32)
+  static bool taskTurn(void* context, uint32_t& sleepMs);
+  xy_sk::HelperTask _task;
+#endif
+
+  GangTopology _topology;
+  XY_SKxxxGroup _group;
+  float _setVoltage;
+  float _setCurrent;
+  float _trim[xy_sk::BUS_MAX_DEVICES];    // Per-unit voltage correction (V)
+  float _tolerance;
+  float _gain;
+  float _maxTrim;
+  GangMeasurement _measurement;
+
+  uint32_t _intervalMs;
+  uint16_t _iterationLimit;
+  volatile bool _running;
+  unsigned long _nextDue;
+  uint16_t _iterations;
+  bool _converged;
+  bool _stalled;
+};
+
+#endif // XY_SKXXX_GANG_H
@@ -0,0 +1,188 @@
+#include "XY-SKxxx-internal.h"
+#include "XY-SKxxx-group.h"
+
+XY_SKxxxGroup::XY_SKxxxGroup() : _count(0) {
+  memset(_devices, 0, sizeof(_devices));
+  memset(_succeeded, 0, sizeof(_succeeded));
+  memset(&_lastResult, 0, sizeof(_lastResult));
+}
+
+bool XY_SKxxxGroup::add(XY_SKxxx& device) {
+  if (_count >= xy_sk::BUS_MAX_DEVICES) {
+    return false;
+  }
+  // Group writes are packed on one wire, devices on another bus cannot join
+  if (_count > 0 && &_devices[0]->getBus() != &device.getBus()) {
+    return false;
+  }
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_devices[i] == &device) {
+      return true;
+    }
+  }
+  _devices[_count++] = &device;
+  return true;
+}
+
+void XY_SKxxxGroup::clear() {
+  _count = 0;
+  memset(_devices, 0, sizeof(_devices));
+}
+
+bool XY_SKxxxGroup::acceptsSetpoint(float voltage, float current) const {
+  if (_count == 0 || voltage < 0.0f || current < 0.0f) {
+    return false;
+  }
+  const xy_sk::ModelInfo& first = _devices[0]->getModelInfo();
+  for (uint8_t i = 0; i < _count; i++) {
+    const xy_sk::ModelInfo& model = _devices[i]->getModelInfo();
+    if (voltage > model.maxVoltage || current > model.maxCurrent) {
+      return false; // Same limits as XY_SKxxx::setVoltage / setCurrent
+    }
+    // One register image goes to every device
+    if (model.voltageScale != first.voltageScale || model.currentScale != first.currentScale) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool XY_SKxxxGroup::setVoltageAndCurrent(float voltage, float current, GroupWriteMode mode, bool verify) {
+  if (!acceptsSetpoint(voltage, current)) {
+    return false;
+  }
+  // REG_V_SET and REG_I_SET are adjacent, one FC16 carries both
+  const xy_sk::ModelInfo& model = _devices[0]->getModelInfo();
+  uint16_t values[2] = {(uint16_t)(voltage * model.voltageScale), (uint16_t)(current * model.currentScale)};
+  return writeRegisters(REG_V_SET, 2, values, mode, verify);
+}
+
+bool XY_SKxxxGroup::setOutputState(bool on, GroupWriteMode mode, bool verify) {
+  uint16_t value = on ? 1 : 0;
+  return writeRegisters(REG_ONOFF, 1, &value, mode, verify);
+}
+
+bool XY_SKxxxGroup::writeRegisters(uint16_t addr, uint16_t count, const uint16_t* values,
+                                   GroupWriteMode mode, bool verify) {
+  memset(&_lastResult, 0, sizeof(_lastResult));
+  memset(_succeeded, 0, sizeof(_succeeded));
+  if (_count == 0 || values == nullptr || count == 0 || count > xy_sk::RTU_MAX_WRITE_REGISTERS) {
+    return false;
+  }
+
+  for (uint8_t i = 0; i < _count; i++) {
+    _devices[i]->countWrite(addr, count);
+  }
+  unsigned long startMicros = micros();
+  bool success = (mode == GROUP_BROADCAST) ? writeBroadcast(addr, count, values, verify)
+                                           : writeUnicast(addr, count, values);
+  _lastResult.totalMicros = micros() - startMicros;
+
+  updateDeviceCaches(addr, count, values);
+  return success;
+}
+
+bool XY_SKxxxGroup::writeUnicast(uint16_t addr, uint16_t count, const uint16_t* values) {
+  xy_sk::RtuBus& bus = _devices[0]->getBus();
+  unsigned long firstMicros = 0;
+  unsigned long lastMicros = 0;
+
+  _lastResult.attempted = _count;
+
+  // Fast pass: one FC16 per device back to back, no retries in between and
+  // no other task's frames either
+  bus.lock();
+  for (uint8_t i = 0; i < _count; i++) {
+    xy_sk::RtuRequest request = {_devices[i]->getSlaveID(), xy_sk::RtuFunction::WRITE_MULTIPLE_REGISTERS,
+                                 0, 0, nullptr, addr, count, values};
+    _succeeded[i] = (bus.execute(request) == xy_sk::RtuStatus::SUCCESS);
+    if (_succeeded[i]) {
+      // The slave applied the write before it sent the echo
+      lastMicros = micros();
+      if (firstMicros == 0) {
+        firstMicros = lastMicros;
+      }
+    }
+  }
+  bus.unlock();
+
+  // Second pass for the stragglers, through each device's retry policy
+  for (uint8_t i = 0; i < _count; i++) {
+    if (!_succeeded[i] && _devices[i]->writeRegisters(addr, count, values)) {
+      _succeeded[i] = true;
+      lastMicros = micros();
+      if (firstMicros == 0) {
+        firstMicros = lastMicros;
+      }
+    }
+  }
+
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_succeeded[i]) {
+      _lastResult.succeeded++;
+    }
+  }
+  _lastResult.skewMicros = lastMicros - firstMicros;
+  return _lastResult.succeeded == _count;
+}
+
+bool XY_SKxxxGroup::writeBroadcast(uint16_t addr, uint16_t count, const uint16_t* values, bool verify) {
+  xy_sk::RtuBus& bus = _devices[0]->getBus();
+  xy_sk::RtuRequest request = {xy_sk::RTU_BROADCAST_ADDRESS, xy_sk::RtuFunction::WRITE_MULTIPLE_REGISTERS,
+                               0, 0, nullptr, addr, count, values};
+
+  _lastResult.attempted = _count;
+  _lastResult.skewMicros = 0; // One frame, every slave sees it at the same time
+
+  if (bus.execute(request) != xy_sk::RtuStatus::SUCCESS) {
+    return false;
+  }
+
+  if (!verify) {
+    // Nobody replies to a broadcast, assume it was taken
+    for (uint8_t i = 0; i < _count; i++) {
+      _succeeded[i] = true;
+    }
+    _lastResult.succeeded = _count;
+    return true;
+  }
+
+  // Read the block back; a device that missed the frame gets a unicast write
+  uint16_t readBack[xy_sk::RTU_MAX_READ_REGISTERS];
+  for (uint8_t i = 0; i < _count; i++) {
+    _devices[i]->invalidateShadow(addr, count);
+    bool matches = (count <= xy_sk::RTU_MAX_READ_REGISTERS) &&
+                   _devices[i]->readRegisters(addr, count, readBack) &&
+                   memcmp(readBack, values, count * sizeof(uint16_t)) == 0;
+    _succeeded[i] = matches || _devices[i]->writeRegisters(addr, count, values);
+    if (_succeeded[i]) {
+      _lastResult.succeeded++;
+    }
+  }
+  return _lastResult.succeeded == _count;
+}
+
+void XY_SKxxxGroup::updateDeviceCaches(uint16_t addr, uint16_t count, const uint16_t* values) {
+  for (uint8_t i = 0; i < _count; i++) {
+    if (!_succeeded[i]) {
+      continue;
+    }
+    XY_SKxxx* device = _devices[i];
+    device->storeShadow(addr, count, values);
+    device->invalidateWriteSideEffects(addr, count);
+    const xy_sk::ModelInfo& model = device->getModelInfo();
+    for (uint16_t r = 0; r < count; r++) {
+      switch (addr + r) {
+        case REG_V_SET:
+          device->_status.setVoltage = values[r] / (float)model.voltageScale;
+          break;
+        case REG_I_SET:
+          device->_status.setCurrent = values[r] / (float)model.currentScale;
+          break;
+        case REG_ONOFF:
+          device->_status.outputEnabled = (values[r] != 0);
+          break;
+      }
+    }
+  }
+}
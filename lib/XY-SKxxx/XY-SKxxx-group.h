@@ -0,0 +1,104 @@
+#ifndef XY_SKXXX_GROUP_H
+#define XY_SKXXX_GROUP_H
+
+#include <Arduino.h>
+#include "XY-SKxxx.h"
+
+// How a group write reaches the devices
+enum GroupWriteMode {
+  GROUP_UNICAST = 0,   // Back-to-back FC16 writes, one per device, each confirmed
+  GROUP_BROADCAST = 1  // One FC16 to slave 0: every slave on the wire applies it at once, no reply
+};
+
+// Outcome of the last group write
+struct GroupWriteResult {
+  uint8_t attempted;       // Devices addressed
+  uint8_t succeeded;       // Devices that confirmed (or were verified after a broadcast)
+  uint32_t skewMicros;     // Spread between the first and the last device taking the write
+  uint32_t totalMicros;    // Whole group operation including retries
+};
+
+/**
+ * Several XY-SK supplies on one bus driven as a group
+ *
+ * Writes are packed back to back without the per-command settle delays of
+ * the single-device helpers, so channels change within a few frame times
+ * of each other. Unicast writes that fail on the first pass are repeated
+ * through each device's retry policy afterwards, keeping the fast pass
+ * tight. In broadcast mode a single frame reaches all slaves at the same
+ * instant; note that this includes slaves on the bus that are not in the
+ * group.
+ */
+class XY_SKxxxGroup {
+public:
+  XY_SKxxxGroup();
+
+  /**
+   * Add a device to the group
+   *
+   * @param device Device handle, must share the bus of the devices already added
+   * @return false if the group is full or the device is on another bus
+   */
+  bool add(XY_SKxxx& device);
+  void clear();
+  uint8_t size() const { return _count; }
+  XY_SKxxx* getDevice(uint8_t index) const { return (index < _count) ? _devices[index] : nullptr; }
+
+  /**
+   * Set voltage and current on every device (one FC16 of REG_V_SET/REG_I_SET each)
+   *
+   * @param voltage Voltage setting in V
+   * @param current Current limit in A
+   * @param mode Unicast or broadcast
+   * @param verify After a broadcast, read the settings back to confirm each device
+   * @return true if every device took the setting
+   */
+  bool setVoltageAndCurrent(float voltage, float current, GroupWriteMode mode = GROUP_UNICAST, bool verify = true);
+
+  /**
+   * Check a setpoint against the limits of every device's model
+   *
+   * @return false if a device cannot take it, or the devices scale the
+   *         setpoint registers differently
+   */
+  bool acceptsSetpoint(float voltage, float current) const;
+
+  /**
+   * Switch the output of every device
+   *
+   * @param on true to enable the outputs
+   * @param mode Unicast or broadcast
+   * @param verify After a broadcast, read REG_ONOFF back to confirm each device
+   * @return true if every device switched
+   */
+  bool setOutputState(bool on, GroupWriteMode mode = GROUP_UNICAST, bool verify = true);
+
+  /**
+   * Write the same register block to every device
+   *
+   * @param addr First register
+   * @param count Number of registers
+   * @param values Register values
+   * @param mode Unicast or broadcast
+   * @param verify After a broadcast, read the block back from each device
+   * @return true if every device took the write
+   */
+  bool writeRegisters(uint16_t addr, uint16_t count, const uint16_t* values,
+                      GroupWriteMode mode = GROUP_UNICAST, bool verify = true);
+
+  // Per-device result of the last group write
+  bool deviceSucceeded(uint8_t index) const { return index < _count && _succeeded[index]; }
+  const GroupWriteResult& getLastResult() const { return _lastResult; }
+
+private:
+  bool writeUnicast(uint16_t addr, uint16_t count, const uint16_t* values);
+  bool writeBroadcast(uint16_t addr, uint16_t count, const uint16_t* values, bool verify);
+  void updateDeviceCaches(uint16_t addr, uint16_t count, const uint16_t* values);
+
+  XY_SKxxx* _devices[xy_sk::BUS_MAX_DEVICES];
+  bool _succeeded[xy_sk::BUS_MAX_DEVICES];
+  uint8_t _count;
+  GroupWriteResult _lastResult;
+};
+
+#endif // XY_SKXXX_GROUP_H
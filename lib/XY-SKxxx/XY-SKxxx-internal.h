@@ -6,8 +6,8 @@
 
 // First include Arduino core
 #include <Arduino.h>
-// Then include ModbusMaster explicitly - use quotes instead of angle brackets for better path resolution
-#include "ModbusMaster.h"
+// Then include the RTU master used for all bus traffic
+#include "XY-SKxxx-rtu.h"
 // Finally include our own header
 #include "XY-SKxxx.h"
 
@@ -0,0 +1,235 @@
+#include "XY-SKxxx-internal.h"
+#include "XY-SKxxx-ir.h"
+
+// Reads averaged for the level before the pulse
+#define IR_BASELINE_SAMPLES 4
+// Smallest current change (register counts) a resistance is computed from
+#define IR_MIN_DELTA_COUNTS 20
+
+XY_SKxxxIrTest::XY_SKxxxIrTest(XY_SKxxx& device)
+  : _device(device), _pulseAmps(0.0f), _pulseMs(500), _recoveryMs(500), _capacityMah(0), _startSoc(0.0f),
+    _intervalMs(0), _running(false), _start(0), _nextDue(0), _startMah(0), _logHead(0), _logCount(0) {
+  memset(_log, 0, sizeof(_log));
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+XY_SKxxxIrTest::~XY_SKxxxIrTest() {
+  stop();
+#if defined(ESP32)
+  _task.join();
+#endif
+}
+
+void XY_SKxxxIrTest::setPulse(float amps, uint32_t durationMs, uint32_t recoveryMs) {
+  _pulseAmps = (amps < 0.0f) ? 0.0f : fminf(amps, _device.getModelInfo().maxCurrent);
+  _pulseMs = (durationMs == 0) ? 1 : (durationMs > 5000) ? 5000 : durationMs;
+  _recoveryMs = recoveryMs;
+}
+
+void XY_SKxxxIrTest::setCapacity(uint32_t capacityMah, float startSoc) {
+  _capacityMah = capacityMah;
+  _startSoc = startSoc;
+}
+
+const IrPoint& XY_SKxxxIrTest::getPoint(uint8_t index) const {
+  uint8_t oldest = (_logCount < IR_LOG_SIZE) ? 0 : _logHead;
+  return _log[(oldest + index) % IR_LOG_SIZE];
+}
+
+const IrPoint* XY_SKxxxIrTest::getLastPoint() const {
+  return (_logCount == 0) ? nullptr : &_log[(_logHead + IR_LOG_SIZE - 1) % IR_LOG_SIZE];
+}
+
+bool XY_SKxxxIrTest::start() {
+  if (_running || !_device.updateEnergyMeters(true)) {
+    return false;
+  }
+  _startMah = _device.getStatusSnapshot().ampHours;
+  _logHead = 0;
+  _logCount = 0;
+  memset(&_stats, 0, sizeof(_stats));
+  _start = millis();
+  _nextDue = _start;
+  _running = true;
+  return true;
+}
+
+bool XY_SKxxxIrTest::update() {
+  if (!_running) {
+    return false;
+  }
+  unsigned long now = millis();
+  if ((long)(now - _nextDue) < 0) {
+    return true;
+  }
+  measure();
+  if (_intervalMs == 0) {
+    _running = false;
+    return false;
+  }
+  _nextDue = now + _intervalMs;
+  return true;
+}
+
+bool XY_SKxxxIrTest::sample(float& voltage, float& current) {
+  // VOUT and IOUT in one transaction
+  uint16_t values[2];
+  if (!_device.readRegisters(REG_VOUT, 2, values)) {
+    return false;
+  }
+  const xy_sk::ModelInfo& model = _device.getModelInfo();
+  voltage = values[0] / (float)model.voltageScale;
+  current = values[1] / (float)model.currentScale;
+  return true;
+}
+
+bool XY_SKxxxIrTest::measure() {
+  IrPoint point;
+  memset(&point, 0, sizeof(point));
+  point.timeMs = millis() - _start;
+  point.soc = -1.0f;
+
+  // Capacity first, outside the timed window
+  if (_device.updateEnergyMeters(true)) {
+    uint32_t ampHours = _device.getStatusSnapshot().ampHours;
+    point.chargedMah = (ampHours >= _startMah) ? ampHours - _startMah : ampHours;
+    if (_capacityMah > 0) {
+      point.soc = _startSoc + point.chargedMah * 100.0f / _capacityMah;
+    }
+  }
+
+  // Nothing else may touch the bus (or I_SET) until it is restored
+  xy_sk::RtuBus& bus = _device.getBus();
+  bus.lock();
+  bool success = pulse(point);
+  bus.unlock();
+
+  _stats.measurements++;
+  if (!success) {
+    _stats.failures++;
+  } else if (!point.valid) {
+    _stats.invalid++;
+  }
+  log(point);
+  return success && point.valid;
+}
+
+bool XY_SKxxxIrTest::pulse(IrPoint& point) {
+  // The setpoint to restore, from the device: the shadow may predate a panel change
+  uint16_t baseRaw;
+  if (!_device.readRegistersDirect(REG_I_SET, 1, &baseRaw)) {
+    return false;
+  }
+
+  float voltage;
+  float current;
+  float sumVoltage = 0.0f;
+  float sumCurrent = 0.0f;
+  for (uint8_t i = 0; i < IR_BASELINE_SAMPLES; i++) {
+    if (!sample(voltage, current)) {
+      return false;
+    }
+    sumVoltage += voltage;
+    sumCurrent += current;
+  }
+  point.voltage = sumVoltage / IR_BASELINE_SAMPLES;
+  point.current = sumCurrent / IR_BASELINE_SAMPLES;
+
+  uint16_t scale = _device.getModelInfo().currentScale;
+  uint16_t pulseRaw = (_pulseAmps > 0.0f) ? (uint16_t)(_pulseAmps * scale) : (uint16_t)(point.current * scale / 2);
+  if (point.current * scale < IR_MIN_DELTA_COUNTS || pulseRaw == baseRaw) {
+    // No current flowing (output off, battery full) or nothing to step
+    return true;
+  }
+
+  uint32_t start = micros();
+  if (!_device.writeRegister(REG_I_SET, pulseRaw)) {
+    return false;
+  }
+
+  // Back to back reads for the pulse, the second half is averaged
+  uint32_t window = _pulseMs * 1000UL;
+  uint16_t averaged = 0;
+  float firstVoltage = 0.0f;
+  float firstCurrent = 0.0f;
+  sumVoltage = 0.0f;
+  sumCurrent = 0.0f;
+  uint32_t elapsed;
+  while ((elapsed = micros() - start) < window) {
+    if (!sample(voltage, current)) {
+      continue;
+    }
+    elapsed = micros() - start;
+    if (point.samples++ == 0) {
+      firstVoltage = voltage;
+      firstCurrent = current;
+      point.latencyMicros = elapsed;
+    }
+    if (elapsed >= window / 2) {
+      sumVoltage += voltage;
+      sumCurrent += current;
+      averaged++;
+    }
+  }
+
+  // Restore before anything else, even if the pulse reads failed; the
+  // retry policy already retries the write
+  if (!_device.writeRegister(REG_I_SET, baseRaw)) {
+    return false;
+  }
+
+  start = micros();
+  point.recoveryVoltage = point.voltage;
+  while (micros() - start < _recoveryMs * 1000UL) {
+    if (sample(voltage, current)) {
+      point.recoveryVoltage = voltage;
+    }
+  }
+
+  if (averaged == 0) {
+    return false;
+  }
+  point.pulseVoltage = sumVoltage / averaged;
+  point.pulseCurrent = sumCurrent / averaged;
+  if (point.latencyMicros > _stats.maxLatencyMicros) {
+    _stats.maxLatencyMicros = point.latencyMicros;
+  }
+
+  float minDelta = IR_MIN_DELTA_COUNTS / (float)scale;
+  float deltaCurrent = point.current - point.pulseCurrent;
+  if (fabsf(deltaCurrent) < minDelta) {
+    return true;
+  }
+  point.resistance = (point.voltage - point.pulseVoltage) / deltaCurrent;
+  if (fabsf(point.current - firstCurrent) >= minDelta) {
+    point.ohmicResistance = (point.voltage - firstVoltage) / (point.current - firstCurrent);
+  }
+  point.valid = point.resistance > 0.0f;
+  return true;
+}
+
+void XY_SKxxxIrTest::log(const IrPoint& point) {
+  _log[_logHead] = point;
+  _logHead = (_logHead + 1) % IR_LOG_SIZE;
+  if (_logCount < IR_LOG_SIZE) {
+    _logCount++;
+  }
+}
+
+#if defined(ESP32)
+bool XY_SKxxxIrTest::startTask(UBaseType_t priority, BaseType_t core) {
+  if (_task.isRunning() || !start()) {
+    return false;
+  }
+
+  if (!_task.start("xy_ir", taskTurn, this, priority, core)) {
+    _running = false;
+    return false;
+  }
+  return true;
+}
+
+bool XY_SKxxxIrTest::taskTurn(void* context, uint32_t& /*sleepMs*/) {
+  return static_cast<XY_SKxxxIrTest*>(context)->update();
+}
+#endif
@@ -0,0 +1,132 @@
+#ifndef XY_SKXXX_IR_H
+#define XY_SKXXX_IR_H
+
+#include <Arduino.h>
+#include "XY-SKxxx.h"
+#include "XY-SKxxx-task.h"
+
+#define IR_LOG_SIZE 96
+
+struct IrPoint {
+  uint32_t timeMs;          // Since start()
+  uint32_t chargedMah;      // Ah counter since start()
+  float soc;                // % from the capacity, -1 if no capacity is set
+  float voltage;            // Before the pulse
+  float current;
+  float pulseVoltage;       // Averaged over the second half of the pulse
+  float pulseCurrent;
+  float recoveryVoltage;    // At the end of the recovery window
+  float resistance;         // dV/dI at the end of the pulse (ohm)
+  float ohmicResistance;    // dV/dI of the first sample after the step (ohm)
+  uint32_t latencyMicros;   // I_SET write sent to the first pulse sample
+  uint16_t samples;         // Reads during the pulse
+  bool valid;
+};
+
+struct IrStats {
+  uint32_t measurements;
+  uint32_t invalid;         // No current flowing, or the pulse did not change it
+  uint32_t failures;        // Bus errors during a measurement
+  uint32_t maxLatencyMicros;
+};
+
+/**
+ * Battery DC internal resistance pulse test
+ *
+ * Steps I_SET from the present level to the pulse level for a short time
+ * and reads VOUT/IOUT before, during and after the pulse back to back.
+ * The resistance is the voltage change divided by the measured current
+ * change, at the first sample after the step (ohmic) and at the end of
+ * the pulse. The default pulse halves the current, which works in CC and
+ * CV charging alike since the supply can always deliver less.
+ *
+ * The whole measurement runs with the bus locked, so the background poll,
+ * web requests and other control loops (a charger holding I_SET) wait
+ * until I_SET has been restored. With a schedule the test repeats during
+ * a charge and logs the resistance against the charged capacity.
+ */
+class XY_SKxxxIrTest {
+public:
+  explicit XY_SKxxxIrTest(XY_SKxxx& device);
+  ~XY_SKxxxIrTest();
+  XY_SKxxxIrTest(const XY_SKxxxIrTest&) = delete;
+  XY_SKxxxIrTest& operator=(const XY_SKxxxIrTest&) = delete;
+
+  /**
+   * I_SET during the pulse (0 = half the measured current) and the pulse
+   * and recovery windows (defaults 500 ms each, pulse at most 5 s)
+   */
+  void setPulse(float amps, uint32_t durationMs, uint32_t recoveryMs = 500);
+
+  /**
+   * Battery capacity and state of charge at start() for the SoC column
+   */
+  void setCapacity(uint32_t capacityMah, float startSoc = 0.0f);
+
+  /**
+   * Repeat every intervalMs after start(), 0 = one measurement
+   */
+  void setSchedule(uint32_t intervalMs) { _intervalMs = intervalMs; }
+
+  /**
+   * Clear the log and take the first measurement
+   */
+  bool start();
+  void stop() { _running = false; }
+
+  /**
+   * Take the scheduled measurement when it is due (blocks for the pulse
+   * and recovery windows)
+   *
+   * @return true while a schedule is running
+   */
+  bool update();
+
+  /**
+   * One measurement now, logged like the scheduled ones
+   */
+  bool measure();
+
+#if defined(ESP32)
+  bool startTask(UBaseType_t priority = 3, BaseType_t core = -1);
+  bool isTaskRunning() const { return _task.isRunning(); }
+#endif
+
+  bool isRunning() const { return _running; }
+
+  // Log, oldest first
+  uint8_t getPointCount() const { return _logCount; }
+  const IrPoint& getPoint(uint8_t index) const;
+  const IrPoint* getLastPoint() const;
+  const IrStats& getStats() const { return _stats; }
+
+private:
+  bool sample(float& voltage, float& current);
+  bool pulse(IrPoint& point);
+  void log(const IrPoint& point);
+
+#if defined(ESP32)
+  static bool taskTurn(void* context, uint32_t& sleepMs);
+  xy_sk::HelperTask _task;
+#endif
+
+  XY_SKxxx& _device;
+  float _pulseAmps;
+  uint32_t _pulseMs;
+  uint32_t _recoveryMs;
+  uint32_t _capacityMah;
+  float _startSoc;
+  uint32_t _intervalMs;
+
+  volatile bool _running;
+  unsigned long _start;
+  unsigned long _nextDue;
+  uint32_t _startMah;
+
+  IrPoint _log[IR_LOG_SIZE];
+  uint8_t _logHead;         // Next entry to write
+  uint8_t _logCount;
+  IrStats _stats;
+};
+
+#endif // XY_SKXXX_IR_H
@@ -3,63 +3,78 @@
 
 /* Cached value access methods for output measurements */
 float XY_SKxxx::getOutputVoltage(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_OUTPUT_VOLTAGE, refresh);
   if (refresh) {
     updateOutputStatus(true);
   }
+  endCacheAccess(CACHE_OUTPUT_VOLTAGE, refresh, mark);
   return _status.outputVoltage;
 }
 
 float XY_SKxxx::getOutputCurrent(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_OUTPUT_CURRENT, refresh);
   if (refresh) {
     updateOutputStatus(true);
   }
+  endCacheAccess(CACHE_OUTPUT_CURRENT, refresh, mark);
   return _status.outputCurrent;
 }
 
 float XY_SKxxx::getOutputPower(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_OUTPUT_POWER, refresh);
   if (refresh) {
     updateOutputStatus(true);
   }
+  endCacheAccess(CACHE_OUTPUT_POWER, refresh, mark);
   return _status.outputPower;
 }
 
 float XY_SKxxx::getInputVoltage(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_INPUT_VOLTAGE, refresh);
   if (refresh) {
     updateOutputStatus(true);
   }
+  endCacheAccess(CACHE_INPUT_VOLTAGE, refresh, mark);
   return _status.inputVoltage;
 }
 
 /* Operation mode indicator methods */
 bool XY_SKxxx::isInConstantCurrentMode(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_CVCC_MODE, refresh);
   if (refresh) {
     updateDeviceState(true);
   }
+  endCacheAccess(CACHE_CVCC_MODE, refresh, mark);
   return (_status.cvccMode == 1);
 }
 
 bool XY_SKxxx::isInConstantVoltageMode(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_CVCC_MODE, refresh);
   if (refresh) {
     updateDeviceState(true);
   }
+  endCacheAccess(CACHE_CVCC_MODE, refresh, mark);
   return (_status.cvccMode == 0);
 }
 
 /* Protection and status methods */
 uint16_t XY_SKxxx::getProtectionStatus(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_PROTECTION_STATUS, refresh);
   if (refresh) {
     updateDeviceState(true);
   }
+  endCacheAccess(CACHE_PROTECTION_STATUS, refresh, mark);
   return _status.protectionStatus;
 }
 
 /* Combined measurement method for convenience */
 bool XY_SKxxx::getMeasurements(float &outVoltage, float &outCurrent, float &outPower, 
                               float &inVoltage, bool refresh) {
-  if (refresh) {
-    if (!updateOutputStatus(true)) {
-      return false;
-    }
+  uint32_t mark = beginCacheAccess(CACHE_MEASUREMENTS, refresh);
+  bool success = !refresh || updateOutputStatus(true);
+  endCacheAccess(CACHE_MEASUREMENTS, refresh, mark);
+  if (!success) {
+    return false;
   }
   
   outVoltage = _status.outputVoltage;
@@ -73,10 +88,11 @@ bool XY_SKxxx::getMeasurements(float &outVoltage, float &outCurrent, float &outP
 /* Complete energy measurement method */
 bool XY_SKxxx::getEnergyMeasurements(uint32_t &ampHours, uint32_t &wattHours, 
                                    uint32_t &outputTime, bool refresh) {
-  if (refresh) {
-    if (!updateEnergyMeters(true)) {
-      return false;
-    }
+  uint32_t mark = beginCacheAccess(CACHE_ENERGY, refresh);
+  bool success = !refresh || updateEnergyMeters(true);
+  endCacheAccess(CACHE_ENERGY, refresh, mark);
+  if (!success) {
+    return false;
   }
   
   ampHours = _status.ampHours;
@@ -88,10 +104,11 @@ bool XY_SKxxx::getEnergyMeasurements(uint32_t &ampHours, uint32_t &wattHours,
 
 /* Combined temperature measurement method */
 bool XY_SKxxx::getTemperatures(float &internalTemp, float &externalTemp, bool refresh) {
-  if (refresh) {
-    if (!updateTemperatures(true)) {
-      return false;
-    }
+  uint32_t mark = beginCacheAccess(CACHE_TEMPERATURES, refresh);
+  bool success = !refresh || updateTemperatures(true);
+  endCacheAccess(CACHE_TEMPERATURES, refresh, mark);
+  if (!success) {
+    return false;
   }
   
   internalTemp = _status.internalTemp;
@@ -102,36 +119,48 @@ bool XY_SKxxx::getTemperatures(float &internalTemp, float &externalTemp, bool re
 
 /* Individual temperature measurement methods */
 float XY_SKxxx::getInternalTemperature(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_INTERNAL_TEMP, refresh);
   if (refresh) {
     updateTemperatures(true);
   }
+  endCacheAccess(CACHE_INTERNAL_TEMP, refresh, mark);
   return _status.internalTemp;
 }
 
 float XY_SKxxx::getExternalTemperature(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_EXTERNAL_TEMP, refresh);
   if (refresh) {
     updateTemperatures(true);
   }
+  endCacheAccess(CACHE_EXTERNAL_TEMP, refresh, mark);
   return _status.externalTemp;
 }
 
 /* CV/CC status method */
 uint16_t XY_SKxxx::getCVCCState(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_CVCC_MODE, refresh);
   if (refresh) {
     updateDeviceState(true);
   }
+  endCacheAccess(CACHE_CVCC_MODE, refresh, mark);
   return _status.cvccMode;
 }
 
 /* Unified operating mode method */
 OperatingMode XY_SKxxx::getOperatingMode(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_OPERATING_MODE, refresh);
   if (refresh) {
     // Update both device state and constant power settings
     updateDeviceState(true);
     updateConstantPowerSettings(true);
   }
+  endCacheAccess(CACHE_OPERATING_MODE, refresh, mark);
   
   // Check operating modes in priority order:
+  // 0. The emulated CR mode drives V_SET itself, it overrides the device modes
+  if (_crEnabled) {
+    return MODE_CR;
+  }
   // 1. First check if constant power mode is enabled (highest priority)
   if (_status.cpModeEnabled) {
     return MODE_CP;
@@ -0,0 +1,28 @@
+#include "XY-SKxxx-model.h"
+
+namespace xy_sk {
+
+const ModelInfo* findModel(uint16_t modelId) {
+    // 0 is what a failed read returns, and models without a known ID use it
+    if (modelId == 0) {
+        return nullptr;
+    }
+
+    const ModelInfo* models[] = {
+        &modelInfo<XY_SK120Traits>(),
+        &modelInfo<XY_SK60Traits>(),
+        &modelInfo<XY6020LTraits>()
+    };
+    for (const ModelInfo* model : models) {
+        if (model->modelId == modelId) {
+            return model;
+        }
+    }
+    return nullptr;
+}
+
+const ModelInfo& defaultModel() {
+    return modelInfo<XY_SK120Traits>();
+}
+
+} // namespace xy_sk
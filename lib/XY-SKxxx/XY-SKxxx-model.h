@@ -0,0 +1,139 @@
+#ifndef XY_SKXXX_MODEL_H
+#define XY_SKXXX_MODEL_H
+
+#include <Arduino.h>
+#include "XY-SKxxx-rtu.h"
+
+namespace xy_sk {
+
+// Optional register sets, absent on some models
+enum ModelFeature : uint16_t {
+    FEATURE_SYSTEM_STATUS  = 0x0001, // REG_SYS_STATUS
+    FEATURE_MPPT           = 0x0002, // REG_MPPT_ENABLE, REG_MPPT_THRESHOLD
+    FEATURE_BATTERY_CUTOFF = 0x0004, // REG_BTF
+    FEATURE_CONSTANT_POWER = 0x0008, // REG_CP_ENABLE, REG_CP_SET
+    FEATURE_FACTORY_RESET  = 0x0010  // REG_FACTORY_RESET
+};
+
+// Cache groups refreshed in the background by XY_SKxxx::pollCache()
+enum PollGroup : uint8_t {
+    POLL_OUTPUT         = 0x01, // VOUT/IOUT/POWER/UIN
+    POLL_STATE          = 0x02, // ON/OFF, lock, protection, CV/CC, system status
+    POLL_SETTINGS       = 0x04, // V/I setpoints, backlight, sleep
+    POLL_ENERGY         = 0x08, // Ah, Wh, output time
+    POLL_TEMPERATURES   = 0x10, // Internal and external temperature
+    POLL_CONSTANT_POWER = 0x20  // CP enable and setpoint
+};
+
+constexpr uint8_t POLL_GROUP_COUNT = 6;
+
+/*
+ * Model traits
+ *
+ * One struct per supported model with its limits, register scaling and
+ * optional register sets. Everything is a compile-time constant; the poll
+ * plan of each model is derived from its features, so groups that read
+ * registers a model lacks never make it onto the wire.
+ */
+
+// XY-SK120: 0-36 V, 0-6 A, 120 W (REG_MODEL 22873)
+struct XY_SK120Traits {
+    static constexpr uint16_t MODEL_ID = 22873;
+    static constexpr float MAX_VOLTAGE = 36.0f;
+    static constexpr float MAX_CURRENT = 6.1f;
+    static constexpr float MAX_POWER = 120.0f;
+    static constexpr uint16_t VOLTAGE_SCALE = 100;    // 0.01 V
+    static constexpr uint16_t CURRENT_SCALE = 1000;   // 0.001 A
+    static constexpr uint16_t POWER_SCALE = 100;      // REG_POWER, 0.01 W
+    static constexpr uint16_t OPP_SCALE = 10;         // REG_S_OPP, 0.1 W
+    static constexpr uint16_t MAX_BLOCK_REGISTERS = RTU_MAX_READ_REGISTERS;
+    static constexpr uint16_t FEATURES = FEATURE_SYSTEM_STATUS | FEATURE_MPPT | FEATURE_BATTERY_CUTOFF |
+                                         FEATURE_CONSTANT_POWER | FEATURE_FACTORY_RESET;
+    static const char* name() { return "XY-SK120"; }
+};
+
+// XY-SK60: same firmware family as the SK120 with a 5 A / 60 W power stage.
+// Its REG_MODEL value is not documented, select it with XY_SKxxx::setModelInfo().
+struct XY_SK60Traits {
+    static constexpr uint16_t MODEL_ID = 0;
+    static constexpr float MAX_VOLTAGE = 36.0f;
+    static constexpr float MAX_CURRENT = 5.1f;
+    static constexpr float MAX_POWER = 60.0f;
+    static constexpr uint16_t VOLTAGE_SCALE = 100;
+    static constexpr uint16_t CURRENT_SCALE = 1000;
+    static constexpr uint16_t POWER_SCALE = 100;
+    static constexpr uint16_t OPP_SCALE = 10;
+    static constexpr uint16_t MAX_BLOCK_REGISTERS = RTU_MAX_READ_REGISTERS;
+    static constexpr uint16_t FEATURES = XY_SK120Traits::FEATURES;
+    static const char* name() { return "XY-SK60"; }
+};
+
+// XY6020L: 0-60 V, 0-20 A, 1200 W (REG_MODEL 0x6100). Coarser current and
+// power resolution and none of the SK-series extension registers
+// (XY6020L-Modbus-Interface.pdf).
+struct XY6020LTraits {
+    static constexpr uint16_t MODEL_ID = 0x6100;
+    static constexpr float MAX_VOLTAGE = 60.0f;
+    static constexpr float MAX_CURRENT = 20.0f;
+    static constexpr float MAX_POWER = 1200.0f;
+    static constexpr uint16_t VOLTAGE_SCALE = 100;    // 0.01 V
+    static constexpr uint16_t CURRENT_SCALE = 100;    // 0.01 A
+    static constexpr uint16_t POWER_SCALE = 10;       // 0.1 W
+    static constexpr uint16_t OPP_SCALE = 1;          // 1 W
+    static constexpr uint16_t MAX_BLOCK_REGISTERS = RTU_MAX_READ_REGISTERS;
+    static constexpr uint16_t FEATURES = 0;
+    static const char* name() { return "XY6020L"; }
+};
+
+// Poll plan of a feature set: the core groups plus the optional ones it supports
+constexpr uint8_t pollPlanFor(uint16_t features) {
+    return POLL_OUTPUT | POLL_STATE | POLL_SETTINGS | POLL_ENERGY | POLL_TEMPERATURES |
+           ((features & FEATURE_CONSTANT_POWER) ? POLL_CONSTANT_POWER : 0);
+}
+
+// Runtime view of a traits type, selected per device from REG_MODEL
+struct ModelInfo {
+    uint16_t modelId;
+    const char* name;
+    float maxVoltage;
+    float maxCurrent;
+    float maxPower;
+    uint16_t voltageScale;
+    uint16_t currentScale;
+    uint16_t powerScale;
+    uint16_t oppScale;
+    uint16_t maxBlockRegisters;
+    uint16_t features;
+    uint8_t pollPlan;
+
+    bool hasFeature(ModelFeature feature) const { return (features & feature) != 0; }
+};
+
+/**
+ * Model description built from a traits type
+ */
+template <typename Traits>
+const ModelInfo& modelInfo() {
+    static const ModelInfo info = {
+        Traits::MODEL_ID, Traits::name(), Traits::MAX_VOLTAGE, Traits::MAX_CURRENT, Traits::MAX_POWER,
+        Traits::VOLTAGE_SCALE, Traits::CURRENT_SCALE, Traits::POWER_SCALE, Traits::OPP_SCALE,
+        Traits::MAX_BLOCK_REGISTERS, Traits::FEATURES, pollPlanFor(Traits::FEATURES)
+    };
+    return info;
+}
+
+/**
+ * Find the model reporting a REG_MODEL value
+ *
+ * @return The matching model, nullptr if the value is unknown
+ */
+const ModelInfo* findModel(uint16_t modelId);
+
+/**
+ * Model assumed until REG_MODEL has been read (XY-SK120)
+ */
+const ModelInfo& defaultModel();
+
+} // namespace xy_sk
+
+#endif // XY_SKXXX_MODEL_H
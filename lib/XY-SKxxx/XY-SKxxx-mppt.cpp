@@ -0,0 +1,280 @@
+#include "XY-SKxxx-internal.h"
+#include "XY-SKxxx-mppt.h"
+
+// Consecutive near-peak iterations that count as converged
+#define MPPT_STABLE_ITERATIONS 3
+// dUIN below this is treated as no voltage change (V)
+#define MPPT_MIN_VOLTAGE_DELTA 0.01f
+
+XY_SKxxxMppt::XY_SKxxxMppt(XY_SKxxx& device, MpptAlgorithm algorithm)
+  : _device(device), _algorithm(algorithm), _intervalMs(50), _step(0.05f), _minCurrent(0.0f),
+    _maxCurrent(device.getModelInfo().maxCurrent), _holdBand(0.005f), _minInputVoltage(0.0f),
+    _running(false), _stopRequested(false), _restoreBuiltIn(false), _builtInKnown(false), _setRaw(0),
+    _stepRaw(0), _minRaw(0), _maxRaw(0), _start(0), _nextDue(0), _lastSample(0), _havePrevious(false),
+    _lastPower(0.0f), _lastInputVoltage(0.0f), _direction(1), _lastReversal(0), _stable(0) {
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+XY_SKxxxMppt::~XY_SKxxxMppt() {
+  stop();
+#if defined(ESP32)
+  _task.join();
+#endif
+  if (_running) {
+    finish();
+  }
+}
+
+void XY_SKxxxMppt::setAlgorithm(MpptAlgorithm algorithm) {
+  if (!_running) {
+    _algorithm = algorithm;
+  }
+}
+
+void XY_SKxxxMppt::setLoopInterval(uint32_t intervalMs) {
+  if (!_running) {
+    _intervalMs = (intervalMs < 5) ? 5 : intervalMs;
+  }
+}
+
+void XY_SKxxxMppt::setStep(float amps) {
+  if (!_running && amps > 0.0f) {
+    _step = amps;
+  }
+}
+
+void XY_SKxxxMppt::setCurrentRange(float minAmps, float maxAmps) {
+  if (_running || minAmps < 0.0f || maxAmps <= minAmps) {
+    return;
+  }
+  _minCurrent = minAmps;
+  _maxCurrent = fminf(maxAmps, _device.getModelInfo().maxCurrent);
+}
+
+float XY_SKxxxMppt::getAveragePower() const {
+  return (_stats.elapsedMs == 0) ? 0.0f : (float)(_stats.energyWh * 3600000.0 / _stats.elapsedMs);
+}
+
+bool XY_SKxxxMppt::start() {
+  if (_running) {
+    return false;
+  }
+  bool hasBuiltIn = _device.hasFeature(xy_sk::FEATURE_MPPT);
+  if (_algorithm == MPPT_BUILT_IN && !hasBuiltIn) {
+    return false;
+  }
+
+  uint16_t raw;
+  if (!_device.readRegister(REG_I_SET, raw)) {
+    return false;
+  }
+
+  // Only one tracker may move the operating point
+  _builtInKnown = hasBuiltIn && _device.getMPPTEnable(_restoreBuiltIn);
+  if (_algorithm == MPPT_BUILT_IN && !_builtInKnown) {
+    return false;
+  }
+  bool wantBuiltIn = (_algorithm == MPPT_BUILT_IN);
+  if (_builtInKnown && _restoreBuiltIn != wantBuiltIn && !_device.setMPPTEnable(wantBuiltIn)) {
+    return false;
+  }
+
+  // The loop works in register counts, no float rounding in the comparison
+  uint16_t scale = _device.getModelInfo().currentScale;
+  _stepRaw = (uint16_t)(_step * scale + 0.5f);
+  if (_stepRaw == 0) {
+    _stepRaw = 1;
+  }
+  _minRaw = (uint16_t)(_minCurrent * scale + 0.5f);
+  _maxRaw = (uint16_t)(_maxCurrent * scale);
+  _setRaw = raw;
+
+  memset(&_stats, 0, sizeof(_stats));
+  _stats.setCurrent = raw / (float)scale;
+  _havePrevious = false;
+  _direction = 1;
+  _lastReversal = 0;
+  _stable = 0;
+  _lastSample = 0;
+  _stopRequested = false;
+  _start = millis();
+  _nextDue = _start;
+  _running = true;
+  return true;
+}
+
+void XY_SKxxxMppt::stop() {
+  if (_running) {
+    _stopRequested = true;
+  }
+}
+
+bool XY_SKxxxMppt::update() {
+  if (!_running) {
+    return false;
+  }
+  if (_stopRequested) {
+    finish();
+    return false;
+  }
+
+  unsigned long now = millis();
+  if ((long)(now - _nextDue) < 0) {
+    return true;
+  }
+  iterate(now);
+
+  // Iterations missed while the bus was busy are dropped, not caught up
+  _nextDue += _intervalMs;
+  if ((long)(now - _nextDue) >= 0) {
+    _nextDue = now + _intervalMs;
+  }
+  return true;
+}
+
+void XY_SKxxxMppt::iterate(unsigned long now) {
+  // VOUT, IOUT, POWER, UIN in one transaction
+  uint16_t values[4];
+  if (!_device.readRegisters(REG_VOUT, 4, values)) {
+    _stats.readFailures++;
+    return;
+  }
+
+  const xy_sk::ModelInfo& model = _device.getModelInfo();
+  float voltage = values[0] / (float)model.voltageScale;
+  float current = values[1] / (float)model.currentScale;
+  float inputVoltage = values[3] / (float)model.voltageScale;
+  float power = voltage * current;
+
+  if (_lastSample != 0) {
+    _stats.energyWh += power * (now - _lastSample) / 3600000.0;
+  }
+  _lastSample = now;
+
+  _stats.iterations++;
+  _stats.inputVoltage = inputVoltage;
+  _stats.outputVoltage = voltage;
+  _stats.outputCurrent = current;
+  _stats.power = power;
+  if (power > _stats.peakPower) {
+    _stats.peakPower = power;
+  }
+  _stats.elapsedMs = now - _start;
+  _stats.loopRate = (_stats.elapsedMs > 0) ? _stats.iterations * 1000.0f / _stats.elapsedMs : 0.0f;
+
+  if (_algorithm == MPPT_BUILT_IN) {
+    if (_havePrevious) {
+      trackConvergence(false, fabsf(power - _lastPower) <= _holdBand * fmaxf(_lastPower, 0.1f));
+    }
+  } else {
+    uint16_t next = nextSetpoint(power, inputVoltage);
+    if (next != _setRaw && !writeCurrent(next)) {
+      _stats.writeFailures++;
+    }
+  }
+
+  _lastPower = power;
+  _lastInputVoltage = inputVoltage;
+  _havePrevious = true;
+}
+
+uint16_t XY_SKxxxMppt::nextSetpoint(float power, float inputVoltage) {
+  // Panel collapsing: back off hard instead of stepping
+  if (_minInputVoltage > 0.0f && inputVoltage < _minInputVoltage) {
+    trackConvergence(_direction > 0, false);
+    _direction = -1;
+    uint16_t halved = _setRaw / 2;
+    return (halved < _minRaw) ? _minRaw : halved;
+  }
+
+  int8_t direction = _direction;
+  bool holding = false;
+  if (_havePrevious) {
+    float dP = power - _lastPower;
+    if (_algorithm == MPPT_PERTURB_OBSERVE) {
+      if (dP < 0.0f) {
+        direction = -_direction;
+      }
+    } else {
+      // dP/dUIN = 0 at the peak; more charge current means lower UIN
+      float dV = inputVoltage - _lastInputVoltage;
+      if (fabsf(dP) <= _holdBand * fmaxf(_lastPower, 0.1f)) {
+        holding = true;
+      } else if (fabsf(dV) < MPPT_MIN_VOLTAGE_DELTA) {
+        direction = (dP > 0.0f) ? -1 : 1;
+      } else {
+        direction = (dP / dV > 0.0f) ? -1 : 1;
+      }
+    }
+    trackConvergence(!holding && direction != _direction, holding);
+  }
+
+  if (holding) {
+    return _setRaw;
+  }
+  _direction = direction;
+  int32_t next = (int32_t)_setRaw + direction * (int32_t)_stepRaw;
+  return (uint16_t)constrain(next, (int32_t)_minRaw, (int32_t)_maxRaw);
+}
+
+bool XY_SKxxxMppt::writeCurrent(uint16_t raw) {
+  if (!_device.writeRegister(REG_I_SET, raw)) {
+    return false;
+  }
+  _setRaw = raw;
+  _stats.writes++;
+  _stats.setCurrent = raw / (float)_device.getModelInfo().currentScale;
+  return true;
+}
+
+void XY_SKxxxMppt::trackConvergence(bool reversed, bool holding) {
+  // P&O settles into reversing every one or two steps around the peak
+  bool nearPeak = holding || (reversed && _stats.iterations - _lastReversal <= 2);
+  if (nearPeak) {
+    if (_stable < MPPT_STABLE_ITERATIONS) {
+      _stable++;
+    }
+  } else if (_stats.iterations - _lastReversal > 2) {
+    _stable = 0;
+  }
+  if (reversed) {
+    _lastReversal = _stats.iterations;
+    _stats.reversals++;
+  }
+  if (!_stats.converged && _stable >= MPPT_STABLE_ITERATIONS) {
+    _stats.converged = true;
+    _stats.convergenceMs = _stats.elapsedMs;
+  }
+}
+
+void XY_SKxxxMppt::finish() {
+  _running = false;
+  _stopRequested = false;
+  if (_builtInKnown) {
+    _device.setMPPTEnable(_restoreBuiltIn);
+  }
+  xy_sk::resyncSetpoints(_device);
+}
+
+#if defined(ESP32)
+bool XY_SKxxxMppt::startTask(UBaseType_t priority, BaseType_t core) {
+  if (_task.isRunning() || !start()) {
+    return false;
+  }
+
+  if (!_task.start("xy_mppt", taskTurn, this, priority, core)) {
+    finish();
+    return false;
+  }
+  return true;
+}
+
+bool XY_SKxxxMppt::taskTurn(void* context, uint32_t& sleepMs) {
+  XY_SKxxxMppt* mppt = static_cast<XY_SKxxxMppt*>(context);
+  if (!mppt->update()) {
+    return false;
+  }
+  sleepMs = xy_sk::HelperTask::msUntil(mppt->_nextDue);
+  return true;
+}
+#endif
@@ -0,0 +1,155 @@
+#ifndef XY_SKXXX_MPPT_H
+#define XY_SKXXX_MPPT_H
+
+#include <Arduino.h>
+#include "XY-SKxxx.h"
+#include "XY-SKxxx-task.h"
+
+enum MpptAlgorithm {
+  MPPT_PERTURB_OBSERVE = 0,        // Step I_SET, reverse when the output power drops
+  MPPT_INCREMENTAL_CONDUCTANCE = 1, // Follow the sign of dP/dUIN, hold at the peak
+  MPPT_BUILT_IN = 2                // Device MPPT (REG_MPPT_ENABLE), telemetry only
+};
+
+struct MpptStats {
+  uint32_t iterations;
+  uint32_t readFailures;
+  uint32_t writeFailures;
+  uint32_t writes;           // I_SET writes, unchanged setpoints are not written
+  uint32_t reversals;        // Perturbation direction changes
+  float loopRate;            // Achieved iterations per second
+  float inputVoltage;        // Last UIN (V)
+  float outputVoltage;
+  float outputCurrent;
+  float power;               // Output power (W)
+  float peakPower;
+  float setCurrent;          // I_SET the tracker last wrote (A)
+  double energyWh;           // Output energy harvested since start()
+  uint32_t elapsedMs;
+  bool converged;            // Oscillating around or holding at the peak
+  uint32_t convergenceMs;    // Time from start() to convergence
+};
+
+/**
+ * Firmware maximum power point tracker for solar charging
+ *
+ * The panel is on the input, the battery on the output. Every loop interval
+ * VOUT, IOUT, POWER and UIN are read in one block and I_SET is moved by
+ * one step: a higher charge current pulls the panel voltage down, a lower
+ * one lets it rise. Perturb and observe keeps stepping in the direction
+ * that raised the output power; incremental conductance follows the sign
+ * of dP/dUIN and stops stepping once the power change is within the hold
+ * band. MPPT_BUILT_IN enables the device MPPT instead and only measures,
+ * so the harvested energy of all three can be compared over the same time.
+ *
+ * update() can be called from loop(); on ESP32 startTask() runs the loop in
+ * its own FreeRTOS task so the loop rate does not depend on loop().
+ */
+class XY_SKxxxMppt {
+public:
+  explicit XY_SKxxxMppt(XY_SKxxx& device, MpptAlgorithm algorithm = MPPT_PERTURB_OBSERVE);
+  ~XY_SKxxxMppt();
+  XY_SKxxxMppt(const XY_SKxxxMppt&) = delete;
+  XY_SKxxxMppt& operator=(const XY_SKxxxMppt&) = delete;
+
+  // Configuration, ignored while running
+  void setAlgorithm(MpptAlgorithm algorithm);
+  MpptAlgorithm getAlgorithm() const { return _algorithm; }
+
+  /**
+   * Time between iterations (default 50 ms, minimum 5 ms)
+   */
+  void setLoopInterval(uint32_t intervalMs);
+  uint32_t getLoopInterval() const { return _intervalMs; }
+
+  /**
+   * I_SET perturbation per iteration (default 0.05 A)
+   */
+  void setStep(float amps);
+
+  /**
+   * Range I_SET is kept in, maxAmps is clamped to the model limit
+   */
+  void setCurrentRange(float minAmps, float maxAmps);
+
+  /**
+   * Relative power change treated as no change by incremental conductance
+   * (default 0.005)
+   */
+  void setHoldBand(float band) { if (!_running) _holdBand = fabsf(band); }
+
+  /**
+   * Panel voltage below which I_SET is halved to keep the panel from
+   * collapsing, 0 disables (default)
+   */
+  void setMinimumInputVoltage(float volts) { if (!_running) _minInputVoltage = volts; }
+
+  /**
+   * Start tracking from the present I_SET
+   *
+   * The firmware algorithms turn the device MPPT off while they run,
+   * MPPT_BUILT_IN turns it on. stop() restores the previous device setting.
+   */
+  bool start();
+  void stop();
+
+  /**
+   * Run the iteration that is due, if any
+   *
+   * @return true while tracking
+   */
+  bool update();
+
+#if defined(ESP32)
+  bool startTask(UBaseType_t priority = 2, BaseType_t core = -1);
+  bool isTaskRunning() const { return _task.isRunning(); }
+#endif
+
+  bool isRunning() const { return _running; }
+  const MpptStats& getStats() const { return _stats; }
+  float getAveragePower() const; // Harvested energy over the elapsed time (W)
+
+private:
+  void iterate(unsigned long now);
+  uint16_t nextSetpoint(float power, float inputVoltage);
+  bool writeCurrent(uint16_t raw);
+  void trackConvergence(bool reversed, bool holding);
+  void finish();
+
+#if defined(ESP32)
+  static bool taskTurn(void* context, uint32_t& sleepMs);
+  xy_sk::HelperTask _task;
+#endif
+
+  XY_SKxxx& _device;
+  MpptAlgorithm _algorithm;
+  uint32_t _intervalMs;
+  float _step;
+  float _minCurrent;
+  float _maxCurrent;
+  float _holdBand;
+  float _minInputVoltage;
+
+  // Run state
+  volatile bool _running;
+  volatile bool _stopRequested;
+  bool _restoreBuiltIn;      // Device MPPT setting before start()
+  bool _builtInKnown;
+  uint16_t _setRaw;          // I_SET in register counts
+  uint16_t _stepRaw;
+  uint16_t _minRaw;
+  uint16_t _maxRaw;
+  unsigned long _start;
+  unsigned long _nextDue;
+  unsigned long _lastSample;
+  bool _havePrevious;
+  float _lastPower;
+  float _lastInputVoltage;
+  int8_t _direction;         // Last step: +1 raised I_SET, -1 lowered it
+  uint32_t _lastReversal;    // Iteration of the last direction change
+  uint8_t _stable;           // Consecutive iterations near the peak
+
+  MpptStats _stats;
+};
+
+#endif // XY_SKXXX_MPPT_H
@@ -4,12 +4,7 @@
 // Over Voltage Protection (OVP)
 bool XY_SKxxx::setOverVoltageProtection(float voltage) {
   uint16_t voltageValue = (uint16_t)(voltage * 100);
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.writeSingleRegister(REG_S_OVP, voltageValue);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
+  if (writeRegister(REG_S_OVP, voltageValue)) {
     _protection.overVoltageProtection = voltage;
     return true;
   }
@@ -23,21 +18,18 @@ bool XY_SKxxx::getOverVoltageProtection(float &voltage) {
 }
 
 float XY_SKxxx::getCachedOverVoltageProtection(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_OVER_VOLTAGE_PROTECTION, refresh);
   if (refresh) {
     updateVoltageCurrentProtection(true);
   }
+  endCacheAccess(CACHE_OVER_VOLTAGE_PROTECTION, refresh, mark);
   return _protection.overVoltageProtection;
 }
 
 // Input Low Voltage Protection (LVP)
 bool XY_SKxxx::setLowVoltageProtection(float voltage) {
   uint16_t voltageValue = (uint16_t)(voltage * 100);
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.writeSingleRegister(REG_S_LVP, voltageValue);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
+  if (writeRegister(REG_S_LVP, voltageValue)) {
     _protection.lowVoltageProtection = voltage;
     return true;
   }
@@ -51,21 +43,18 @@ bool XY_SKxxx::getLowVoltageProtection(float &voltage) {
 }
 
 float XY_SKxxx::getCachedLowVoltageProtection(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_LOW_VOLTAGE_PROTECTION, refresh);
   if (refresh) {
     updateVoltageCurrentProtection(true);
   }
+  endCacheAccess(CACHE_LOW_VOLTAGE_PROTECTION, refresh, mark);
   return _protection.lowVoltageProtection;
 }
 
 // Over Current Protection (OCP)
 bool XY_SKxxx::setOverCurrentProtection(float current) {
-  uint16_t currentValue = (uint16_t)(current * 1000);
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.writeSingleRegister(REG_S_OCP, currentValue);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
+  uint16_t currentValue = (uint16_t)(current * _model->currentScale);
+  if (writeRegister(REG_S_OCP, currentValue)) {
     _protection.overCurrentProtection = current;
     return true;
   }
@@ -79,19 +68,20 @@ bool XY_SKxxx::getOverCurrentProtection(float &current) {
 }
 
 float XY_SKxxx::getCachedOverCurrentProtection(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_OVER_CURRENT_PROTECTION, refresh);
   if (refresh) {
     updateVoltageCurrentProtection(true);
   }
+  endCacheAccess(CACHE_OVER_CURRENT_PROTECTION, refresh, mark);
   return _protection.overCurrentProtection;
 }
 
 // Over Power Protection (OPP)
 bool XY_SKxxx::setOverPowerProtection(float power) {
-  uint16_t value = static_cast<uint16_t>(power * 10.0f); // Use 10 for 1 decimal place
+  uint16_t value = static_cast<uint16_t>(power * _model->oppScale);
   bool success = writeRegister(REG_S_OPP, value);
   if (success) {
     _protection.overPowerProtection = power;
-    _lastPowerProtectionUpdate = millis();
   }
   return success;
 }
@@ -100,37 +90,26 @@ bool XY_SKxxx::getOverPowerProtection(float &power) {
   uint16_t value;
   bool success = readRegister(REG_S_OPP, value);
   if (success) {
-    power = value / 10.0f; // Use 10 for 1 decimal place
+    power = value / (float)_model->oppScale;
     _protection.overPowerProtection = power;
-    _lastPowerProtectionUpdate = millis();
   }
   return success;
 }
 
 float XY_SKxxx::getCachedOverPowerProtection(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_OVER_POWER_PROTECTION, refresh);
   if (refresh) {
     updatePowerProtection(true);
   }
+  endCacheAccess(CACHE_OVER_POWER_PROTECTION, refresh, mark);
   return _protection.overPowerProtection;
 }
 
 // High Power Protection Time (OHP Hours and Minutes)
 bool XY_SKxxx::setHighPowerProtectionTime(uint16_t hours, uint16_t minutes) {
-  waitForSilentInterval();
-  
-  uint8_t resultHours = modbus.writeSingleRegister(REG_S_OHP_H, hours);
-  _lastCommsTime = millis();
-  
-  if (resultHours != modbus.ku8MBSuccess) {
-    return false;
-  }
-  
-  delay(_silentIntervalTime * 2);
-  
-  uint8_t resultMinutes = modbus.writeSingleRegister(REG_S_OHP_M, minutes);
-  _lastCommsTime = millis();
-  
-  if (resultMinutes == modbus.ku8MBSuccess) {
+  // Both halves in one FC16 frame, the device never holds half a setting
+  uint16_t values[2] = {hours, minutes};
+  if (writeRegisters(REG_S_OHP_H, 2, values)) {
     _protection.highPowerHours = hours;
     _protection.highPowerMinutes = minutes;
     return true;
@@ -145,30 +124,19 @@ bool XY_SKxxx::getHighPowerProtectionTime(uint16_t &hours, uint16_t &minutes) {
 }
 
 void XY_SKxxx::getCachedHighPowerProtectionTime(uint16_t &hours, uint16_t &minutes, bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_HIGH_POWER_TIME, refresh);
   if (refresh) {
     updatePowerProtection(true);
   }
+  endCacheAccess(CACHE_HIGH_POWER_TIME, refresh, mark);
   hours = _protection.highPowerHours;
   minutes = _protection.highPowerMinutes;
 }
 
 // Over Amp-Hour Protection (OAH Low and High)
 bool XY_SKxxx::setOverAmpHourProtection(uint16_t ampHoursLow, uint16_t ampHoursHigh) {
-  waitForSilentInterval();
-  
-  uint8_t resultLow = modbus.writeSingleRegister(REG_S_OAH_L, ampHoursLow);
-  _lastCommsTime = millis();
-  
-  if (resultLow != modbus.ku8MBSuccess) {
-    return false;
-  }
-  
-  delay(_silentIntervalTime * 2);
-  
-  uint8_t resultHigh = modbus.writeSingleRegister(REG_S_OAH_H, ampHoursHigh);
-  _lastCommsTime = millis();
-  
-  if (resultHigh == modbus.ku8MBSuccess) {
+  uint16_t values[2] = {ampHoursLow, ampHoursHigh};
+  if (writeRegisters(REG_S_OAH_L, 2, values)) {
     _protection.overAmpHoursLow = ampHoursLow;
     _protection.overAmpHoursHigh = ampHoursHigh;
     return true;
@@ -183,30 +151,19 @@ bool XY_SKxxx::getOverAmpHourProtection(uint16_t &ampHoursLow, uint16_t &ampHour
 }
 
 void XY_SKxxx::getCachedOverAmpHourProtection(uint16_t &ampHoursLow, uint16_t &ampHoursHigh, bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_OVER_AMP_HOURS, refresh);
   if (refresh) {
     updateEnergyProtection(true);
   }
+  endCacheAccess(CACHE_OVER_AMP_HOURS, refresh, mark);
   ampHoursLow = _protection.overAmpHoursLow;
   ampHoursHigh = _protection.overAmpHoursHigh;
 }
 
 // Over Watt-Hour Protection (OWH Low and High)
 bool XY_SKxxx::setOverWattHourProtection(uint16_t wattHoursLow, uint16_t wattHoursHigh) {
-  waitForSilentInterval();
-  
-  uint8_t resultLow = modbus.writeSingleRegister(REG_S_OWH_L, wattHoursLow);
-  _lastCommsTime = millis();
-  
-  if (resultLow != modbus.ku8MBSuccess) {
-    return false;
-  }
-  
-  delay(_silentIntervalTime * 2);
-  
-  uint8_t resultHigh = modbus.writeSingleRegister(REG_S_OWH_H, wattHoursHigh);
-  _lastCommsTime = millis();
-  
-  if (resultHigh == modbus.ku8MBSuccess) {
+  uint16_t values[2] = {wattHoursLow, wattHoursHigh};
+  if (writeRegisters(REG_S_OWH_L, 2, values)) {
     _protection.overWattHoursLow = wattHoursLow;
     _protection.overWattHoursHigh = wattHoursHigh;
     return true;
@@ -221,9 +178,11 @@ bool XY_SKxxx::getOverWattHourProtection(uint16_t &wattHoursLow, uint16_t &wattH
 }
 
 void XY_SKxxx::getCachedOverWattHourProtection(uint16_t &wattHoursLow, uint16_t &wattHoursHigh, bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_OVER_WATT_HOURS, refresh);
   if (refresh) {
     updateEnergyProtection(true);
   }
+  endCacheAccess(CACHE_OVER_WATT_HOURS, refresh, mark);
   wattHoursLow = _protection.overWattHoursLow;
   wattHoursHigh = _protection.overWattHoursHigh;
 }
@@ -231,12 +190,7 @@ void XY_SKxxx::getCachedOverWattHourProtection(uint16_t &wattHoursLow, uint16_t
 // Over Temperature Protection (OTP)
 bool XY_SKxxx::setOverTemperatureProtection(float temperature) {
   uint16_t tempValue = (uint16_t)(temperature * 10);
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.writeSingleRegister(REG_S_OTP, tempValue);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
+  if (writeRegister(REG_S_OTP, tempValue)) {
     _protection.overTemperature = temperature;
     return true;
   }
@@ -250,20 +204,17 @@ bool XY_SKxxx::getOverTemperatureProtection(float &temperature) {
 }
 
 float XY_SKxxx::getCachedOverTemperatureProtection(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_OVER_TEMPERATURE, refresh);
   if (refresh) {
     updateTemperatureProtection(true);
   }
+  endCacheAccess(CACHE_OVER_TEMPERATURE, refresh, mark);
   return _protection.overTemperature;
 }
 
 // Power-On Initialization Setting (Output on/off on startup)
 bool XY_SKxxx::setPowerOnInitialization(bool outputOnAtStartup) {
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.writeSingleRegister(REG_S_INI, outputOnAtStartup ? 1 : 0);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
+  if (writeRegister(REG_S_INI, outputOnAtStartup ? 1 : 0)) {
     _protection.outputOnAtStartup = outputOnAtStartup;
     return true;
   }
@@ -277,178 +228,113 @@ bool XY_SKxxx::getPowerOnInitialization(bool &outputOnAtStartup) {
 }
 
 bool XY_SKxxx::getCachedPowerOnInitialization(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_POWER_ON_INIT, refresh);
   if (refresh) {
     updateStartupSetting(true);
   }
+  endCacheAccess(CACHE_POWER_ON_INIT, refresh, mark);
   return _protection.outputOnAtStartup;
 }
 
 // Protection settings cache update methods
+// Each decodes its part of M0 from the register shadow; without force,
+// registers read or written within the cache timeout are not read again
 bool XY_SKxxx::updateAllProtectionSettings(bool force) {
-  bool result = true;
-  
-  result &= updateConstantVoltageCurrentSettings(force);
-  result &= updateVoltageCurrentProtection(force);
-  result &= updatePowerProtection(force);
-  result &= updateEnergyProtection(force);
-  result &= updateTemperatureProtection(force);
-  result &= updateStartupSetting(force);
+  // All of M0 in one block read, the parts below then find it fresh
+  bool result = refreshShadow(REG_CV_SET, REG_S_INI - REG_CV_SET + 1, force ? 0 : _cacheTimeout);
+  
+  result &= updateConstantVoltageCurrentSettings(false);
+  result &= updateVoltageCurrentProtection(false);
+  result &= updatePowerProtection(false);
+  result &= updateEnergyProtection(false);
+  result &= updateTemperatureProtection(false);
+  result &= updateStartupSetting(false);
   result &= updateBatteryCutoffCurrent(force);  // Add this line
   
   return result;
 }
 
 bool XY_SKxxx::updateConstantVoltageCurrentSettings(bool force) {
-  unsigned long now = millis();
-  if (!force && (now - _lastConstantVCUpdate < _cacheTimeout)) {
-    return true;
-  }
-  
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.readHoldingRegisters(REG_CV_SET, 2);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
-    _protection.constantVoltage = modbus.getResponseBuffer(0) / 100.0f;
-    _protection.constantCurrent = modbus.getResponseBuffer(1) / 1000.0f;
-    
-    _lastConstantVCUpdate = now;
-    return true;
+  if (!refreshShadow(REG_CV_SET, 2, force ? 0 : _cacheTimeout)) {
+    return false;
   }
   
-  return false;
+  _protection.constantVoltage = _shadow[REG_CV_SET] / (float)_model->voltageScale;
+  _protection.constantCurrent = _shadow[REG_CC_SET] / (float)_model->currentScale;
+  return true;
 }
 
 bool XY_SKxxx::updateVoltageCurrentProtection(bool force) {
-  unsigned long now = millis();
-  if (!force && (now - _lastVoltageCurrentProtectionUpdate < _cacheTimeout)) {
-    return true;
-  }
-  
-  waitForSilentInterval();
-  
-  // Read low voltage, over voltage, and over current protection values
-  uint8_t result = modbus.readHoldingRegisters(REG_S_LVP, 3);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
-    _protection.lowVoltageProtection = modbus.getResponseBuffer(0) / 100.0f;
-    _protection.overVoltageProtection = modbus.getResponseBuffer(1) / 100.0f;
-    _protection.overCurrentProtection = modbus.getResponseBuffer(2) / 1000.0f;
-    
-    _lastVoltageCurrentProtectionUpdate = now;
-    return true;
+  // Low voltage, over voltage, and over current protection values
+  if (!refreshShadow(REG_S_LVP, 3, force ? 0 : _cacheTimeout)) {
+    return false;
   }
   
-  return false;
+  _protection.lowVoltageProtection = _shadow[REG_S_LVP] / 100.0f;
+  _protection.overVoltageProtection = _shadow[REG_S_OVP] / 100.0f;
+  _protection.overCurrentProtection = _shadow[REG_S_OCP] / (float)_model->currentScale;
+  return true;
 }
 
 bool XY_SKxxx::updatePowerProtection(bool force) {
-  unsigned long now = millis();
-  if (!force && (now - _lastPowerProtectionUpdate < _cacheTimeout)) {
-    return true;
-  }
-  
-  waitForSilentInterval();
-  
-  // Read over power protection and high power protection time
-  uint8_t result = modbus.readHoldingRegisters(REG_S_OPP, 3);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
-    _protection.overPowerProtection = modbus.getResponseBuffer(0) / 10.0f; // Use 10 for 1 decimal place
-    _protection.highPowerHours = modbus.getResponseBuffer(1);
-    _protection.highPowerMinutes = modbus.getResponseBuffer(2);
-    
-    _lastPowerProtectionUpdate = now;
-    return true;
+  // Over power protection and high power protection time
+  if (!refreshShadow(REG_S_OPP, 3, force ? 0 : _cacheTimeout)) {
+    return false;
   }
   
-  return false;
+  _protection.overPowerProtection = _shadow[REG_S_OPP] / (float)_model->oppScale;
+  _protection.highPowerHours = _shadow[REG_S_OHP_H];
+  _protection.highPowerMinutes = _shadow[REG_S_OHP_M];
+  return true;
 }
 
 bool XY_SKxxx::updateEnergyProtection(bool force) {
-  unsigned long now = millis();
-  if (!force && (now - _lastEnergyProtectionUpdate < _cacheTimeout)) {
-    return true;
-  }
-  
-  waitForSilentInterval();
-  
-  // Read over amp-hour and over watt-hour protection values
-  uint8_t result = modbus.readHoldingRegisters(REG_S_OAH_L, 4);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
-    _protection.overAmpHoursLow = modbus.getResponseBuffer(0);
-    _protection.overAmpHoursHigh = modbus.getResponseBuffer(1);
-    _protection.overWattHoursLow = modbus.getResponseBuffer(2);
-    _protection.overWattHoursHigh = modbus.getResponseBuffer(3);
-    
-    _lastEnergyProtectionUpdate = now;
-    return true;
+  // Over amp-hour and over watt-hour protection values
+  if (!refreshShadow(REG_S_OAH_L, 4, force ? 0 : _cacheTimeout)) {
+    return false;
   }
   
-  return false;
+  _protection.overAmpHoursLow = _shadow[REG_S_OAH_L];
+  _protection.overAmpHoursHigh = _shadow[REG_S_OAH_H];
+  _protection.overWattHoursLow = _shadow[REG_S_OWH_L];
+  _protection.overWattHoursHigh = _shadow[REG_S_OWH_H];
+  return true;
 }
 
 bool XY_SKxxx::updateTemperatureProtection(bool force) {
-  unsigned long now = millis();
-  if (!force && (now - _lastTempProtectionUpdate < _cacheTimeout)) {
-    return true;
-  }
-  
-  waitForSilentInterval();
-  
-  // Read over temperature protection value
-  uint8_t result = modbus.readHoldingRegisters(REG_S_OTP, 1);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
-    // Don't divide by 10.0f - OTP is stored as a whole number with no decimal places
-    _protection.overTemperature = modbus.getResponseBuffer(0);
-    
-    _lastTempProtectionUpdate = now;
-    return true;
+  if (!refreshShadow(REG_S_OTP, 1, force ? 0 : _cacheTimeout)) {
+    return false;
   }
   
-  return false;
+  // Don't divide by 10.0f - OTP is stored as a whole number with no decimal places
+  _protection.overTemperature = _shadow[REG_S_OTP];
+  return true;
 }
 
 bool XY_SKxxx::updateStartupSetting(bool force) {
-  unsigned long now = millis();
-  if (!force && (now - _lastStartupSettingUpdate < _cacheTimeout)) {
-    return true;
-  }
-  
-  waitForSilentInterval();
-  
-  // Read power-on initialization setting
-  uint8_t result = modbus.readHoldingRegisters(REG_S_INI, 1);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
-    _protection.outputOnAtStartup = (modbus.getResponseBuffer(0) != 0);
-    
-    _lastStartupSettingUpdate = now;
-    return true;
+  if (!refreshShadow(REG_S_INI, 1, force ? 0 : _cacheTimeout)) {
+    return false;
   }
   
-  return false;
+  _protection.outputOnAtStartup = (_shadow[REG_S_INI] != 0);
+  return true;
 }
 
 /* Access to cached constant voltage and constant current values */
 float XY_SKxxx::getCachedConstantVoltage(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_CONSTANT_VOLTAGE, refresh);
   if (refresh) {
     updateConstantVoltageCurrentSettings(true);
   }
+  endCacheAccess(CACHE_CONSTANT_VOLTAGE, refresh, mark);
   return _protection.constantVoltage;
 }
 
 float XY_SKxxx::getCachedConstantCurrent(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_CONSTANT_CURRENT, refresh);
   if (refresh) {
     updateConstantVoltageCurrentSettings(true);
   }
+  endCacheAccess(CACHE_CONSTANT_CURRENT, refresh, mark);
   return _protection.constantCurrent;
 }
@@ -0,0 +1,132 @@
+#include "XY-SKxxx-queue.h"
+
+namespace xy_sk {
+
+RequestQueue::RequestQueue() : _head(0), _count(0) {
+#if defined(ESP32)
+    _mux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+    memset(_entries, 0, sizeof(_entries));
+    resetStats();
+}
+
+void RequestQueue::lock() const {
+#if defined(ESP32)
+    portENTER_CRITICAL(&_mux);
+#endif
+}
+
+void RequestQueue::unlock() const {
+#if defined(ESP32)
+    portEXIT_CRITICAL(&_mux);
+#endif
+}
+
+bool RequestQueue::submit(uint16_t key, unsigned long timeToLiveMs, BusRequestHandler handler, void* context,
+                          uint32_t arg, float value) {
+    BusRequest request = {key, millis() + timeToLiveMs, handler, context, arg, value, 0};
+    return submit(request);
+}
+
+bool RequestQueue::submit(const BusRequest& request) {
+    if (request.handler == nullptr) {
+        return false;
+    }
+
+    BusRequest queued = request;
+    queued.submitted = millis();
+
+    BusRequest replaced;
+    bool superseded = false;
+    bool accepted = true;
+
+    lock();
+    _stats.submitted++;
+
+    // Replace a pending request with the same key in place
+    if (queued.key != REQUEST_KEY_NONE) {
+        for (uint8_t i = 0; i < _count; i++) {
+            BusRequest& entry = _entries[(_head + i) % REQUEST_QUEUE_CAPACITY];
+            if (entry.key == queued.key) {
+                replaced = entry;
+                // The merged request waits as long as the oldest one did
+                queued.submitted = entry.submitted;
+                entry = queued;
+                superseded = true;
+                _stats.coalesced++;
+                break;
+            }
+        }
+    }
+
+    if (!superseded) {
+        if (_count >= REQUEST_QUEUE_CAPACITY) {
+            _stats.rejected++;
+            accepted = false;
+        } else {
+            _entries[(_head + _count) % REQUEST_QUEUE_CAPACITY] = queued;
+            _count++;
+            if (_count > _stats.highWater) {
+                _stats.highWater = _count;
+            }
+        }
+    }
+    unlock();
+
+    // Tell the owner of the replaced request outside the critical section
+    if (superseded) {
+        replaced.handler(replaced.context, replaced, RequestOutcome::SUPERSEDED);
+    }
+    return accepted;
+}
+
+uint8_t RequestQueue::process(uint8_t maxRequests) {
+    uint8_t executed = 0;
+
+    while (executed < maxRequests) {
+        BusRequest request;
+
+        lock();
+        if (_count == 0) {
+            unlock();
+            break;
+        }
+        request = _entries[_head];
+        _head = (_head + 1) % REQUEST_QUEUE_CAPACITY;
+        _count--;
+        unlock();
+
+        unsigned long now = millis();
+        if ((long)(now - request.deadline) > 0) {
+            _stats.expired++;
+            request.handler(request.context, request, RequestOutcome::EXPIRED);
+            continue;
+        }
+
+        uint32_t waited = now - request.submitted;
+        if (waited > _stats.maxWaitMs) {
+            _stats.maxWaitMs = waited;
+        }
+        _stats.executed++;
+        request.handler(request.context, request, RequestOutcome::EXECUTE);
+        executed++;
+    }
+
+    return executed;
+}
+
+bool RequestQueue::isPending(uint16_t key) const {
+    bool pending = false;
+    lock();
+    for (uint8_t i = 0; i < _count && !pending; i++) {
+        pending = (_entries[(_head + i) % REQUEST_QUEUE_CAPACITY].key == key);
+    }
+    unlock();
+    return pending;
+}
+
+void RequestQueue::resetStats() {
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+} // namespace xy_sk
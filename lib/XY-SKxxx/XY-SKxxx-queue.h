@@ -0,0 +1,101 @@
+#ifndef XY_SKXXX_QUEUE_H
+#define XY_SKXXX_QUEUE_H
+
+#include <Arduino.h>
+
+namespace xy_sk {
+
+constexpr uint8_t REQUEST_QUEUE_CAPACITY = 16;
+constexpr uint16_t REQUEST_KEY_NONE = 0;  // Never coalesced with other requests
+
+// What happened to a queued request, passed to its handler
+enum class RequestOutcome : uint8_t {
+    EXECUTE = 0,     // Run the request now
+    EXPIRED = 1,     // Deadline passed before it reached the bus, nothing was sent
+    SUPERSEDED = 2   // A newer request with the same key replaced it
+};
+
+struct BusRequest;
+typedef void (*BusRequestHandler)(void* context, const BusRequest& request, RequestOutcome outcome);
+
+// One unit of bus work. The handler performs the register accesses when the
+// request is executed, or just reports back when it is dropped.
+struct BusRequest {
+    uint16_t key;               // Coalescing key, REQUEST_KEY_NONE to never merge
+    unsigned long deadline;     // millis() after which the result is useless
+    BusRequestHandler handler;
+    void* context;
+    uint32_t arg;               // Caller-defined (client id, register address...)
+    float value;                // Caller-defined (setpoint...)
+    unsigned long submitted;    // millis() when queued, filled in by submit()
+};
+
+// Queue counters
+struct RequestQueueStats {
+    uint32_t submitted;
+    uint32_t executed;
+    uint32_t expired;           // Dropped because the deadline passed
+    uint32_t coalesced;         // Replaced by a newer request with the same key
+    uint32_t rejected;          // Queue full
+    uint32_t maxWaitMs;         // Longest time an executed request waited
+    uint8_t highWater;          // Largest queue depth seen
+};
+
+/**
+ * FIFO of bus requests with deadlines and coalescing keys
+ *
+ * Producers (web handlers, other tasks) submit requests; a single consumer
+ * calls process() from the loop that owns the bus. A request whose key is
+ * already pending replaces the older one in place, keeping its queue
+ * position, so repeated polls collapse into one bus access. Requests whose
+ * deadline passed are dropped before they touch the wire.
+ */
+class RequestQueue {
+public:
+    RequestQueue();
+
+    /**
+     * Queue a request
+     *
+     * @param request Request to add, key and deadline must be set
+     * @return false if the queue is full (the request is not queued)
+     */
+    bool submit(const BusRequest& request);
+
+    /**
+     * Submit helper with a relative deadline
+     */
+    bool submit(uint16_t key, unsigned long timeToLiveMs, BusRequestHandler handler, void* context,
+                uint32_t arg = 0, float value = 0.0f);
+
+    /**
+     * Execute queued requests in order, dropping expired ones
+     *
+     * @param maxRequests Upper bound of requests executed in this call
+     * @return Number of requests executed
+     */
+    uint8_t process(uint8_t maxRequests = 1);
+
+    uint8_t size() const { return _count; }
+    bool isPending(uint16_t key) const;
+
+    const RequestQueueStats& getStats() const { return _stats; }
+    void resetStats();
+
+private:
+    void lock() const;
+    void unlock() const;
+
+    BusRequest _entries[REQUEST_QUEUE_CAPACITY];
+    uint8_t _head;
+    uint8_t _count;
+    RequestQueueStats _stats;
+
+#if defined(ESP32)
+    mutable portMUX_TYPE _mux;  // Also taken by the const readers
+#endif
+};
+
+} // namespace xy_sk
+
+#endif // XY_SKXXX_QUEUE_H
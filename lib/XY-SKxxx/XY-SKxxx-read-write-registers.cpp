@@ -14,35 +14,17 @@ bool XY_SKxxx::debugReadRegisters(uint16_t addr, uint8_t count, uint16_t* values
     return false; // Invalid count value
   }
   
-  waitForSilentInterval();
-  
-  // Try to read holding registers first
-  uint8_t result = modbus.readHoldingRegisters(addr, count);
-  
-  if (result == modbus.ku8MBSuccess) {
-    // Copy the results to the output array
-    for (uint8_t i = 0; i < count; i++) {
-      values[i] = modbus.getResponseBuffer(i);
-    }
-    _lastCommsTime = millis();
+  // Try to read holding registers first, always from the device
+  if (readRegistersDirect(addr, count, values)) {
     return true;
   }
   
   // If holding registers fail, try input registers
-  delay(_silentIntervalTime * 2);
-  result = modbus.readInputRegisters(addr, count);
-  
-  if (result == modbus.ku8MBSuccess) {
-    // Copy the results to the output array
-    for (uint8_t i = 0; i < count; i++) {
-      values[i] = modbus.getResponseBuffer(i);
-    }
-    _lastCommsTime = millis();
-    return true;
-  }
+  delay(_bus->getSilentInterval() * 2);
+  xy_sk::RtuRequest request = {_slaveID, xy_sk::RtuFunction::READ_INPUT_REGISTERS, addr, count, values, 0, 0, nullptr};
+  _lastError = _bus->execute(request);
   
-  _lastCommsTime = millis();
-  return false;
+  return (_lastError == xy_sk::RtuStatus::SUCCESS);
 }
 
 /**
@@ -53,12 +35,7 @@ bool XY_SKxxx::debugReadRegisters(uint16_t addr, uint8_t count, uint16_t* values
  * @return true if successful
  */
 bool XY_SKxxx::debugWriteRegister(uint16_t addr, uint16_t value) {
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.writeSingleRegister(addr, value);
-  _lastCommsTime = millis();
-  
-  return (result == modbus.ku8MBSuccess);
+  return writeRegister(addr, value);
 }
 
 /**
@@ -74,16 +51,6 @@ bool XY_SKxxx::debugWriteRegisters(uint16_t addr, uint8_t count, const uint16_t*
     return false; // Invalid count value
   }
   
-  waitForSilentInterval();
-  
-  // Set the transmit buffer with the values to write
-  for (uint8_t i = 0; i < count; i++) {
-    modbus.setTransmitBuffer(i, values[i]);
-  }
-  
   // Write the values to the registers
-  uint8_t result = modbus.writeMultipleRegisters(addr, count);
-  _lastCommsTime = millis();
-  
-  return (result == modbus.ku8MBSuccess);
+  return writeRegisters(addr, count, values);
 }
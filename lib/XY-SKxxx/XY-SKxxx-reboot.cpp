@@ -0,0 +1,232 @@
+#include "XY-SKxxx-internal.h"
+#include "XY-SKxxx-reboot.h"
+#include "XY-SKxxx-transaction.h"
+
+XY_SKxxxRebootMonitor::XY_SKxxxRebootMonitor(XY_SKxxx& device)
+  : _device(device), _intervalMs(1000), _failureLimit(2), _replay(true), _replayOutput(false),
+    _callback(nullptr), _callbackContext(nullptr), _journalCount(0), _running(false), _nextDue(0), _lastGood(0),
+    _failures(0), _havePrevious(false), _previousSeconds(0), _previousOn(false), _previousWrites(0), _logHead(0),
+    _logCount(0) {
+  memset(_journal, 0, sizeof(_journal));
+  memset(_log, 0, sizeof(_log));
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+XY_SKxxxRebootMonitor::~XY_SKxxxRebootMonitor() {
+  stop();
+#if defined(ESP32)
+  _task.join();
+#endif
+}
+
+void XY_SKxxxRebootMonitor::setHeartbeat(uint32_t intervalMs, uint8_t failures) {
+  _intervalMs = (intervalMs == 0) ? 1 : intervalMs;
+  _failureLimit = (failures == 0) ? 1 : failures;
+}
+
+bool XY_SKxxxRebootMonitor::journal(uint16_t addr, uint16_t value) {
+  for (uint8_t i = 0; i < _journalCount; i++) {
+    if (_journal[i].addr == addr) {
+      _journal[i].value = value;
+      return true;
+    }
+  }
+  if (_journalCount >= REBOOT_JOURNAL_SIZE) {
+    return false;
+  }
+  _journal[_journalCount].addr = addr;
+  _journal[_journalCount].value = value;
+  _journalCount++;
+  return true;
+}
+
+bool XY_SKxxxRebootMonitor::journal(uint16_t addr, uint16_t count, const uint16_t* values) {
+  for (uint16_t i = 0; i < count; i++) {
+    if (!journal(addr + i, values[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool XY_SKxxxRebootMonitor::journalCurrent(uint16_t addr, uint16_t count) {
+  uint16_t values[REBOOT_JOURNAL_SIZE];
+  if (count > REBOOT_JOURNAL_SIZE || !_device.readRegisters(addr, count, values)) {
+    return false;
+  }
+  return journal(addr, count, values);
+}
+
+void XY_SKxxxRebootMonitor::setRebootCallback(RebootCallback callback, void* context) {
+  _callback = callback;
+  _callbackContext = context;
+}
+
+const RebootEvent& XY_SKxxxRebootMonitor::getEvent(uint8_t index) const {
+  uint8_t oldest = (_logCount < REBOOT_LOG_SIZE) ? 0 : _logHead;
+  return _log[(oldest + index) % REBOOT_LOG_SIZE];
+}
+
+bool XY_SKxxxRebootMonitor::start() {
+  if (_running) {
+    return false;
+  }
+  _failures = 0;
+  _havePrevious = false;
+  _lastGood = millis();
+  _nextDue = _lastGood;
+  _running = true;
+  return true;
+}
+
+bool XY_SKxxxRebootMonitor::update() {
+  if (!_running) {
+    return false;
+  }
+  unsigned long now = millis();
+  if ((long)(now - _nextDue) < 0) {
+    return true;
+  }
+  _nextDue = now + _intervalMs;
+  heartbeat();
+  return true;
+}
+
+void XY_SKxxxRebootMonitor::heartbeat() {
+  // Output time and output state in one block, neither comes from the shadow
+  uint16_t values[REG_ONOFF - REG_OUT_H + 1];
+  _stats.heartbeats++;
+  if (!_device.readRegisters(REG_OUT_H, REG_ONOFF - REG_OUT_H + 1, values)) {
+    _stats.heartbeatFailures++;
+    if (_failures < 255) {
+      _failures++;
+    }
+    return;
+  }
+
+  uint32_t start = micros();
+  unsigned long now = millis();
+  uint32_t seconds = values[0] * 3600UL + values[1] * 60UL + values[2];
+  bool on = values[REG_ONOFF - REG_OUT_H] != 0;
+  uint32_t writes = _device.getOutputWriteCount();
+  bool outage = _failures >= _failureLimit;
+  bool backwards = _havePrevious && seconds < _previousSeconds;
+  // Switched off from the panel during an outage looks the same, so this
+  // is only trusted across an outage
+  bool dropped = outage && _havePrevious && _previousOn && !on && writes == _previousWrites;
+
+  RebootEvent event;
+  memset(&event, 0, sizeof(event));
+  event.timeMs = now;
+  event.reason = backwards ? REBOOT_COUNTER_BACKWARDS : REBOOT_OUTPUT_DROPPED;
+  event.outageMs = outage ? now - _lastGood : 0;
+  event.previousSeconds = _previousSeconds;
+  event.seconds = seconds;
+
+  if (outage) {
+    _stats.outages++;
+  }
+  _failures = 0;
+  _lastGood = now;
+  _havePrevious = true;
+  _previousSeconds = seconds;
+  _previousOn = on;
+  _previousWrites = writes;
+
+  if (backwards || dropped) {
+    recover(event, start);
+  }
+}
+
+bool XY_SKxxxRebootMonitor::recover(RebootReason reason) {
+  RebootEvent event;
+  memset(&event, 0, sizeof(event));
+  event.timeMs = millis();
+  event.reason = reason;
+  return recover(event, micros());
+}
+
+bool XY_SKxxxRebootMonitor::recover(RebootEvent& event, uint32_t start) {
+  // Nothing else may use the stale caches or write setpoints meanwhile
+  xy_sk::RtuBus& bus = _device.getBus();
+  bus.lock();
+  _device.invalidateCaches();
+
+  // Intended settings first, the reload then reads back what the device took
+  event.replayOk = true;
+  if (_replay && _journalCount > 0) {
+    uint32_t replayStart = micros();
+    event.replayOk = replayJournal(event);
+    event.replayMicros = micros() - replayStart;
+  }
+
+  uint32_t reloadStart = micros();
+  event.reloaded = _device.reloadCaches();
+  event.reloadMicros = micros() - reloadStart;
+  bus.unlock();
+
+  event.recoveryMicros = micros() - start;
+  // The next heartbeat starts a new output time baseline
+  _havePrevious = false;
+
+  _stats.reboots++;
+  if (event.recoveryMicros > _stats.maxRecoveryMicros) {
+    _stats.maxRecoveryMicros = event.recoveryMicros;
+  }
+  _log[_logHead] = event;
+  _logHead = (_logHead + 1) % REBOOT_LOG_SIZE;
+  if (_logCount < REBOOT_LOG_SIZE) {
+    _logCount++;
+  }
+  if (_callback != nullptr) {
+    _callback(_callbackContext, event);
+  }
+  return event.reloaded && event.replayOk;
+}
+
+bool XY_SKxxxRebootMonitor::replayJournal(RebootEvent& event) {
+  // Runs of adjacent registers as FC16, ONOFF after everything else if enabled
+  XY_SKxxxTransaction transaction(_device);
+  bool haveOutput = false;
+  uint16_t output = 0;
+  for (uint8_t i = 0; i < _journalCount; i++) {
+    if (_journal[i].addr == REG_ONOFF) {
+      haveOutput = true;
+      output = _journal[i].value;
+    } else {
+      transaction.write(_journal[i].addr, _journal[i].value);
+    }
+  }
+
+  bool success = transaction.commit();
+  event.replayed = transaction.size() - transaction.getResult().failed;
+  // Never switch the output on over missing protections
+  if (haveOutput && _replayOutput && success) {
+    if (_device.writeRegister(REG_ONOFF, output)) {
+      event.replayed++;
+    } else {
+      success = false;
+    }
+  }
+  return success;
+}
+
+#if defined(ESP32)
+bool XY_SKxxxRebootMonitor::startTask(UBaseType_t priority, BaseType_t core) {
+  if (_task.isRunning() || !start()) {
+    return false;
+  }
+
+  if (!_task.start("xy_reboot", taskTurn, this, priority, core)) {
+    _running = false;
+    return false;
+  }
+  return true;
+}
+
+bool XY_SKxxxRebootMonitor::taskTurn(void* context, uint32_t& sleepMs) {
+  XY_SKxxxRebootMonitor* monitor = static_cast<XY_SKxxxRebootMonitor*>(context);
+  sleepMs = monitor->_intervalMs;
+  return monitor->update();
+}
+#endif
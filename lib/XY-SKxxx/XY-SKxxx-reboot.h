@@ -0,0 +1,161 @@
+#ifndef XY_SKXXX_REBOOT_H
+#define XY_SKXXX_REBOOT_H
+
+#include <Arduino.h>
+#include "XY-SKxxx.h"
+#include "XY-SKxxx-task.h"
+
+#define REBOOT_LOG_SIZE 8
+#define REBOOT_JOURNAL_SIZE 32
+
+enum RebootReason {
+  REBOOT_COUNTER_BACKWARDS = 0,  // Output time went backwards
+  REBOOT_OUTPUT_DROPPED = 1,     // Output went off across an outage without a write from this driver
+  REBOOT_MANUAL = 2              // recover() called by the application
+};
+
+struct RebootEvent {
+  uint32_t timeMs;            // millis() of the detection
+  RebootReason reason;
+  uint32_t outageMs;          // Last good heartbeat before the outage to the first one after
+  uint32_t previousSeconds;   // Output time before and after, for REBOOT_COUNTER_BACKWARDS
+  uint32_t seconds;
+  uint32_t reloadMicros;      // Caches invalidated and read back
+  uint32_t replayMicros;      // Journal written (0 without replay)
+  uint32_t recoveryMicros;    // Detection to recovered
+  uint8_t replayed;           // Journal registers written
+  bool reloaded;
+  bool replayOk;
+};
+
+struct RebootStats {
+  uint32_t heartbeats;
+  uint32_t heartbeatFailures;
+  uint32_t outages;           // Outages ended, with or without a reboot
+  uint32_t reboots;
+  uint32_t maxRecoveryMicros;
+};
+
+/**
+ * Power cycle detection and recovery
+ *
+ * A heartbeat reads the output time (REG_OUT_H/M/S) and the output state
+ * in one block. The device restarts its output time counter when it boots,
+ * so the counter going backwards means it was power cycled between two
+ * heartbeats. An outage alone is no proof, the link may have dropped while
+ * the supply ran on; it only counts as a reboot if the output was on before
+ * it and is off after it without this driver having switched it
+ * (XY_SKxxx::getOutputWriteCount()). On a reboot every cache is
+ * invalidated at once and the journal of intended settings is replayed as
+ * FC16 runs. reloadCaches() then reads it all back in a few block reads, so
+ * the caches show what the device took. Each recovery is logged with its
+ * timing.
+ *
+ * A journalled ONOFF is only replayed with setReplayOutput(true), and only
+ * after the rest of the journal was written, so the protections are back
+ * before the output is switched on. Without it the output stays as the
+ * device came up, a panel switch is never overridden. Firmware that clears
+ * the output time when the output is switched on from the panel looks like
+ * a reboot; the recovery then rewrites the journal.
+ */
+class XY_SKxxxRebootMonitor {
+public:
+  typedef void (*RebootCallback)(void* context, const RebootEvent& event);
+
+  explicit XY_SKxxxRebootMonitor(XY_SKxxx& device);
+  ~XY_SKxxxRebootMonitor();
+  XY_SKxxxRebootMonitor(const XY_SKxxxRebootMonitor&) = delete;
+  XY_SKxxxRebootMonitor& operator=(const XY_SKxxxRebootMonitor&) = delete;
+
+  /**
+   * Heartbeat interval (default 1000 ms) and the failed heartbeats in a
+   * row that make an outage (default 2)
+   */
+  void setHeartbeat(uint32_t intervalMs, uint8_t failures = 2);
+
+  /**
+   * Intended settings rewritten after a reboot
+   *
+   * @return false if the journal is full
+   */
+  bool journal(uint16_t addr, uint16_t value);
+  bool journal(uint16_t addr, uint16_t count, const uint16_t* values);
+  bool journalCurrent(uint16_t addr, uint16_t count); // Values the device has now
+  void clearJournal() { _journalCount = 0; }
+  uint8_t getJournalSize() const { return _journalCount; }
+  void setReplay(bool enabled) { _replay = enabled; }
+  // Also replay a journalled ONOFF (default off)
+  void setReplayOutput(bool enabled) { _replayOutput = enabled; }
+
+  void setRebootCallback(RebootCallback callback, void* context);
+
+  bool start();
+  void stop() { _running = false; }
+
+  /**
+   * Send the heartbeat when it is due and recover on a detection
+   *
+   * @return true while the monitor is running
+   */
+  bool update();
+
+  /**
+   * Replay the journal and reload the caches now
+   */
+  bool recover(RebootReason reason = REBOOT_MANUAL);
+
+#if defined(ESP32)
+  bool startTask(UBaseType_t priority = 2, BaseType_t core = -1);
+  bool isTaskRunning() const { return _task.isRunning(); }
+#endif
+
+  bool isRunning() const { return _running; }
+  bool isLinkDown() const { return _failures >= _failureLimit; }
+
+  const RebootStats& getStats() const { return _stats; }
+  // Log, oldest first
+  uint8_t getEventCount() const { return _logCount; }
+  const RebootEvent& getEvent(uint8_t index) const;
+
+private:
+  struct JournalEntry {
+    uint16_t addr;
+    uint16_t value;
+  };
+
+  void heartbeat();
+  bool recover(RebootEvent& event, uint32_t start);
+  bool replayJournal(RebootEvent& event);
+
+#if defined(ESP32)
+  static bool taskTurn(void* context, uint32_t& sleepMs);
+  xy_sk::HelperTask _task;
+#endif
+
+  XY_SKxxx& _device;
+  uint32_t _intervalMs;
+  uint8_t _failureLimit;
+  bool _replay;
+  bool _replayOutput;
+  RebootCallback _callback;
+  void* _callbackContext;
+
+  JournalEntry _journal[REBOOT_JOURNAL_SIZE];
+  uint8_t _journalCount;
+
+  volatile bool _running;
+  unsigned long _nextDue;
+  unsigned long _lastGood;    // millis() of the last answered heartbeat
+  uint8_t _failures;          // Failed heartbeats in a row
+  bool _havePrevious;
+  uint32_t _previousSeconds;
+  bool _previousOn;
+  uint32_t _previousWrites;   // getOutputWriteCount() at the last answered heartbeat
+
+  RebootEvent _log[REBOOT_LOG_SIZE];
+  uint8_t _logHead;           // Next entry to write
+  uint8_t _logCount;
+  RebootStats _stats;
+};
+
+#endif // XY_SKXXX_REBOOT_H
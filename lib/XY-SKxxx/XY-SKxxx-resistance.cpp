@@ -0,0 +1,156 @@
+#include "XY-SKxxx-internal.h"
+
+// Below this output current V/I is mostly measurement noise
+#define CR_MIN_CURRENT 0.01f
+// Consecutive in-tolerance iterations that count as settled
+#define CR_SETTLE_ITERATIONS 5
+
+/**
+ * Set the resistance the emulated CR mode holds
+ *
+ * @param ohms Target V/I, must be positive
+ * @return true if the value was accepted
+ */
+bool XY_SKxxx::setConstantResistance(float ohms) {
+  if (ohms <= 0.0f) {
+    return false;
+  }
+  _crTarget = ohms;
+  // Settling and tracking error are measured from the new target
+  resetConstantResistanceTracking();
+  return true;
+}
+
+/**
+ * Enable or disable the emulated Constant Resistance (CR) mode
+ *
+ * Enabling starts from the present V_SET and turns the device CP mode off.
+ * Disabling leaves V_SET where the loop last put it.
+ *
+ * @param enabled true to enable, false to disable
+ * @return true if successful
+ */
+bool XY_SKxxx::setConstantResistanceMode(bool enabled) {
+  if (!enabled) {
+    _crEnabled = false;
+    return true;
+  }
+  if (_crTarget <= 0.0f) {
+    return false;
+  }
+
+  if (_status.cpModeEnabled && !setConstantPowerMode(false)) {
+    return false;
+  }
+
+  uint16_t value;
+  if (!readRegister(REG_V_SET, value)) {
+    return false;
+  }
+  _crRaw = value;
+  _crSetVoltage = value / (float)_model->voltageScale;
+
+  memset(&_crStats, 0, sizeof(_crStats));
+  _crStats.since = millis();
+  resetConstantResistanceTracking();
+  _crEnabled = true;
+  return true;
+}
+
+/**
+ * Tune the emulation loop
+ *
+ * @param gain Fraction of the voltage error corrected per iteration (0-1, default 0.5)
+ * @param tolerance Relative resistance error counted as settled (default 0.02)
+ */
+void XY_SKxxx::setConstantResistanceTuning(float gain, float tolerance) {
+  _crGain = constrain(gain, 0.01f, 1.0f);
+  _crTolerance = fabsf(tolerance);
+}
+
+void XY_SKxxx::resetConstantResistanceTracking() {
+  _crInBand = 0;
+  _crBandStart = 0;
+  _crTargetSince = millis();
+  _crSquaredError = 0.0f;
+  _crErrorSamples = 0;
+  _crStats.settled = false;
+  _crStats.settlingMs = 0;
+  _crStats.rmsError = 0.0f;
+}
+
+/**
+ * Run one iteration of the emulated CR loop
+ *
+ * One block read of VOUT/IOUT and at most one V_SET write, only when the
+ * corrected setpoint differs at register resolution.
+ *
+ * @return true if the iteration's bus traffic succeeded
+ */
+bool XY_SKxxx::updateConstantResistance() {
+  if (!_crEnabled) {
+    return false;
+  }
+
+  unsigned long now = millis();
+  uint16_t values[2];
+  if (!readRegisters(REG_VOUT, 2, values)) {
+    _crStats.failures++;
+    return false;
+  }
+
+  float voltage = values[0] / (float)_model->voltageScale;
+  float current = values[1] / (float)_model->currentScale;
+  _status.outputVoltage = voltage;
+  _status.outputCurrent = current;
+
+  _crStats.iterations++;
+  unsigned long elapsed = now - _crStats.since;
+  _crStats.loopRate = (elapsed > 0) ? _crStats.iterations * 1000.0f / elapsed : 0.0f;
+
+  // Without load current the resistance is undefined, hold V_SET
+  _crStats.noLoad = (current < CR_MIN_CURRENT);
+  if (_crStats.noLoad) {
+    return true;
+  }
+
+  float resistance = voltage / current;
+  float error = (resistance - _crTarget) / _crTarget;
+  _crStats.resistance = resistance;
+  _crStats.error = error;
+  _crSquaredError += error * error;
+  _crErrorSamples++;
+  _crStats.rmsError = sqrtf(_crSquaredError / _crErrorSamples);
+
+  if (fabsf(error) <= _crTolerance) {
+    if (_crInBand == 0) {
+      _crBandStart = now;
+    }
+    if (_crInBand < CR_SETTLE_ITERATIONS) {
+      _crInBand++;
+    }
+    if (_crInBand >= CR_SETTLE_ITERATIONS && !_crStats.settled) {
+      _crStats.settled = true;
+      _crStats.settlingMs = _crBandStart - _crTargetSince;
+    }
+  } else {
+    _crInBand = 0;
+  }
+
+  // Move V_SET towards the voltage the target resistance gives at this current
+  _crSetVoltage += _crGain * (_crTarget * current - voltage);
+  _crSetVoltage = constrain(_crSetVoltage, 0.0f, _model->maxVoltage);
+
+  uint16_t raw = (uint16_t)(_crSetVoltage * _model->voltageScale + 0.5f);
+  if (raw == _crRaw) {
+    return true;
+  }
+  if (!writeRegister(REG_V_SET, raw)) {
+    _crStats.failures++;
+    return false;
+  }
+  _crRaw = raw;
+  _crStats.writes++;
+  _status.setVoltage = raw / (float)_model->voltageScale;
+  return true;
+}
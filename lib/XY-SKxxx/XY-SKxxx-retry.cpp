@@ -0,0 +1,124 @@
+#include "XY-SKxxx-retry.h"
+
+namespace xy_sk {
+
+ErrorClass classifyRtuStatus(RtuStatus status) {
+    switch (status) {
+        case RtuStatus::SUCCESS:
+            return ErrorClass::NONE;
+        case RtuStatus::RESPONSE_TIMED_OUT:
+            return ErrorClass::TIMEOUT;
+        case RtuStatus::INVALID_CRC:
+        case RtuStatus::INVALID_SLAVE_ID:
+        case RtuStatus::INVALID_FUNCTION:
+        case RtuStatus::INVALID_RESPONSE:
+            return ErrorClass::CORRUPTED;
+        case RtuStatus::INVALID_REQUEST:
+        case RtuStatus::BUSY:
+        case RtuStatus::PENDING:
+            return ErrorClass::LOCAL;
+        default:
+            return isRtuException(status) ? ErrorClass::EXCEPTION : ErrorClass::CORRUPTED;
+    }
+}
+
+RetryPolicy::RetryPolicy()
+    : _backoffBaseMs(20), _backoffMaxMs(200), _deadlineMs(3000) {
+    // Reads: retry anything transient, a slave exception will not change on repeat
+    setMaxAttempts(OperationType::READ, ErrorClass::TIMEOUT, 3);
+    setMaxAttempts(OperationType::READ, ErrorClass::CORRUPTED, 3);
+    setMaxAttempts(OperationType::READ, ErrorClass::EXCEPTION, 1);
+    setMaxAttempts(OperationType::READ, ErrorClass::LOCAL, 1);
+
+    // Writes: register writes carry absolute values, so one repeat is safe even
+    // if the first attempt was executed and only the echo got lost
+    setMaxAttempts(OperationType::WRITE, ErrorClass::TIMEOUT, 2);
+    setMaxAttempts(OperationType::WRITE, ErrorClass::CORRUPTED, 2);
+    setMaxAttempts(OperationType::WRITE, ErrorClass::EXCEPTION, 1);
+    setMaxAttempts(OperationType::WRITE, ErrorClass::LOCAL, 1);
+
+    // Success needs no retry
+    setMaxAttempts(OperationType::READ, ErrorClass::NONE, 1);
+    setMaxAttempts(OperationType::WRITE, ErrorClass::NONE, 1);
+
+    resetStats();
+}
+
+void RetryPolicy::setMaxAttempts(OperationType type, ErrorClass errorClass, uint8_t attempts) {
+    _maxAttempts[static_cast<uint8_t>(type)][static_cast<uint8_t>(errorClass)] = (attempts == 0) ? 1 : attempts;
+}
+
+uint8_t RetryPolicy::getMaxAttempts(OperationType type, ErrorClass errorClass) const {
+    return _maxAttempts[static_cast<uint8_t>(type)][static_cast<uint8_t>(errorClass)];
+}
+
+void RetryPolicy::setBackoff(unsigned long baseMs, unsigned long maxMs) {
+    _backoffBaseMs = baseMs;
+    _backoffMaxMs = (maxMs < baseMs) ? baseMs : maxMs;
+}
+
+bool RetryPolicy::shouldRetry(OperationType type, RtuStatus status, uint8_t attempt,
+                              unsigned long elapsedMs, unsigned long& backoffMs) {
+    backoffMs = 0;
+    ErrorClass errorClass = classifyRtuStatus(status);
+    if (errorClass == ErrorClass::NONE) {
+        return false;
+    }
+
+    uint8_t maxAttempts = getMaxAttempts(type, errorClass);
+    if (maxAttempts <= 1) {
+        _stats.failFast++;
+        return false;
+    }
+    if (attempt >= maxAttempts) {
+        _stats.exhausted++;
+        return false;
+    }
+
+    backoffMs = backoffFor(attempt);
+
+    // Do not start an attempt that cannot finish inside the budget
+    if (_deadlineMs > 0 && elapsedMs + backoffMs >= _deadlineMs) {
+        backoffMs = 0;
+        _stats.deadlineExceeded++;
+        return false;
+    }
+
+    _stats.retries++;
+    return true;
+}
+
+unsigned long RetryPolicy::remainingBudget(unsigned long elapsedMs) const {
+    if (_deadlineMs == 0) {
+        return 0;
+    }
+    return (elapsedMs < _deadlineMs) ? _deadlineMs - elapsedMs : 1;
+}
+
+void RetryPolicy::recordOutcome(bool success, uint8_t attempts) {
+    _stats.operations++;
+    if (success && attempts > 1) {
+        _stats.recovered++;
+    }
+}
+
+void RetryPolicy::resetStats() {
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+unsigned long RetryPolicy::backoffFor(uint8_t attempt) const {
+    // Exponential growth, capped, then "equal jitter": half fixed, half random,
+    // so two masters that failed together do not retry in lockstep
+    unsigned long backoff = _backoffBaseMs;
+    for (uint8_t i = 1; i < attempt && backoff < _backoffMaxMs; i++) {
+        backoff *= 2;
+    }
+    if (backoff > _backoffMaxMs) {
+        backoff = _backoffMaxMs;
+    }
+
+    unsigned long half = backoff / 2;
+    return half + random(half + 1);
+}
+
+} // namespace xy_sk
@@ -0,0 +1,115 @@
+#ifndef XY_SKXXX_RETRY_H
+#define XY_SKXXX_RETRY_H
+
+#include <Arduino.h>
+#include "XY-SKxxx-rtu.h"
+
+namespace xy_sk {
+
+// Kind of bus operation, decides how safe a repeat is
+enum class OperationType : uint8_t {
+    READ = 0,   // Idempotent, repeating has no side effects
+    WRITE = 1   // Changes device state
+};
+
+// Failure classes a retry decision is based on
+enum class ErrorClass : uint8_t {
+    NONE = 0,       // Transaction succeeded
+    TIMEOUT = 1,    // No (complete) reply
+    CORRUPTED = 2,  // Reply arrived but was damaged: CRC, wrong slave/function, bad length
+    EXCEPTION = 3,  // Slave rejected the request, repeating gives the same answer
+    LOCAL = 4       // Request never left the master (invalid request, busy)
+};
+
+constexpr uint8_t ERROR_CLASS_COUNT = 5;
+
+/**
+ * Map an RTU transaction result to its error class
+ */
+ErrorClass classifyRtuStatus(RtuStatus status);
+
+// Counters kept by the retry policy
+struct RetryStats {
+    uint32_t operations;        // Operations run through the policy
+    uint32_t retries;           // Extra attempts made
+    uint32_t recovered;         // Operations that succeeded after at least one retry
+    uint32_t exhausted;         // Operations that failed after using all attempts
+    uint32_t deadlineExceeded;  // Operations stopped by the deadline budget
+    uint32_t failFast;          // Operations failed without retry because of the error class
+};
+
+/**
+ * Retry/backoff policy for bus operations
+ *
+ * Each (operation type, error class) pair has a maximum number of attempts.
+ * Between attempts the caller waits an exponential backoff with jitter,
+ * bounded by a maximum, and the whole operation is limited by a deadline
+ * budget so the worst-case latency of a call is known up front.
+ */
+class RetryPolicy {
+public:
+    RetryPolicy();
+
+    /**
+     * Set the total number of attempts (first try included) for a case
+     *
+     * @param type Read or write operation
+     * @param errorClass Failure class of the previous attempt
+     * @param attempts 1 fails fast, 0 is treated as 1
+     */
+    void setMaxAttempts(OperationType type, ErrorClass errorClass, uint8_t attempts);
+    uint8_t getMaxAttempts(OperationType type, ErrorClass errorClass) const;
+
+    /**
+     * Configure the backoff between attempts
+     *
+     * @param baseMs Wait before the second attempt, doubled for each further attempt
+     * @param maxMs Upper bound of a single wait
+     */
+    void setBackoff(unsigned long baseMs, unsigned long maxMs);
+
+    /**
+     * Set the time budget of one operation including all retries (0 = unlimited)
+     */
+    void setDeadline(unsigned long deadlineMs) { _deadlineMs = deadlineMs; }
+    unsigned long getDeadline() const { return _deadlineMs; }
+
+    /**
+     * Decide whether a failed attempt should be repeated
+     *
+     * @param type Read or write operation
+     * @param status Result of the attempt that just finished
+     * @param attempt Number of attempts made so far (1 after the first)
+     * @param elapsedMs Time spent on the operation so far
+     * @param backoffMs Receives the wait before the next attempt
+     * @return true if the caller should wait backoffMs and try again
+     */
+    bool shouldRetry(OperationType type, RtuStatus status, uint8_t attempt,
+                     unsigned long elapsedMs, unsigned long& backoffMs);
+
+    /**
+     * Time left for the next attempt, 0 if there is no deadline
+     */
+    unsigned long remainingBudget(unsigned long elapsedMs) const;
+
+    /**
+     * Record the final outcome of an operation
+     */
+    void recordOutcome(bool success, uint8_t attempts);
+
+    const RetryStats& getStats() const { return _stats; }
+    void resetStats();
+
+private:
+    unsigned long backoffFor(uint8_t attempt) const;
+
+    uint8_t _maxAttempts[2][ERROR_CLASS_COUNT];
+    unsigned long _backoffBaseMs;
+    unsigned long _backoffMaxMs;
+    unsigned long _deadlineMs;
+    RetryStats _stats;
+};
+
+} // namespace xy_sk
+
+#endif // XY_SKXXX_RETRY_H
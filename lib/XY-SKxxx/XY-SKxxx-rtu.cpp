@@ -0,0 +1,410 @@
+#include "XY-SKxxx-rtu.h"
+
+namespace xy_sk {
+
+namespace {
+
+// CRC16 lookup table for the reflected Modbus polynomial 0xA001
+const uint16_t CRC16_TABLE[256] = {
+    0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+    0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+    0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+    0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+    0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+    0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+    0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+    0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+    0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+    0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+    0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+    0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+    0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+    0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+    0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+    0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+    0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+    0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+    0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+    0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+    0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+    0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+    0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+    0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+    0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+    0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+    0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+    0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+    0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+    0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+    0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+    0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040,
+};
+
+inline void putWord(uint8_t* frame, uint16_t& pos, uint16_t value) {
+    frame[pos++] = static_cast<uint8_t>(value >> 8);
+    frame[pos++] = static_cast<uint8_t>(value & 0xFF);
+}
+
+inline bool isReadFunction(RtuFunction function) {
+    return function == RtuFunction::READ_HOLDING_REGISTERS ||
+           function == RtuFunction::READ_INPUT_REGISTERS ||
+           function == RtuFunction::READ_WRITE_MULTIPLE_REGISTERS;
+}
+
+} // namespace
+
+uint16_t rtuCrc16Update(uint16_t crc, uint8_t value) {
+    return (crc >> 8) ^ CRC16_TABLE[(crc ^ value) & 0xFF];
+}
+
+uint16_t rtuCrc16(const uint8_t* data, size_t length, uint16_t crc) {
+    for (size_t i = 0; i < length; i++) {
+        crc = (crc >> 8) ^ CRC16_TABLE[(crc ^ data[i]) & 0xFF];
+    }
+    return crc;
+}
+
+RtuMaster::RtuMaster()
+    : _port(nullptr), _baudRate(115200), _responseTimeout(2000), _replyStartTimeout(0), _turnaroundDelay(10),
+      _preTransmission(nullptr), _postTransmission(nullptr), _callbackContext(nullptr),
+      _state(State::IDLE), _txLength(0), _rxCount(0), _rxExpected(0), _rxCrc(0xFFFF),
+      _rxCrcLow(0), _rxHighByte(0), _startMicros(0), _sentMicros(0), _cpuMicros(0),
+      _timeoutMicros(0), _replyFrameMicros(0) {
+    memset(&_request, 0, sizeof(_request));
+    memset(_rxHeader, 0, sizeof(_rxHeader));
+    resetStats();
+}
+
+void RtuMaster::begin(Stream& port, unsigned long baudRate) {
+    _port = &port;
+    setBaudRate(baudRate);
+    _state = State::IDLE;
+}
+
+void RtuMaster::setBaudRate(unsigned long baudRate) {
+    if (baudRate > 0) {
+        _baudRate = baudRate;
+    }
+}
+
+void RtuMaster::setTransmissionCallbacks(TransmissionCallback pre, TransmissionCallback post, void* context) {
+    _preTransmission = pre;
+    _postTransmission = post;
+    _callbackContext = context;
+}
+
+unsigned long RtuMaster::frameTimeMicros(uint16_t bytes) const {
+    // 11 bits per character: start + 8 data + parity/stop + stop
+    return (unsigned long)(((uint64_t)bytes * 11UL * 1000000UL) / _baudRate);
+}
+
+void RtuMaster::resetStats() {
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+RtuStatus RtuMaster::readHoldingRegisters(uint8_t slave, uint16_t address, uint16_t count, uint16_t* dest) {
+    RtuRequest request = {slave, RtuFunction::READ_HOLDING_REGISTERS, address, count, dest, 0, 0, nullptr};
+    return execute(request);
+}
+
+RtuStatus RtuMaster::readInputRegisters(uint8_t slave, uint16_t address, uint16_t count, uint16_t* dest) {
+    RtuRequest request = {slave, RtuFunction::READ_INPUT_REGISTERS, address, count, dest, 0, 0, nullptr};
+    return execute(request);
+}
+
+RtuStatus RtuMaster::writeSingleRegister(uint8_t slave, uint16_t address, uint16_t value) {
+    RtuRequest request = {slave, RtuFunction::WRITE_SINGLE_REGISTER, 0, 0, nullptr, address, 1, &value};
+    return execute(request);
+}
+
+RtuStatus RtuMaster::writeMultipleRegisters(uint8_t slave, uint16_t address, uint16_t count, const uint16_t* src) {
+    RtuRequest request = {slave, RtuFunction::WRITE_MULTIPLE_REGISTERS, 0, 0, nullptr, address, count, src};
+    return execute(request);
+}
+
+RtuStatus RtuMaster::readWriteMultipleRegisters(uint8_t slave, uint16_t readAddress, uint16_t readCount, uint16_t* dest,
+                                                uint16_t writeAddress, uint16_t writeCount, const uint16_t* src) {
+    RtuRequest request = {slave, RtuFunction::READ_WRITE_MULTIPLE_REGISTERS, readAddress, readCount, dest,
+                          writeAddress, writeCount, src};
+    return execute(request);
+}
+
+RtuStatus RtuMaster::execute(const RtuRequest& request) {
+    RtuStatus status = start(request);
+    while (status == RtuStatus::PENDING) {
+        status = poll();
+        if (status == RtuStatus::PENDING) {
+            yield();
+        }
+    }
+    return status;
+}
+
+RtuStatus RtuMaster::start(const RtuRequest& request) {
+    if (_port == nullptr) {
+        return RtuStatus::INVALID_REQUEST;
+    }
+    if (_state != State::IDLE) {
+        return RtuStatus::BUSY;
+    }
+
+    unsigned long encodeStart = micros();
+    bool broadcast = (request.slave == RTU_BROADCAST_ADDRESS);
+
+    // Validate the request before touching the wire
+    if (request.slave > RTU_MAX_SLAVE_ADDRESS) {
+        return RtuStatus::INVALID_REQUEST;
+    }
+    if (isReadFunction(request.function)) {
+        if (broadcast || request.readBuffer == nullptr ||
+            request.readCount < 1 || request.readCount > RTU_MAX_READ_REGISTERS) {
+            return RtuStatus::INVALID_REQUEST;
+        }
+    }
+    switch (request.function) {
+        case RtuFunction::WRITE_SINGLE_REGISTER:
+            if (request.writeData == nullptr) {
+                return RtuStatus::INVALID_REQUEST;
+            }
+            break;
+        case RtuFunction::WRITE_MULTIPLE_REGISTERS:
+            if (request.writeData == nullptr || request.writeCount < 1 ||
+                request.writeCount > RTU_MAX_WRITE_REGISTERS) {
+                return RtuStatus::INVALID_REQUEST;
+            }
+            break;
+        case RtuFunction::READ_WRITE_MULTIPLE_REGISTERS:
+            if (request.writeData == nullptr || request.writeCount < 1 ||
+                request.writeCount > RTU_MAX_RW_WRITE_REGISTERS) {
+                return RtuStatus::INVALID_REQUEST;
+            }
+            break;
+        default:
+            break;
+    }
+
+    // Encode the request ADU
+    uint16_t pos = 0;
+    _txFrame[pos++] = request.slave;
+    _txFrame[pos++] = static_cast<uint8_t>(request.function);
+
+    switch (request.function) {
+        case RtuFunction::READ_HOLDING_REGISTERS:
+        case RtuFunction::READ_INPUT_REGISTERS:
+            putWord(_txFrame, pos, request.readAddress);
+            putWord(_txFrame, pos, request.readCount);
+            break;
+        case RtuFunction::WRITE_SINGLE_REGISTER:
+            putWord(_txFrame, pos, request.writeAddress);
+            putWord(_txFrame, pos, request.writeData[0]);
+            break;
+        case RtuFunction::WRITE_MULTIPLE_REGISTERS:
+            putWord(_txFrame, pos, request.writeAddress);
+            putWord(_txFrame, pos, request.writeCount);
+            _txFrame[pos++] = static_cast<uint8_t>(request.writeCount * 2);
+            for (uint16_t i = 0; i < request.writeCount; i++) {
+                putWord(_txFrame, pos, request.writeData[i]);
+            }
+            break;
+        case RtuFunction::READ_WRITE_MULTIPLE_REGISTERS:
+            putWord(_txFrame, pos, request.readAddress);
+            putWord(_txFrame, pos, request.readCount);
+            putWord(_txFrame, pos, request.writeAddress);
+            putWord(_txFrame, pos, request.writeCount);
+            _txFrame[pos++] = static_cast<uint8_t>(request.writeCount * 2);
+            for (uint16_t i = 0; i < request.writeCount; i++) {
+                putWord(_txFrame, pos, request.writeData[i]);
+            }
+            break;
+        default:
+            return RtuStatus::INVALID_REQUEST;
+    }
+
+    uint16_t crc = rtuCrc16(_txFrame, pos);
+    _txFrame[pos++] = static_cast<uint8_t>(crc & 0xFF);
+    _txFrame[pos++] = static_cast<uint8_t>(crc >> 8);
+    _txLength = pos;
+
+    // Drop stale bytes left over from an aborted or late reply
+    while (_port->available() > 0) {
+        _port->read();
+    }
+
+    _request = request;
+    _rxCount = 0;
+    _rxExpected = 0;
+    _rxCrc = 0xFFFF;
+
+    // Size the reply window for this slave and request
+    uint16_t replyBytes = isReadFunction(request.function) ? 5 + request.readCount * 2 : 8;
+    _replyFrameMicros = frameTimeMicros(replyBytes);
+    _timeoutMicros = _responseTimeout * 1000UL;
+    if (!broadcast && _adaptiveTimeout.isEnabled()) {
+        _timeoutMicros = _adaptiveTimeout.timeoutFor(request.slave, _replyFrameMicros, _timeoutMicros);
+    }
+    _cpuMicros = micros() - encodeStart;
+
+    if (_preTransmission) {
+        _preTransmission(_callbackContext);
+    }
+
+    _startMicros = micros();
+    _port->write(_txFrame, _txLength);
+    _port->flush();
+    _sentMicros = micros();
+
+    if (_postTransmission) {
+        _postTransmission(_callbackContext);
+    }
+
+    _state = broadcast ? State::BROADCAST_TURNAROUND : State::WAITING_REPLY;
+    return RtuStatus::PENDING;
+}
+
+RtuStatus RtuMaster::poll() {
+    if (_state == State::IDLE) {
+        return RtuStatus::INVALID_REQUEST;
+    }
+
+    if (_state == State::BROADCAST_TURNAROUND) {
+        // No reply will come, just give slaves time to execute the request
+        if (micros() - _sentMicros >= _turnaroundDelay * 1000UL) {
+            return finish(RtuStatus::SUCCESS);
+        }
+        return RtuStatus::PENDING;
+    }
+
+    int available = _port->available();
+    if (available > 0) {
+        unsigned long decodeStart = micros();
+        while (available-- > 0) {
+            int value = _port->read();
+            if (value < 0) {
+                break;
+            }
+            RtuStatus status = consume(static_cast<uint8_t>(value));
+            if (status != RtuStatus::PENDING) {
+                _cpuMicros += micros() - decodeStart;
+                return finish(status);
+            }
+        }
+        _cpuMicros += micros() - decodeStart;
+    }
+
+    unsigned long waited = micros() - _sentMicros;
+    if (waited >= _timeoutMicros || (_replyStartTimeout > 0 && _rxCount == 0 && waited >= _replyStartTimeout)) {
+        return finish(RtuStatus::RESPONSE_TIMED_OUT);
+    }
+    return RtuStatus::PENDING;
+}
+
+RtuStatus RtuMaster::consume(uint8_t value) {
+    uint16_t index = _rxCount++;
+
+    // The two trailing bytes carry the CRC, everything before is checksummed
+    if (_rxExpected != 0 && index >= _rxExpected - 2) {
+        if (index == _rxExpected - 2) {
+            _rxCrcLow = value;
+            return RtuStatus::PENDING;
+        }
+        uint16_t received = static_cast<uint16_t>(_rxCrcLow) | (static_cast<uint16_t>(value) << 8);
+        if (received != _rxCrc) {
+            return RtuStatus::INVALID_CRC;
+        }
+        if (_rxHeader[1] & 0x80) {
+            return rtuExceptionStatus(_rxHeader[2]);
+        }
+        if (isReadFunction(_request.function)) {
+            memcpy(_request.readBuffer, _rxWords, _request.readCount * sizeof(uint16_t));
+        }
+        return RtuStatus::SUCCESS;
+    }
+
+    _rxCrc = rtuCrc16Update(_rxCrc, value);
+    if (index < sizeof(_rxHeader)) {
+        _rxHeader[index] = value;
+    }
+
+    const uint8_t function = static_cast<uint8_t>(_request.function);
+
+    if (index == 0) {
+        if (value != _request.slave) {
+            return RtuStatus::INVALID_SLAVE_ID;
+        }
+    } else if (index == 1) {
+        if (value == (function | 0x80)) {
+            _rxExpected = 5; // Address, function, exception code, CRC
+        } else if (value != function) {
+            return RtuStatus::INVALID_FUNCTION;
+        } else if (!isReadFunction(_request.function)) {
+            _rxExpected = 8; // Write replies echo address and value/quantity
+        }
+    } else if (_rxHeader[1] & 0x80) {
+        // Exception code, kept in the header
+    } else if (isReadFunction(_request.function)) {
+        if (index == 2) {
+            if (value != _request.readCount * 2) {
+                return RtuStatus::INVALID_RESPONSE;
+            }
+            _rxExpected = 3 + value + 2;
+        } else {
+            // Decode register words, the caller's buffer only gets them after the CRC
+            uint16_t offset = index - 3;
+            if ((offset & 1) == 0) {
+                _rxHighByte = value;
+            } else {
+                _rxWords[offset >> 1] = (static_cast<uint16_t>(_rxHighByte) << 8) | value;
+            }
+        }
+    } else if (index == 5) {
+        // FC06 echoes address and value, FC16 echoes address and quantity
+        uint16_t echoAddress = (static_cast<uint16_t>(_rxHeader[2]) << 8) | _rxHeader[3];
+        uint16_t echoValue = (static_cast<uint16_t>(_rxHeader[4]) << 8) | _rxHeader[5];
+        uint16_t expectedValue = (_request.function == RtuFunction::WRITE_SINGLE_REGISTER)
+                                     ? _request.writeData[0] : _request.writeCount;
+        if (echoAddress != _request.writeAddress || echoValue != expectedValue) {
+            return RtuStatus::INVALID_RESPONSE;
+        }
+    }
+
+    return RtuStatus::PENDING;
+}
+
+RtuStatus RtuMaster::finish(RtuStatus status) {
+    uint32_t latency = micros() - _startMicros;
+
+    _stats.transactions++;
+    _stats.lastCpuMicros = _cpuMicros;
+    _stats.totalCpuMicros += _cpuMicros;
+    _stats.lastLatencyMicros = latency;
+    _stats.totalLatencyMicros += latency;
+    if (latency > _stats.maxLatencyMicros) {
+        _stats.maxLatencyMicros = latency;
+    }
+    if (_request.slave == RTU_BROADCAST_ADDRESS) {
+        _stats.broadcasts++;
+    } else if (_adaptiveTimeout.isEnabled()) {
+        // A complete reply, even an exception or a corrupted one, shows how fast the slave answers
+        if (status == RtuStatus::RESPONSE_TIMED_OUT) {
+            _adaptiveTimeout.recordTimeout(_request.slave);
+        } else if (status == RtuStatus::SUCCESS || status == RtuStatus::INVALID_CRC || isRtuException(status)) {
+            _adaptiveTimeout.recordReply(_request.slave, micros() - _sentMicros, _replyFrameMicros);
+        }
+    }
+
+    if (status != RtuStatus::SUCCESS) {
+        _stats.failures++;
+        if (status == RtuStatus::RESPONSE_TIMED_OUT) {
+            _stats.timeouts++;
+        } else if (status == RtuStatus::INVALID_CRC) {
+            _stats.crcErrors++;
+        } else if (isRtuException(status)) {
+            _stats.exceptions++;
+        }
+    }
+
+    _state = State::IDLE;
+    return status;
+}
+
+} // namespace xy_sk
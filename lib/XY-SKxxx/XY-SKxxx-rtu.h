@@ -0,0 +1,250 @@
+#ifndef XY_SKXXX_RTU_H
+#define XY_SKXXX_RTU_H
+
+#include <Arduino.h>
+#include "XY-SKxxx-timeout.h"
+
+namespace xy_sk {
+
+// Protocol limits (Modbus Application Protocol v1.1b3, section 6)
+constexpr uint8_t RTU_BROADCAST_ADDRESS = 0;          // Slave 0: every slave executes, nobody replies
+constexpr uint8_t RTU_MAX_SLAVE_ADDRESS = 247;
+constexpr uint16_t RTU_MAX_READ_REGISTERS = 125;      // FC03 / FC04
+constexpr uint16_t RTU_MAX_WRITE_REGISTERS = 123;     // FC16
+constexpr uint16_t RTU_MAX_RW_WRITE_REGISTERS = 121;  // FC23 write part
+constexpr uint16_t RTU_MAX_ADU_SIZE = 256;            // Largest RTU frame incl. address and CRC
+
+// Supported function codes
+enum class RtuFunction : uint8_t {
+    READ_HOLDING_REGISTERS        = 0x03,
+    READ_INPUT_REGISTERS          = 0x04,
+    WRITE_SINGLE_REGISTER         = 0x06,
+    WRITE_MULTIPLE_REGISTERS      = 0x10,
+    READ_WRITE_MULTIPLE_REGISTERS = 0x17
+};
+
+// Transaction result codes.
+// 0x01-0x0B are Modbus exception codes reported by the slave, 0xE0-0xE3 match
+// the values ModbusMaster used for its ku8MB* constants so logs stay comparable.
+enum class RtuStatus : uint8_t {
+    SUCCESS                  = 0x00,
+    ILLEGAL_FUNCTION         = 0x01,
+    ILLEGAL_DATA_ADDRESS     = 0x02,
+    ILLEGAL_DATA_VALUE       = 0x03,
+    SLAVE_DEVICE_FAILURE     = 0x04,
+    ACKNOWLEDGE              = 0x05,
+    SLAVE_DEVICE_BUSY        = 0x06,
+    MEMORY_PARITY_ERROR      = 0x08,
+    GATEWAY_PATH_UNAVAILABLE = 0x0A,
+    GATEWAY_TARGET_FAILED    = 0x0B,
+    INVALID_SLAVE_ID         = 0xE0, // Reply came from a different slave
+    INVALID_FUNCTION         = 0xE1, // Reply function code does not match the request
+    RESPONSE_TIMED_OUT       = 0xE2,
+    INVALID_CRC              = 0xE3,
+    INVALID_RESPONSE         = 0xE4, // Wrong byte count or write echo mismatch
+    INVALID_REQUEST          = 0xE5, // Request rejected locally (bad count, broadcast read...)
+    BUSY                     = 0xE6, // Another transaction is still in flight
+    UNKNOWN_EXCEPTION        = 0xE7, // Exception response with a code outside 0x01-0x0B
+    PENDING                  = 0xFF  // Non-blocking transaction not finished yet
+};
+
+/**
+ * Check whether a status is an exception code returned by the slave
+ */
+inline bool isRtuException(RtuStatus status) {
+    return (static_cast<uint8_t>(status) >= 0x01 && static_cast<uint8_t>(status) <= 0x0B) ||
+           status == RtuStatus::UNKNOWN_EXCEPTION;
+}
+
+/**
+ * Status for the exception code of an exception response; codes outside
+ * the Modbus range would read as success or as one of the local results
+ */
+inline RtuStatus rtuExceptionStatus(uint8_t code) {
+    return (code >= 0x01 && code <= 0x0B) ? static_cast<RtuStatus>(code) : RtuStatus::UNKNOWN_EXCEPTION;
+}
+
+/**
+ * Table-driven Modbus CRC16 (polynomial 0xA001, initial value 0xFFFF)
+ *
+ * @param data Bytes to checksum
+ * @param length Number of bytes
+ * @param crc Running CRC value, pass the previous result to continue a checksum
+ * @return CRC16 with the low byte transmitted first
+ */
+uint16_t rtuCrc16(const uint8_t* data, size_t length, uint16_t crc = 0xFFFF);
+
+/**
+ * Update a running CRC16 with a single byte
+ */
+uint16_t rtuCrc16Update(uint16_t crc, uint8_t value);
+
+// Description of one master request. Register data is read from the caller's
+// buffer directly; read replies are staged until their CRC has been checked.
+struct RtuRequest {
+    uint8_t slave;
+    RtuFunction function;
+    uint16_t readAddress;      // FC03/FC04/FC23
+    uint16_t readCount;
+    uint16_t* readBuffer;      // Receives readCount words on success, must stay valid until the transaction ends
+    uint16_t writeAddress;     // FC06/FC16/FC23
+    uint16_t writeCount;       // 1 for FC06
+    const uint16_t* writeData; // writeCount words
+};
+
+// Per-master transaction counters
+struct RtuStats {
+    uint32_t transactions;      // Completed transactions (any result)
+    uint32_t failures;          // Transactions that did not return SUCCESS
+    uint32_t timeouts;
+    uint32_t crcErrors;
+    uint32_t exceptions;        // Exception responses from slaves
+    uint32_t broadcasts;
+    uint32_t lastCpuMicros;     // CPU time spent encoding/decoding the last transaction
+    uint32_t totalCpuMicros;
+    uint32_t lastLatencyMicros; // Request start to last response byte
+    uint32_t maxLatencyMicros;
+    uint32_t totalLatencyMicros;
+};
+
+/**
+ * Minimal Modbus RTU master
+ *
+ * Encodes requests straight into a single transmit frame and decodes the
+ * reply byte-by-byte while it arrives: the CRC is updated incrementally and
+ * register words are decoded into a receive buffer as soon as both bytes
+ * are in. They are copied to the caller's buffer once the CRC matched, a
+ * corrupted reply never touches it. The blocking helpers are built on a start()/poll() pair that can
+ * also be driven from a cooperative loop or a task.
+ */
+class RtuMaster {
+public:
+    typedef void (*TransmissionCallback)(void* context);
+
+    RtuMaster();
+
+    /**
+     * Attach the master to a serial port that is already configured
+     *
+     * @param port Serial port used for the RS485/TTL link
+     * @param baudRate Line speed, used for frame timing
+     */
+    void begin(Stream& port, unsigned long baudRate);
+
+    /**
+     * Update frame timing after the line speed changed
+     */
+    void setBaudRate(unsigned long baudRate);
+    unsigned long getBaudRate() const { return _baudRate; }
+
+    /**
+     * Set the response timeout in milliseconds (default 2000 ms)
+     *
+     * With adaptive timeouts enabled this is the ceiling, used for slaves
+     * that have no round-trip history yet.
+     */
+    void setResponseTimeout(unsigned long timeoutMs) { _responseTimeout = timeoutMs; }
+    unsigned long getResponseTimeout() const { return _responseTimeout; }
+
+    /**
+     * Fail a transaction early when no reply byte at all has arrived this
+     * long after the request was sent (0 disables, default). Used by bus
+     * scans, where most addresses never answer.
+     */
+    void setReplyStartTimeout(unsigned long timeoutMicros) { _replyStartTimeout = timeoutMicros; }
+    unsigned long getReplyStartTimeout() const { return _replyStartTimeout; }
+
+    /**
+     * Per-slave timeout estimator, enabled by default
+     */
+    AdaptiveTimeout& adaptiveTimeout() { return _adaptiveTimeout; }
+    const AdaptiveTimeout& adaptiveTimeout() const { return _adaptiveTimeout; }
+
+    /**
+     * Set how long to keep the line idle after a broadcast (default 10 ms)
+     */
+    void setTurnaroundDelay(unsigned long delayMs) { _turnaroundDelay = delayMs; }
+
+    /**
+     * Register callbacks run right before the request is written and right
+     * after it has left the UART (used for DE/RE control and bus timing)
+     */
+    void setTransmissionCallbacks(TransmissionCallback pre, TransmissionCallback post, void* context);
+
+    // Blocking helpers - return once the transaction is finished
+    RtuStatus readHoldingRegisters(uint8_t slave, uint16_t address, uint16_t count, uint16_t* dest);
+    RtuStatus readInputRegisters(uint8_t slave, uint16_t address, uint16_t count, uint16_t* dest);
+    RtuStatus writeSingleRegister(uint8_t slave, uint16_t address, uint16_t value);
+    RtuStatus writeMultipleRegisters(uint8_t slave, uint16_t address, uint16_t count, const uint16_t* src);
+    RtuStatus readWriteMultipleRegisters(uint8_t slave, uint16_t readAddress, uint16_t readCount, uint16_t* dest,
+                                         uint16_t writeAddress, uint16_t writeCount, const uint16_t* src);
+
+    /**
+     * Run a request to completion
+     */
+    RtuStatus execute(const RtuRequest& request);
+
+    /**
+     * Encode and send a request without waiting for the reply
+     *
+     * @return PENDING if the request is on the wire, otherwise the reason it was rejected
+     */
+    RtuStatus start(const RtuRequest& request);
+
+    /**
+     * Consume received bytes of the transaction in flight
+     *
+     * @return PENDING while waiting, otherwise the final transaction result
+     */
+    RtuStatus poll();
+
+    bool isBusy() const { return _state != State::IDLE; }
+
+    const RtuStats& getStats() const { return _stats; }
+    void resetStats();
+
+    /**
+     * Time needed to transmit the given number of bytes at the current baud rate
+     */
+    unsigned long frameTimeMicros(uint16_t bytes) const;
+
+private:
+    enum class State : uint8_t { IDLE, WAITING_REPLY, BROADCAST_TURNAROUND };
+
+    RtuStatus finish(RtuStatus status);
+    RtuStatus consume(uint8_t value);
+
+    Stream* _port;
+    unsigned long _baudRate;
+    unsigned long _responseTimeout;
+    unsigned long _replyStartTimeout;  // Microseconds, 0 = disabled
+    unsigned long _turnaroundDelay;
+    TransmissionCallback _preTransmission;
+    TransmissionCallback _postTransmission;
+    void* _callbackContext;
+
+    // Transaction in flight
+    State _state;
+    RtuRequest _request;
+    uint8_t _txFrame[RTU_MAX_ADU_SIZE];
+    uint16_t _txLength;
+    uint16_t _rxCount;       // Bytes received so far
+    uint16_t _rxExpected;    // Full reply length once known, 0 before
+    uint16_t _rxCrc;         // Running CRC over the reply
+    uint8_t _rxHeader[6];    // Address, function and the first payload bytes
+    uint8_t _rxCrcLow;
+    uint8_t _rxHighByte;     // First byte of a register word being decoded
+    uint16_t _rxWords[RTU_MAX_READ_REGISTERS]; // Decoded register words, copied out after the CRC
+    unsigned long _startMicros;  // Before the request was written
+    unsigned long _sentMicros;   // After the request left the UART
+    uint32_t _cpuMicros;
+    unsigned long _timeoutMicros;    // Timeout applied to this transaction
+    unsigned long _replyFrameMicros; // Wire time of the expected reply
+
+    RtuStats _stats;
+    AdaptiveTimeout _adaptiveTimeout;
+};
+
+} // namespace xy_sk
+
+#endif // XY_SKXXX_RTU_H
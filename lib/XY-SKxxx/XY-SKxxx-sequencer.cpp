@@ -0,0 +1,332 @@
+#include "XY-SKxxx-internal.h"
+#include "XY-SKxxx-sequencer.h"
+
+XY_SKxxxSequencer::XY_SKxxxSequencer(XY_SKxxx& device)
+  : _device(device), _count(0), _repeat(1), _rampIntervalMs(100), _settleMs(20),
+    _callback(nullptr), _callbackContext(nullptr), _state(SEQ_IDLE), _step(0), _point(0), _cycle(0),
+    _stepStart(0), _nextDue(0), _readbackDue(0), _readbackPending(false), _finishing(false), _start(0),
+    _fromVoltage(0.0f), _fromCurrent(0.0f), _lastVoltage(0.0f), _lastCurrent(0.0f),
+    _lastMicros(0), _clockHigh(0) {
+  memset(_steps, 0, sizeof(_steps));
+  memset(&_sample, 0, sizeof(_sample));
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+XY_SKxxxSequencer::~XY_SKxxxSequencer() {
+  stop();
+#if defined(ESP32)
+  _task.join();
+#endif
+}
+
+void XY_SKxxxSequencer::clear() {
+  if (isRunning()) {
+    return;
+  }
+  _count = 0;
+  _state = SEQ_IDLE;
+}
+
+bool XY_SKxxxSequencer::addPoint(float voltage, float current, uint32_t dwellMs) {
+  if (isRunning() || _count >= SEQUENCER_MAX_STEPS) {
+    return false;
+  }
+  _steps[_count++] = {voltage, current, dwellMs, false};
+  return true;
+}
+
+bool XY_SKxxxSequencer::addRamp(float voltage, float current, uint32_t durationMs) {
+  if (isRunning() || _count >= SEQUENCER_MAX_STEPS) {
+    return false;
+  }
+  _steps[_count++] = {voltage, current, durationMs, true};
+  return true;
+}
+
+bool XY_SKxxxSequencer::addStaircase(float startVoltage, float stepVoltage, uint8_t steps, float current,
+                                     uint32_t dwellMs) {
+  if (isRunning() || steps == 0 || _count + steps > SEQUENCER_MAX_STEPS) {
+    return false;
+  }
+  for (uint8_t i = 0; i < steps; i++) {
+    _steps[_count++] = {startVoltage + stepVoltage * i, current, dwellMs, false};
+  }
+  return true;
+}
+
+void XY_SKxxxSequencer::setSampleCallback(SampleCallback callback, void* context) {
+  _callback = callback;
+  _callbackContext = context;
+}
+
+uint64_t XY_SKxxxSequencer::clockMicros() {
+  // micros() wraps every 71 minutes, burn-in profiles run longer
+  uint32_t now = micros();
+  if (now < _lastMicros) {
+    _clockHigh += 1ULL << 32;
+  }
+  _lastMicros = now;
+  return _clockHigh | now;
+}
+
+uint16_t XY_SKxxxSequencer::pointsOf(uint8_t step) const {
+  const SequenceStep& s = _steps[step];
+  if (!s.ramp) {
+    return 1;
+  }
+  uint32_t points = (s.durationMs + _rampIntervalMs - 1) / _rampIntervalMs;
+  return (points == 0) ? 1 : (points > 0xFFFF ? 0xFFFF : (uint16_t)points);
+}
+
+uint32_t XY_SKxxxSequencer::getTotalDurationMs() const {
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    total += _steps[i].durationMs;
+  }
+  return total * (_repeat == 0 ? 1 : _repeat);
+}
+
+uint32_t XY_SKxxxSequencer::getMeanJitterMicros() const {
+  return (_stats.updates == 0) ? 0 : (uint32_t)(_stats.totalJitterMicros / _stats.updates);
+}
+
+bool XY_SKxxxSequencer::start() {
+  if (isRunning() || _count == 0) {
+    return false;
+  }
+
+  const xy_sk::ModelInfo& model = _device.getModelInfo();
+  for (uint8_t i = 0; i < _count; i++) {
+    const SequenceStep& s = _steps[i];
+    if (s.voltage < 0.0f || s.voltage > model.maxVoltage || s.current < 0.0f || s.current > model.maxCurrent) {
+      return false;
+    }
+  }
+
+  // A ramp needs a known starting point; otherwise an unknown setpoint is
+  // simply written on the first update
+  bool known = _device.updateDeviceSettings(true);
+  if (!known && _steps[0].ramp) {
+    return false;
+  }
+  _fromVoltage = _device.getSetVoltage(false);
+  _fromCurrent = _device.getSetCurrent(false);
+  _lastVoltage = known ? _fromVoltage : -1.0f;
+  _lastCurrent = known ? _fromCurrent : -1.0f;
+
+  memset(&_stats, 0, sizeof(_stats));
+  memset(&_sample, 0, sizeof(_sample));
+  _stats.minJitterMicros = INT32_MAX;
+  _stats.maxJitterMicros = INT32_MIN;
+
+  _step = 0;
+  _point = 0;
+  _cycle = 0;
+  _readbackPending = false;
+  _finishing = false;
+  _start = clockMicros();
+  _stepStart = _start;
+  _nextDue = _start;
+  _state = SEQ_RUNNING;
+  return true;
+}
+
+void XY_SKxxxSequencer::stop() {
+  if (_state == SEQ_RUNNING) {
+    _state = SEQ_STOPPED;
+  }
+}
+
+bool XY_SKxxxSequencer::update() {
+  if (_state != SEQ_RUNNING) {
+    return false;
+  }
+
+  uint64_t now = clockMicros();
+  if (_readbackPending && now >= _readbackDue) {
+    readBack();
+    finishSample();
+    now = clockMicros();
+  }
+
+  if (now < _nextDue) {
+    return true;
+  }
+
+  // The previous update never got its read back
+  if (_readbackPending) {
+    _readbackPending = false;
+    _stats.missedReadbacks++;
+    finishSample();
+  }
+
+  if (_finishing) {
+    _state = SEQ_DONE;
+    return false;
+  }
+
+  float voltage, current;
+  computeSetpoint(voltage, current);
+
+  int32_t jitter = (int32_t)(now - _nextDue);
+  _stats.updates++;
+  _stats.totalJitterMicros += (uint32_t)jitter;
+  if (jitter < _stats.minJitterMicros) {
+    _stats.minJitterMicros = jitter;
+  }
+  if (jitter > _stats.maxJitterMicros) {
+    _stats.maxJitterMicros = jitter;
+  }
+
+  _sample.step = _step;
+  _sample.point = _point;
+  _sample.cycle = _cycle;
+  _sample.scheduledMs = (uint32_t)((_nextDue - _start) / 1000);
+  _sample.jitterMicros = jitter;
+  _sample.setVoltage = voltage;
+  _sample.setCurrent = current;
+  _sample.voltage = 0.0f;
+  _sample.current = 0.0f;
+  _sample.readBack = false;
+
+  if (!writeSetpoint(voltage, current)) {
+    _stats.writeFailures++;
+    _state = SEQ_FAILED;
+    finishSample();
+    return false;
+  }
+
+  if (_settleMs == 0) {
+    readBack();
+    finishSample();
+  } else {
+    _readbackPending = true;
+    _readbackDue = _nextDue + (uint64_t)_settleMs * 1000;
+  }
+
+  scheduleNext();
+  return true;
+}
+
+void XY_SKxxxSequencer::computeSetpoint(float& voltage, float& current) const {
+  const SequenceStep& s = _steps[_step];
+  if (!s.ramp) {
+    voltage = s.voltage;
+    current = s.current;
+    return;
+  }
+
+  // Each ramp update holds its value for one interval, the last one reaches the target
+  float fraction = (float)(_point + 1) / pointsOf(_step);
+  voltage = _fromVoltage + (s.voltage - _fromVoltage) * fraction;
+  current = _fromCurrent + (s.current - _fromCurrent) * fraction;
+}
+
+void XY_SKxxxSequencer::scheduleNext() {
+  _point++;
+  if (_point >= pointsOf(_step)) {
+    const SequenceStep& done = _steps[_step];
+    _fromVoltage = done.voltage;
+    _fromCurrent = done.current;
+    _stepStart += (uint64_t)done.durationMs * 1000;
+    _point = 0;
+    _step++;
+
+    if (_step >= _count) {
+      _step = 0;
+      _cycle++;
+      _stats.cycles = _cycle;
+      if (_repeat != 0 && _cycle >= _repeat) {
+        // Hold the last setpoint for its dwell, then finish
+        _finishing = true;
+        _nextDue = _stepStart;
+        return;
+      }
+    }
+  }
+
+  // Due times come from the step start, never from when the last write happened
+  const SequenceStep& s = _steps[_step];
+  _nextDue = _stepStart + (uint64_t)s.durationMs * 1000 * _point / pointsOf(_step);
+}
+
+bool XY_SKxxxSequencer::writeSetpoint(float voltage, float current) {
+  // Compare at register resolution and only write what changed
+  const xy_sk::ModelInfo& model = _device.getModelInfo();
+  bool voltageChanged = (int32_t)(voltage * model.voltageScale) != (int32_t)(_lastVoltage * model.voltageScale);
+  bool currentChanged = (int32_t)(current * model.currentScale) != (int32_t)(_lastCurrent * model.currentScale);
+
+  bool success = true;
+  if (voltageChanged && currentChanged) {
+    success = _device.setVoltageAndCurrent(voltage, current);
+  } else if (voltageChanged) {
+    success = _device.setVoltage(voltage);
+  } else if (currentChanged) {
+    success = _device.setCurrent(current);
+  }
+
+  if (success) {
+    _lastVoltage = voltage;
+    _lastCurrent = current;
+  }
+  return success;
+}
+
+void XY_SKxxxSequencer::readBack() {
+  _readbackPending = false;
+  float voltage, current, power;
+  if (_device.getOutput(voltage, current, power)) {
+    _sample.voltage = voltage;
+    _sample.current = current;
+    _sample.readBack = true;
+  } else {
+    _stats.readFailures++;
+  }
+}
+
+void XY_SKxxxSequencer::finishSample() {
+  if (_callback) {
+    _callback(_callbackContext, _sample);
+  }
+}
+
+uint64_t XY_SKxxxSequencer::microsUntilNextEvent() {
+  uint64_t now = clockMicros();
+  uint64_t next = (_readbackPending && _readbackDue < _nextDue) ? _readbackDue : _nextDue;
+  return (next > now) ? next - now : 0;
+}
+
+#if defined(ESP32)
+bool XY_SKxxxSequencer::startTask(UBaseType_t priority, BaseType_t core) {
+  if (_task.isRunning() || !start()) {
+    return false;
+  }
+
+  if (!_task.start("xy_sequencer", taskEntry, this, priority, core)) {
+    _state = SEQ_STOPPED;
+    return false;
+  }
+  return true;
+}
+
+void XY_SKxxxSequencer::taskEntry(void* context) {
+  XY_SKxxxSequencer* sequencer = static_cast<XY_SKxxxSequencer*>(context);
+  const uint64_t tickMicros = portTICK_PERIOD_MS * 1000ULL;
+  const uint64_t maxSleepMicros = 50000; // Notice stop() within 50 ms
+
+  while (sequencer->update()) {
+    // Sleep through most of the wait, spin the last tick for sub-ms timing
+    uint64_t wait = sequencer->microsUntilNextEvent();
+    if (wait > maxSleepMicros) {
+      wait = maxSleepMicros;
+    }
+    if (wait >= 2 * tickMicros) {
+      vTaskDelay((TickType_t)(wait / tickMicros) - 1);
+    } else if (wait > 0) {
+      delayMicroseconds((uint32_t)wait);
+    }
+  }
+
+  sequencer->_task.exit();
+}
+#endif
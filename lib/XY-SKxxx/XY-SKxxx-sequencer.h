@@ -0,0 +1,184 @@
+#ifndef XY_SKXXX_SEQUENCER_H
+#define XY_SKXXX_SEQUENCER_H
+
+#include <Arduino.h>
+#include "XY-SKxxx.h"
+#include "XY-SKxxx-task.h"
+
+#define SEQUENCER_MAX_STEPS 64
+
+// One entry of an output profile
+struct SequenceStep {
+  float voltage;        // Target voltage (V)
+  float current;        // Target current limit (A)
+  uint32_t durationMs;  // Dwell time, or ramp duration
+  bool ramp;            // Ramp linearly from the previous setpoint instead of jumping
+};
+
+// Result of one setpoint update
+struct SequenceSample {
+  uint8_t step;         // Profile index
+  uint16_t point;       // Update within a ramp, 0 for plain steps
+  uint16_t cycle;       // Repeat number, starting at 0
+  uint32_t scheduledMs; // Scheduled time since start()
+  int32_t jitterMicros; // Start of the write minus the scheduled time
+  float setVoltage;
+  float setCurrent;
+  float voltage;        // Output read back after the settle time
+  float current;
+  bool readBack;        // false if the next update was due before the read back
+};
+
+struct SequencerStats {
+  uint32_t updates;
+  uint32_t writeFailures;
+  uint32_t readFailures;
+  uint32_t missedReadbacks;
+  int32_t minJitterMicros;
+  int32_t maxJitterMicros;
+  uint64_t totalJitterMicros; // Sum of |jitter|, see getMeanJitterMicros()
+  uint16_t cycles;            // Completed repeats
+};
+
+enum SequencerState {
+  SEQ_IDLE = 0,
+  SEQ_RUNNING = 1,
+  SEQ_DONE = 2,
+  SEQ_STOPPED = 3,
+  SEQ_FAILED = 4    // A setpoint write failed, the output keeps its last setpoint
+};
+
+/**
+ * Output profile sequencer
+ *
+ * Runs a list of steps (plain dwells, linear ramps, staircases built from
+ * them) with optional repeats. Update times are computed from the start
+ * time rather than from the previous update, so bus latency shows up as
+ * jitter on one update instead of drifting the whole profile. Ramps are
+ * written as a staircase of setpoints every ramp interval. Only the
+ * setpoint that changed is written. After each update the output is read
+ * back once the settle time has passed.
+ *
+ * update() can be called from loop(); on ESP32 startTask() runs the
+ * profile in its own FreeRTOS task that sleeps until the next update, so
+ * the timing does not depend on what loop() is doing.
+ */
+class XY_SKxxxSequencer {
+public:
+  typedef void (*SampleCallback)(void* context, const SequenceSample& sample);
+
+  explicit XY_SKxxxSequencer(XY_SKxxx& device);
+  ~XY_SKxxxSequencer();
+  XY_SKxxxSequencer(const XY_SKxxxSequencer&) = delete;
+  XY_SKxxxSequencer& operator=(const XY_SKxxxSequencer&) = delete;
+
+  // Profile building, all return false when the profile is full or running
+  void clear();
+  bool addPoint(float voltage, float current, uint32_t dwellMs);
+  bool addRamp(float voltage, float current, uint32_t durationMs);
+  bool addStaircase(float startVoltage, float stepVoltage, uint8_t steps, float current, uint32_t dwellMs);
+  uint8_t size() const { return _count; }
+  const SequenceStep& getStep(uint8_t index) const { return _steps[index]; }
+
+  /**
+   * Number of passes through the profile, 0 repeats until stop()
+   */
+  void setRepeat(uint16_t count) { _repeat = count; }
+
+  /**
+   * Time between setpoint updates within a ramp (default 100 ms)
+   */
+  void setRampInterval(uint32_t intervalMs) { _rampIntervalMs = (intervalMs < 10) ? 10 : intervalMs; }
+
+  /**
+   * Delay between a setpoint update and its read back (default 20 ms)
+   */
+  void setSettleTime(uint32_t settleMs) { _settleMs = settleMs; }
+
+  /**
+   * Called for every update once its read back is done or skipped
+   */
+  void setSampleCallback(SampleCallback callback, void* context);
+
+  /**
+   * Check the profile against the model limits and start it
+   *
+   * Ramps in the first step start from the present setpoints.
+   */
+  bool start();
+  void stop();
+
+  /**
+   * Perform the read back or setpoint update that is due, if any
+   *
+   * @return true while the profile is running
+   */
+  bool update();
+
+#if defined(ESP32)
+  /**
+   * start() and run the profile in a dedicated FreeRTOS task
+   *
+   * The task ends when the profile is done, fails or is stopped. Sample
+   * callbacks then run in that task.
+   */
+  bool startTask(UBaseType_t priority = 2, BaseType_t core = -1);
+  bool isTaskRunning() const { return _task.isRunning(); }
+#endif
+
+  SequencerState getState() const { return _state; }
+  bool isRunning() const { return _state == SEQ_RUNNING; }
+  const SequencerStats& getStats() const { return _stats; }
+  uint32_t getMeanJitterMicros() const;
+  const SequenceSample& getLastSample() const { return _sample; }
+  uint32_t getTotalDurationMs() const;
+
+private:
+  uint64_t clockMicros();
+  uint16_t pointsOf(uint8_t step) const;
+  uint64_t microsUntilNextEvent();
+  void scheduleNext();
+  void computeSetpoint(float& voltage, float& current) const;
+  bool writeSetpoint(float voltage, float current);
+  void readBack();
+  void finishSample();
+
+#if defined(ESP32)
+  static void taskEntry(void* context);
+  xy_sk::HelperTask _task;
+#endif
+
+  XY_SKxxx& _device;
+  SequenceStep _steps[SEQUENCER_MAX_STEPS];
+  uint8_t _count;
+  uint16_t _repeat;
+  uint32_t _rampIntervalMs;
+  uint32_t _settleMs;
+  SampleCallback _callback;
+  void* _callbackContext;
+
+  // Run state
+  volatile SequencerState _state;
+  uint8_t _step;
+  uint16_t _point;
+  uint16_t _cycle;
+  uint64_t _stepStart;      // Scheduled start of the current step, clock micros
+  uint64_t _nextDue;        // Next setpoint update, clock micros
+  uint64_t _readbackDue;
+  bool _readbackPending;
+  bool _finishing;          // Last step written, waiting for its dwell to end
+  uint64_t _start;
+  float _fromVoltage;       // Setpoint a ramp starts from
+  float _fromCurrent;
+  float _lastVoltage;       // Setpoint last written
+  float _lastCurrent;
+
+  // 64-bit extension of micros()
+  uint32_t _lastMicros;
+  uint64_t _clockHigh;
+
+  SequenceSample _sample;
+  SequencerStats _stats;
+};
+
+#endif // XY_SKXXX_SEQUENCER_H
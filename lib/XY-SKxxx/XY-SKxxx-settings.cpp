@@ -12,16 +12,10 @@ bool XY_SKxxx::setSlaveAddress(uint8_t address) {
     return false; // Invalid Modbus address
   }
   
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.writeSingleRegister(REG_SLAVE_ADDR, address);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
+  if (writeRegister(REG_SLAVE_ADDR, address)) {
     // Update local slave ID (note: next communications will use new address)
     _slaveID = address;
-    // Re-initialize ModbusMaster with the new slave ID
-    modbus.begin(_slaveID, Serial1);
+    _bus->attach(_slaveID, staticPollCache, this, _pollWeight);
     return true;
   }
   
@@ -35,13 +29,9 @@ bool XY_SKxxx::setSlaveAddress(uint8_t address) {
  * @return true if successful
  */
 bool XY_SKxxx::getSlaveAddress(uint8_t &address) {
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.readHoldingRegisters(REG_SLAVE_ADDR, 1);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
-    address = modbus.getResponseBuffer(0);
+  uint16_t value;
+  if (readRegister(REG_SLAVE_ADDR, value)) {
+    address = value;
     return true;
   }
   
@@ -61,37 +51,17 @@ bool XY_SKxxx::setBaudRate(uint8_t baudRate) {
     return false; // Invalid baud rate code
   }
   
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.writeSingleRegister(REG_BAUDRATE_L, baudRate);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
+  if (writeRegister(REG_BAUDRATE_L, baudRate)) {
     // Convert code to actual baud rate
-    long newBaudRate;
-    switch (baudRate) {
-      case 0: newBaudRate = 9600; break;
-      case 1: newBaudRate = 14400; break;
-      case 2: newBaudRate = 19200; break;
-      case 3: newBaudRate = 38400; break;
-      case 4: newBaudRate = 56000; break;
-      case 5: newBaudRate = 576000; break;
-      case 6: newBaudRate = 115200; break;
-      case 7: newBaudRate = 2400; break;
-      case 8: newBaudRate = 4800; break;
-      default: return false;
+    long newBaudRate = baudRateFromCode(baudRate);
+    if (newBaudRate == 0) {
+      return false;
     }
     
     // Note: communication speed will change after this command
-    // Next operations will need to use the new baud rate
-    _baudRate = newBaudRate;
-    
-    // Update the Serial1 baud rate
-    Serial1.flush();
-    Serial1.begin(newBaudRate, SERIAL_8N1, _rxPin, _txPin);
-    
-    // Recalculate silent interval for new baud rate
-    _silentIntervalTime = silentInterval(newBaudRate);
+    // Next operations will need to use the new baud rate. The UART belongs
+    // to the bus, so every other slave on it must be switched as well.
+    _bus->setBaudRate(newBaudRate);
     
     return true;
   }
@@ -105,13 +75,9 @@ bool XY_SKxxx::setBaudRate(uint8_t baudRate) {
  * @return Baud rate code (0-8) or 255 on error
  */
 uint8_t XY_SKxxx::getBaudRateCode() {
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.readHoldingRegisters(REG_BAUDRATE_L, 1);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
-    return modbus.getResponseBuffer(0);
+  uint16_t value;
+  if (readRegister(REG_BAUDRATE_L, value)) {
+    return value;
   }
   
   return 255; // Error value
@@ -126,6 +92,16 @@ long XY_SKxxx::getActualBaudRate() {
   uint8_t code = getBaudRateCode();
   if (code == 255) return 0;
   
+  return baudRateFromCode(code);
+}
+
+/**
+ * Convert a REG_BAUDRATE_L code to a line speed
+ * 
+ * @param code Baud rate code (0-8)
+ * @return Baud rate in bps or 0 for an unknown code
+ */
+long XY_SKxxx::baudRateFromCode(uint8_t code) {
   switch (code) {
     case 0: return 9600;
     case 1: return 14400;
@@ -153,12 +129,7 @@ bool XY_SKxxx::setBacklightBrightness(uint8_t level) {
     level = 5; // Clamp to maximum
   }
   
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.writeSingleRegister(REG_B_LED, level);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
+  if (writeRegister(REG_B_LED, level)) {
     _status.backlightLevel = level;
     return true;
   }
@@ -172,13 +143,9 @@ bool XY_SKxxx::setBacklightBrightness(uint8_t level) {
  * @return Brightness level (0-5) or 255 on error
  */
 uint8_t XY_SKxxx::getBacklightBrightness() {
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.readHoldingRegisters(REG_B_LED, 1);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
-    _status.backlightLevel = modbus.getResponseBuffer(0);
+  uint16_t value;
+  if (readRegister(REG_B_LED, value)) {
+    _status.backlightLevel = value;
     return _status.backlightLevel;
   }
   
@@ -192,12 +159,7 @@ uint8_t XY_SKxxx::getBacklightBrightness() {
  * @return true if successful
  */
 bool XY_SKxxx::setSleepTimeout(uint8_t minutes) {
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.writeSingleRegister(REG_SLEEP, minutes);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
+  if (writeRegister(REG_SLEEP, minutes)) {
     _status.sleepTimeout = minutes;
     return true;
   }
@@ -211,13 +173,9 @@ bool XY_SKxxx::setSleepTimeout(uint8_t minutes) {
  * @return Sleep timeout in minutes or 255 on error
  */
 uint8_t XY_SKxxx::getSleepTimeout() {
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.readHoldingRegisters(REG_SLEEP, 1);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
-    _status.sleepTimeout = modbus.getResponseBuffer(0);
+  uint16_t value;
+  if (readRegister(REG_SLEEP, value)) {
+    _status.sleepTimeout = value;
     return _status.sleepTimeout;
   }
   
@@ -231,12 +189,7 @@ uint8_t XY_SKxxx::getSleepTimeout() {
  * @return true if successful
  */
 bool XY_SKxxx::setTemperatureUnit(bool celsius) {
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.writeSingleRegister(REG_F_C, celsius ? 1 : 0);
-  _lastCommsTime = millis();
-  
-  return (result == modbus.ku8MBSuccess);
+  return writeRegister(REG_F_C, celsius ? 1 : 0);
 }
 
 /**
@@ -246,13 +199,9 @@ bool XY_SKxxx::setTemperatureUnit(bool celsius) {
  * @return true if successful
  */
 bool XY_SKxxx::getTemperatureUnit(bool &celsius) {
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.readHoldingRegisters(REG_F_C, 1);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
-    celsius = (modbus.getResponseBuffer(0) != 0);
+  uint16_t value;
+  if (readRegister(REG_F_C, value)) {
+    celsius = (value != 0);
     return true;
   }
   
@@ -266,12 +215,11 @@ bool XY_SKxxx::getTemperatureUnit(bool &celsius) {
  * @return true if successful
  */
 bool XY_SKxxx::setMPPTEnable(bool enabled) {
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.writeSingleRegister(REG_MPPT_ENABLE, enabled ? 1 : 0);
-  _lastCommsTime = millis();
+  if (!hasFeature(xy_sk::FEATURE_MPPT)) {
+    return false;
+  }
   
-  return (result == modbus.ku8MBSuccess);
+  return writeRegister(REG_MPPT_ENABLE, enabled ? 1 : 0);
 }
 
 /**
@@ -281,6 +229,10 @@ bool XY_SKxxx::setMPPTEnable(bool enabled) {
  * @return true if successful
  */
 bool XY_SKxxx::getMPPTEnable(bool &enabled) {
+  if (!hasFeature(xy_sk::FEATURE_MPPT)) {
+    return false;
+  }
+  
   // Try from cache first, refresh if requested
   if (updateCalibrationSettings(false)) {
     enabled = _mpptEnabled;
@@ -288,12 +240,9 @@ bool XY_SKxxx::getMPPTEnable(bool &enabled) {
   }
   
   // If cache failed, read directly
-  waitForSilentInterval();
-  uint8_t result = modbus.readHoldingRegisters(REG_MPPT_ENABLE, 1);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
-    enabled = (modbus.getResponseBuffer(0) != 0);
+  uint16_t value;
+  if (readRegister(REG_MPPT_ENABLE, value)) {
+    enabled = (value != 0);
     _mpptEnabled = enabled;  // Update cache
     return true;
   }
@@ -308,6 +257,10 @@ bool XY_SKxxx::getMPPTEnable(bool &enabled) {
  * @return true if successful
  */
 bool XY_SKxxx::setMPPTThreshold(float threshold) {
+  if (!hasFeature(xy_sk::FEATURE_MPPT)) {
+    return false;
+  }
+  
   // Validate threshold range
   if (threshold < 0.0f || threshold > 1.0f) {
     return false; // Invalid threshold
@@ -315,12 +268,7 @@ bool XY_SKxxx::setMPPTThreshold(float threshold) {
   
   // Convert to integer representation (2 decimal places)
   uint16_t thresholdValue = (uint16_t)(threshold * 100);
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.writeSingleRegister(REG_MPPT_THRESHOLD, thresholdValue);
-  _lastCommsTime = millis();
-  
-  return (result == modbus.ku8MBSuccess);
+  return writeRegister(REG_MPPT_THRESHOLD, thresholdValue);
 }
 
 /**
@@ -330,6 +278,10 @@ bool XY_SKxxx::setMPPTThreshold(float threshold) {
  * @return true if successful
  */
 bool XY_SKxxx::getMPPTThreshold(float &threshold) {
+  if (!hasFeature(xy_sk::FEATURE_MPPT)) {
+    return false;
+  }
+  
   // Try from cache first
   if (updateCalibrationSettings(false)) {
     threshold = _mpptThreshold;
@@ -337,12 +289,9 @@ bool XY_SKxxx::getMPPTThreshold(float &threshold) {
   }
   
   // If cache failed, read directly
-  waitForSilentInterval();
-  uint8_t result = modbus.readHoldingRegisters(REG_MPPT_THRESHOLD, 1);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
-    threshold = modbus.getResponseBuffer(0) / 100.0f;
+  uint16_t value;
+  if (readRegister(REG_MPPT_THRESHOLD, value)) {
+    threshold = value / 100.0f;
     _mpptThreshold = threshold;  // Update cache
     return true;
   }
@@ -357,13 +306,16 @@ bool XY_SKxxx::getMPPTThreshold(float &threshold) {
  * @return true if successful
  */
 bool XY_SKxxx::setConstantPowerMode(bool enabled) {
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.writeSingleRegister(REG_CP_ENABLE, enabled ? 1 : 0);
-  _lastCommsTime = millis();
+  if (!hasFeature(xy_sk::FEATURE_CONSTANT_POWER)) {
+    return false;
+  }
   
-  if (result == modbus.ku8MBSuccess) {
+  if (writeRegister(REG_CP_ENABLE, enabled ? 1 : 0)) {
     _status.cpModeEnabled = enabled;
+    // The device CP mode and the emulated CR loop would fight over the output
+    if (enabled) {
+      _crEnabled = false;
+    }
     return true;
   }
   
@@ -377,13 +329,13 @@ bool XY_SKxxx::setConstantPowerMode(bool enabled) {
  * @return true if successful
  */
 bool XY_SKxxx::getConstantPowerMode(bool &enabled) {
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.readHoldingRegisters(REG_CP_ENABLE, 1);
-  _lastCommsTime = millis();
+  if (!hasFeature(xy_sk::FEATURE_CONSTANT_POWER)) {
+    return false;
+  }
   
-  if (result == modbus.ku8MBSuccess) {
-    enabled = (modbus.getResponseBuffer(0) != 0);
+  uint16_t value;
+  if (readRegister(REG_CP_ENABLE, value)) {
+    enabled = (value != 0);
     _status.cpModeEnabled = enabled;  // Update cache
     return true;
   }
@@ -398,10 +350,12 @@ bool XY_SKxxx::getConstantPowerMode(bool &enabled) {
  * @return true if CP mode is enabled
  */
 bool XY_SKxxx::isConstantPowerModeEnabled(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_CP_MODE_ENABLED, refresh);
   if (refresh) {
     bool enabled;
     getConstantPowerMode(enabled);
   }
+  endCacheAccess(CACHE_CP_MODE_ENABLED, refresh, mark);
   return _status.cpModeEnabled;
 }
 
@@ -412,18 +366,17 @@ bool XY_SKxxx::isConstantPowerModeEnabled(bool refresh) {
  * @return true if successful
  */
 bool XY_SKxxx::setConstantPower(float power) {
+  if (!hasFeature(xy_sk::FEATURE_CONSTANT_POWER)) {
+    return false;
+  }
+  
   if (power < 0.0f) {
     return false; // Invalid power value
   }
   
   // Convert to integer representation (1 decimal place)
   uint16_t powerValue = (uint16_t)(power * 10);
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.writeSingleRegister(REG_CP_SET, powerValue);
-  _lastCommsTime = millis();
-  
-  if (result == modbus.ku8MBSuccess) {
+  if (writeRegister(REG_CP_SET, powerValue)) {
     _status.constantPower = power;
     _lastConstantPowerUpdate = millis();
     return true;
@@ -439,13 +392,13 @@ bool XY_SKxxx::setConstantPower(float power) {
  * @return true if successful
  */
 bool XY_SKxxx::getConstantPower(float &power) {
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.readHoldingRegisters(REG_CP_SET, 1);
-  _lastCommsTime = millis();
+  if (!hasFeature(xy_sk::FEATURE_CONSTANT_POWER)) {
+    return false;
+  }
   
-  if (result == modbus.ku8MBSuccess) {
-    power = modbus.getResponseBuffer(0) / 10.0f;
+  uint16_t value;
+  if (readRegister(REG_CP_SET, value)) {
+    power = value / 10.0f;
     _status.constantPower = power;
     _lastConstantPowerUpdate = millis();
     return true;
@@ -461,9 +414,11 @@ bool XY_SKxxx::getConstantPower(float &power) {
  * @return Current Constant Power value (W)
  */
 float XY_SKxxx::getCachedConstantPower(bool refresh) {
+  uint32_t mark = beginCacheAccess(CACHE_CONSTANT_POWER, refresh);
   if (refresh) {
     updateConstantPowerSettings(true);
   }
+  endCacheAccess(CACHE_CONSTANT_POWER, refresh, mark);
   return _status.constantPower;
 }
 
@@ -474,10 +429,9 @@ float XY_SKxxx::getCachedConstantPower(bool refresh) {
  * @note The device will reset and may temporarily disconnect
  */
 bool XY_SKxxx::restoreFactoryDefaults() {
-  waitForSilentInterval();
-  
-  uint8_t result = modbus.writeSingleRegister(REG_FACTORY_RESET, 0x0001);
-  _lastCommsTime = millis();
+  if (!hasFeature(xy_sk::FEATURE_FACTORY_RESET)) {
+    return false;
+  }
   
-  return (result == modbus.ku8MBSuccess);
+  return writeRegister(REG_FACTORY_RESET, 0x0001);
 }
@@ -0,0 +1,195 @@
+#include "XY-SKxxx-internal.h"
+#include "XY-SKxxx-cd-data-group.h"
+
+// Unwanted registers a block read may carry to save a frame. A frame
+// costs the request, the reply header and the turnaround of the device,
+// more than 24 extra registers on the wire (4 ms at 115200 baud).
+#define SHADOW_MERGE_GAP 24
+
+#define SHADOW_BIT(bits, addr) ((bits)[(addr) >> 5] & (1UL << ((addr) & 31)))
+
+bool XY_SKxxx::isShadowReadable(uint16_t addr) const {
+  if (addr <= REG_EXTRACT_M) {
+    return true;
+  }
+  switch (addr) {
+    case REG_SYS_STATUS:
+      return hasFeature(xy_sk::FEATURE_SYSTEM_STATUS);
+    case REG_MPPT_ENABLE:
+    case REG_MPPT_THRESHOLD:
+      return hasFeature(xy_sk::FEATURE_MPPT);
+    case REG_BTF:
+      return hasFeature(xy_sk::FEATURE_BATTERY_CUTOFF);
+    case REG_CP_ENABLE:
+    case REG_CP_SET:
+      return hasFeature(xy_sk::FEATURE_CONSTANT_POWER);
+  }
+  // Memory groups M0-M9, 14 registers at the start of each 16 register slot
+  uint16_t offset = addr - xy_sk::DATA_GROUP_BASE_ADDR;
+  return addr >= xy_sk::DATA_GROUP_BASE_ADDR && offset < 10 * xy_sk::DATA_GROUP_SIZE &&
+         (offset % xy_sk::DATA_GROUP_SIZE) < xy_sk::DATA_GROUP_REGISTERS;
+}
+
+bool XY_SKxxx::isShadowCacheable(uint16_t addr) const {
+  // Measurements, protection and CV/CC state and the output switch (a
+  // protection trip turns it off) change without a write from us
+  if ((addr >= REG_VOUT && addr <= REG_T_EX) || (addr >= REG_PROTECT && addr <= REG_ONOFF) ||
+      addr == REG_SYS_STATUS) {
+    return false;
+  }
+  return addr < XY_SKXXX_SHADOW_SIZE && isShadowReadable(addr);
+}
+
+void XY_SKxxx::storeShadow(uint16_t addr, uint16_t count, const uint16_t* values) {
+  unsigned long now = millis();
+  for (uint16_t i = 0; i < count && addr + i < XY_SKXXX_SHADOW_SIZE; i++) {
+    uint16_t reg = addr + i;
+    _shadow[reg] = values[i];
+    _shadowTime[reg] = now;
+    _shadowValid[reg >> 5] |= 1UL << (reg & 31);
+  }
+}
+
+void XY_SKxxx::invalidateShadow(uint16_t addr, uint16_t count) {
+  for (uint16_t i = 0; i < count && addr + i < XY_SKXXX_SHADOW_SIZE; i++) {
+    uint16_t reg = addr + i;
+    _shadowValid[reg >> 5] &= ~(1UL << (reg & 31));
+  }
+}
+
+void XY_SKxxx::countWrite(uint16_t addr, uint16_t count) {
+  if (addr <= REG_ONOFF && addr + count > REG_ONOFF) {
+    _outputWrites++;
+  }
+}
+
+void XY_SKxxx::invalidateWriteSideEffects(uint16_t addr, uint16_t count) {
+  for (uint16_t reg = addr; reg < addr + count; reg++) {
+    switch (reg) {
+      case REG_V_SET:
+      case REG_I_SET:
+        // M0 holds the active CV/CC setpoints
+        invalidateShadow(REG_CV_SET + (reg - REG_V_SET), 1);
+        break;
+      case REG_CV_SET:
+      case REG_CC_SET:
+        invalidateShadow(REG_V_SET + (reg - REG_CV_SET), 1);
+        break;
+      case REG_EXTRACT_M:
+        // Calling a group copies it to M0 and the setpoints
+        invalidateShadow(REG_V_SET, 2);
+        invalidateShadow(xy_sk::DATA_GROUP_BASE_ADDR, xy_sk::DATA_GROUP_REGISTERS);
+        break;
+      case REG_FACTORY_RESET:
+        invalidateShadow();
+        break;
+    }
+  }
+}
+
+bool XY_SKxxx::getShadowRegisters(uint16_t addr, uint16_t count, uint16_t* buffer, unsigned long maxAge) const {
+  if (addr + count > XY_SKXXX_SHADOW_SIZE) {
+    return false;
+  }
+  unsigned long now = millis();
+  for (uint16_t reg = addr; reg < addr + count; reg++) {
+    if (!SHADOW_BIT(_shadowValid, reg) || now - _shadowTime[reg] >= maxAge) {
+      return false;
+    }
+  }
+  memcpy(buffer, &_shadow[addr], count * sizeof(uint16_t));
+  return true;
+}
+
+unsigned long XY_SKxxx::getShadowAge(uint16_t addr) const {
+  if (addr >= XY_SKXXX_SHADOW_SIZE || !SHADOW_BIT(_shadowValid, addr)) {
+    return XY_SKXXX_SHADOW_FOREVER;
+  }
+  return millis() - _shadowTime[addr];
+}
+
+bool XY_SKxxx::refreshShadow(uint16_t addr, uint16_t count, unsigned long maxAge) {
+  uint32_t wanted[XY_SKXXX_SHADOW_SIZE / 32];
+  memset(wanted, 0, sizeof(wanted));
+  unsigned long now = millis();
+  for (uint16_t reg = addr; reg < addr + count && reg < XY_SKXXX_SHADOW_SIZE; reg++) {
+    if (!SHADOW_BIT(_shadowValid, reg) || now - _shadowTime[reg] >= maxAge) {
+      wanted[reg >> 5] |= 1UL << (reg & 31);
+    }
+  }
+  return refreshShadowBits(wanted);
+}
+
+bool XY_SKxxx::refreshShadow(const uint16_t* registers, uint8_t count, unsigned long maxAge) {
+  uint32_t wanted[XY_SKXXX_SHADOW_SIZE / 32];
+  memset(wanted, 0, sizeof(wanted));
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < count; i++) {
+    uint16_t reg = registers[i];
+    if (reg < XY_SKXXX_SHADOW_SIZE && (!SHADOW_BIT(_shadowValid, reg) || now - _shadowTime[reg] >= maxAge)) {
+      wanted[reg >> 5] |= 1UL << (reg & 31);
+    }
+  }
+  return refreshShadowBits(wanted);
+}
+
+bool XY_SKxxx::refreshShadowBits(const uint32_t* wanted) {
+  uint16_t maxBlock = (_model->maxBlockRegisters < xy_sk::RTU_MAX_READ_REGISTERS)
+    ? _model->maxBlockRegisters : xy_sk::RTU_MAX_READ_REGISTERS;
+  bool success = true;
+
+  // The blocks of one refresh go out back to back
+  _bus->lock();
+  uint16_t addr = 0;
+  while (addr < XY_SKXXX_SHADOW_SIZE) {
+    if (!SHADOW_BIT(wanted, addr)) {
+      addr++;
+      continue;
+    }
+
+    // Grow the block over wanted registers and short readable gaps
+    uint16_t first = addr;
+    uint16_t last = addr;
+    for (uint16_t next = addr + 1; next < XY_SKXXX_SHADOW_SIZE && next - first < maxBlock; next++) {
+      if (SHADOW_BIT(wanted, next)) {
+        last = next;
+      } else if (next - last > SHADOW_MERGE_GAP || !isShadowReadable(next)) {
+        break;
+      }
+    }
+
+    success &= readShadowBlock(first, last, wanted);
+    addr = last + 1;
+  }
+  _bus->unlock();
+  return success;
+}
+
+bool XY_SKxxx::readShadowBlock(uint16_t first, uint16_t last, const uint32_t* wanted) {
+  uint16_t values[xy_sk::RTU_MAX_READ_REGISTERS];
+  if (readRegistersDirect(first, last - first + 1, values)) {
+    return true;
+  }
+  if (_lastError != xy_sk::RtuStatus::ILLEGAL_DATA_ADDRESS) {
+    return false;
+  }
+
+  // A gap register the device does not answer after all: read the wanted runs alone
+  bool success = true;
+  uint16_t reg = first;
+  while (reg <= last) {
+    if (!SHADOW_BIT(wanted, reg)) {
+      reg++;
+      continue;
+    }
+    uint16_t runStart = reg;
+    while (reg <= last && SHADOW_BIT(wanted, reg)) {
+      reg++;
+    }
+    if (runStart == first && reg == last + 1) {
+      return false; // Nothing was merged, the wanted registers themselves failed
+    }
+    success &= readRegistersDirect(runStart, reg - runStart, values);
+  }
+  return success;
+}
@@ -0,0 +1,273 @@
+#include "XY-SKxxx-internal.h"
+#include "XY-SKxxx-step.h"
+
+// Reads averaged for the output before the step
+#define STEP_BASELINE_SAMPLES 8
+
+XY_SKxxxStepResponse::XY_SKxxxStepResponse(XY_SKxxx& device)
+  : _device(device), _caseCount(0), _tolerance(0.02f), _settleMs(1000), _captureMs(1000), _running(false),
+    _stopRequested(false), _current(0), _prepared(false), _due(0), _resultCount(0) {
+  memset(_cases, 0, sizeof(_cases));
+  memset(_results, 0, sizeof(_results));
+}
+
+XY_SKxxxStepResponse::~XY_SKxxxStepResponse() {
+  stop();
+#if defined(ESP32)
+  _task.join();
+#endif
+  if (_running) {
+    finish();
+  }
+}
+
+bool XY_SKxxxStepResponse::addStep(StepQuantity quantity, float from, float to, float limit) {
+  const xy_sk::ModelInfo& model = _device.getModelInfo();
+  float max = (quantity == STEP_VOLTAGE) ? model.maxVoltage : model.maxCurrent;
+  float limitMax = (quantity == STEP_VOLTAGE) ? model.maxCurrent : model.maxVoltage;
+  if (_running || _caseCount >= STEP_MAX_CASES || from < 0.0f || to < 0.0f || from > max || to > max ||
+      from == to || limit < 0.0f || limit > limitMax) {
+    return false;
+  }
+  StepCase& step = _cases[_caseCount++];
+  step.quantity = quantity;
+  step.from = from;
+  step.to = to;
+  step.limit = limit;
+  return true;
+}
+
+uint8_t XY_SKxxxStepResponse::addMatrix(StepQuantity quantity, const float* levels, uint8_t levelCount,
+                                        const float* limits, uint8_t limitCount) {
+  uint8_t added = 0;
+  uint8_t conditions = (limits == nullptr || limitCount == 0) ? 1 : limitCount;
+  for (uint8_t c = 0; c < conditions; c++) {
+    float limit = (limits == nullptr || limitCount == 0) ? 0.0f : limits[c];
+    for (uint8_t i = 1; i < levelCount; i++) {
+      added += addStep(quantity, levels[i - 1], levels[i], limit) ? 1 : 0;
+    }
+    for (uint8_t i = levelCount - 1; i > 0; i--) {
+      added += addStep(quantity, levels[i], levels[i - 1], limit) ? 1 : 0;
+    }
+  }
+  return added;
+}
+
+void XY_SKxxxStepResponse::clearSteps() {
+  if (!_running) {
+    _caseCount = 0;
+  }
+}
+
+bool XY_SKxxxStepResponse::start() {
+  if (_running || _caseCount == 0) {
+    return false;
+  }
+
+  if (!_restore.save(_device)) {
+    return false;
+  }
+
+  memset(_results, 0, sizeof(_results));
+  _resultCount = 0;
+  _current = 0;
+  _prepared = false;
+  _stopRequested = false;
+  _running = true;
+  return true;
+}
+
+void XY_SKxxxStepResponse::stop() {
+  if (_running) {
+    _stopRequested = true;
+  }
+}
+
+bool XY_SKxxxStepResponse::update() {
+  if (!_running) {
+    return false;
+  }
+  if (_stopRequested || _current >= _caseCount) {
+    finish();
+    return false;
+  }
+
+  const StepCase& step = _cases[_current];
+  unsigned long now = millis();
+  if (!_prepared) {
+    if (!prepare(step)) {
+      // Reported as not valid, go on with the next case
+      _results[_resultCount++].step = step;
+      _current++;
+      return true;
+    }
+    _prepared = true;
+    _due = now + _settleMs;
+    return true;
+  }
+  if ((long)(now - _due) < 0) {
+    return true;
+  }
+
+  capture(step);
+  _prepared = false;
+  _current++;
+  return true;
+}
+
+bool XY_SKxxxStepResponse::prepare(const StepCase& step) {
+  if (step.limit > 0.0f && !writeSetpoint(step.quantity == STEP_VOLTAGE ? STEP_CURRENT : STEP_VOLTAGE, step.limit)) {
+    return false;
+  }
+  if (!writeSetpoint(step.quantity, step.from)) {
+    return false;
+  }
+  return _device.setOutputState(true);
+}
+
+bool XY_SKxxxStepResponse::writeSetpoint(StepQuantity quantity, float value) {
+  return (quantity == STEP_VOLTAGE) ? _device.setVoltage(value) : _device.setCurrent(value);
+}
+
+bool XY_SKxxxStepResponse::sample(StepQuantity quantity, float& value) {
+  // VOUT and IOUT in one transaction
+  uint16_t values[2];
+  if (!_device.readRegisters(REG_VOUT, 2, values)) {
+    return false;
+  }
+  const xy_sk::ModelInfo& model = _device.getModelInfo();
+  value = (quantity == STEP_VOLTAGE) ? values[0] / (float)model.voltageScale : values[1] / (float)model.currentScale;
+  return true;
+}
+
+void XY_SKxxxStepResponse::capture(const StepCase& step) {
+  StepResult& result = _results[_resultCount++];
+  result.step = step;
+
+  float value;
+  float sum = 0.0f;
+  uint8_t baseline = 0;
+  for (uint8_t i = 0; i < STEP_BASELINE_SAMPLES; i++) {
+    if (sample(step.quantity, value)) {
+      sum += value;
+      baseline++;
+    } else {
+      result.readFailures++;
+    }
+  }
+  if (baseline == 0) {
+    return;
+  }
+  result.initial = sum / baseline;
+
+  // Times count from sending the setpoint, not from its acknowledgement
+  uint32_t start = micros();
+  if (!writeSetpoint(step.quantity, step.to)) {
+    return;
+  }
+
+  uint16_t count = 0;
+  uint32_t window = _captureMs * 1000UL;
+  while (count < STEP_MAX_SAMPLES && (micros() - start) < window && !_stopRequested) {
+    if (sample(step.quantity, value)) {
+      _sampleMicros[count] = micros() - start;
+      _sampleValue[count] = value;
+      count++;
+    } else {
+      result.readFailures++;
+    }
+  }
+  analyze(result, count);
+}
+
+void XY_SKxxxStepResponse::analyze(StepResult& result, uint16_t count) {
+  result.samples = count;
+  if (count == 0) {
+    return;
+  }
+  result.sampleIntervalMs = _sampleMicros[count - 1] / 1000.0f / count;
+
+  // Final value from the last tenth of the capture
+  uint16_t tail = (count >= 10) ? count / 10 : 1;
+  float sum = 0.0f;
+  for (uint16_t i = count - tail; i < count; i++) {
+    sum += _sampleValue[i];
+  }
+  result.final = sum / tail;
+
+  const xy_sk::ModelInfo& model = _device.getModelInfo();
+  float lsb = 1.0f / ((result.step.quantity == STEP_VOLTAGE) ? model.voltageScale : model.currentScale);
+  float delta = result.final - result.initial;
+  float span = fabsf(delta);
+  result.valid = span > lsb && span >= 0.1f * fabsf(result.step.to - result.step.from);
+  if (!result.valid) {
+    return;
+  }
+
+  // Work on the response normalized to 0..1, rising for both step directions
+  float band = fmaxf(_tolerance * span, lsb) / span;
+  float t10 = -1.0f;
+  float t90 = -1.0f;
+  float peak = 0.0f;
+  int32_t lastOutside = -1;
+  float previousTime = 0.0f;
+  float previous = 0.0f;
+  for (uint16_t i = 0; i < count; i++) {
+    float time = _sampleMicros[i] / 1000.0f;
+    float y = (_sampleValue[i] - result.initial) / delta;
+    // Interpolate the crossings between samples
+    if (t10 < 0.0f && y >= 0.1f) {
+      t10 = previousTime + (0.1f - previous) * (time - previousTime) / (y - previous);
+    }
+    if (t90 < 0.0f && y >= 0.9f) {
+      t90 = previousTime + (0.9f - previous) * (time - previousTime) / (y - previous);
+    }
+    if (y > peak) {
+      peak = y;
+    }
+    if (fabsf(y - 1.0f) > band) {
+      lastOutside = i;
+    }
+    previousTime = time;
+    previous = y;
+  }
+
+  float end = _sampleMicros[count - 1] / 1000.0f;
+  result.delayMs = (t10 < 0.0f) ? end : t10;
+  result.riseMs = (t90 < 0.0f) ? end - result.delayMs : t90 - result.delayMs;
+  result.peak = result.initial + peak * delta;
+  result.overshootPercent = (peak > 1.0f) ? (peak - 1.0f) * 100.0f : 0.0f;
+  // Settled only if the output entered the band before the samples the final value came from
+  result.settled = lastOutside < (int32_t)(count - tail);
+  result.settlingMs = !result.settled ? end : (lastOutside < 0) ? _sampleMicros[0] / 1000.0f
+                                            : _sampleMicros[lastOutside + 1] / 1000.0f;
+}
+
+void XY_SKxxxStepResponse::finish() {
+  _restore.restore(_device);
+  _stopRequested = false;
+  _running = false;
+}
+
+#if defined(ESP32)
+bool XY_SKxxxStepResponse::startTask(UBaseType_t priority, BaseType_t core) {
+  if (_task.isRunning() || !start()) {
+    return false;
+  }
+
+  if (!_task.start("xy_step", taskTurn, this, priority, core)) {
+    finish();
+    return false;
+  }
+  return true;
+}
+
+bool XY_SKxxxStepResponse::taskTurn(void* context, uint32_t& sleepMs) {
+  XY_SKxxxStepResponse* test = static_cast<XY_SKxxxStepResponse*>(context);
+  if (!test->update()) {
+    return false;
+  }
+  sleepMs = xy_sk::HelperTask::msUntil(test->_due);
+  return true;
+}
+#endif
@@ -0,0 +1,153 @@
+#ifndef XY_SKXXX_STEP_H
+#define XY_SKXXX_STEP_H
+
+#include <Arduino.h>
+#include "XY-SKxxx.h"
+#include "XY-SKxxx-task.h"
+
+#define STEP_MAX_CASES 16
+#define STEP_MAX_SAMPLES 512
+
+// Setpoint that is stepped, and the output that is measured
+enum StepQuantity {
+  STEP_VOLTAGE = 0,  // V_SET, VOUT measured
+  STEP_CURRENT = 1   // I_SET, IOUT measured
+};
+
+struct StepCase {
+  StepQuantity quantity;
+  float from;               // V or A
+  float to;
+  float limit;              // Other setpoint during the step (I_SET for voltage steps), 0 = unchanged
+};
+
+struct StepResult {
+  StepCase step;
+  bool valid;               // The output moved by at least 10 % of the commanded step
+  bool settled;             // Stayed inside the tolerance band before the capture ended
+  float initial;            // Output before the step
+  float final;              // Output at the end of the capture
+  float peak;               // Largest excursion in the step direction
+  float delayMs;            // Step command to 10 % of the response
+  float riseMs;             // 10 % to 90 %
+  float overshootPercent;   // Peak beyond the final value, % of the step
+  float settlingMs;         // Step command to entering the tolerance band for good
+  uint16_t samples;
+  float sampleIntervalMs;   // Mean time between samples (bus rate)
+  uint16_t readFailures;
+};
+
+/**
+ * Step response characterization
+ *
+ * Runs a list of setpoint steps and measures how the output follows: for
+ * each case the output is held at the start value for the settle time,
+ * the new setpoint is written and VOUT/IOUT are read back to back (one
+ * two-register read each, so at the full bus rate) for the capture time.
+ * Times are measured from the moment the setpoint write is sent, so they
+ * include the Modbus latency a closed loop on the ESP32 sees.
+ *
+ * The "load condition" of a case is the other setpoint: the current limit
+ * for voltage steps, the voltage limit for current steps. The resistive
+ * load itself is whatever is connected. The output is switched on for the
+ * test; setpoints and the output state are restored when it ends.
+ *
+ * The capture of one case blocks update() for the capture time; on ESP32
+ * startTask() runs the whole matrix in its own task.
+ */
+class XY_SKxxxStepResponse {
+public:
+  explicit XY_SKxxxStepResponse(XY_SKxxx& device);
+  ~XY_SKxxxStepResponse();
+  XY_SKxxxStepResponse(const XY_SKxxxStepResponse&) = delete;
+  XY_SKxxxStepResponse& operator=(const XY_SKxxxStepResponse&) = delete;
+
+  // Test matrix, ignored while running
+  bool addStep(StepQuantity quantity, float from, float to, float limit = 0.0f);
+
+  /**
+   * Steps up through the levels and back down, once for each limit
+   * (or once with the limit unchanged when limits is nullptr)
+   *
+   * @return Number of cases added
+   */
+  uint8_t addMatrix(StepQuantity quantity, const float* levels, uint8_t levelCount,
+                    const float* limits = nullptr, uint8_t limitCount = 0);
+  void clearSteps();
+  uint8_t getStepCount() const { return _caseCount; }
+
+  /**
+   * Settling band, % of the step (default 2 %, at least one register count)
+   */
+  void setTolerance(float percent) { if (!_running && percent > 0.0f) _tolerance = percent / 100.0f; }
+  float getTolerance() const { return _tolerance * 100.0f; }
+
+  /**
+   * Time at the start value before the step (default 1000 ms) and time
+   * sampled after it (default 1000 ms, up to STEP_MAX_SAMPLES samples)
+   */
+  void setSettleTime(uint32_t ms) { if (!_running) _settleMs = ms; }
+  void setCaptureTime(uint32_t ms) { if (!_running && ms > 0) _captureMs = ms; }
+
+  /**
+   * Clear the previous report and start with the first case
+   */
+  bool start();
+  void stop();
+
+  /**
+   * Advance the test; a capture blocks for the capture time
+   *
+   * @return true while running
+   */
+  bool update();
+
+#if defined(ESP32)
+  bool startTask(UBaseType_t priority = 2, BaseType_t core = -1);
+  bool isTaskRunning() const { return _task.isRunning(); }
+#endif
+
+  bool isRunning() const { return _running; }
+  uint8_t getCurrentStep() const { return _current; }
+
+  // Report of the last run
+  uint8_t getResultCount() const { return _resultCount; }
+  const StepResult& getResult(uint8_t index) const { return _results[index]; }
+
+private:
+  bool prepare(const StepCase& step);
+  bool writeSetpoint(StepQuantity quantity, float value);
+  bool sample(StepQuantity quantity, float& value);
+  void capture(const StepCase& step);
+  void analyze(StepResult& result, uint16_t count);
+  void finish();
+
+#if defined(ESP32)
+  static bool taskTurn(void* context, uint32_t& sleepMs);
+  xy_sk::HelperTask _task;
+#endif
+
+  XY_SKxxx& _device;
+  StepCase _cases[STEP_MAX_CASES];
+  uint8_t _caseCount;
+  float _tolerance;
+  uint32_t _settleMs;
+  uint32_t _captureMs;
+
+  // Run state
+  volatile bool _running;
+  volatile bool _stopRequested;
+  uint8_t _current;         // Case being run
+  bool _prepared;           // Start value written, waiting for the settle time
+  unsigned long _due;
+  xy_sk::OutputSnapshot _restore; // Setpoints and output state before the test
+
+  // Capture of the running case
+  uint32_t _sampleMicros[STEP_MAX_SAMPLES];
+  float _sampleValue[STEP_MAX_SAMPLES];
+
+  StepResult _results[STEP_MAX_CASES];
+  uint8_t _resultCount;
+};
+
+#endif // XY_SKXXX_STEP_H
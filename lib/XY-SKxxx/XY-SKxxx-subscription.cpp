@@ -0,0 +1,187 @@
+#include "XY-SKxxx-internal.h"
+
+namespace {
+
+// Cache group that refreshes each field, indexed by StatusField
+const uint8_t FIELD_GROUP[FIELD_COUNT] = {
+  xy_sk::POLL_OUTPUT,         // FIELD_OUTPUT_VOLTAGE
+  xy_sk::POLL_OUTPUT,         // FIELD_OUTPUT_CURRENT
+  xy_sk::POLL_OUTPUT,         // FIELD_OUTPUT_POWER
+  xy_sk::POLL_OUTPUT,         // FIELD_INPUT_VOLTAGE
+  xy_sk::POLL_ENERGY,         // FIELD_AMP_HOURS
+  xy_sk::POLL_ENERGY,         // FIELD_WATT_HOURS
+  xy_sk::POLL_ENERGY,         // FIELD_OUTPUT_TIME
+  xy_sk::POLL_TEMPERATURES,   // FIELD_INTERNAL_TEMP
+  xy_sk::POLL_TEMPERATURES,   // FIELD_EXTERNAL_TEMP
+  xy_sk::POLL_STATE,          // FIELD_OUTPUT_ENABLED
+  xy_sk::POLL_STATE,          // FIELD_KEY_LOCKED
+  xy_sk::POLL_STATE,          // FIELD_PROTECTION_STATUS
+  xy_sk::POLL_STATE,          // FIELD_CVCC_MODE
+  xy_sk::POLL_STATE,          // FIELD_SYSTEM_STATUS
+  xy_sk::POLL_SETTINGS,       // FIELD_SET_VOLTAGE
+  xy_sk::POLL_SETTINGS,       // FIELD_SET_CURRENT
+  xy_sk::POLL_CONSTANT_POWER, // FIELD_CP_MODE_ENABLED
+  xy_sk::POLL_CONSTANT_POWER  // FIELD_CONSTANT_POWER
+};
+
+// Shared by both subscription kinds: true when value moved far enough from
+// the one last reported
+bool fieldChanged(float value, float lastValue, float deadband, bool reported) {
+  if (!reported) {
+    return true;
+  }
+  float change = fabsf(value - lastValue);
+  // Without a deadband any change counts, discrete fields use that
+  return deadband > 0.0f ? change >= deadband : change != 0.0f;
+}
+
+} // namespace
+
+float XY_SKxxx::getStatusField(StatusField field) const {
+  switch (field) {
+    case FIELD_OUTPUT_VOLTAGE:    return _status.outputVoltage;
+    case FIELD_OUTPUT_CURRENT:    return _status.outputCurrent;
+    case FIELD_OUTPUT_POWER:      return _status.outputPower;
+    case FIELD_INPUT_VOLTAGE:     return _status.inputVoltage;
+    case FIELD_AMP_HOURS:         return (float)_status.ampHours;
+    case FIELD_WATT_HOURS:        return (float)_status.wattHours;
+    case FIELD_OUTPUT_TIME:       return (float)_status.outputTime;
+    case FIELD_INTERNAL_TEMP:     return _status.internalTemp;
+    case FIELD_EXTERNAL_TEMP:     return _status.externalTemp;
+    case FIELD_OUTPUT_ENABLED:    return _status.outputEnabled ? 1.0f : 0.0f;
+    case FIELD_KEY_LOCKED:        return _status.keyLocked ? 1.0f : 0.0f;
+    case FIELD_PROTECTION_STATUS: return (float)_status.protectionStatus;
+    case FIELD_CVCC_MODE:         return (float)_status.cvccMode;
+    case FIELD_SYSTEM_STATUS:     return (float)_status.systemStatus;
+    case FIELD_SET_VOLTAGE:       return _status.setVoltage;
+    case FIELD_SET_CURRENT:       return _status.setCurrent;
+    case FIELD_CP_MODE_ENABLED:   return _status.cpModeEnabled ? 1.0f : 0.0f;
+    case FIELD_CONSTANT_POWER:    return _status.constantPower;
+    default:                      return 0.0f;
+  }
+}
+
+bool XY_SKxxx::addOutputSampleCallback(OutputSampleCallback callback, void* context) {
+  if (callback == nullptr) {
+    return false;
+  }
+  for (uint8_t i = 0; i < XY_SKXXX_MAX_SAMPLE_HOOKS; i++) {
+    if (_sampleHooks[i].callback == nullptr) {
+      _sampleHooks[i].callback = callback;
+      _sampleHooks[i].context = context;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool XY_SKxxx::removeOutputSampleCallback(OutputSampleCallback callback, void* context) {
+  for (uint8_t i = 0; i < XY_SKXXX_MAX_SAMPLE_HOOKS; i++) {
+    if (_sampleHooks[i].callback == callback && _sampleHooks[i].context == context) {
+      _sampleHooks[i].callback = nullptr;
+      return true;
+    }
+  }
+  return false;
+}
+
+void XY_SKxxx::setOutputSampleCallback(OutputSampleCallback callback, void* context) {
+  memset(_sampleHooks, 0, sizeof(_sampleHooks));
+  addOutputSampleCallback(callback, context);
+}
+
+int8_t XY_SKxxx::subscribe(StatusField field, StatusCallback callback, void* context, float deadband) {
+  if (callback == nullptr || field >= FIELD_COUNT) {
+    return -1;
+  }
+
+  for (uint8_t i = 0; i < XY_SKXXX_MAX_SUBSCRIPTIONS; i++) {
+    StatusSubscription& sub = _subscriptions[i];
+    if (sub.callback == nullptr) {
+      sub.callback = callback;
+      sub.context = context;
+      sub.field = field;
+      sub.deadband = fabsf(deadband);
+      sub.lastValue = 0.0f;
+      sub.reported = false;
+      return i;
+    }
+  }
+  return -1;
+}
+
+int8_t XY_SKxxx::subscribeFields(uint32_t fields, StatusCallback callback, void* context, const float* deadbands) {
+  fields &= STATUS_FIELD_BIT(FIELD_COUNT) - 1;
+  if (callback == nullptr || fields == 0) {
+    return -1;
+  }
+
+  for (uint8_t i = 0; i < XY_SKXXX_MAX_FIELD_SET_SUBSCRIPTIONS; i++) {
+    FieldSetSubscription& sub = _fieldSetSubscriptions[i];
+    if (sub.callback == nullptr) {
+      sub.callback = callback;
+      sub.context = context;
+      sub.fields = fields;
+      sub.reported = 0;
+      for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+        sub.deadbands[f] = (deadbands != nullptr) ? fabsf(deadbands[f]) : 0.0f;
+      }
+      return XY_SKXXX_MAX_SUBSCRIPTIONS + i;
+    }
+  }
+  return -1;
+}
+
+bool XY_SKxxx::unsubscribe(int8_t handle) {
+  if (handle >= XY_SKXXX_MAX_SUBSCRIPTIONS && handle < XY_SKXXX_MAX_SUBSCRIPTIONS + XY_SKXXX_MAX_FIELD_SET_SUBSCRIPTIONS) {
+    FieldSetSubscription& sub = _fieldSetSubscriptions[handle - XY_SKXXX_MAX_SUBSCRIPTIONS];
+    if (sub.callback == nullptr) {
+      return false;
+    }
+    sub.callback = nullptr;
+    return true;
+  }
+  if (handle < 0 || handle >= XY_SKXXX_MAX_SUBSCRIPTIONS || _subscriptions[handle].callback == nullptr) {
+    return false;
+  }
+  _subscriptions[handle].callback = nullptr;
+  return true;
+}
+
+void XY_SKxxx::notifySubscribers(xy_sk::PollGroup group) {
+  for (uint8_t i = 0; i < XY_SKXXX_MAX_SUBSCRIPTIONS; i++) {
+    StatusSubscription& sub = _subscriptions[i];
+    if (sub.callback == nullptr || !(FIELD_GROUP[sub.field] & group)) {
+      continue;
+    }
+
+    float value = getStatusField(sub.field);
+    if (!fieldChanged(value, sub.lastValue, sub.deadband, sub.reported)) {
+      continue;
+    }
+
+    // Compare against the reported value so slow drifts still add up
+    sub.lastValue = value;
+    sub.reported = true;
+    sub.callback(sub.context, *this, sub.field, value);
+  }
+
+  for (uint8_t i = 0; i < XY_SKXXX_MAX_FIELD_SET_SUBSCRIPTIONS; i++) {
+    FieldSetSubscription& sub = _fieldSetSubscriptions[i];
+    for (uint8_t f = 0; f < FIELD_COUNT && sub.callback != nullptr; f++) {
+      uint32_t bit = STATUS_FIELD_BIT(f);
+      if (!(sub.fields & bit) || !(FIELD_GROUP[f] & group)) {
+        continue;
+      }
+
+      float value = getStatusField((StatusField)f);
+      if (!fieldChanged(value, sub.lastValues[f], sub.deadbands[f], sub.reported & bit)) {
+        continue;
+      }
+
+      sub.lastValues[f] = value;
+      sub.reported |= bit;
+      sub.callback(sub.context, *this, (StatusField)f, value);
+    }
+  }
+}
@@ -0,0 +1,245 @@
+#include "XY-SKxxx-internal.h"
+#include "XY-SKxxx-sweep.h"
+
+// VOUT (0x02) through CVCC (0x11) in one read
+#define IV_BLOCK_START REG_VOUT
+#define IV_BLOCK_COUNT (REG_CVCC - REG_VOUT + 1)
+// Readings within this many counts of the previous read count as unchanged
+#define IV_STABLE_COUNTS 2
+// Consecutive failed reads or writes that abort the sweep
+#define IV_MAX_FAILURES 5
+
+XY_SKxxxIvSweep::XY_SKxxxIvSweep(XY_SKxxx& device)
+  : _device(device), _mode(IV_SWEEP_VOLTAGE), _start(0.0f), _end(0.0f), _points(0), _limit(0.0f),
+    _stableReads(3), _minSettleMs(200), _settleTimeoutMs(3000), _average(4), _running(false),
+    _stopRequested(false), _index(0), _phase(PHASE_SETTLE), _sweepStart(0), _pointStart(0), _stable(0),
+    _lastVoltage(0), _lastCurrent(0), _lastCvcc(0), _haveLast(false), _samples(0), _consecutiveFailures(0) {
+  memset(_sum, 0, sizeof(_sum));
+  memset(_table, 0, sizeof(_table));
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+XY_SKxxxIvSweep::~XY_SKxxxIvSweep() {
+  stop();
+#if defined(ESP32)
+  _task.join();
+#endif
+  if (_running) {
+    finish();
+  }
+}
+
+bool XY_SKxxxIvSweep::configure(IvSweepMode mode, float start, float end, uint16_t points, float limit) {
+  const xy_sk::ModelInfo& model = _device.getModelInfo();
+  float max = (mode == IV_SWEEP_VOLTAGE) ? model.maxVoltage : model.maxCurrent;
+  float limitMax = (mode == IV_SWEEP_VOLTAGE) ? model.maxCurrent : model.maxVoltage;
+  if (_running || points < 2 || points > IV_MAX_POINTS || start < 0.0f || end < 0.0f || start > max ||
+      end > max || start == end || limit < 0.0f || limit > limitMax) {
+    return false;
+  }
+  _mode = mode;
+  _start = start;
+  _end = end;
+  _points = points;
+  _limit = limit;
+  return true;
+}
+
+void XY_SKxxxIvSweep::setSettling(uint8_t stableReads, uint32_t minMs, uint32_t timeoutMs) {
+  if (_running) {
+    return;
+  }
+  _stableReads = (stableReads < 2) ? 2 : stableReads;
+  _minSettleMs = minMs;
+  _settleTimeoutMs = (timeoutMs < minMs) ? minMs : timeoutMs;
+}
+
+float XY_SKxxxIvSweep::setpointAt(uint16_t index) const {
+  return _start + (_end - _start) * index / (_points - 1);
+}
+
+bool XY_SKxxxIvSweep::start() {
+  if (_running || _points == 0) {
+    return false;
+  }
+
+  if (!_restore.save(_device)) {
+    return false;
+  }
+
+  bool limited = (_limit <= 0.0f) ||
+                 ((_mode == IV_SWEEP_VOLTAGE) ? _device.setCurrent(_limit) : _device.setVoltage(_limit));
+  if (!limited) {
+    return false;
+  }
+
+  memset(_table, 0, sizeof(_table));
+  memset(&_stats, 0, sizeof(_stats));
+  _sweepStart = millis();
+  _index = 0;
+  _consecutiveFailures = 0;
+  _stopRequested = false;
+  if (!writePoint(0) || !_device.setOutputState(true)) {
+    finish();
+    return false;
+  }
+  _running = true;
+  return true;
+}
+
+void XY_SKxxxIvSweep::stop() {
+  if (_running) {
+    _stopRequested = true;
+  }
+}
+
+bool XY_SKxxxIvSweep::writePoint(uint16_t index) {
+  float setpoint = setpointAt(index);
+  bool success = (_mode == IV_SWEEP_VOLTAGE) ? _device.setVoltage(setpoint) : _device.setCurrent(setpoint);
+  if (!success) {
+    _stats.writeFailures++;
+    return false;
+  }
+  _table[index].setpoint = setpoint;
+  _phase = PHASE_SETTLE;
+  _pointStart = millis();
+  _stable = 0;
+  _haveLast = false;
+  _samples = 0;
+  memset(_sum, 0, sizeof(_sum));
+  return true;
+}
+
+bool XY_SKxxxIvSweep::update() {
+  if (!_running) {
+    return false;
+  }
+  if (_stopRequested) {
+    _stats.aborted = true;
+    finish();
+    return false;
+  }
+
+  uint16_t block[IV_BLOCK_COUNT];
+  if (!_device.readRegisters(IV_BLOCK_START, IV_BLOCK_COUNT, block)) {
+    _stats.readFailures++;
+    if (++_consecutiveFailures >= IV_MAX_FAILURES) {
+      _stats.aborted = true;
+      finish();
+      return false;
+    }
+    return true;
+  }
+  _consecutiveFailures = 0;
+  _stats.reads++;
+
+  uint16_t protection = block[REG_PROTECT - IV_BLOCK_START];
+  if (protection != 0) {
+    _stats.protection = protection;
+    _stats.aborted = true;
+    finish();
+    return false;
+  }
+
+  if (_phase == PHASE_SETTLE) {
+    settle(block, millis());
+    return true;
+  }
+
+  accumulate(block);
+  if (_samples < _average) {
+    return true;
+  }
+  completePoint();
+  if (_index >= _points) {
+    finish();
+    return false;
+  }
+
+  // Next setpoint goes out right after the last sample of this point
+  if (!writePoint(_index)) {
+    _stats.aborted = true;
+    finish();
+    return false;
+  }
+  return true;
+}
+
+void XY_SKxxxIvSweep::settle(const uint16_t* block, unsigned long now) {
+  uint16_t voltage = block[REG_VOUT - IV_BLOCK_START];
+  uint16_t current = block[REG_IOUT - IV_BLOCK_START];
+  uint16_t cvcc = block[REG_CVCC - IV_BLOCK_START];
+  unsigned long elapsed = now - _pointStart;
+
+  bool unchanged = _haveLast && cvcc == _lastCvcc && abs((int)voltage - (int)_lastVoltage) <= IV_STABLE_COUNTS &&
+                   abs((int)current - (int)_lastCurrent) <= IV_STABLE_COUNTS;
+  _stable = unchanged ? _stable + 1 : 1;
+  _lastVoltage = voltage;
+  _lastCurrent = current;
+  _lastCvcc = cvcc;
+  _haveLast = true;
+
+  IvPoint& point = _table[_index];
+  if (elapsed >= _minSettleMs && _stable >= _stableReads) {
+    point.settled = true;
+  } else if (elapsed < _settleTimeoutMs) {
+    return;
+  }
+  point.settleMs = (uint16_t)((elapsed > 65535UL) ? 65535UL : elapsed);
+  _phase = PHASE_AVERAGE;
+  // The read that settled is the first sample of the average
+  accumulate(block);
+}
+
+void XY_SKxxxIvSweep::accumulate(const uint16_t* block) {
+  const xy_sk::ModelInfo& model = _device.getModelInfo();
+  _sum[0] += block[REG_VOUT - IV_BLOCK_START] / (float)model.voltageScale;
+  _sum[1] += block[REG_IOUT - IV_BLOCK_START] / (float)model.currentScale;
+  _sum[2] += block[REG_POWER - IV_BLOCK_START] / (float)model.powerScale;
+  _sum[3] += block[REG_UIN - IV_BLOCK_START] / (float)model.voltageScale;
+  _lastCvcc = block[REG_CVCC - IV_BLOCK_START];
+  _samples++;
+}
+
+void XY_SKxxxIvSweep::completePoint() {
+  IvPoint& point = _table[_index];
+  point.voltage = _sum[0] / _samples;
+  point.current = _sum[1] / _samples;
+  point.power = _sum[2] / _samples;
+  point.inputVoltage = _sum[3] / _samples;
+  point.cvcc = (uint8_t)_lastCvcc;
+  if (!point.settled) {
+    _stats.unsettled++;
+  }
+  _stats.points++;
+  _stats.elapsedMs = millis() - _sweepStart;
+  _index++;
+}
+
+void XY_SKxxxIvSweep::finish() {
+  _restore.restore(_device);
+  _stats.elapsedMs = millis() - _sweepStart;
+  _stopRequested = false;
+  _running = false;
+}
+
+#if defined(ESP32)
+bool XY_SKxxxIvSweep::startTask(UBaseType_t priority, BaseType_t core) {
+  if (_task.isRunning() || !start()) {
+    return false;
+  }
+
+  if (!_task.start("xy_sweep", taskTurn, this, priority, core)) {
+    finish();
+    return false;
+  }
+  return true;
+}
+
+bool XY_SKxxxIvSweep::taskTurn(void* context, uint32_t& sleepMs) {
+  XY_SKxxxIvSweep* sweep = static_cast<XY_SKxxxIvSweep*>(context);
+  // Back to back reads, one tick apart so loop() still gets the CPU
+  sleepMs = 0;
+  return sweep->update();
+}
+#endif
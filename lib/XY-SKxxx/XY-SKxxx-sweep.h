@@ -0,0 +1,150 @@
+#ifndef XY_SKXXX_SWEEP_H
+#define XY_SKXXX_SWEEP_H
+
+#include <Arduino.h>
+#include "XY-SKxxx.h"
+#include "XY-SKxxx-task.h"
+
+#define IV_MAX_POINTS 128
+
+// Setpoint that is swept
+enum IvSweepMode {
+  IV_SWEEP_VOLTAGE = 0,  // V_SET, I_SET is the limit
+  IV_SWEEP_CURRENT = 1   // I_SET, V_SET is the limit
+};
+
+struct IvPoint {
+  float setpoint;           // V or A written
+  float voltage;            // Averaged VOUT
+  float current;            // Averaged IOUT
+  float power;              // Averaged POWER
+  float inputVoltage;       // Averaged UIN (panel voltage when sweeping a solar input)
+  uint8_t cvcc;             // REG_CVCC at the end of the point (0: CV, 1: CC)
+  bool settled;             // false if the settle timeout ran out
+  uint16_t settleMs;        // Setpoint write to settled
+};
+
+struct IvSweepStats {
+  uint16_t points;          // Points captured
+  uint16_t unsettled;       // Points captured after the settle timeout
+  uint32_t elapsedMs;
+  uint32_t reads;
+  uint32_t readFailures;
+  uint32_t writeFailures;
+  uint16_t protection;      // REG_PROTECT that aborted the sweep, 0 if none
+  bool aborted;             // Stopped early: stop(), protection or failures
+};
+
+/**
+ * I-V curve sweep
+ *
+ * Steps V_SET (or I_SET) from start to end in N points and records the
+ * averaged output at each one. After each write the block VOUT..CVCC is
+ * read until the CV/CC state and the readings stop changing, then the
+ * block is read again for the average. Each sample is one transaction that
+ * carries VOUT, IOUT, POWER, UIN, the protection status and the CV/CC
+ * state together, and the next setpoint is written straight after the
+ * last averaged sample, so the bus never sits idle between points.
+ *
+ * The output is switched on for the sweep. Setpoints and the output state
+ * are restored when it ends; a protection trip aborts it.
+ */
+class XY_SKxxxIvSweep {
+public:
+  explicit XY_SKxxxIvSweep(XY_SKxxx& device);
+  ~XY_SKxxxIvSweep();
+  XY_SKxxxIvSweep(const XY_SKxxxIvSweep&) = delete;
+  XY_SKxxxIvSweep& operator=(const XY_SKxxxIvSweep&) = delete;
+
+  /**
+   * Sweep range, ignored while running
+   *
+   * @param limit Other setpoint during the sweep (current limit for a voltage sweep), 0 = unchanged
+   */
+  bool configure(IvSweepMode mode, float start, float end, uint16_t points, float limit = 0.0f);
+  IvSweepMode getMode() const { return _mode; }
+
+  /**
+   * A point is settled after stableReads reads with the same CV/CC state
+   * and readings within 2 counts, but not before minMs (the meter update
+   * lags the setpoint). After timeoutMs it is captured anyway and flagged.
+   * Defaults: 3 reads, 200 ms, 3000 ms
+   */
+  void setSettling(uint8_t stableReads, uint32_t minMs, uint32_t timeoutMs);
+
+  /**
+   * Reads averaged per point (default 4)
+   */
+  void setAveraging(uint8_t samples) { if (!_running) _average = (samples == 0) ? 1 : samples; }
+
+  bool start();
+  void stop();
+
+  /**
+   * One bus read (and the next setpoint write when a point completes)
+   *
+   * @return true while running
+   */
+  bool update();
+
+#if defined(ESP32)
+  bool startTask(UBaseType_t priority = 1, BaseType_t core = -1);
+  bool isTaskRunning() const { return _task.isRunning(); }
+#endif
+
+  bool isRunning() const { return _running; }
+  uint16_t getPlannedPoints() const { return _points; }
+
+  // Table of the last sweep
+  uint16_t getPointCount() const { return _stats.points; }
+  const IvPoint& getPoint(uint16_t index) const { return _table[index]; }
+  const IvSweepStats& getStats() const { return _stats; }
+
+private:
+  enum Phase : uint8_t { PHASE_SETTLE, PHASE_AVERAGE };
+
+  float setpointAt(uint16_t index) const;
+  bool writePoint(uint16_t index);
+  void settle(const uint16_t* block, unsigned long now);
+  void accumulate(const uint16_t* block);
+  void completePoint();
+  void finish();
+
+#if defined(ESP32)
+  static bool taskTurn(void* context, uint32_t& sleepMs);
+  xy_sk::HelperTask _task;
+#endif
+
+  XY_SKxxx& _device;
+  IvSweepMode _mode;
+  float _start;
+  float _end;
+  uint16_t _points;
+  float _limit;
+  uint8_t _stableReads;
+  uint32_t _minSettleMs;
+  uint32_t _settleTimeoutMs;
+  uint8_t _average;
+
+  // Run state
+  volatile bool _running;
+  volatile bool _stopRequested;
+  uint16_t _index;          // Point being measured
+  Phase _phase;
+  unsigned long _sweepStart;
+  unsigned long _pointStart;  // millis() of the setpoint write
+  uint8_t _stable;
+  uint16_t _lastVoltage;    // Raw readings of the previous settle read
+  uint16_t _lastCurrent;
+  uint16_t _lastCvcc;
+  bool _haveLast;
+  uint8_t _samples;
+  float _sum[4];            // VOUT, IOUT, POWER, UIN
+  uint8_t _consecutiveFailures;
+  xy_sk::OutputSnapshot _restore; // Setpoints and output state before the sweep
+
+  IvPoint _table[IV_MAX_POINTS];
+  IvSweepStats _stats;
+};
+
+#endif // XY_SKXXX_SWEEP_H
@@ -0,0 +1,91 @@
+#include "XY-SKxxx-internal.h"
+#include "XY-SKxxx-task.h"
+
+namespace xy_sk {
+
+bool OutputSnapshot::save(XY_SKxxx& device) {
+    uint16_t values[2];
+    uint16_t state;
+    if (!device.readRegisters(REG_V_SET, 2, values) || !device.readRegister(REG_ONOFF, state)) {
+        return false;
+    }
+    voltage = values[0];
+    current = values[1];
+    output = (state != 0);
+    return true;
+}
+
+void OutputSnapshot::restore(XY_SKxxx& device) const {
+    device.writeRegister(REG_V_SET, voltage);
+    device.writeRegister(REG_I_SET, current);
+    device.setOutputState(output);
+    resyncSetpoints(device);
+}
+
+void resyncSetpoints(XY_SKxxx& device) {
+    device.updateDeviceSettings(true);
+}
+
+#if defined(ESP32)
+static const uint32_t TASK_STACK_SIZE = 4096;
+
+HelperTask::HelperTask() : _handle(nullptr), _turn(nullptr), _context(nullptr) {
+}
+
+bool HelperTask::start(const char* name, Turn turn, void* context, UBaseType_t priority, BaseType_t core) {
+    if (_handle != nullptr || turn == nullptr) {
+        return false;
+    }
+    _turn = turn;
+    _context = context;
+    return start(name, runTurns, this, priority, core);
+}
+
+bool HelperTask::start(const char* name, TaskFunction_t entry, void* context, UBaseType_t priority, BaseType_t core) {
+    if (_handle != nullptr) {
+        return false;
+    }
+
+    // The handle is stored before the task first runs, so its exit() always clears it
+    BaseType_t created = (core < 0)
+        ? xTaskCreate(entry, name, TASK_STACK_SIZE, context, priority, &_handle)
+        : xTaskCreatePinnedToCore(entry, name, TASK_STACK_SIZE, context, priority, &_handle, core);
+    if (created != pdPASS) {
+        _handle = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void HelperTask::exit() {
+    _handle = nullptr;
+    vTaskDelete(nullptr);
+}
+
+void HelperTask::join() const {
+    while (_handle != nullptr) {
+        delay(1);
+    }
+}
+
+uint32_t HelperTask::msUntil(unsigned long due) {
+    long wait = (long)(due - millis());
+    return (wait > 0) ? (uint32_t)wait : 0;
+}
+
+void HelperTask::runTurns(void* self) {
+    HelperTask* task = static_cast<HelperTask*>(self);
+    uint32_t sleepMs = TASK_STOP_LATENCY_MS;
+    while (task->_turn(task->_context, sleepMs)) {
+        if (sleepMs > TASK_STOP_LATENCY_MS) {
+            sleepMs = TASK_STOP_LATENCY_MS;
+        }
+        TickType_t ticks = pdMS_TO_TICKS(sleepMs);
+        vTaskDelay(ticks > 0 ? ticks : 1);
+        sleepMs = TASK_STOP_LATENCY_MS;
+    }
+    task->exit();
+}
+#endif
+
+} // namespace xy_sk
@@ -0,0 +1,91 @@
+#ifndef XY_SKXXX_TASK_H
+#define XY_SKXXX_TASK_H
+
+#include <Arduino.h>
+
+class XY_SKxxx;
+
+namespace xy_sk {
+
+/**
+ * V_SET, I_SET and output state of a device, saved before a test drives the
+ * output and written back when it ends
+ */
+struct OutputSnapshot {
+    uint16_t voltage;   // Raw V_SET
+    uint16_t current;   // Raw I_SET
+    bool output;
+
+    OutputSnapshot() : voltage(0), current(0), output(false) {}
+
+    bool save(XY_SKxxx& device);
+
+    // Writes the raw setpoints back, then resyncs the setpoint cache
+    void restore(XY_SKxxx& device) const;
+};
+
+/**
+ * Re-read the setpoints after raw REG_V_SET/REG_I_SET writes, which bypass
+ * the setpoint cache
+ */
+void resyncSetpoints(XY_SKxxx& device);
+
+#if defined(ESP32)
+// Longest sleep between two turns of a helper task, and so the latency of stop()
+constexpr uint32_t TASK_STOP_LATENCY_MS = 100;
+
+/**
+ * FreeRTOS task of a helper (sequencer, waveform, MPPT tracker, ...)
+ *
+ * The task clears the handle as its last act, so the owner can tell when
+ * the task no longer references it.
+ */
+class HelperTask {
+public:
+    /**
+     * One turn of the task: the work, then how long to sleep before the
+     * next turn. sleepMs starts out as TASK_STOP_LATENCY_MS.
+     *
+     * @return false to end the task
+     */
+    typedef bool (*Turn)(void* context, uint32_t& sleepMs);
+
+    HelperTask();
+
+    /**
+     * Run turn(context) in a new task until it returns false
+     *
+     * Sleeps are capped at TASK_STOP_LATENCY_MS and last at least one tick,
+     * so loop() and other lower priority tasks get to run.
+     *
+     * @param core -1 lets the scheduler choose
+     */
+    bool start(const char* name, Turn turn, void* context, UBaseType_t priority, BaseType_t core);
+
+    // Run a task function with its own loop, which has to end with exit()
+    bool start(const char* name, TaskFunction_t entry, void* context, UBaseType_t priority, BaseType_t core);
+
+    // Last act of a task function, does not return
+    void exit();
+
+    // Wait until the task has seen a stop and ended, for destructors
+    void join() const;
+
+    bool isRunning() const { return _handle != nullptr; }
+    TaskHandle_t getHandle() const { return _handle; }
+
+    // Sleep for a turn that waits for a millis() deadline, 0 once it is due
+    static uint32_t msUntil(unsigned long due);
+
+private:
+    static void runTurns(void* self);
+
+    TaskHandle_t _handle;
+    Turn _turn;
+    void* _context;
+};
+#endif
+
+} // namespace xy_sk
+
+#endif // XY_SKXXX_TASK_H
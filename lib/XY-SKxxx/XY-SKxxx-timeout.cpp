@@ -0,0 +1,152 @@
+#include "XY-SKxxx-timeout.h"
+
+namespace xy_sk {
+
+AdaptiveTimeout::AdaptiveTimeout()
+    : _enabled(true), _floorMicros(20000), _multiplier(2.0f), _percentile(0.99f),
+      _minSamples(8), _coldMicros(200000), _coldProbeInterval(8) {
+    resetAll();
+}
+
+void AdaptiveTimeout::configure(unsigned long floorMs, float multiplier, float percentile, uint8_t minSamples) {
+    _floorMicros = floorMs * 1000UL;
+    _multiplier = (multiplier < 1.0f) ? 1.0f : multiplier;
+    _percentile = constrain(percentile, 0.5f, 1.0f);
+    _minSamples = constrain(minSamples, (uint8_t)1, TIMEOUT_SAMPLE_WINDOW);
+}
+
+unsigned long AdaptiveTimeout::timeoutFor(uint8_t slave, unsigned long replyFrameMicros, unsigned long ceilingMicros) {
+    Entry* entry = find(slave, true);
+    if (entry == nullptr) {
+        return ceilingMicros;
+    }
+    entry->lastUsed = millis();
+
+    unsigned long timeout = ceilingMicros;
+    bool coldProbe = _coldProbeInterval > 0 && entry->consecutiveTimeouts > 0 &&
+                     (entry->consecutiveTimeouts % _coldProbeInterval) == 0;
+
+    if (!coldProbe) {
+        unsigned long learned = (entry->count > 0)
+            ? (unsigned long)(entry->percentileMicros * _multiplier) + replyFrameMicros : 0;
+        if (entry->count >= _minSamples) {
+            timeout = learned;
+        } else {
+            // Cold: the baud-scaled allowance, or the few samples there are if slower
+            timeout = _coldMicros + replyFrameMicros;
+            if (learned > timeout) {
+                timeout = learned;
+            }
+        }
+        if (timeout < _floorMicros) {
+            timeout = _floorMicros;
+        }
+        if (timeout > ceilingMicros) {
+            timeout = ceilingMicros;
+        }
+    }
+
+    entry->lastTimeoutMicros = timeout;
+    return timeout;
+}
+
+void AdaptiveTimeout::recordReply(uint8_t slave, unsigned long responseMicros, unsigned long replyFrameMicros) {
+    Entry* entry = find(slave, true);
+    if (entry == nullptr) {
+        return;
+    }
+
+    // Keep only the slave's own turnaround, the wire time is added back per request
+    uint32_t delay = (responseMicros > replyFrameMicros) ? responseMicros - replyFrameMicros : 0;
+    entry->samples[entry->head] = delay;
+    entry->head = (entry->head + 1) % TIMEOUT_SAMPLE_WINDOW;
+    if (entry->count < TIMEOUT_SAMPLE_WINDOW) {
+        entry->count++;
+    }
+    entry->consecutiveTimeouts = 0;
+    updatePercentile(*entry);
+}
+
+void AdaptiveTimeout::recordTimeout(uint8_t slave) {
+    Entry* entry = find(slave, true);
+    if (entry != nullptr && entry->consecutiveTimeouts < 0xFFFF) {
+        entry->consecutiveTimeouts++;
+    }
+}
+
+void AdaptiveTimeout::reset(uint8_t slave) {
+    Entry* entry = find(slave, false);
+    if (entry != nullptr) {
+        memset(entry, 0, sizeof(Entry));
+    }
+}
+
+void AdaptiveTimeout::resetAll() {
+    memset(_entries, 0, sizeof(_entries));
+}
+
+bool AdaptiveTimeout::getSlaveStats(uint8_t index, SlaveTimingStats& stats) const {
+    if (index >= TIMEOUT_MAX_TRACKED_SLAVES || !_entries[index].used) {
+        return false;
+    }
+    const Entry& entry = _entries[index];
+    stats.slave = entry.slave;
+    stats.sampleCount = entry.count;
+    stats.consecutiveTimeouts = entry.consecutiveTimeouts;
+    stats.percentileMicros = entry.percentileMicros;
+    stats.lastTimeoutMicros = entry.lastTimeoutMicros;
+    return true;
+}
+
+AdaptiveTimeout::Entry* AdaptiveTimeout::find(uint8_t slave, bool create) {
+    Entry* freeSlot = nullptr;
+    Entry* oldest = nullptr;
+
+    for (uint8_t i = 0; i < TIMEOUT_MAX_TRACKED_SLAVES; i++) {
+        Entry& entry = _entries[i];
+        if (entry.used && entry.slave == slave) {
+            return &entry;
+        }
+        if (!entry.used) {
+            if (freeSlot == nullptr) {
+                freeSlot = &entry;
+            }
+        } else if (oldest == nullptr || (long)(entry.lastUsed - oldest->lastUsed) < 0) {
+            oldest = &entry;
+        }
+    }
+
+    if (!create) {
+        return nullptr;
+    }
+
+    // Reuse the least recently used slot when all are taken
+    Entry* slot = (freeSlot != nullptr) ? freeSlot : oldest;
+    memset(slot, 0, sizeof(Entry));
+    slot->used = true;
+    slot->slave = slave;
+    slot->lastUsed = millis();
+    return slot;
+}
+
+void AdaptiveTimeout::updatePercentile(Entry& entry) {
+    // Insertion sort of a copy, the window is small
+    uint32_t sorted[TIMEOUT_SAMPLE_WINDOW];
+    for (uint8_t i = 0; i < entry.count; i++) {
+        uint32_t value = entry.samples[i];
+        int8_t j = i - 1;
+        while (j >= 0 && sorted[j] > value) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = value;
+    }
+
+    uint8_t rank = (uint8_t)ceilf(_percentile * entry.count);
+    if (rank < 1) {
+        rank = 1;
+    }
+    entry.percentileMicros = sorted[rank - 1];
+}
+
+} // namespace xy_sk
@@ -0,0 +1,124 @@
+#ifndef XY_SKXXX_TIMEOUT_H
+#define XY_SKXXX_TIMEOUT_H
+
+#include <Arduino.h>
+
+namespace xy_sk {
+
+constexpr uint8_t TIMEOUT_MAX_TRACKED_SLAVES = 8;  // Slaves with their own RTT history
+constexpr uint8_t TIMEOUT_SAMPLE_WINDOW = 32;      // Samples kept per slave
+
+// Snapshot of the timing state kept for one slave
+struct SlaveTimingStats {
+    uint8_t slave;
+    uint8_t sampleCount;           // Valid samples in the window
+    uint16_t consecutiveTimeouts;
+    uint32_t percentileMicros;     // Reply delay percentile, reply frame time excluded
+    uint32_t lastTimeoutMicros;    // Timeout used for the last request
+};
+
+/**
+ * Per-slave response timeout derived from measured round trips
+ *
+ * Every answered request adds the slave's reply delay (time from the end of
+ * the request to the end of the reply, minus the reply's own frame time) to
+ * a sliding window. Once enough samples exist the timeout becomes
+ *
+ *     percentile(window) * multiplier + reply frame time
+ *
+ * clamped between a floor and the master's configured ceiling. Slaves with
+ * too little history ("cold") get a cold turnaround allowance plus the reply
+ * frame time, so the cold timeout scales with the baud rate and a dead unit
+ * does not cost the full ceiling per attempt. A slave that keeps timing out
+ * gets one ceiling-length probe every few attempts so a slow wake-up is not
+ * mistaken for a dead device forever.
+ */
+class AdaptiveTimeout {
+public:
+    AdaptiveTimeout();
+
+    void setEnabled(bool enabled) { _enabled = enabled; }
+    bool isEnabled() const { return _enabled; }
+
+    /**
+     * Configure the estimator
+     *
+     * @param floorMs Lowest timeout ever used
+     * @param multiplier Safety factor applied to the percentile (k)
+     * @param percentile Percentile of the window to use (0.50-1.00)
+     * @param minSamples Samples needed before leaving the cold timeout
+     */
+    void configure(unsigned long floorMs, float multiplier, float percentile, uint8_t minSamples);
+
+    /**
+     * Turnaround allowed to a slave without enough samples (default 200 ms),
+     * the reply frame time is added per request
+     */
+    void setColdTurnaround(unsigned long turnaroundMs) { _coldMicros = turnaroundMs * 1000UL; }
+
+    /**
+     * Number of consecutive timeouts after which one attempt uses the ceiling again
+     */
+    void setColdProbeInterval(uint8_t attempts) { _coldProbeInterval = attempts; }
+
+    /**
+     * Timeout to use for the next request to a slave
+     *
+     * @param slave Slave address
+     * @param replyFrameMicros Transmission time of the expected reply
+     * @param ceilingMicros Upper bound (the master's fixed response timeout)
+     * @return Timeout in microseconds
+     */
+    unsigned long timeoutFor(uint8_t slave, unsigned long replyFrameMicros, unsigned long ceilingMicros);
+
+    /**
+     * Record a request the slave answered (successfully or with an error frame)
+     */
+    void recordReply(uint8_t slave, unsigned long responseMicros, unsigned long replyFrameMicros);
+
+    /**
+     * Record a request the slave did not answer in time
+     */
+    void recordTimeout(uint8_t slave);
+
+    void reset(uint8_t slave);
+    void resetAll();
+
+    /**
+     * Read the timing state of a tracked slave
+     *
+     * @param index Slot index (0 to TIMEOUT_MAX_TRACKED_SLAVES - 1)
+     * @param stats Receives the snapshot
+     * @return true if the slot is in use
+     */
+    bool getSlaveStats(uint8_t index, SlaveTimingStats& stats) const;
+
+private:
+    struct Entry {
+        bool used;
+        uint8_t slave;
+        uint8_t head;                 // Next sample slot
+        uint8_t count;
+        uint16_t consecutiveTimeouts;
+        uint32_t samples[TIMEOUT_SAMPLE_WINDOW];
+        uint32_t percentileMicros;
+        uint32_t lastTimeoutMicros;
+        unsigned long lastUsed;       // millis() of the last request, for slot reuse
+    };
+
+    Entry* find(uint8_t slave, bool create);
+    void updatePercentile(Entry& entry);
+
+    bool _enabled;
+    unsigned long _floorMicros;
+    float _multiplier;
+    float _percentile;
+    uint8_t _minSamples;
+    unsigned long _coldMicros;
+    uint8_t _coldProbeInterval;
+    Entry _entries[TIMEOUT_MAX_TRACKED_SLAVES];
+};
+
+} // namespace xy_sk
+
+#endif // XY_SKXXX_TIMEOUT_H
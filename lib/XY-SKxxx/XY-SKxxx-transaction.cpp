@@ -0,0 +1,125 @@
+#include "XY-SKxxx-internal.h"
+#include "XY-SKxxx-transaction.h"
+
+XY_SKxxxTransaction::XY_SKxxxTransaction(XY_SKxxx& device) : _device(device), _count(0) {
+  memset(_writes, 0, sizeof(_writes));
+  memset(&_result, 0, sizeof(_result));
+}
+
+bool XY_SKxxxTransaction::write(uint16_t addr, uint16_t value) {
+  // Insertion keeps the list sorted, runs are found in one pass at commit
+  uint8_t i = 0;
+  while (i < _count && _writes[i].addr < addr) {
+    i++;
+  }
+  if (i < _count && _writes[i].addr == addr) {
+    _writes[i].value = value;
+    return true;
+  }
+  if (_count >= TRANSACTION_MAX_WRITES) {
+    return false;
+  }
+  memmove(&_writes[i + 1], &_writes[i], (_count - i) * sizeof(TransactionWrite));
+  _writes[i].addr = addr;
+  _writes[i].value = value;
+  _writes[i].written = false;
+  _writes[i].verified = false;
+  _count++;
+  return true;
+}
+
+bool XY_SKxxxTransaction::write(uint16_t addr, uint16_t count, const uint16_t* values) {
+  for (uint16_t i = 0; i < count; i++) {
+    if (!write(addr + i, values[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void XY_SKxxxTransaction::clear() {
+  _count = 0;
+}
+
+uint8_t XY_SKxxxTransaction::runLength(uint8_t first) const {
+  uint8_t length = 1;
+  while (first + length < _count && length < xy_sk::RTU_MAX_WRITE_REGISTERS &&
+         _writes[first + length].addr == _writes[first].addr + length) {
+    length++;
+  }
+  return length;
+}
+
+uint8_t XY_SKxxxTransaction::planFrames() const {
+  uint8_t frames = 0;
+  for (uint8_t i = 0; i < _count; i += runLength(i)) {
+    frames++;
+  }
+  return frames;
+}
+
+bool XY_SKxxxTransaction::commit(bool verify) {
+  memset(&_result, 0, sizeof(_result));
+  _result.registers = _count;
+  if (_count == 0) {
+    return true;
+  }
+
+  uint32_t start = micros();
+  xy_sk::RtuBus& bus = _device.getBus();
+  bus.lock();
+
+  uint16_t values[xy_sk::RTU_MAX_WRITE_REGISTERS];
+  for (uint8_t i = 0; i < _count;) {
+    uint8_t length = runLength(i);
+    bool success;
+    if (length == 1) {
+      success = _device.writeRegister(_writes[i].addr, _writes[i].value);
+    } else {
+      for (uint8_t r = 0; r < length; r++) {
+        values[r] = _writes[i + r].value;
+      }
+      success = _device.writeRegisters(_writes[i].addr, length, values);
+    }
+    _result.frames++;
+    if (!success) {
+      _result.failedFrames++;
+      _result.failed += length;
+    }
+    for (uint8_t r = 0; r < length; r++) {
+      _writes[i + r].written = success;
+      _writes[i + r].verified = false;
+    }
+    i += length;
+  }
+
+  if (verify) {
+    for (uint8_t i = 0; i < _count;) {
+      uint8_t length = runLength(i);
+      // From the device, the shadow only holds what was sent
+      bool read = _device.readRegistersDirect(_writes[i].addr, length, values);
+      _result.readFrames++;
+      for (uint8_t r = 0; r < length; r++) {
+        TransactionWrite& write = _writes[i + r];
+        write.verified = read && values[r] == write.value;
+        if (!write.verified) {
+          _result.mismatched++;
+        }
+      }
+      i += length;
+    }
+  }
+
+  bus.unlock();
+  _result.micros = micros() - start;
+  return _result.failedFrames == 0 && _result.mismatched == 0;
+}
+
+bool XY_SKxxxTransaction::succeeded(uint16_t addr) const {
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_writes[i].addr == addr) {
+      return _writes[i].written && (_result.readFrames == 0 || _writes[i].verified);
+    }
+  }
+  return false;
+}
@@ -0,0 +1,86 @@
+#ifndef XY_SKXXX_TRANSACTION_H
+#define XY_SKXXX_TRANSACTION_H
+
+#include <Arduino.h>
+#include "XY-SKxxx.h"
+
+#define TRANSACTION_MAX_WRITES 64
+
+// One register of a transaction
+struct TransactionWrite {
+  uint16_t addr;
+  uint16_t value;
+  bool written;            // The frame carrying it was acknowledged
+  bool verified;           // Read back equal (only with verify)
+};
+
+// Outcome of the last commit()
+struct TransactionResult {
+  uint8_t frames;          // Write frames sent (FC06 for single registers, FC16 for runs)
+  uint8_t failedFrames;
+  uint8_t readFrames;      // Verify reads
+  uint8_t registers;
+  uint8_t failed;          // Registers whose write frame failed
+  uint8_t mismatched;      // Registers that read back a different value
+  uint32_t micros;         // Whole burst including verification
+};
+
+/**
+ * Batched register writes
+ *
+ * Collects writes to arbitrary registers, keeps them sorted by address
+ * (a later write to the same register replaces the earlier value) and
+ * sends each run of adjacent addresses as one FC16 frame. The frames go
+ * out back to back with the bus locked, so other tasks cannot interleave
+ * and multi-register settings change in one frame instead of one write
+ * per register with settle delays in between. With verify every run is
+ * read back and each register reports whether it took the value.
+ *
+ * The register shadow takes the written values; the decoded caches
+ * (getStatusSnapshot()) refresh with the next poll.
+ */
+class XY_SKxxxTransaction {
+public:
+  explicit XY_SKxxxTransaction(XY_SKxxx& device);
+  XY_SKxxxTransaction(const XY_SKxxxTransaction&) = delete;
+  XY_SKxxxTransaction& operator=(const XY_SKxxxTransaction&) = delete;
+
+  /**
+   * Add a register write
+   *
+   * @return false if the transaction is full
+   */
+  bool write(uint16_t addr, uint16_t value);
+  bool write(uint16_t addr, uint16_t count, const uint16_t* values);
+
+  void clear();
+  uint8_t size() const { return _count; }
+
+  /**
+   * Frames commit() will send for the writes collected so far
+   */
+  uint8_t planFrames() const;
+
+  /**
+   * Send all writes, optionally read them back
+   *
+   * @return true if every frame was acknowledged (and every register verified)
+   */
+  bool commit(bool verify = false);
+
+  const TransactionResult& getResult() const { return _result; }
+
+  // Writes in address order, with the per-register outcome of the last commit()
+  const TransactionWrite& getWrite(uint8_t index) const { return _writes[index]; }
+  bool succeeded(uint16_t addr) const;
+
+private:
+  uint8_t runLength(uint8_t first) const;
+
+  XY_SKxxx& _device;
+  TransactionWrite _writes[TRANSACTION_MAX_WRITES];
+  uint8_t _count;
+  TransactionResult _result;
+};
+
+#endif // XY_SKXXX_TRANSACTION_H
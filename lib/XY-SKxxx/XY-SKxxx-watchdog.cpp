@@ -0,0 +1,283 @@
+#include "XY-SKxxx-internal.h"
+#include "XY-SKxxx-watchdog.h"
+
+XY_SKxxxWatchdog::XY_SKxxxWatchdog(XY_SKxxx& device)
+  : _device(device), _ruleCount(0), _armed(false), _tripped(false), _callback(nullptr),
+    _callbackContext(nullptr), _pollMs(20), _lastPoll(0), _havePrevious(false), _lastSample(0),
+    _lastCurrent(0.0f), _logHead(0), _logCount(0) {
+#if defined(ESP32)
+  _taskStop = false;
+#endif
+  memset(_rules, 0, sizeof(_rules));
+  memset(_log, 0, sizeof(_log));
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+XY_SKxxxWatchdog::~XY_SKxxxWatchdog() {
+#if defined(ESP32)
+  stopTask();
+  _task.join();
+#endif
+  disarm();
+}
+
+int8_t XY_SKxxxWatchdog::addRule(WatchdogRuleType type, float limit, uint32_t timeMs) {
+  if (_armed || _ruleCount >= WATCHDOG_MAX_RULES || limit <= 0.0f) {
+    return -1;
+  }
+  Rule& rule = _rules[_ruleCount];
+  memset(&rule, 0, sizeof(rule));
+  rule.type = type;
+  rule.limit = limit;
+  rule.timeMs = timeMs;
+  return (int8_t)_ruleCount++;
+}
+
+int8_t XY_SKxxxWatchdog::addCurrentLimit(float amps, uint32_t holdMs) {
+  return addRule(RULE_CURRENT_ABOVE, amps, holdMs);
+}
+
+int8_t XY_SKxxxWatchdog::addVoltageLimit(float volts, uint32_t holdMs) {
+  return addRule(RULE_VOLTAGE_ABOVE, volts, holdMs);
+}
+
+int8_t XY_SKxxxWatchdog::addPowerLimit(float watts, uint32_t holdMs) {
+  return addRule(RULE_POWER_ABOVE, watts, holdMs);
+}
+
+int8_t XY_SKxxxWatchdog::addCurrentSlewLimit(float ampsPerSecond) {
+  return addRule(RULE_CURRENT_SLEW, ampsPerSecond, 0);
+}
+
+int8_t XY_SKxxxWatchdog::addAveragePowerLimit(float watts, uint32_t windowMs) {
+  if (windowMs < WATCHDOG_WINDOW_SLOTS) {
+    return -1;
+  }
+  return addRule(RULE_AVERAGE_POWER, watts, windowMs);
+}
+
+void XY_SKxxxWatchdog::clearRules() {
+  if (!_armed) {
+    _ruleCount = 0;
+  }
+}
+
+void XY_SKxxxWatchdog::setTripCallback(TripCallback callback, void* context) {
+  _callback = callback;
+  _callbackContext = context;
+}
+
+bool XY_SKxxxWatchdog::arm() {
+  if (_ruleCount == 0) {
+    return false;
+  }
+  // Next to any other sample hook of the device
+  if (!_armed && !_device.addOutputSampleCallback(onSample, this)) {
+    return false;
+  }
+  reset();
+  _armed = true;
+  return true;
+}
+
+void XY_SKxxxWatchdog::disarm() {
+  if (_armed) {
+    _device.removeOutputSampleCallback(onSample, this);
+    _armed = false;
+  }
+}
+
+void XY_SKxxxWatchdog::reset() {
+  for (uint8_t i = 0; i < _ruleCount; i++) {
+    Rule& rule = _rules[i];
+    rule.violating = false;
+    rule.slot = 0;
+    memset(rule.slotEnergy, 0, sizeof(rule.slotEnergy));
+    memset(rule.slotTime, 0, sizeof(rule.slotTime));
+  }
+  _havePrevious = false;
+  _tripped = false;
+}
+
+const WatchdogTrip& XY_SKxxxWatchdog::getTrip(uint8_t index) const {
+  uint8_t oldest = (_logCount < WATCHDOG_LOG_SIZE) ? 0 : _logHead;
+  return _log[(oldest + index) % WATCHDOG_LOG_SIZE];
+}
+
+bool XY_SKxxxWatchdog::update() {
+  if (!_armed) {
+    return false;
+  }
+  unsigned long now = millis();
+  if (now - _lastPoll >= _pollMs) {
+    _lastPoll = now;
+    // The sample hook evaluates the rules
+    _device.updateOutputStatus(true);
+  }
+  return true;
+}
+
+void XY_SKxxxWatchdog::onSample(void* context, XY_SKxxx& /*device*/, const DeviceStatus& status,
+                                uint32_t sampleMicros) {
+  static_cast<XY_SKxxxWatchdog*>(context)->evaluate(status, sampleMicros);
+}
+
+float XY_SKxxxWatchdog::averagePower(Rule& rule, float power, uint32_t elapsed, bool& windowFull) {
+  // Fixed slots of window/16 keep the cost independent of the sample rate
+  uint32_t slotMicros = (uint32_t)((uint64_t)rule.timeMs * 1000ULL / WATCHDOG_WINDOW_SLOTS);
+  if (rule.slotTime[rule.slot] >= slotMicros) {
+    rule.slot = (rule.slot + 1) % WATCHDOG_WINDOW_SLOTS;
+    rule.slotEnergy[rule.slot] = 0.0f;
+    rule.slotTime[rule.slot] = 0;
+  }
+  rule.slotEnergy[rule.slot] += power * elapsed;
+  rule.slotTime[rule.slot] += elapsed;
+
+  float energy = 0.0f;
+  uint32_t time = 0;
+  for (uint8_t i = 0; i < WATCHDOG_WINDOW_SLOTS; i++) {
+    energy += rule.slotEnergy[i];
+    time += rule.slotTime[i];
+  }
+  // Only judge the average once the window has been covered
+  windowFull = time >= slotMicros * (WATCHDOG_WINDOW_SLOTS - 1);
+  return (time > 0) ? energy / time : 0.0f;
+}
+
+void XY_SKxxxWatchdog::evaluate(const DeviceStatus& status, uint32_t sampleMicros) {
+  if (!_armed) {
+    return;
+  }
+  _stats.samples++;
+
+  uint32_t elapsed = 0;
+  if (_havePrevious) {
+    elapsed = sampleMicros - _lastSample;
+    if (elapsed > _stats.maxSampleGapMicros) {
+      _stats.maxSampleGapMicros = elapsed;
+    }
+  }
+
+  // Latched: the output is already off until reset()
+  if (_tripped) {
+    _lastSample = sampleMicros;
+    _lastCurrent = status.outputCurrent;
+    _havePrevious = true;
+    return;
+  }
+
+  for (uint8_t i = 0; i < _ruleCount; i++) {
+    Rule& rule = _rules[i];
+    float value;
+    bool violation;
+
+    switch (rule.type) {
+      case RULE_CURRENT_SLEW:
+        if (!_havePrevious || elapsed == 0) {
+          continue;
+        }
+        value = fabsf(status.outputCurrent - _lastCurrent) * 1000000.0f / elapsed;
+        violation = value > rule.limit;
+        break;
+
+      case RULE_AVERAGE_POWER: {
+        if (!_havePrevious) {
+          continue;
+        }
+        bool windowFull;
+        value = averagePower(rule, status.outputPower, elapsed, windowFull);
+        violation = windowFull && value > rule.limit;
+        break;
+      }
+
+      default:
+        value = (rule.type == RULE_CURRENT_ABOVE) ? status.outputCurrent
+              : (rule.type == RULE_VOLTAGE_ABOVE) ? status.outputVoltage
+              : status.outputPower;
+        violation = value > rule.limit;
+        // "Above the limit for longer than the hold time"
+        if (violation && rule.timeMs > 0) {
+          if (!rule.violating) {
+            rule.violating = true;
+            rule.violatingSince = sampleMicros;
+          }
+          violation = (sampleMicros - rule.violatingSince) >= rule.timeMs * 1000UL;
+        } else if (!violation) {
+          rule.violating = false;
+        }
+        break;
+    }
+
+    if (violation) {
+      trip(i, value, sampleMicros);
+      break;
+    }
+  }
+
+  if (!_tripped) {
+    uint32_t evaluateMicros = micros() - sampleMicros;
+    if (evaluateMicros > _stats.maxEvaluateMicros) {
+      _stats.maxEvaluateMicros = evaluateMicros;
+    }
+  }
+  _lastSample = sampleMicros;
+  _lastCurrent = status.outputCurrent;
+  _havePrevious = true;
+}
+
+void XY_SKxxxWatchdog::trip(uint8_t index, float value, uint32_t sampleMicros) {
+  _tripped = true;
+  uint32_t decided = micros();
+  bool off = _device.setOutputState(false);
+  uint32_t done = micros();
+
+  WatchdogTrip& entry = _log[_logHead];
+  entry.rule = index;
+  entry.type = _rules[index].type;
+  entry.value = value;
+  entry.limit = _rules[index].limit;
+  entry.timeMs = millis();
+  entry.detectMicros = decided - sampleMicros;
+  entry.responseMicros = done - sampleMicros;
+  entry.outputOff = off;
+  _logHead = (_logHead + 1) % WATCHDOG_LOG_SIZE;
+  if (_logCount < WATCHDOG_LOG_SIZE) {
+    _logCount++;
+  }
+
+  _stats.trips++;
+  if (entry.responseMicros > _stats.worstResponseMicros) {
+    _stats.worstResponseMicros = entry.responseMicros;
+  }
+
+  if (_callback != nullptr) {
+    _callback(_callbackContext, entry);
+  }
+}
+
+#if defined(ESP32)
+bool XY_SKxxxWatchdog::startTask(UBaseType_t priority, BaseType_t core) {
+  if (_task.isRunning() || !arm()) {
+    return false;
+  }
+
+  _taskStop = false;
+  if (!_task.start("xy_watchdog", taskEntry, this, priority, core)) {
+    disarm();
+    return false;
+  }
+  return true;
+}
+
+void XY_SKxxxWatchdog::taskEntry(void* context) {
+  XY_SKxxxWatchdog* watchdog = static_cast<XY_SKxxxWatchdog*>(context);
+  TickType_t ticks = pdMS_TO_TICKS(watchdog->_pollMs);
+  TickType_t last = xTaskGetTickCount();
+  while (!watchdog->_taskStop && watchdog->_armed) {
+    watchdog->_device.updateOutputStatus(true);
+    vTaskDelayUntil(&last, ticks > 0 ? ticks : 1);
+  }
+
+  watchdog->_task.exit();
+}
+#endif
@@ -0,0 +1,162 @@
+#ifndef XY_SKXXX_WATCHDOG_H
+#define XY_SKXXX_WATCHDOG_H
+
+#include <Arduino.h>
+#include "XY-SKxxx.h"
+#include "XY-SKxxx-task.h"
+
+#define WATCHDOG_MAX_RULES 8
+#define WATCHDOG_LOG_SIZE 16
+#define WATCHDOG_WINDOW_SLOTS 16
+
+enum WatchdogRuleType {
+  RULE_CURRENT_ABOVE = 0,  // Output current (A), optionally for longer than holdMs
+  RULE_VOLTAGE_ABOVE = 1,  // Output voltage (V), optionally for longer than holdMs
+  RULE_POWER_ABOVE = 2,    // Output power (W), optionally for longer than holdMs
+  RULE_CURRENT_SLEW = 3,   // |dI/dt| between two samples (A/s)
+  RULE_AVERAGE_POWER = 4   // Time weighted output power over a sliding window (W)
+};
+
+struct WatchdogTrip {
+  uint8_t rule;             // Index returned by add...()
+  WatchdogRuleType type;
+  float value;              // Value that tripped
+  float limit;
+  uint32_t timeMs;          // millis() of the trip
+  uint32_t detectMicros;    // Sample arrival to trip decision
+  uint32_t responseMicros;  // Sample arrival to output off acknowledged by the device
+  bool outputOff;           // false if the output off write failed
+};
+
+struct WatchdogStats {
+  uint32_t samples;
+  uint32_t trips;
+  uint32_t maxSampleGapMicros;    // Longest time between two evaluated samples
+  uint32_t maxEvaluateMicros;     // Longest rule evaluation without a trip
+  uint32_t worstResponseMicros;   // Longest sample-to-off time of all trips
+};
+
+/**
+ * Application level protection
+ *
+ * Evaluates a set of rules on every output sample the device reads, from
+ * whichever task reads it: the background poll, a control loop or the
+ * watchdog's own fast poll. It is installed as the device output sample
+ * hook, so nothing between the Modbus response and the rule check is
+ * queued or sent over the network. The first rule that trips switches the
+ * output off with setOutputState(false) and the watchdog latches until
+ * reset().
+ *
+ * Each trip is logged with the time from the sample arriving to the
+ * decision and to the output-off acknowledgement. An overload starting
+ * just after a sample is only seen with the next one, so the worst case
+ * response is the longest sample gap plus the slowest trip.
+ */
+class XY_SKxxxWatchdog {
+public:
+  typedef void (*TripCallback)(void* context, const WatchdogTrip& trip);
+
+  explicit XY_SKxxxWatchdog(XY_SKxxx& device);
+  ~XY_SKxxxWatchdog();
+  XY_SKxxxWatchdog(const XY_SKxxxWatchdog&) = delete;
+  XY_SKxxxWatchdog& operator=(const XY_SKxxxWatchdog&) = delete;
+
+  // Rules, return the rule index or -1 when full or armed
+  int8_t addCurrentLimit(float amps, uint32_t holdMs = 0);
+  int8_t addVoltageLimit(float volts, uint32_t holdMs = 0);
+  int8_t addPowerLimit(float watts, uint32_t holdMs = 0);
+  int8_t addCurrentSlewLimit(float ampsPerSecond);
+  int8_t addAveragePowerLimit(float watts, uint32_t windowMs);
+  void clearRules();
+  uint8_t getRuleCount() const { return _ruleCount; }
+  WatchdogRuleType getRuleType(uint8_t index) const { return _rules[index].type; }
+  float getRuleLimit(uint8_t index) const { return _rules[index].limit; }
+  uint32_t getRuleTime(uint8_t index) const { return _rules[index].timeMs; }
+
+  /**
+   * Add the output sample hook and start evaluating
+   *
+   * @return false without rules or when the device has no free hook slot
+   */
+  bool arm();
+  void disarm();
+  bool isArmed() const { return _armed; }
+
+  /**
+   * Clear the trip latch and the rule state; the output stays off
+   */
+  void reset();
+  bool isTripped() const { return _tripped; }
+
+  void setTripCallback(TripCallback callback, void* context);
+
+  /**
+   * Fast poll for loop(): refresh the output block when the interval has
+   * passed (default 20 ms)
+   */
+  void setPollInterval(uint32_t intervalMs) { _pollMs = (intervalMs == 0) ? 1 : intervalMs; }
+  bool update();
+
+#if defined(ESP32)
+  /**
+   * Arm and fast poll the output block in a dedicated FreeRTOS task
+   */
+  bool startTask(UBaseType_t priority = 4, BaseType_t core = -1);
+  void stopTask() { _taskStop = true; }
+  bool isTaskRunning() const { return _task.isRunning(); }
+#endif
+
+  const WatchdogStats& getStats() const { return _stats; }
+  uint32_t getWorstCaseResponseMicros() const { return _stats.maxSampleGapMicros + _stats.worstResponseMicros; }
+
+  // Trip log, oldest first
+  uint8_t getTripCount() const { return _logCount; }
+  const WatchdogTrip& getTrip(uint8_t index) const;
+
+private:
+  struct Rule {
+    WatchdogRuleType type;
+    float limit;
+    uint32_t timeMs;          // Hold time, or window length for RULE_AVERAGE_POWER
+    bool violating;
+    uint32_t violatingSince;  // Sample micros the violation started
+    // Sliding window for RULE_AVERAGE_POWER
+    float slotEnergy[WATCHDOG_WINDOW_SLOTS]; // W * us
+    uint32_t slotTime[WATCHDOG_WINDOW_SLOTS]; // us
+    uint8_t slot;
+  };
+
+  int8_t addRule(WatchdogRuleType type, float limit, uint32_t timeMs);
+  static void onSample(void* context, XY_SKxxx& device, const DeviceStatus& status, uint32_t sampleMicros);
+  void evaluate(const DeviceStatus& status, uint32_t sampleMicros);
+  float averagePower(Rule& rule, float power, uint32_t elapsed, bool& windowFull);
+  void trip(uint8_t index, float value, uint32_t sampleMicros);
+
+#if defined(ESP32)
+  static void taskEntry(void* context);
+  xy_sk::HelperTask _task;
+  volatile bool _taskStop;
+#endif
+
+  XY_SKxxx& _device;
+  Rule _rules[WATCHDOG_MAX_RULES];
+  uint8_t _ruleCount;
+  volatile bool _armed;
+  volatile bool _tripped;
+  TripCallback _callback;
+  void* _callbackContext;
+  uint32_t _pollMs;
+  unsigned long _lastPoll;
+
+  bool _havePrevious;
+  uint32_t _lastSample;     // Sample micros
+  float _lastCurrent;
+
+  WatchdogTrip _log[WATCHDOG_LOG_SIZE];
+  uint8_t _logHead;         // Next entry to write
+  uint8_t _logCount;
+
+  WatchdogStats _stats;
+};
+
+#endif // XY_SKXXX_WATCHDOG_H
@@ -0,0 +1,279 @@
+#include "XY-SKxxx-internal.h"
+#include "XY-SKxxx-waveform.h"
+
+XY_SKxxxWaveform::XY_SKxxxWaveform(XY_SKxxx& device, WaveformTarget target)
+  : _device(device), _target(target), _count(0), _periodMicros(20000), _cycles(0),
+    _running(false), _stopRequested(false), _start(0), _nextSample(0), _restoreValue(0),
+    _restoreKnown(false), _lastMicros(0), _clockHigh(0) {
+#if defined(ESP32)
+  _timer = nullptr;
+#endif
+  memset(_table, 0, sizeof(_table));
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+XY_SKxxxWaveform::~XY_SKxxxWaveform() {
+  stop();
+#if defined(ESP32)
+  _task.join();
+#endif
+  if (_running) {
+    finish();
+  }
+}
+
+void XY_SKxxxWaveform::setTarget(WaveformTarget target) {
+  if (_running || target == _target) {
+    return;
+  }
+  // The table is scaled for one register
+  _target = target;
+  _count = 0;
+}
+
+bool XY_SKxxxWaveform::toRaw(float value, uint16_t& raw) const {
+  const xy_sk::ModelInfo& model = _device.getModelInfo();
+  float limit = (_target == WAVE_VOLTAGE) ? model.maxVoltage : model.maxCurrent;
+  uint16_t scale = (_target == WAVE_VOLTAGE) ? model.voltageScale : model.currentScale;
+  if (value < 0.0f || value > limit) {
+    return false;
+  }
+  raw = (uint16_t)(value * scale + 0.5f);
+  return true;
+}
+
+float XY_SKxxxWaveform::getPoint(uint16_t index) const {
+  const xy_sk::ModelInfo& model = _device.getModelInfo();
+  uint16_t scale = (_target == WAVE_VOLTAGE) ? model.voltageScale : model.currentScale;
+  return _table[index] / (float)scale;
+}
+
+bool XY_SKxxxWaveform::generateSine(float offset, float amplitude, uint16_t points) {
+  if (_running || points < 2 || points > WAVEFORM_MAX_POINTS) {
+    return false;
+  }
+  uint16_t table[WAVEFORM_MAX_POINTS];
+  for (uint16_t i = 0; i < points; i++) {
+    if (!toRaw(offset + amplitude * sinf(2.0f * PI * i / points), table[i])) {
+      return false;
+    }
+  }
+  memcpy(_table, table, points * sizeof(uint16_t));
+  _count = points;
+  return true;
+}
+
+bool XY_SKxxxWaveform::generateTriangle(float low, float high, uint16_t points) {
+  if (_running || points < 2 || points > WAVEFORM_MAX_POINTS) {
+    return false;
+  }
+  uint16_t table[WAVEFORM_MAX_POINTS];
+  for (uint16_t i = 0; i < points; i++) {
+    float phase = (float)i / points;
+    float shape = (phase < 0.5f) ? 2.0f * phase : 2.0f * (1.0f - phase);
+    if (!toRaw(low + (high - low) * shape, table[i])) {
+      return false;
+    }
+  }
+  memcpy(_table, table, points * sizeof(uint16_t));
+  _count = points;
+  return true;
+}
+
+bool XY_SKxxxWaveform::loadCsv(const char* csv) {
+  if (_running || csv == nullptr) {
+    return false;
+  }
+  uint16_t table[WAVEFORM_MAX_POINTS];
+  uint16_t count = 0;
+  const char* p = csv;
+  while (true) {
+    while (*p == ',' || *p == ';' || isspace((unsigned char)*p)) {
+      p++;
+    }
+    if (*p == '\0') {
+      break;
+    }
+    char* end;
+    float value = strtof(p, &end);
+    if (end == p || count >= WAVEFORM_MAX_POINTS || !toRaw(value, table[count])) {
+      return false;
+    }
+    count++;
+    p = end;
+  }
+  if (count == 0) {
+    return false;
+  }
+  memcpy(_table, table, count * sizeof(uint16_t));
+  _count = count;
+  return true;
+}
+
+uint32_t XY_SKxxxWaveform::getMinimumPeriodMicros(uint32_t turnaroundMicros) const {
+  xy_sk::RtuBus& bus = _device.getBus();
+  // FC06 request and its echo are 8 bytes each, 11 bits per character
+  uint32_t frameMicros = (uint32_t)((16ULL * 11ULL * 1000000ULL) / bus.getBaudRate());
+  // The bus keeps twice the silent interval between frames
+  return frameMicros + turnaroundMicros + bus.getSilentInterval() * 2000UL;
+}
+
+uint64_t XY_SKxxxWaveform::clockMicros() {
+#if defined(ESP32)
+  // Same time base as the esp_timer driving the writes
+  return (uint64_t)esp_timer_get_time();
+#else
+  uint32_t now = micros();
+  if (now < _lastMicros) {
+    _clockHigh += 1ULL << 32;
+  }
+  _lastMicros = now;
+  return _clockHigh | now;
+#endif
+}
+
+uint32_t XY_SKxxxWaveform::getMeanJitterMicros() const {
+  uint32_t samples = _stats.writes + _stats.failures;
+  return (samples == 0) ? 0 : (uint32_t)(_stats.totalJitterMicros / samples);
+}
+
+float XY_SKxxxWaveform::getWriteRate() const {
+  return (_stats.elapsedMs == 0) ? 0.0f : _stats.writes * 1000.0f / _stats.elapsedMs;
+}
+
+bool XY_SKxxxWaveform::start() {
+  if (_running || _count == 0 || _periodMicros == 0) {
+    return false;
+  }
+
+  uint16_t reg = (_target == WAVE_VOLTAGE) ? REG_V_SET : REG_I_SET;
+  _restoreKnown = _device.readRegister(reg, _restoreValue);
+
+  memset(&_stats, 0, sizeof(_stats));
+  _stats.minJitterMicros = INT32_MAX;
+  _stats.maxJitterMicros = INT32_MIN;
+  _nextSample = 0;
+  _stopRequested = false;
+  _start = clockMicros();
+  _running = true;
+  return true;
+}
+
+void XY_SKxxxWaveform::stop() {
+  if (_running) {
+    _stopRequested = true;
+  }
+}
+
+bool XY_SKxxxWaveform::update() {
+  if (!_running) {
+    return false;
+  }
+  if (_stopRequested) {
+    finish();
+    return false;
+  }
+
+  uint64_t elapsed = clockMicros() - _start;
+  uint64_t slot = elapsed / _periodMicros;
+  if (slot < _nextSample) {
+    return true;
+  }
+  if (_cycles != 0 && slot >= (uint64_t)_cycles * _count) {
+    finish();
+    return false;
+  }
+
+  // Stay in phase: samples whose period has already passed are dropped
+  if (slot > _nextSample) {
+    _stats.skipped += (uint32_t)(slot - _nextSample);
+  }
+
+  int32_t jitter = (int32_t)(elapsed - slot * _periodMicros);
+  _stats.totalJitterMicros += (uint32_t)jitter;
+  if (jitter < _stats.minJitterMicros) {
+    _stats.minJitterMicros = jitter;
+  }
+  if (jitter > _stats.maxJitterMicros) {
+    _stats.maxJitterMicros = jitter;
+  }
+
+  // A late retry would only be overwritten by the next sample, so none is made
+  uint16_t value = _table[slot % _count];
+  uint16_t reg = (_target == WAVE_VOLTAGE) ? REG_V_SET : REG_I_SET;
+  xy_sk::RtuRequest request = {_device.getSlaveID(), xy_sk::RtuFunction::WRITE_SINGLE_REGISTER, 0, 0, nullptr,
+                               reg, 1, &value};
+  if (_device.getBus().execute(request) == xy_sk::RtuStatus::SUCCESS) {
+    _stats.writes++;
+  } else {
+    _stats.failures++;
+  }
+
+  _nextSample = slot + 1;
+  _stats.periods = (uint32_t)(_nextSample / _count);
+  _stats.elapsedMs = (uint32_t)((clockMicros() - _start) / 1000);
+  return true;
+}
+
+void XY_SKxxxWaveform::finish() {
+  _running = false;
+  _stopRequested = false;
+  if (_restoreKnown) {
+    _device.writeRegister((_target == WAVE_VOLTAGE) ? REG_V_SET : REG_I_SET, _restoreValue);
+  }
+  xy_sk::resyncSetpoints(_device);
+}
+
+#if defined(ESP32)
+bool XY_SKxxxWaveform::startTimer(UBaseType_t priority, BaseType_t core) {
+  if (_task.isRunning() || !start()) {
+    return false;
+  }
+
+  esp_timer_create_args_t args = {};
+  args.callback = timerCallback;
+  args.arg = this;
+  args.name = "xy_waveform";
+  if (esp_timer_create(&args, &_timer) != ESP_OK) {
+    _timer = nullptr;
+    finish();
+    return false;
+  }
+
+  if (!_task.start("xy_waveform", taskEntry, this, priority, core)) {
+    esp_timer_delete(_timer);
+    _timer = nullptr;
+    finish();
+    return false;
+  }
+
+  // Phase reference is the timer start; sample 0 is written right away
+  _start = clockMicros();
+  esp_timer_start_periodic(_timer, _periodMicros);
+  xTaskNotifyGive(_task.getHandle());
+  return true;
+}
+
+void XY_SKxxxWaveform::timerCallback(void* context) {
+  XY_SKxxxWaveform* waveform = static_cast<XY_SKxxxWaveform*>(context);
+  if (waveform->_task.isRunning()) {
+    xTaskNotifyGive(waveform->_task.getHandle());
+  }
+}
+
+void XY_SKxxxWaveform::taskEntry(void* context) {
+  XY_SKxxxWaveform* waveform = static_cast<XY_SKxxxWaveform*>(context);
+  while (true) {
+    // The timeout lets stop() take effect even if timer events were lost
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+    if (!waveform->update()) {
+      break;
+    }
+  }
+
+  esp_timer_stop(waveform->_timer);
+  esp_timer_delete(waveform->_timer);
+  waveform->_timer = nullptr;
+  waveform->_task.exit();
+}
+#endif
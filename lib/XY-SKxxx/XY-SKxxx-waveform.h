@@ -0,0 +1,145 @@
+#ifndef XY_SKXXX_WAVEFORM_H
+#define XY_SKXXX_WAVEFORM_H
+
+#include <Arduino.h>
+#include "XY-SKxxx.h"
+#include "XY-SKxxx-task.h"
+
+#if defined(ESP32)
+#include <esp_timer.h>
+#endif
+
+#define WAVEFORM_MAX_POINTS 256
+
+// Setpoint register the waveform is streamed to
+enum WaveformTarget {
+  WAVE_VOLTAGE = 0,  // REG_V_SET
+  WAVE_CURRENT = 1   // REG_I_SET
+};
+
+struct WaveformStats {
+  uint32_t writes;
+  uint32_t failures;
+  uint32_t skipped;            // Samples dropped to stay in phase after a slow write
+  uint32_t periods;            // Completed passes through the table
+  int32_t minJitterMicros;
+  int32_t maxJitterMicros;
+  uint64_t totalJitterMicros;
+  uint32_t elapsedMs;
+};
+
+/**
+ * Arbitrary waveform output
+ *
+ * A waveform (sine, triangle or a list of values) is converted once into
+ * a table of raw setpoint register values at the model's resolution. While
+ * running, one table entry is written per sample period with a single
+ * FC06 frame straight through the bus: no retries, no caching and no float
+ * conversion in the write path. The sample due is derived from the time
+ * since start, so a write that overruns its period skips the samples it
+ * missed instead of shifting the phase of everything after it.
+ *
+ * On ESP32 startTimer() phase-locks the writes to a periodic esp_timer that
+ * wakes a dedicated task; elsewhere update() is called from loop(). When
+ * the waveform ends or is stopped, the setpoint it started from is
+ * restored.
+ */
+class XY_SKxxxWaveform {
+public:
+  explicit XY_SKxxxWaveform(XY_SKxxx& device, WaveformTarget target = WAVE_VOLTAGE);
+  ~XY_SKxxxWaveform();
+  XY_SKxxxWaveform(const XY_SKxxxWaveform&) = delete;
+  XY_SKxxxWaveform& operator=(const XY_SKxxxWaveform&) = delete;
+
+  // Table building, values are in V or A; false if out of the model limits or running
+  void setTarget(WaveformTarget target);
+  WaveformTarget getTarget() const { return _target; }
+  bool generateSine(float offset, float amplitude, uint16_t points);
+  bool generateTriangle(float low, float high, uint16_t points);
+
+  /**
+   * Load values separated by commas, spaces or line breaks
+   */
+  bool loadCsv(const char* csv);
+
+  uint16_t size() const { return _count; }
+  uint16_t getRawPoint(uint16_t index) const { return _table[index]; }
+  float getPoint(uint16_t index) const;
+
+  /**
+   * Time between two written samples
+   */
+  void setSamplePeriod(uint32_t periodMicros) { _periodMicros = periodMicros; }
+  uint32_t getSamplePeriod() const { return _periodMicros; }
+
+  /**
+   * Shortest sample period the bus can carry: FC06 request and echo at the
+   * current baud rate plus the given slave turnaround
+   */
+  uint32_t getMinimumPeriodMicros(uint32_t turnaroundMicros = 2000) const;
+
+  /**
+   * Passes through the table, 0 runs until stop()
+   */
+  void setCycles(uint32_t cycles) { _cycles = cycles; }
+
+  bool start();
+
+  /**
+   * Stop after the current sample, the next update() restores the setpoint
+   */
+  void stop();
+
+  /**
+   * Write the sample that is due, if any
+   *
+   * @return true while the waveform is running
+   */
+  bool update();
+
+#if defined(ESP32)
+  /**
+   * start() with writes driven by a periodic esp_timer and a dedicated task
+   */
+  bool startTimer(UBaseType_t priority = 3, BaseType_t core = -1);
+  bool isTimerRunning() const { return _task.isRunning(); }
+#endif
+
+  bool isRunning() const { return _running; }
+  const WaveformStats& getStats() const { return _stats; }
+  uint32_t getMeanJitterMicros() const;
+  float getWriteRate() const; // Achieved writes per second
+
+private:
+  bool toRaw(float value, uint16_t& raw) const;
+  uint64_t clockMicros();
+  void finish();
+
+#if defined(ESP32)
+  static void timerCallback(void* context);
+  static void taskEntry(void* context);
+  esp_timer_handle_t _timer;
+  xy_sk::HelperTask _task;
+#endif
+
+  XY_SKxxx& _device;
+  WaveformTarget _target;
+  uint16_t _table[WAVEFORM_MAX_POINTS];
+  uint16_t _count;
+  uint32_t _periodMicros;
+  uint32_t _cycles;
+
+  volatile bool _running;
+  volatile bool _stopRequested;
+  uint64_t _start;
+  uint64_t _nextSample;     // Index of the next sample since start
+  uint16_t _restoreValue;   // Raw setpoint before start()
+  bool _restoreKnown;
+
+  uint32_t _lastMicros;
+  uint64_t _clockHigh;
+
+  WaveformStats _stats;
+};
+
+#endif // XY_SKXXX_WAVEFORM_H
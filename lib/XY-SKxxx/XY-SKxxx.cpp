@@ -1,22 +1,41 @@
 #include "XY-SKxxx-internal.h" // Include internal header
 #include "XY-SKxxx-cd-data-group.h" // Add include for the memory group header
 
-/* Initialize static member */
-XY_SKxxx* XY_SKxxx::_instance = nullptr;
-
 XY_SKxxx::XY_SKxxx(uint8_t rxPin, uint8_t txPin, uint8_t slaveID)
-  : _rxPin(rxPin), _txPin(txPin), _slaveID(slaveID), _lastCommsTime(0), _silentIntervalTime(0),
+  : XY_SKxxx(*new xy_sk::RtuBus(), slaveID) {
+  _rxPin = rxPin;
+  _txPin = txPin;
+  _ownsBus = true;
+}
+
+XY_SKxxx::XY_SKxxx(xy_sk::RtuBus& bus, uint8_t slaveID)
+  : modbus(bus.master()), _rxPin(0), _txPin(0), _slaveID(slaveID), _bus(&bus), _ownsBus(false),
+    _pollWeight(1), _pollStep(0), _crPollTurn(0), _model(&xy_sk::defaultModel()), _modelFixed(false),
     _lastOutputUpdate(0), _lastSettingsUpdate(0), _lastEnergyUpdate(0), _lastTempUpdate(0), 
-    _lastStateUpdate(0), _lastConstantVCUpdate(0), _lastVoltageCurrentProtectionUpdate(0),
-    _lastPowerProtectionUpdate(0), _lastEnergyProtectionUpdate(0), _lastTempProtectionUpdate(0),
-    _lastStartupSettingUpdate(0), _lastBatteryCutoffUpdate(0), _lastCommunicationSettingsUpdate(0),
-    _lastConstantPowerUpdate(0), _cacheTimeout(5000), _cacheValid(false) {
-  // Store instance pointer for static callback use
-  _instance = this;
-  
+    _lastStateUpdate(0), _cacheTimeout(5000), _cacheValid(false),
+    _lastError(xy_sk::RtuStatus::SUCCESS), _outputWrites(0), _readFrames(0), _lastConstantPowerUpdate(0) {
   // Initialize device status with default values
   memset(&_status, 0, sizeof(DeviceStatus));
+  memset(_sampleHooks, 0, sizeof(_sampleHooks));
   memset(&_protection, 0, sizeof(ProtectionSettings)); 
+  memset(&_energy, 0, sizeof(_energy));
+  _energyFromZero = false;
+  memset(_subscriptions, 0, sizeof(_subscriptions));
+  memset(_fieldSetSubscriptions, 0, sizeof(_fieldSetSubscriptions));
+  memset(_shadow, 0, sizeof(_shadow));
+  memset(_shadowValid, 0, sizeof(_shadowValid));
+  memset(_shadowTime, 0, sizeof(_shadowTime));
+  memset(_cacheStats, 0, sizeof(_cacheStats));
+  
+  // Constant Resistance emulation is off until enabled
+  _crEnabled = false;
+  _crTarget = 0.0f;
+  _crGain = 0.5f;
+  _crTolerance = 0.02f;
+  _crSetVoltage = 0.0f;
+  _crRaw = 0;
+  resetConstantResistanceTracking();
+  memset(&_crStats, 0, sizeof(_crStats));
   
   // Initialize memory group cache
   for (int i = 0; i < 10; i++) {
@@ -29,36 +48,89 @@ XY_SKxxx::XY_SKxxx(uint8_t rxPin, uint8_t txPin, uint8_t slaveID)
   _cachedBaudRateCode = 6; // Default is 115200 (code 6)
 }
 
+XY_SKxxx::~XY_SKxxx() {
+  _bus->detach(this);
+  if (_ownsBus) {
+    delete _bus;
+  }
+}
+
 void XY_SKxxx::begin(long baudRate) {
-  _baudRate = baudRate;
-  _silentIntervalTime = silentInterval(baudRate);
-  
-  // Initialize hardware serial for XIAO ESP32S3
-  Serial1.begin(baudRate, SERIAL_8N1, _rxPin, _txPin);
-  
-  // Initialize ModbusMaster with Serial1
-  modbus.begin(_slaveID, Serial1);
+  if (_ownsBus) {
+    // Initialize hardware serial for XIAO ESP32S3
+    _bus->begin(Serial1, baudRate, _rxPin, _txPin);
+  }
+  begin();
+}
+
+void XY_SKxxx::begin() {
+  // Register with the bus scheduler for background cache refreshes
+  _bus->attach(_slaveID, staticPollCache, this, _pollWeight);
+}
+
+void XY_SKxxx::setPollWeight(uint8_t weight) {
+  _pollWeight = (weight == 0) ? 1 : weight;
+  _bus->attach(_slaveID, staticPollCache, this, _pollWeight);
+}
+
+bool XY_SKxxx::staticPollCache(void* context) {
+  return static_cast<XY_SKxxx*>(context)->pollCache();
+}
+
+bool XY_SKxxx::pollCache() {
+  // The emulated CR mode needs the fastest loop the bus allows, the
+  // cache groups still get every fourth turn
+  if (_crEnabled && (++_crPollTurn & 0x03) != 0) {
+    return updateConstantResistance();
+  }
   
-  // Set up pre and post transmission callbacks using static functions
-  modbus.preTransmission(staticPreTransmission);
-  modbus.postTransmission(staticPostTransmission);
+  // One cache group per turn so the shared wire is handed on quickly.
+  // Groups that are still fresh, or not in this model's poll plan, are
+  // skipped without bus traffic.
+  for (uint8_t i = 0; i < xy_sk::POLL_GROUP_COUNT; i++) {
+    uint8_t step = _pollStep;
+    _pollStep = (_pollStep + 1) % xy_sk::POLL_GROUP_COUNT;
+    
+    if (!(_model->pollPlan & (1 << step))) {
+      continue;
+    }
+    
+    switch (step) {
+      case 0:
+        if (millis() - _lastOutputUpdate >= _cacheTimeout) return updateOutputStatus(true);
+        break;
+      case 1:
+        if (millis() - _lastStateUpdate >= _cacheTimeout) return updateDeviceState(true);
+        break;
+      case 2:
+        if (millis() - _lastSettingsUpdate >= _cacheTimeout) return updateDeviceSettings(true);
+        break;
+      case 3:
+        if (millis() - _lastEnergyUpdate >= _cacheTimeout) return updateEnergyMeters(true);
+        break;
+      case 4:
+        if (millis() - _lastTempUpdate >= _cacheTimeout) return updateTemperatures(true);
+        break;
+      case 5:
+        if (millis() - _lastConstantPowerUpdate >= _cacheTimeout) return updateConstantPowerSettings(true);
+        break;
+    }
+  }
+  return true;
 }
 
-/* Modbus RTU timing methods */
+void XY_SKxxx::setModelInfo(const xy_sk::ModelInfo& model) {
+  _model = &model;
+  _modelFixed = true;
+}
+
+/* Modbus RTU timing methods - the timing state lives in the shared bus */
 unsigned long XY_SKxxx::silentInterval(unsigned long baudRate) {
-  // 3.5 character times = 3.5 * (11 bits/character)
-  // 11 bits = 1 start bit + 8 data bits + 1 parity bit + 1 stop bit in Modbus-RTU asynchronous transmission
-  float characterTime = 1000.0 / (float)(baudRate / 11.0); // Milliseconds per character
-  return (unsigned long)(3.5 * characterTime);
+  return xy_sk::RtuBus::silentInterval(baudRate);
 }
 
 void XY_SKxxx::waitForSilentInterval() {
-  unsigned long elapsed = millis() - _lastCommsTime;
-  // Use a longer wait time to ensure device is ready
-  if (elapsed < (_silentIntervalTime * 2) && _lastCommsTime > 0) {
-    // Need to wait for the remaining silent interval time
-    delay((_silentIntervalTime * 2) - elapsed);
-  }
+  _bus->waitForSilentInterval();
 }
 
 bool XY_SKxxx::preTransmission() {
@@ -67,23 +139,13 @@ bool XY_SKxxx::preTransmission() {
 }
 
 bool XY_SKxxx::postTransmission() {
-  _lastCommsTime = millis();
+  _bus->markActivity();
   return true;
 }
 
-void XY_SKxxx::staticPreTransmission() {
-  if (_instance) {
-    _instance->preTransmission();
-  }
-}
-
-void XY_SKxxx::staticPostTransmission() {
-  if (_instance) {
-    _instance->postTransmission();
-  }
-}
-
 bool XY_SKxxx::testConnection() {
+  // Ask the device, not the shadow
+  invalidateShadow(REG_MODEL, 1);
   waitForSilentInterval();
   preTransmission();
   uint16_t model = getModel();
@@ -92,48 +154,113 @@ bool XY_SKxxx::testConnection() {
 }
 
 // Direct register access methods for memory groups
+// Register data is decoded by the RTU master straight into the caller's buffer
 bool XY_SKxxx::readRegisters(uint16_t addr, uint16_t count, uint16_t* buffer) {
-  waitForSilentInterval();
-  uint8_t result = modbus.readHoldingRegisters(addr, count);
-  if (result == modbus.ku8MBSuccess) {
-    for (uint16_t i = 0; i < count; i++) {
-      buffer[i] = modbus.getResponseBuffer(i);
-    }
-    _lastCommsTime = millis();
+  // Settings that are still fresh need no frame
+  bool cacheable = (count > 0);
+  for (uint16_t i = 0; i < count && cacheable; i++) {
+    cacheable = isShadowCacheable(addr + i);
+  }
+  if (cacheable && getShadowRegisters(addr, count, buffer, _cacheTimeout)) {
     return true;
   }
-  _lastCommsTime = millis();
-  return false;
+  return readRegistersDirect(addr, count, buffer);
 }
 
-bool XY_SKxxx::writeRegister(uint16_t addr, uint16_t value) {
-  waitForSilentInterval();
-  uint8_t result = modbus.writeSingleRegister(addr, value);
-  _lastCommsTime = millis();
-  return (result == modbus.ku8MBSuccess);
+bool XY_SKxxx::readRegistersDirect(uint16_t addr, uint16_t count, uint16_t* buffer) {
+  // The shadow must not take an older reply after a newer write
+  _bus->lock();
+  bool success = true;
+  uint16_t sampleAddr = 0;
+  uint16_t sampleCount = 0;
+  uint32_t sampleMicros = 0;
+  // Blocks longer than the model accepts are split into several reads
+  while (count > 0) {
+    uint16_t chunk = (count > _model->maxBlockRegisters) ? _model->maxBlockRegisters : count;
+    xy_sk::RtuRequest request = {_slaveID, xy_sk::RtuFunction::READ_HOLDING_REGISTERS, addr, chunk, buffer, 0, 0, nullptr};
+    _readFrames++;
+    if (!transact(xy_sk::OperationType::READ, request)) {
+      success = false;
+      break;
+    }
+    if (addr <= REG_VOUT && addr + chunk > REG_IOUT) {
+      sampleAddr = addr;
+      sampleCount = chunk;
+      sampleMicros = micros();
+    }
+    storeShadow(addr, chunk, buffer);
+    addr += chunk;
+    buffer += chunk;
+    count -= chunk;
+  }
+  _bus->unlock();
+  
+  // Every output sample reaches the hooks, whoever read it
+  if (sampleCount > 0) {
+    decodeOutputSample(sampleAddr, sampleCount, sampleMicros);
+  }
+  return success;
 }
 
-bool XY_SKxxx::writeRegisters(uint16_t addr, uint16_t count, uint16_t* buffer) {
-  waitForSilentInterval();
-  for (uint16_t i = 0; i < count; i++) {
-    modbus.setTransmitBuffer(i, buffer[i]);
+bool XY_SKxxx::writeRegister(uint16_t addr, uint16_t value) {
+  xy_sk::RtuRequest request = {_slaveID, xy_sk::RtuFunction::WRITE_SINGLE_REGISTER, 0, 0, nullptr, addr, 1, &value};
+  _bus->lock();
+  countWrite(addr, 1);
+  bool success = transact(xy_sk::OperationType::WRITE, request);
+  if (success) {
+    storeShadow(addr, 1, &value);
+    invalidateWriteSideEffects(addr, 1);
   }
-  uint8_t result = modbus.writeMultipleRegisters(addr, count);
-  _lastCommsTime = millis();
-  return (result == modbus.ku8MBSuccess);
+  _bus->unlock();
+  return success;
 }
 
-// Add a single register read method
-bool XY_SKxxx::readRegister(uint16_t addr, uint16_t& value) {
-  waitForSilentInterval();
-  uint16_t buffer[1];
-  bool success = readRegisters(addr, 1, buffer);
+bool XY_SKxxx::writeRegisters(uint16_t addr, uint16_t count, const uint16_t* buffer) {
+  xy_sk::RtuRequest request = {_slaveID, xy_sk::RtuFunction::WRITE_MULTIPLE_REGISTERS, 0, 0, nullptr, addr, count, buffer};
+  _bus->lock();
+  countWrite(addr, count);
+  bool success = transact(xy_sk::OperationType::WRITE, request);
   if (success) {
-    value = buffer[0];
+    storeShadow(addr, count, buffer);
+    invalidateWriteSideEffects(addr, count);
   }
+  _bus->unlock();
   return success;
 }
 
+bool XY_SKxxx::transact(xy_sk::OperationType type, const xy_sk::RtuRequest& request) {
+  // The caller holds the bus lock; the master's timeout belongs to this
+  // request only while an attempt is on the wire
+  unsigned long startTime = millis();
+  uint8_t attempts = 0;
+  
+  while (true) {
+    // Never wait for a reply longer than the budget that is left
+    unsigned long ceiling = modbus.getResponseTimeout();
+    unsigned long remaining = retryPolicy.remainingBudget(millis() - startTime);
+    modbus.setResponseTimeout((remaining > 0 && remaining < ceiling) ? remaining : ceiling);
+    _lastError = _bus->execute(request);
+    modbus.setResponseTimeout(ceiling);
+    attempts++;
+    
+    unsigned long backoff;
+    if (!retryPolicy.shouldRetry(type, _lastError, attempts, millis() - startTime, backoff)) {
+      break;
+    }
+    // Other tasks may use the bus while this one backs off
+    _bus->pause(backoff);
+  }
+  
+  bool success = (_lastError == xy_sk::RtuStatus::SUCCESS);
+  retryPolicy.recordOutcome(success, attempts);
+  return success;
+}
+
+// Add a single register read method
+bool XY_SKxxx::readRegister(uint16_t addr, uint16_t& value) {
+  return readRegisters(addr, 1, &value);
+}
+
 // Add memory group methods implementation
 bool XY_SKxxx::readMemoryGroup(xy_sk::MemoryGroup group, uint16_t* data, bool force) {
     // Try to get from cache first unless forced refresh is requested
@@ -141,9 +268,10 @@ bool XY_SKxxx::readMemoryGroup(xy_sk::MemoryGroup group, uint16_t* data, bool fo
         return true;
     }
     
-    // Cache miss or forced refresh - read from device
+    // Cache miss or forced refresh - read from device, a forced one past the shadow
     uint16_t startAddr = xy_sk::DataGroupManager::getGroupStartAddress(group);
-    bool success = readRegisters(startAddr, xy_sk::DATA_GROUP_REGISTERS, data);
+    bool success = force ? readRegistersDirect(startAddr, xy_sk::DATA_GROUP_REGISTERS, data)
+                         : readRegisters(startAddr, xy_sk::DATA_GROUP_REGISTERS, data);
     
     // Update cache if read was successful
     if (success) {
@@ -158,7 +286,7 @@ bool XY_SKxxx::readMemoryGroup(xy_sk::MemoryGroup group, uint16_t* data, bool fo
 
 bool XY_SKxxx::writeMemoryGroup(xy_sk::MemoryGroup group, const uint16_t* data) {
     uint16_t startAddr = xy_sk::DataGroupManager::getGroupStartAddress(group);
-    bool success = writeRegisters(startAddr, xy_sk::DATA_GROUP_REGISTERS, const_cast<uint16_t*>(data));
+    bool success = writeRegisters(startAddr, xy_sk::DATA_GROUP_REGISTERS, data);
     
     // Update cache if write was successful
     if (success) {
@@ -225,35 +353,50 @@ bool XY_SKxxx::writeGroupRegister(xy_sk::MemoryGroup group, xy_sk::GroupRegister
 
 bool XY_SKxxx::getCachedMemoryGroup(xy_sk::MemoryGroup group, uint16_t* data, bool refresh) {
     uint8_t groupIdx = static_cast<uint8_t>(group);
-    
-    // Check if refresh is requested or if cache is invalid
-    if (refresh || !groupCache[groupIdx].valid) {
-        return updateMemoryGroupCache(group, true);
-    }
-    
-    // Check if cache is stale (older than 5 seconds)
     unsigned long currentTime = millis();
-    unsigned long cacheAge = currentTime - groupCache[groupIdx].lastUpdate;
-    if (cacheAge > 5000) { // 5 seconds cache validity
-        return updateMemoryGroupCache(group, true);
+    unsigned long cacheAge = groupCache[groupIdx].valid ? currentTime - groupCache[groupIdx].lastUpdate
+                                                        : XY_SKXXX_SHADOW_FOREVER;
+    uint32_t mark = beginCacheAccess(CACHE_MEMORY_GROUP, refresh, cacheAge);
+    
+    // Check if refresh is requested, the cache is invalid or stale (older than 5 seconds)
+    if (refresh || !groupCache[groupIdx].valid || cacheAge > 5000) {
+        // Only a requested refresh has to bypass the register shadow
+        groupCache[groupIdx].valid = false;
+        if (!updateMemoryGroupCache(group, refresh)) {
+            endCacheAccess(CACHE_MEMORY_GROUP, refresh, mark, cacheAge);
+            return false;
+        }
+        // A shadow answer is as old as its oldest register, not brand new
+        cacheAge = millis() - groupCache[groupIdx].lastUpdate;
     }
     
     // Copy data from cache
     memcpy(data, groupCache[groupIdx].values, xy_sk::DATA_GROUP_REGISTERS * sizeof(uint16_t));
+    endCacheAccess(CACHE_MEMORY_GROUP, refresh, mark, cacheAge);
     return true;
 }
 
 bool XY_SKxxx::updateMemoryGroupCache(xy_sk::MemoryGroup group, bool force) {
     uint8_t groupIdx = static_cast<uint8_t>(group);
     
-    // Only update if forced or cache is invalid
+    // Only update if forced or cache is invalid; forced reads skip the register shadow
     if (force || !groupCache[groupIdx].valid) {
         uint16_t startAddr = xy_sk::DataGroupManager::getGroupStartAddress(group);
-        bool success = readRegisters(startAddr, xy_sk::DATA_GROUP_REGISTERS, groupCache[groupIdx].values);
+        bool success = force ? readRegistersDirect(startAddr, xy_sk::DATA_GROUP_REGISTERS, groupCache[groupIdx].values)
+                             : readRegisters(startAddr, xy_sk::DATA_GROUP_REGISTERS, groupCache[groupIdx].values);
         
         if (success) {
+            // Both paths leave the group in the shadow, date the copy by
+            // its oldest register
+            unsigned long age = 0;
+            for (uint16_t i = 0; i < xy_sk::DATA_GROUP_REGISTERS; i++) {
+                unsigned long regAge = getShadowAge(startAddr + i);
+                if (regAge != XY_SKXXX_SHADOW_FOREVER && regAge > age) {
+                    age = regAge;
+                }
+            }
             groupCache[groupIdx].valid = true;
-            groupCache[groupIdx].lastUpdate = millis();
+            groupCache[groupIdx].lastUpdate = millis() - age;
         } else {
             groupCache[groupIdx].valid = false;
         }
@@ -266,6 +409,10 @@ bool XY_SKxxx::updateMemoryGroupCache(xy_sk::MemoryGroup group, bool force) {
 
 // Battery cutoff methods
 bool XY_SKxxx::setBatteryCutoffCurrent(float current) {
+  if (!hasFeature(xy_sk::FEATURE_BATTERY_CUTOFF)) {
+    return false;
+  }
+  
   // Battery cutoff current is stored with 3 decimal places
   uint16_t value = current * 1000;
   
@@ -274,13 +421,16 @@ bool XY_SKxxx::setBatteryCutoffCurrent(float current) {
   bool success = writeRegister(REG_BTF, value);
   if (success) {
     _protection.batteryCutoffCurrent = current;
-    _lastBatteryCutoffUpdate = millis();
   }
   
   return success;
 }
 
 bool XY_SKxxx::getBatteryCutoffCurrent(float &current) {
+  if (!hasFeature(xy_sk::FEATURE_BATTERY_CUTOFF)) {
+    return false;
+  }
+  
   uint16_t value;
   
   waitForSilentInterval();
@@ -288,7 +438,6 @@ bool XY_SKxxx::getBatteryCutoffCurrent(float &current) {
   if (readRegister(REG_BTF, value)) {
     current = value / 1000.0f;
     _protection.batteryCutoffCurrent = current;
-    _lastBatteryCutoffUpdate = millis();
     return true;
   }
   
@@ -2,7 +2,10 @@
 #define XY_SKXXX_H
 
 #include <Arduino.h>
-#include <ModbusMaster.h>
+#include "XY-SKxxx-rtu.h"
+#include "XY-SKxxx-bus.h"
+#include "XY-SKxxx-retry.h"
+#include "XY-SKxxx-model.h"
 #include "XY-SKxxx-cd-data-group.h" // Add this include for Memory Group definitions
 
 // Define Modbus register addresses (follow protocol naming convention, p.3 of documentation)
@@ -162,6 +165,17 @@ struct DeviceStatus {
   float constantPower;      // Constant Power setting (W)
 };
 
+// Energy counters extended to 64 bits, see XY_SKxxx::getEnergyCounters()
+struct EnergyCounters {
+  uint64_t ampHours;       // mAh, the device counter at the first read plus every step since,
+                           // or the steps since resetEnergyCounters(), across device resets
+  uint64_t wattHours;      // mWh
+  uint64_t outputTime;     // Seconds
+  uint32_t samples;        // Counter reads checked since the start or resetEnergyCounters()
+  uint32_t repaired;       // Torn reads repaired (a carry caught half done)
+  uint32_t resets;         // Counters cleared by the device
+};
+
 // Protection settings cache structure
 struct ProtectionSettings {
   // Constant Voltage/Current settings
@@ -198,21 +212,142 @@ struct ProtectionSettings {
 enum OperatingMode {
   MODE_CV = 0,  // Constant Voltage
   MODE_CC = 1,  // Constant Current
-  MODE_CP = 2   // Constant Power
+  MODE_CP = 2,  // Constant Power
+  MODE_CR = 3   // Constant Resistance, emulated by a control loop on the ESP
+};
+
+// Constant Resistance (CR) emulation loop metrics
+struct ConstantResistanceStats {
+  uint32_t iterations;     // Loop iterations since CR mode was enabled
+  uint32_t failures;       // Iterations whose read or write failed
+  uint32_t writes;         // V_SET writes
+  float loopRate;          // Iterations per second
+  float resistance;        // Last measured V/I (ohm)
+  float error;             // Last relative tracking error ((R - target) / target)
+  float rmsError;          // RMS relative error since the target was set
+  bool noLoad;             // Output current too low to measure a resistance
+  bool settled;            // Error stayed within tolerance for several iterations
+  uint32_t settlingMs;     // Target set to settled
+  unsigned long since;     // millis() when CR mode was enabled
+};
+
+// Cached status fields that can be subscribed to, see XY_SKxxx::subscribe()
+enum StatusField : uint8_t {
+  FIELD_OUTPUT_VOLTAGE = 0,
+  FIELD_OUTPUT_CURRENT,
+  FIELD_OUTPUT_POWER,
+  FIELD_INPUT_VOLTAGE,
+  FIELD_AMP_HOURS,
+  FIELD_WATT_HOURS,
+  FIELD_OUTPUT_TIME,
+  FIELD_INTERNAL_TEMP,
+  FIELD_EXTERNAL_TEMP,
+  FIELD_OUTPUT_ENABLED,
+  FIELD_KEY_LOCKED,
+  FIELD_PROTECTION_STATUS,
+  FIELD_CVCC_MODE,
+  FIELD_SYSTEM_STATUS,
+  FIELD_SET_VOLTAGE,
+  FIELD_SET_CURRENT,
+  FIELD_CP_MODE_ENABLED,
+  FIELD_CONSTANT_POWER,
+  FIELD_COUNT
+};
+
+#define XY_SKXXX_MAX_SUBSCRIPTIONS 12
+#define XY_SKXXX_MAX_FIELD_SET_SUBSCRIPTIONS 2
+#define STATUS_FIELD_BIT(field) (1UL << (field))
+#define XY_SKXXX_MAX_SAMPLE_HOOKS 4
+
+// Register shadow covering 0x0000-0x00FF
+#define XY_SKXXX_SHADOW_SIZE 256
+#define XY_SKXXX_SHADOW_FOREVER 0xFFFFFFFFUL
+
+// Cached accessors counted by the cache statistics, see XY_SKxxx::getCacheStats()
+enum CacheField : uint8_t {
+  CACHE_OUTPUT_VOLTAGE = 0,
+  CACHE_OUTPUT_CURRENT,
+  CACHE_OUTPUT_POWER,
+  CACHE_INPUT_VOLTAGE,
+  CACHE_MEASUREMENTS,            // getMeasurements()
+  CACHE_ENERGY,                  // getEnergyMeasurements()
+  CACHE_TEMPERATURES,            // getTemperatures()
+  CACHE_INTERNAL_TEMP,
+  CACHE_EXTERNAL_TEMP,
+  CACHE_OUTPUT_ENABLED,
+  CACHE_KEY_LOCKED,
+  CACHE_PROTECTION_STATUS,
+  CACHE_CVCC_MODE,               // getCVCCState(), isInConstantVoltageMode(), isInConstantCurrentMode()
+  CACHE_SYSTEM_STATUS,
+  CACHE_SET_VOLTAGE,
+  CACHE_SET_CURRENT,
+  CACHE_OPERATING_MODE,
+  CACHE_CP_MODE_ENABLED,
+  CACHE_CONSTANT_POWER,
+  CACHE_TEMP_CALIBRATION,        // Internal and external offsets
+  CACHE_CONSTANT_VOLTAGE,        // getCachedConstantVoltage() and the other M0 accessors
+  CACHE_CONSTANT_CURRENT,
+  CACHE_LOW_VOLTAGE_PROTECTION,
+  CACHE_OVER_VOLTAGE_PROTECTION,
+  CACHE_OVER_CURRENT_PROTECTION,
+  CACHE_OVER_POWER_PROTECTION,
+  CACHE_HIGH_POWER_TIME,
+  CACHE_OVER_AMP_HOURS,
+  CACHE_OVER_WATT_HOURS,
+  CACHE_OVER_TEMPERATURE,
+  CACHE_POWER_ON_INIT,
+  CACHE_BATTERY_CUTOFF,
+  CACHE_MEMORY_GROUP,            // getCachedMemoryGroup()
+  CACHE_FIELD_COUNT
+};
+
+// Age of the values served: <100 ms, <1 s, <5 s, <30 s, <5 min, older or never read
+#define XY_SKXXX_CACHE_AGE_BUCKETS 6
+
+// Counters of one cached accessor
+struct CacheFieldStats {
+  uint32_t hits;                 // Served from the cache, younger than the cache timeout
+  uint32_t staleHits;            // Served from the cache, older than the cache timeout
+  uint32_t misses;               // Called without refresh but read the device anyway
+  uint32_t refreshes;            // Called with refresh = true
+  uint32_t redundantRefreshes;   // ... while the cached value was younger than the cache timeout
+  uint32_t busReads;             // Read frames sent on behalf of the accessor
+  uint32_t ageHistogram[XY_SKXXX_CACHE_AGE_BUCKETS];
 };
 
 class XY_SKxxx {
 public:
+  // Single device owning Serial1 on the given pins
   XY_SKxxx(uint8_t rxPin, uint8_t txPin, uint8_t slaveID);
-  void begin(long baudRate);
+  // Device handle on a bus shared with other slaves
+  XY_SKxxx(xy_sk::RtuBus& bus, uint8_t slaveID);
+  ~XY_SKxxx();
+  XY_SKxxx(const XY_SKxxx&) = delete;
+  XY_SKxxx& operator=(const XY_SKxxx&) = delete;
+  
+  void begin(long baudRate); // Starts the UART when the device owns its bus
+  void begin();              // Shared bus: the bus is already running
   bool testConnection();
   
+  // Bus access and scheduling
+  xy_sk::RtuBus& getBus() { return *_bus; }
+  uint8_t getSlaveID() const { return _slaveID; }
+  void setPollWeight(uint8_t weight);
+  bool pollCache(); // Refresh the stalest cache group, run by RtuBus::service()
+  
   // Basic device information
-  uint16_t getModel();
+  uint16_t getModel(); // Also selects the model traits from REG_MODEL
   uint16_t getVersion();
   
+  // Model limits, scaling and optional registers (XY-SK120 until REG_MODEL is read)
+  const xy_sk::ModelInfo& getModelInfo() const { return *_model; }
+  void setModelInfo(const xy_sk::ModelInfo& model); // Overrides detection, e.g. for the XY-SK60
+  bool hasFeature(xy_sk::ModelFeature feature) const { return _model->hasFeature(feature); }
+  
   // Status cache methods
   bool updateAllStatus(bool force = false);
+  void invalidateCaches(); // Shadow, decoded values and memory groups at once
+  bool reloadCaches();     // Invalidate, then refill everything in a few block reads
   bool updateOutputStatus(bool force = false);
   bool updateDeviceSettings(bool force = false);
   bool updateEnergyMeters(bool force = false);
@@ -237,6 +372,59 @@ public:
   float getSetVoltage(bool refresh = false);
   float getSetCurrent(bool refresh = false);
   
+  // Cached values without any bus access
+  const DeviceStatus& getStatusSnapshot() const { return _status; }
+  float getStatusField(StatusField field) const;
+  
+  /*
+   * Value-change subscriptions
+   *
+   * The callback runs after a cache refresh (normally the background poll
+   * driven by RtuBus::service()) when the subscribed field differs from the
+   * value last reported to that subscriber. Analog fields can be given a
+   * deadband: the callback only runs once the value has moved by at least
+   * that much. The first refresh after subscribing always reports.
+   */
+  typedef void (*StatusCallback)(void* context, XY_SKxxx& device, StatusField field, float value);
+  
+  /**
+   * @return Subscription handle for unsubscribe(), -1 if all slots are taken
+   */
+  int8_t subscribe(StatusField field, StatusCallback callback, void* context, float deadband = 0.0f);
+  
+  /**
+   * Watch several fields with one subscription, e.g. for a display that
+   * redraws on any change. The callback runs once per changed field, as if
+   * each field had its own subscription, but only one of the
+   * XY_SKXXX_MAX_FIELD_SET_SUBSCRIPTIONS slots is used.
+   * @param fields STATUS_FIELD_BIT() of each watched field, or'ed together
+   * @param deadbands Optional, FIELD_COUNT entries indexed by StatusField,
+   *                  copied into the subscription
+   * @return Handle for unsubscribe(), -1 if all slots are taken
+   */
+  int8_t subscribeFields(uint32_t fields, StatusCallback callback, void* context, const float* deadbands = nullptr);
+  bool unsubscribe(int8_t handle);
+  
+  /*
+   * Output sample hooks
+   *
+   * Run on every successful device read that covers VOUT and IOUT, changed
+   * or not: the background poll, getOutput() and the raw block reads of
+   * the control loops (constant resistance, MPPT, step response, I-V
+   * sweep, IR test) alike. The output fields of the status are decoded
+   * from the read first; a read without REG_POWER takes V * I. Hooks run
+   * before subscribers are notified. The time is micros() right after the
+   * response arrived. Meant for checks that must see every sample, such
+   * as XY_SKxxxWatchdog. Up to XY_SKXXX_MAX_SAMPLE_HOOKS per device.
+   */
+  typedef void (*OutputSampleCallback)(void* context, XY_SKxxx& device, const DeviceStatus& status,
+                                       uint32_t sampleMicros);
+  // @return false if all hook slots are taken
+  bool addOutputSampleCallback(OutputSampleCallback callback, void* context);
+  bool removeOutputSampleCallback(OutputSampleCallback callback, void* context);
+  // Replace every hook with this one, nullptr removes them all
+  void setOutputSampleCallback(OutputSampleCallback callback, void* context);
+  
   // Output settings
   bool setVoltage(float voltage);
   bool setCurrent(float current);
@@ -249,6 +437,17 @@ public:
                            uint32_t &outputTime, bool refresh = true);
   bool getTemperatures(float &internalTemp, float &externalTemp, bool refresh = true);
   
+  /*
+   * Extended energy counters
+   *
+   * Every read of the counters is checked against the last one. A read
+   * that caught a carry half done is repaired, a counter going backwards
+   * otherwise is taken as the device clearing it. The steps add up in 64
+   * bits, so totals survive device resets and the 32-bit wrap.
+   */
+  const EnergyCounters& getEnergyCounters() const { return _energy; }
+  void resetEnergyCounters();
+  
   // System control
   bool setKeyLock(bool lock);
   uint16_t getCVCCState(bool refresh = false);
@@ -264,6 +463,7 @@ public:
   bool setBaudRate(uint8_t baudRate);
   uint8_t getBaudRateCode();
   long getActualBaudRate();
+  static long baudRateFromCode(uint8_t code);
   bool setBeeper(bool enabled);
   bool getBeeper(bool &enabled);
   bool setTemperatureUnit(bool celsius);
@@ -344,6 +544,17 @@ public:
   bool getConstantPower(float &power);
   float getCachedConstantPower(bool refresh = false);
   
+  // Constant Resistance (CR) mode, emulated on the ESP: every iteration
+  // reads VOUT/IOUT in one block and moves V_SET towards target * IOUT.
+  // While enabled, three of four pollCache() turns run the loop.
+  bool setConstantResistance(float ohms);
+  float getConstantResistance() const { return _crTarget; }
+  bool setConstantResistanceMode(bool enabled);
+  bool isConstantResistanceModeEnabled() const { return _crEnabled; }
+  void setConstantResistanceTuning(float gain, float tolerance);
+  bool updateConstantResistance(); // One loop iteration
+  const ConstantResistanceStats& getConstantResistanceStats() const { return _crStats; }
+  
   // Protection cache methods
   bool updateAllProtectionSettings(bool force = false);
   bool updateConstantVoltageCurrentSettings(bool force = false);
@@ -367,13 +578,71 @@ public:
   bool getCachedPowerOnInitialization(bool refresh = false);
 
   // Add direct register access methods for memory groups
+  // Reads of settings younger than the cache timeout are answered from the
+  // register shadow, measurements and status always go to the device
   bool readRegisters(uint16_t addr, uint16_t count, uint16_t* buffer);
   bool readRegister(uint16_t addr, uint16_t& value); // Add this method
+  bool readRegistersDirect(uint16_t addr, uint16_t count, uint16_t* buffer); // Always on the bus, never the shadow
   bool writeRegister(uint16_t addr, uint16_t value);
-  bool writeRegisters(uint16_t addr, uint16_t count, uint16_t* buffer);
+  bool writeRegisters(uint16_t addr, uint16_t count, const uint16_t* buffer);
+  
+  // ONOFF writes sent to this device by any path, answered or not
+  uint32_t getOutputWriteCount() const { return _outputWrites; }
+
+  /*
+   * Register shadow
+   *
+   * A copy of 0x0000-0x00FF with a validity bit and a timestamp per
+   * register. Every successful read and write in that range lands in the
+   * shadow, including group writes. The update*() methods decode from it,
+   * so their values and readRegister() never disagree.
+   */
+  
+  /**
+   * Read the registers of a range that are missing or older than maxAge
+   * (0 = all of them), in the fewest block reads: wanted registers are
+   * merged into one read across short gaps of readable registers
+   */
+  bool refreshShadow(uint16_t addr, uint16_t count, unsigned long maxAge = 0);
+  bool refreshShadow(const uint16_t* registers, uint8_t count, unsigned long maxAge = 0);
+  
+  /**
+   * Shadow values without bus access
+   *
+   * @return false unless every register was read or written within maxAge
+   */
+  bool getShadowRegisters(uint16_t addr, uint16_t count, uint16_t* buffer,
+                          unsigned long maxAge = XY_SKXXX_SHADOW_FOREVER) const;
+  unsigned long getShadowAge(uint16_t addr) const; // XY_SKXXX_SHADOW_FOREVER if never read
+  void invalidateShadow(uint16_t addr = 0, uint16_t count = XY_SKXXX_SHADOW_SIZE);
+  
+  // Registers readRegister() may answer from the shadow (not measurements or status)
+  bool isShadowCacheable(uint16_t addr) const;
+  // Registers this model answers, the only ones used to bridge gaps in a block read
+  bool isShadowReadable(uint16_t addr) const;
+
+  /*
+   * Cache statistics
+   *
+   * Every cached accessor (the methods taking a refresh flag) counts
+   * whether it was served from the cache, fresh or stale, how often it was
+   * asked to refresh a value that was still fresh, the read frames its
+   * refreshes cost and the age of the values it returned.
+   */
+  const CacheFieldStats& getCacheStats(CacheField field) const { return _cacheStats[field]; }
+  void resetCacheStats();
+  static const char* getCacheFieldName(CacheField field);
+  // Upper end of an age bucket in ms, XY_SKXXX_SHADOW_FOREVER for the last one
+  static unsigned long getCacheAgeLimit(uint8_t bucket);
+
+  // Result of the last bus transaction (timeout, CRC error, exception code...)
+  xy_sk::RtuStatus getLastError() const { return _lastError; }
 
-  // Make ModbusMaster available to external code
-  ModbusMaster modbus;
+  // Make the RTU master of the bus available to external code
+  xy_sk::RtuMaster& modbus;
+
+  // Retry/backoff rules applied to every register read and write
+  xy_sk::RetryPolicy retryPolicy;
 
   // Debug functions for direct register access
   bool debugReadRegisters(uint16_t addr, uint8_t count, uint16_t* values);
@@ -387,7 +656,7 @@ public:
    * 
    * @param group Memory group to read from
    * @param data Array to store the read data (must be able to hold DATA_GROUP_REGISTERS values)
-   * @param force Force read from device even if cache is valid
+   * @param force Force read from device even if cache or register shadow is valid
    * @return true if successful
    */
   bool readMemoryGroup(xy_sk::MemoryGroup group, uint16_t* data, bool force = false);
@@ -434,7 +703,7 @@ public:
    * 
    * @param group Memory group to get
    * @param data Array to store the group data
-   * @param refresh Whether to refresh the cache from device
+   * @param refresh Whether to refresh the cache from device, bypassing the register shadow
    * @return true if successful
    */
   bool getCachedMemoryGroup(xy_sk::MemoryGroup group, uint16_t* data, bool refresh = false);
@@ -443,7 +712,7 @@ public:
    * Update the memory group cache from the device
    * 
    * @param group Memory group to update
-   * @param force Force update even if cache is still valid
+   * @param force Force update from the device even if cache or register shadow is still valid
    * @return true if successful
    */
   bool updateMemoryGroupCache(xy_sk::MemoryGroup group, bool force = false);
@@ -461,16 +730,64 @@ public:
   OperatingMode getOperatingMode(bool refresh = false);
 
 private:
+  // Group writes update the caches of every member device
+  friend class XY_SKxxxGroup;
+  
   uint8_t _rxPin;
   uint8_t _txPin;
   uint8_t _slaveID;
-  unsigned long _baudRate;
-  unsigned long _lastCommsTime;
-  unsigned long _silentIntervalTime;
+  
+  // Bus this device talks on, owned when created with the pin constructor
+  xy_sk::RtuBus* _bus;
+  bool _ownsBus;
+  uint8_t _pollWeight;
+  uint8_t _pollStep;       // Next cache group refreshed by pollCache()
+  uint8_t _crPollTurn;     // Splits pollCache() turns between CR loop and cache groups
+  
+  // Traits of the connected model
+  const xy_sk::ModelInfo* _model;
+  bool _modelFixed;        // Set with setModelInfo(), REG_MODEL is not used
+  
+  // Value-change subscribers, a slot is free when its callback is nullptr
+  struct StatusSubscription {
+    StatusCallback callback;
+    void* context;
+    StatusField field;
+    float deadband;
+    float lastValue;       // Value last passed to the callback
+    bool reported;
+  };
+  StatusSubscription _subscriptions[XY_SKXXX_MAX_SUBSCRIPTIONS];
+  
+  // Multi-field subscribers, handles follow the single-field ones
+  struct FieldSetSubscription {
+    StatusCallback callback;
+    void* context;
+    uint32_t fields;       // STATUS_FIELD_BIT() mask
+    uint32_t reported;     // Fields reported at least once
+    float deadbands[FIELD_COUNT];
+    float lastValues[FIELD_COUNT];
+  };
+  FieldSetSubscription _fieldSetSubscriptions[XY_SKXXX_MAX_FIELD_SET_SUBSCRIPTIONS];
+  
+  // Report changed fields of a cache group that was just refreshed
+  void notifySubscribers(xy_sk::PollGroup group);
+  
+  // Output sample hooks, a slot is free when its callback is nullptr
+  struct SampleHook {
+    OutputSampleCallback callback;
+    void* context;
+  };
+  SampleHook _sampleHooks[XY_SKXXX_MAX_SAMPLE_HOOKS];
+  
+  // Decode VOUT/IOUT (and POWER/UIN if read) of a device read, run the hooks
+  void decodeOutputSample(uint16_t addr, uint16_t count, uint32_t sampleMicros);
   
   // Cache management
   DeviceStatus _status;
   ProtectionSettings _protection;
+  EnergyCounters _energy;
+  bool _energyFromZero;    // Next first sample seeds zero totals, set by resetEnergyCounters()
   unsigned long _lastOutputUpdate;
   unsigned long _lastSettingsUpdate;
   unsigned long _lastEnergyUpdate;
@@ -478,17 +795,45 @@ private:
   unsigned long _lastStateUpdate;
   unsigned long _cacheTimeout;
   bool _cacheValid;
-  unsigned long _lastConstantVCUpdate;
-  unsigned long _lastVoltageCurrentProtectionUpdate;
-  unsigned long _lastPowerProtectionUpdate;
-  unsigned long _lastEnergyProtectionUpdate;
-  unsigned long _lastTempProtectionUpdate;
-  unsigned long _lastStartupSettingUpdate;
-  
-  // Static members for callbacks
-  static XY_SKxxx* _instance;
-  static void staticPreTransmission();
-  static void staticPostTransmission();
+  
+  xy_sk::RtuStatus _lastError;
+  
+  // Run one request through the retry policy, keeps the deadline budget.
+  // Called with the bus locked, the lock is let go while backing off
+  bool transact(xy_sk::OperationType type, const xy_sk::RtuRequest& request);
+  
+  // Register shadow, see XY-SKxxx-shadow.cpp
+  uint16_t _shadow[XY_SKXXX_SHADOW_SIZE];
+  uint32_t _shadowValid[XY_SKXXX_SHADOW_SIZE / 32];
+  unsigned long _shadowTime[XY_SKXXX_SHADOW_SIZE];
+  bool readShadowBlock(uint16_t first, uint16_t last, const uint32_t* wanted);
+  bool refreshShadowBits(const uint32_t* wanted);
+  void storeShadow(uint16_t addr, uint16_t count, const uint16_t* values);
+  void invalidateWriteSideEffects(uint16_t addr, uint16_t count);
+  uint32_t _outputWrites;
+  void countWrite(uint16_t addr, uint16_t count); // Before sending, the write may land unanswered
+  
+  // Cache statistics, see XY-SKxxx-cachestats.cpp
+  CacheFieldStats _cacheStats[CACHE_FIELD_COUNT];
+  uint32_t _readFrames;    // Read frames sent by readRegistersDirect()
+  unsigned long cacheFieldAge(CacheField field) const;
+  unsigned long decodedAge(uint16_t addr, unsigned long decoded) const; // Status group stamped at decoded
+  // Around the refresh of an accessor; begin returns the mark passed to end
+  uint32_t beginCacheAccess(CacheField field, bool refresh);
+  uint32_t beginCacheAccess(CacheField field, bool refresh, unsigned long age);
+  void endCacheAccess(CacheField field, bool refresh, uint32_t mark);
+  void endCacheAccess(CacheField field, bool refresh, uint32_t mark, unsigned long age);
+  
+  // Decode a poll group from the shadow, stamp it and notify subscribers
+  void decodeOutputStatus(unsigned long now);
+  void decodeDeviceState(unsigned long now);
+  void decodeDeviceSettings(unsigned long now);
+  void decodeEnergyMeters(unsigned long now); // Also checks and extends the counters
+  void decodeTemperatures(unsigned long now);
+  void decodeConstantPowerSettings(unsigned long now);
+  
+  // Static trampoline for the bus scheduler (context is the instance)
+  static bool staticPollCache(void* context);
 
   // Additional cache fields 
   float _internalTempCalibration;
@@ -497,15 +842,10 @@ private:
   uint8_t _selectedDataGroup;
   bool _mpptEnabled;         // Add MPPT enable state cache
   float _mpptThreshold;      // Add MPPT threshold cache
-  unsigned long _lastCalibrationUpdate;
-  
-  // Additional cache timestamps
-  unsigned long _lastBatteryCutoffUpdate;
   
   // Communication settings cache
   uint8_t _cachedSlaveAddress;
   uint8_t _cachedBaudRateCode;
-  unsigned long _lastCommunicationSettingsUpdate;
 
   // Update methods for new cached values
   bool updateCalibrationSettings(bool force = false);
@@ -517,6 +857,21 @@ private:
   // Add CP mode cache management
   bool updateConstantPowerSettings(bool force = false);
   unsigned long _lastConstantPowerUpdate;
+
+  // Constant Resistance emulation state
+  bool _crEnabled;
+  float _crTarget;          // Target resistance (ohm)
+  float _crGain;            // Fraction of the voltage error corrected per iteration
+  float _crTolerance;       // Relative error counted as settled
+  float _crSetVoltage;      // Unrounded V_SET integrated by the loop
+  uint16_t _crRaw;          // V_SET register value last written
+  uint8_t _crInBand;        // Consecutive iterations within tolerance
+  unsigned long _crBandStart;
+  unsigned long _crTargetSince;
+  float _crSquaredError;
+  uint32_t _crErrorSamples;
+  ConstantResistanceStats _crStats;
+  void resetConstantResistanceTracking();
 };
 
 #endif // XY_SKXXX_H
\ No newline at end of file
@@ -1,6 +1,5 @@
 #include <Arduino.h>
 #include <ESPAsyncWebServer.h>
-#include <ModbusMaster.h>
 #include <FS.h>
 #include <LittleFS.h>                    // Built-in ESP32 LittleFS
 #include "web_interface.h" // "web_interface.h"
@@ -26,8 +25,10 @@ XYModbusConfig xyConfig;
 // Create XY_SKxxx instance with default pins (will be updated from config)
 XY_SKxxx *powerSupply = nullptr;
 
+// Set once the startup connection test passed, gates the background poll
+bool powerSupplyConnected = false;
+
 AsyncWebServer server(80);
-ModbusMaster modbus;
 
 // Remove the local getLogTimestamp implementation
 // Now using the one from log_utils.h
@@ -122,9 +123,6 @@ void setup(){
         delay(1000);
     }
 
-    // Initialize the Modbus communication
-    setupModbus();
-
     // Set up TCP/IP networking properly before starting server
     // This sequence helps resolve binding issues
     IPAddress localIP = WiFi.localIP();
@@ -209,6 +207,7 @@ void setup(){
     if (powerSupply->testConnection())
     {
         Serial.println("Connection successful!");
+        powerSupplyConnected = true;
 
         // Read and display device information
         uint16_t model = powerSupply->getModel();
@@ -216,13 +215,19 @@ void setup(){
 
         Serial.println("\nDevice Information:");
         Serial.print("Model:   ");
-        Serial.println(model);
+        Serial.print(model);
+        Serial.print(" (");
+        Serial.print(powerSupply->getModelInfo().name);
+        Serial.println(")");
         Serial.print("Version: ");
         Serial.println(version);
 
         // Display initial status
         displayDeviceStatus(powerSupply);
 
+        // Changes seen by the background poll are pushed to the web clients
+        subscribeWebStatusUpdates(powerSupply);
+
         // Initialize serial monitor interface - MOVED ALL RELATED CODE TO HERE
         Serial.println("\nInitializing serial monitor interface...");
         setupSerialMonitorControl();
@@ -244,8 +249,17 @@ void loop()
     // Process serial monitor commands
     checkSerialMonitorInput(powerSupply, xyConfig);
 
+    // Background cache refresh, one cache group per turn; value-change
+    // subscribers are called back from here
+    if (powerSupply && powerSupplyConnected)
+    {
+        powerSupply->getBus().service();
+    }
+
+    // Run queued WebSocket requests on the bus (expired ones are dropped)
+    processWebRequestQueue();
+
     // You can process other interfaces here in the future:
-    // processWebSocketMessages();
     // processRestApiRequests();
     // processMqttMessages();
 
@@ -1,25 +1,8 @@
 #include "modbus_handler.h"
 #include <Arduino.h>
 
-// Default settings for XY-SK120
-#define MODBUS_SLAVE_ID 1
-#define MODBUS_SERIAL Serial1
-#define MODBUS_BAUDRATE 9600
-#define TX_PIN 6  // Adjust for your XIAO ESP32S3 board
-#define RX_PIN 7  // Adjust for your XIAO ESP32S3 board
-
 // Stub functions since we're removing the dummy data
 
-void setupModbus() {
-  // Configure Serial1 for Modbus communication
-  MODBUS_SERIAL.begin(MODBUS_BAUDRATE, SERIAL_8N1, RX_PIN, TX_PIN);
-  
-  // Initialize Modbus communication
-  modbus.begin(MODBUS_SLAVE_ID, MODBUS_SERIAL);
-  
-  Serial.println("Modbus RTU initialized");
-}
-
 void updateModbusData() {
   // Empty implementation - we no longer use dummy data
 }
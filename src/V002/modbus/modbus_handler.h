@@ -1,12 +1,9 @@
 #ifndef MODBUS_HANDLER_H
 #define MODBUS_HANDLER_H
 
-#include <ModbusMaster.h>
 #include <ArduinoJson.h>
 
-extern ModbusMaster modbus;
-
-void setupModbus();
+// The serial port and the Modbus master belong to XY_SKxxx (XY-SKxxx-rtu.h)
 void updateModbusData();
 void getModbusDataJson(DynamicJsonDocument &doc);
 
@@ -16,6 +16,9 @@ void displayBasicControlMenu() {
   Serial.println("cc [value] - Set constant current mode");
   Serial.println("cp [value] - Set constant power mode");  // Add CP mode command
   Serial.println("cpmode [on/off] - Enable/disable constant power mode");  // Add CP mode toggle
+  Serial.println("cr [ohms] - Set emulated constant resistance");
+  Serial.println("crmode [on/off] - Enable/disable emulated constant resistance mode");
+  Serial.println("crstats - Show constant resistance loop statistics");
   Serial.println("group [0-9] - Activate memory group (0-9)");
   Serial.println("menu - Return to main menu");
   Serial.println("help - Show this menu");
@@ -162,6 +165,71 @@ void handleBasicControl(const String& input, XY_SKxxx* ps) {
     else {
       Serial.println("Invalid option. Use 'on' or 'off'");
     }
+  } else if (input.startsWith("crmode ")) {
+    String mode = input.substring(7);
+    mode.trim();
+
+    if (mode == "on") {
+      if (ps->setConstantResistanceMode(true)) {
+        Serial.println("Constant Resistance mode enabled");
+      } else {
+        Serial.println("Failed to enable Constant Resistance mode (set a resistance with 'cr' first)");
+      }
+    }
+    else if (mode == "off") {
+      ps->setConstantResistanceMode(false);
+      Serial.println("Constant Resistance mode disabled");
+    }
+    else {
+      Serial.println("Invalid option. Use 'on' or 'off'");
+    }
+  } else if (input == "crstats") {
+    const ConstantResistanceStats& stats = ps->getConstantResistanceStats();
+    Serial.println("\n==== Constant Resistance ====");
+    Serial.print("Mode:       ");
+    Serial.println(ps->isConstantResistanceModeEnabled() ? "ON" : "OFF");
+    Serial.print("Target:     ");
+    Serial.print(ps->getConstantResistance(), 3);
+    Serial.println(" ohm");
+    if (stats.noLoad) {
+      Serial.println("Measured:   no load current");
+    } else {
+      Serial.print("Measured:   ");
+      Serial.print(stats.resistance, 3);
+      Serial.print(" ohm (error ");
+      Serial.print(stats.error * 100.0f, 2);
+      Serial.print(" %, RMS ");
+      Serial.print(stats.rmsError * 100.0f, 2);
+      Serial.println(" %)");
+    }
+    Serial.print("Loop rate:  ");
+    Serial.print(stats.loopRate, 1);
+    Serial.println(" Hz");
+    Serial.print("Iterations: ");
+    Serial.print(stats.iterations);
+    Serial.print(", writes: ");
+    Serial.print(stats.writes);
+    Serial.print(", failures: ");
+    Serial.println(stats.failures);
+    Serial.print("Settled:    ");
+    if (stats.settled) {
+      Serial.print("yes, after ");
+      Serial.print(stats.settlingMs);
+      Serial.println(" ms");
+    } else {
+      Serial.println("no");
+    }
+  } else if (input.startsWith("cr ")) {
+    float ohms;
+    if (parseFloat(input.substring(3), ohms)) {
+      if (ps->setConstantResistance(ohms)) {
+        Serial.print("Constant resistance set to: ");
+        Serial.print(ohms, 3);
+        Serial.println(" ohm");
+      } else {
+        Serial.println("Failed to set constant resistance");
+      }
+    }
   } else if (input == "status") {
     // Get current readings
     float voltage, current, power;
@@ -29,21 +29,9 @@ void handleCDDataMenu(const String& input, XY_SKxxx* ps) {
       xy_sk::MemoryGroup group = static_cast<xy_sk::MemoryGroup>(i);
       uint16_t groupData[xy_sk::DATA_GROUP_REGISTERS];
       
-      // Add a small delay between reads to avoid overwhelming the device
-      if (i > 0) delay(200);
-      
-      // Force a refresh - don't use cached values since they may be incorrect
-      bool success = false;
-      for (int attempt = 0; attempt < 3 && !success; attempt++) {
-        if (attempt > 0) {
-          delay(200);  // Wait longer between retries
-          Serial.print(".");
-        }
-        
-        // Read directly from device, bypassing cache
-        uint16_t addr = xy_sk::DataGroupManager::getGroupStartAddress(group);
-        success = ps->readRegisters(addr, xy_sk::DATA_GROUP_REGISTERS, groupData);
-      }
+      // Read directly from device, bypassing the shadow - retries follow ps->retryPolicy
+      uint16_t addr = xy_sk::DataGroupManager::getGroupStartAddress(group);
+      bool success = ps->readRegistersDirect(addr, xy_sk::DATA_GROUP_REGISTERS, groupData);
       
       if (success) {
         // Extract voltage and current values from the group data
@@ -15,6 +15,36 @@ void displayDebugMenu() {
   Serial.println("raw [function] [register] [count] - Read raw register block");
   Serial.println("scan [start] [end] - Scan register range");
   Serial.println("compare [start] [end] - Scan and compare register values before/after changing settings");
+  Serial.println("busstats [reset] - Show Modbus RTU transaction statistics");
+  Serial.println("busstats adaptive on|off - Toggle adaptive response timeouts");
+  Serial.println("cachestats [reset] - Show cache hits, stale hits, refreshes and read frames per cached value");
+  Serial.println("bench [count] - Time a number of block reads");
+  Serial.println("discover [first] [last] - Find slaves and baud rates on the bus");
+  Serial.println("seq ramp [from] [to] [current] [ms] [repeat] - Run a voltage ramp");
+  Serial.println("seq stair [start] [step] [count] [current] [dwell_ms] [repeat] - Run a voltage staircase");
+  Serial.println("seq stop | seq status - Stop the sequence or show its timing statistics");
+  Serial.println("awg sine [v|i] [offset] [amplitude] [points] [sample_ms] [cycles] - Stream a sine");
+  Serial.println("awg tri [v|i] [low] [high] [points] [sample_ms] [cycles] - Stream a triangle");
+  Serial.println("awg csv [v|i] [sample_ms] [v1,v2,...] - Stream a list of values");
+  Serial.println("awg stop | awg status - Stop the waveform or show write rate and jitter");
+  Serial.println("mppt po|ic|builtin [interval_ms] [step_A] - Track the solar maximum power point");
+  Serial.println("mppt stop | mppt status - Stop tracking or show power, harvested energy and loop rate");
+  Serial.println("charge liion|lifepo4|lead [cells] [current_A] [interval_ms] - Charge a battery");
+  Serial.println("charge stop | charge status - Stop charging or show stage, capacity and temperature");
+  Serial.println("wd current|voltage|power [limit] [hold_ms] - Add a watchdog trip rule");
+  Serial.println("wd slew [A/s] | wd avgpower [W] [window_ms] - Add a slew rate or average power rule");
+  Serial.println("wd arm [poll_ms] | wd disarm | wd reset | wd clear | wd status - Control the watchdog, show trips");
+  Serial.println("derate i|cp [start_C] [end_C] [min_%] [in|ex|max] - Derate I_SET or CP with temperature");
+  Serial.println("derate stop | derate status - Restore the setpoint or show temperature and throttled time");
+  Serial.println("step v|i [levels] [limits] [tolerance_%] [capture_ms] - Measure rise, overshoot and settling");
+  Serial.println("step stop | step report - Stop the step test or show the results");
+  Serial.println("iv v|i [start] [end] [points] [limit] [timeout_ms] - Sweep V_SET or I_SET for an I-V curve");
+  Serial.println("iv stop | iv status | iv table - Stop the sweep, show progress or print the table as CSV");
+  Serial.println("ir [pulse_A] [pulse_ms] [interval_s] [capacity_mAh] [start_soc_%] - Battery internal resistance");
+  Serial.println("ir stop | ir log - Stop the schedule or print the R-vs-SoC table as CSV");
+  Serial.println("txn [reg1] [val1] [reg2] [val2] ... [verify] - Write registers (hex) as one burst, runs in one frame");
+  Serial.println("reboot start [interval_ms] [noreplay] [output] - Detect PSU power cycles, replay the journal (and ONOFF) and reload caches");
+  Serial.println("reboot journal | reboot now | reboot status | reboot stop - Journal current settings, recover now, show log");
   Serial.println("menu - Return to main menu");
   Serial.println("help - Show this menu");
 }
@@ -55,6 +85,82 @@ void handleDebugMenu(const String& input, XY_SKxxx* ps) {
     return;
   }
   
+  // Handle bus statistics commands
+  if (input.startsWith("busstats")) {
+    handleDebugBusStats(input, ps);
+    return;
+  }
+  
+  if (input.startsWith("cachestats")) {
+    handleDebugCacheStats(input, ps);
+    return;
+  }
+  
+  if (input.startsWith("bench")) {
+    handleDebugBench(input, ps);
+    return;
+  }
+  
+  if (input.startsWith("discover")) {
+    handleDebugDiscover(input, ps);
+    return;
+  }
+  
+  if (input.startsWith("seq")) {
+    handleDebugSequence(input, ps);
+    return;
+  }
+  
+  if (input.startsWith("awg")) {
+    handleDebugWaveform(input, ps);
+    return;
+  }
+  
+  if (input.startsWith("mppt")) {
+    handleDebugMppt(input, ps);
+    return;
+  }
+  
+  if (input.startsWith("charge")) {
+    handleDebugCharge(input, ps);
+    return;
+  }
+  
+  if (input.startsWith("wd ")) {
+    handleDebugWatchdog(input, ps);
+    return;
+  }
+  
+  if (input.startsWith("derate")) {
+    handleDebugDerate(input, ps);
+    return;
+  }
+  
+  if (input.startsWith("step ")) {
+    handleDebugStep(input, ps);
+    return;
+  }
+  
+  if (input.startsWith("iv ")) {
+    handleDebugSweep(input, ps);
+    return;
+  }
+  
+  if (input == "ir" || input.startsWith("ir ")) {
+    handleDebugIr(input, ps);
+    return;
+  }
+  
+  if (input.startsWith("txn ")) {
+    handleDebugTransaction(input, ps);
+    return;
+  }
+  
+  if (input == "reboot" || input.startsWith("reboot ")) {
+    handleDebugReboot(input, ps);
+    return;
+  }
+  
   // Handle help or unknown command
   if (input == "help") {
     displayDebugMenu();
@@ -23,3 +23,46 @@ bool handleDebugWriteTrial(const String& input, XY_SKxxx* ps);
 
 // Write range command
 bool handleDebugWriteRange(const String& input, XY_SKxxx* ps);
+
+// Bus statistics and benchmark commands
+bool handleDebugBusStats(const String& input, XY_SKxxx* ps);
+bool handleDebugBench(const String& input, XY_SKxxx* ps);
+
+// Cache hit/miss counters of the cached accessors
+bool handleDebugCacheStats(const String& input, XY_SKxxx* ps);
+
+// Slave address and baud rate sweep
+bool handleDebugDiscover(const String& input, XY_SKxxx* ps);
+
+// Output profile sequencer (ramps and staircases)
+bool handleDebugSequence(const String& input, XY_SKxxx* ps);
+
+// Arbitrary waveform output (sine, triangle, CSV)
+bool handleDebugWaveform(const String& input, XY_SKxxx* ps);
+
+// Firmware maximum power point tracking
+bool handleDebugMppt(const String& input, XY_SKxxx* ps);
+
+// Multi-stage battery charging
+bool handleDebugCharge(const String& input, XY_SKxxx* ps);
+
+// Application level protection rules
+bool handleDebugWatchdog(const String& input, XY_SKxxx* ps);
+
+// Temperature derating of I_SET or the CP setpoint
+bool handleDebugDerate(const String& input, XY_SKxxx* ps);
+
+// Step response characterization
+bool handleDebugStep(const String& input, XY_SKxxx* ps);
+
+// I-V curve sweep
+bool handleDebugSweep(const String& input, XY_SKxxx* ps);
+
+// Battery internal resistance pulse test
+bool handleDebugIr(const String& input, XY_SKxxx* ps);
+
+// Batched register writes (runs merged into FC16 frames)
+bool handleDebugTransaction(const String& input, XY_SKxxx* ps);
+
+// PSU reboot detection and recovery
+bool handleDebugReboot(const String& input, XY_SKxxx* ps);
@@ -0,0 +1,124 @@
+#include "menu_debug.h"
+#include "serial_core.h"
+#include "XY-SKxxx-charger.h"
+
+// One charger for the serial console, created on first use
+static XY_SKxxxCharger* charger = nullptr;
+
+static void printChargeStatus() {
+  static const char* const chemistryNames[] = {"Li-ion", "LiFePO4", "lead-acid"};
+  const ChargeSession& session = charger->getSession();
+  const ChargeProfile& profile = charger->getProfile();
+
+  Serial.println("\n==== Charger ====");
+  Serial.print("State: ");
+  Serial.print(XY_SKxxxCharger::stateName(session.state));
+  if (profile.cells > 0) {
+    Serial.print(", ");
+    Serial.print(profile.cells);
+    Serial.print(" cell ");
+    Serial.print(chemistryNames[profile.chemistry]);
+  }
+  Serial.println();
+  Serial.print("Battery: ");
+  Serial.print(session.voltage, 2);
+  Serial.print(" V ");
+  Serial.print(session.current, 3);
+  Serial.print(" A, target ");
+  Serial.print(session.targetVoltage, 2);
+  Serial.println(" V");
+  Serial.print("Temperature: ");
+  if (isnan(session.temperature)) {
+    Serial.println("no sensor");
+  } else {
+    Serial.print(session.temperature, 1);
+    Serial.println(" C");
+  }
+  Serial.print("Charged: ");
+  Serial.print(session.chargedMah);
+  Serial.print(" mAh, ");
+  Serial.print(session.chargedMwh);
+  Serial.println(" mWh");
+  Serial.print("Time: ");
+  Serial.print(session.elapsedMs / 1000);
+  Serial.print(" s, in stage ");
+  Serial.print(session.stageMs / 1000);
+  Serial.println(" s");
+  Serial.print("Loop: ");
+  Serial.print(session.loopRate, 1);
+  Serial.print(" Hz, read failures: ");
+  Serial.print(session.readFailures);
+  Serial.print(", write failures: ");
+  Serial.println(session.writeFailures);
+}
+
+bool handleDebugCharge(const String& input, XY_SKxxx* ps) {
+  if (charger == nullptr) {
+    charger = new XY_SKxxxCharger(*ps);
+  }
+
+  if (input.startsWith("charge stop")) {
+    charger->stop();
+    Serial.println("Charging stopped, output off");
+    return true;
+  }
+
+  if (input.startsWith("charge status")) {
+    printChargeStatus();
+    return true;
+  }
+
+  if (charger->isRunning()) {
+    Serial.println("A charge is running, use 'charge stop' first");
+    return false;
+  }
+
+  // charge <liion|lifepo4|lead> <cells> <current A> [interval ms]
+  String args = input.substring(input.indexOf(' ') + 1);
+  int space = args.indexOf(' ');
+  String chemistry = (space > 0) ? args.substring(0, space) : args;
+  float values[3] = {0, 0, 0};
+  uint8_t count = 0;
+  while (space > 0 && count < 3) {
+    args = args.substring(space + 1);
+    args.trim();
+    space = args.indexOf(' ');
+    values[count++] = ((space > 0) ? args.substring(0, space) : args).toFloat();
+  }
+
+  BatteryChemistry chem;
+  if (chemistry == "liion") {
+    chem = CHEM_LI_ION;
+  } else if (chemistry == "lifepo4") {
+    chem = CHEM_LIFEPO4;
+  } else if (chemistry == "lead") {
+    chem = CHEM_LEAD_ACID;
+  } else {
+    Serial.println("Use: charge liion|lifepo4|lead [cells] [current_A] [interval_ms] | charge stop | charge status");
+    return false;
+  }
+  if (count < 2 || values[0] < 1) {
+    Serial.println("Invalid format. Use: charge liion|lifepo4|lead [cells] [current_A] [interval_ms]");
+    return false;
+  }
+  if (count > 2) {
+    charger->setLoopInterval((uint32_t)values[2]);
+  }
+
+  ChargeProfile profile = chargeProfileFor(chem, (uint8_t)values[0], values[1]);
+#if defined(ESP32)
+  bool started = charger->startTask(profile);
+#else
+  bool started = charger->start(profile);
+#endif
+  if (!started) {
+    Serial.println("Failed to start: check cells and current against the model limits");
+    return false;
+  }
+  Serial.print("Charging started in ");
+  Serial.print(XY_SKxxxCharger::stateName(charger->getState()));
+  Serial.print(", target ");
+  Serial.print(charger->getSession().targetVoltage, 2);
+  Serial.println(" V");
+  return true;
+}
@@ -0,0 +1,136 @@
+#include "menu_debug.h"
+#include "serial_core.h"
+#include "XY-SKxxx-derating.h"
+
+// One derating loop for the serial console, created on first use
+static XY_SKxxxDerating* derating = nullptr;
+
+static void printDeratingStatus() {
+  static const char* const sensorNames[] = {"internal", "external", "hottest"};
+  const DeratingStats& stats = derating->getStats();
+  bool current = derating->getTarget() == DERATE_CURRENT;
+
+  Serial.println("\n==== Derating ====");
+  Serial.print("State: ");
+  Serial.print(!derating->isRunning() ? "stopped" : (derating->isThrottling() ? "throttling" : "full setpoint"));
+  Serial.print(", ");
+  Serial.print(sensorNames[derating->getSensor()]);
+  Serial.println(" sensor");
+  Serial.print("Temperature: ");
+  Serial.print(stats.temperature, 1);
+  Serial.print(" C (curve at ");
+  Serial.print(stats.effectiveTemperature, 1);
+  Serial.print(" C), peak ");
+  Serial.print(stats.peakTemperature, 1);
+  Serial.println(" C");
+  Serial.print("Setpoint: ");
+  Serial.print(stats.setpoint, current ? 3 : 1);
+  Serial.print(current ? " A" : " W");
+  Serial.print(" of ");
+  Serial.print(derating->getNominal(), current ? 3 : 1);
+  Serial.print(current ? " A" : " W");
+  Serial.print(" (");
+  Serial.print(stats.factor * 100.0f, 0);
+  Serial.print(" %, lowest ");
+  Serial.print(stats.minFactor * 100.0f, 0);
+  Serial.println(" %)");
+  Serial.print("Throttled: ");
+  Serial.print(stats.throttledMs / 1000);
+  Serial.print(" s of ");
+  Serial.print(stats.elapsedMs / 1000);
+  Serial.print(" s, ");
+  Serial.print(stats.throttleEvents);
+  Serial.println(" events");
+  Serial.print("Iterations: ");
+  Serial.print(stats.iterations);
+  Serial.print(", writes: ");
+  Serial.print(stats.writes);
+  Serial.print(", read failures: ");
+  Serial.print(stats.readFailures);
+  Serial.print(", write failures: ");
+  Serial.println(stats.writeFailures);
+}
+
+bool handleDebugDerate(const String& input, XY_SKxxx* ps) {
+  if (derating == nullptr) {
+    derating = new XY_SKxxxDerating(*ps);
+  }
+
+  if (input.startsWith("derate stop")) {
+    derating->stop();
+#if !defined(ESP32)
+    derating->update();
+#endif
+    Serial.println("Derating stopped, nominal setpoint restored");
+    return true;
+  }
+
+  if (input.startsWith("derate status")) {
+    printDeratingStatus();
+    return true;
+  }
+
+  if (derating->isRunning()) {
+    Serial.println("Derating is running, use 'derate stop' first");
+    return false;
+  }
+
+  // derate <i|cp> <start C> <end C> <min %> [in|ex|max]
+  String args = input.substring(input.indexOf(' ') + 1);
+  int space = args.indexOf(' ');
+  String target = (space > 0) ? args.substring(0, space) : args;
+  float values[3] = {0, 0, 0};
+  uint8_t count = 0;
+  String sensor = "max";
+  while (space > 0 && count < 4) {
+    args = args.substring(space + 1);
+    args.trim();
+    space = args.indexOf(' ');
+    String value = (space > 0) ? args.substring(0, space) : args;
+    if (count < 3) {
+      values[count] = value.toFloat();
+    } else {
+      sensor = value;
+    }
+    count++;
+  }
+
+  if (target == "i") {
+    derating->setTarget(DERATE_CURRENT);
+  } else if (target == "cp") {
+    derating->setTarget(DERATE_POWER);
+  } else {
+    Serial.println("Use: derate i|cp [start_C] [end_C] [min_%] [in|ex|max] | derate stop | derate status");
+    return false;
+  }
+  if (sensor == "in") {
+    derating->setSensor(DERATE_INTERNAL);
+  } else if (sensor == "ex") {
+    derating->setSensor(DERATE_EXTERNAL);
+  } else {
+    derating->setSensor(DERATE_HOTTEST);
+  }
+  if (count < 3 || !derating->setLinearCurve(values[0], values[1], values[2] / 100.0f)) {
+    Serial.println("Invalid curve. Use: derate i|cp [start_C] [end_C] [min_%] [in|ex|max], start below end");
+    return false;
+  }
+
+#if defined(ESP32)
+  bool started = derating->startTask();
+#else
+  bool started = derating->start();
+#endif
+  if (!started) {
+    Serial.println("Failed to start: check the connection, 'cp' needs a model with constant power");
+    return false;
+  }
+  Serial.print("Derating from ");
+  Serial.print(derating->getNominal(), 3);
+  Serial.print(target == "i" ? " A" : " W");
+  Serial.print(" between ");
+  Serial.print(values[0], 1);
+  Serial.print(" C and ");
+  Serial.print(values[1], 1);
+  Serial.println(" C");
+  return true;
+}
@@ -0,0 +1,85 @@
+#include "menu_debug.h"
+#include "serial_core.h"
+#include "XY-SKxxx-discovery.h"
+
+// Print a dot per baud rate block so a long sweep shows it is alive
+static void printDiscoveryProgress(void* context, unsigned long baudRate, uint8_t slave, bool found) {
+  uint8_t* lastSlave = static_cast<uint8_t*>(context);
+  if (found) {
+    Serial.print("\nFound slave ");
+    Serial.print(slave);
+    Serial.print(" at ");
+    Serial.print(baudRate);
+    Serial.println(" baud");
+  }
+  if (slave == *lastSlave) {
+    Serial.print(baudRate);
+    Serial.println(" baud done");
+  }
+}
+
+bool handleDebugDiscover(const String& input, XY_SKxxx* ps) {
+  // Optional slave range, default 1-247
+  uint16_t first = 1;
+  uint16_t last = 247;
+  int spacePos1 = input.indexOf(' ');
+  if (spacePos1 > 0) {
+    int spacePos2 = input.indexOf(' ', spacePos1 + 1);
+    String firstStr = (spacePos2 > 0) ? input.substring(spacePos1 + 1, spacePos2) : input.substring(spacePos1 + 1);
+    if (!parseUInt16(firstStr, first) ||
+        (spacePos2 > 0 && !parseUInt16(input.substring(spacePos2 + 1), last))) {
+      Serial.println("Invalid format. Use: discover [first] [last]");
+      return false;
+    }
+    if (spacePos2 <= 0) {
+      last = first;
+    }
+  }
+  if (first < 1 || last > 247 || last < first) {
+    Serial.println("Slave addresses must be 1-247 with first <= last");
+    return false;
+  }
+  
+  xy_sk::BusDiscovery discovery(ps->getBus());
+  discovery.setSlaveRange(first, last);
+  uint8_t lastSlave = last;
+  discovery.setProgressCallback(printDiscoveryProgress, &lastSlave);
+  
+  Serial.print("\nSweeping slaves ");
+  Serial.print(first);
+  Serial.print("-");
+  Serial.print(last);
+  Serial.print(" at all baud rates, about ");
+  Serial.print(discovery.estimateDurationMs() / 1000);
+  Serial.println(" s...");
+  
+  uint8_t found = discovery.run();
+  
+  Serial.println("\n==== Bus Discovery ====");
+  Serial.println("Slave\t| Baud\t| Model\t| Version\t| Reply (us)");
+  Serial.println("--------------------------------------------------");
+  for (uint8_t i = 0; i < found; i++) {
+    const xy_sk::DiscoveredDevice& device = discovery.getDevice(i);
+    Serial.print(device.slave);
+    Serial.print("\t| ");
+    Serial.print(device.baudRate);
+    Serial.print("\t| ");
+    if (device.model == 0) {
+      Serial.print("?");
+    } else {
+      Serial.print(device.model);
+    }
+    Serial.print("\t| ");
+    Serial.print(device.version);
+    Serial.print("\t\t| ");
+    Serial.println(device.replyMicros);
+  }
+  
+  Serial.print(found);
+  Serial.print(" device(s), ");
+  Serial.print(discovery.getProbeCount());
+  Serial.print(" probes in ");
+  Serial.print(discovery.getElapsedMs());
+  Serial.println(" ms");
+  return true;
+}
@@ -0,0 +1,97 @@
+#include "menu_debug.h"
+#include "serial_core.h"
+#include "XY-SKxxx-ir.h"
+
+// One internal resistance test for the serial console, created on first use
+static XY_SKxxxIrTest* irTest = nullptr;
+
+static void printIrLog() {
+  const IrStats& stats = irTest->getStats();
+
+  Serial.println("\n==== Internal resistance ====");
+  Serial.print("State: ");
+  Serial.println(irTest->isRunning() ? "scheduled" : "idle");
+  Serial.print("Measurements: ");
+  Serial.print(stats.measurements);
+  Serial.print(", invalid: ");
+  Serial.print(stats.invalid);
+  Serial.print(", bus failures: ");
+  Serial.print(stats.failures);
+  Serial.print(", worst write-to-sample: ");
+  Serial.print(stats.maxLatencyMicros);
+  Serial.println(" us");
+
+  // CSV for the R-vs-SoC curve
+  Serial.println("time_s,charged_mah,soc,v,i,v_pulse,i_pulse,r_mohm,r_ohmic_mohm,v_recovery");
+  for (uint8_t i = 0; i < irTest->getPointCount(); i++) {
+    const IrPoint& point = irTest->getPoint(i);
+    if (!point.valid) {
+      Serial.printf("%lu,%lu,,%.3f,%.3f,,,,,\n", (unsigned long)(point.timeMs / 1000),
+                    (unsigned long)point.chargedMah, point.voltage, point.current);
+      continue;
+    }
+    Serial.printf("%lu,%lu,%.1f,%.3f,%.3f,%.3f,%.3f,%.1f,%.1f,%.3f\n", (unsigned long)(point.timeMs / 1000),
+                  (unsigned long)point.chargedMah, point.soc, point.voltage, point.current, point.pulseVoltage,
+                  point.pulseCurrent, point.resistance * 1000.0f, point.ohmicResistance * 1000.0f,
+                  point.recoveryVoltage);
+  }
+}
+
+bool handleDebugIr(const String& input, XY_SKxxx* ps) {
+  if (irTest == nullptr) {
+    irTest = new XY_SKxxxIrTest(*ps);
+  }
+
+  if (input.startsWith("ir stop")) {
+    irTest->stop();
+    Serial.println("Internal resistance schedule stopped");
+    return true;
+  }
+
+  if (input.startsWith("ir log")) {
+    printIrLog();
+    return true;
+  }
+
+  if (irTest->isRunning()) {
+    Serial.println("A schedule is running, use 'ir stop' first");
+    return false;
+  }
+
+  // ir [pulse A] [pulse ms] [interval s] [capacity mAh] [start SoC %]
+  float values[5] = {0, 500, 0, 0, 0};
+  uint8_t count = 0;
+  String args = input.substring(2);
+  args.trim();
+  while (args.length() > 0 && count < 5) {
+    int space = args.indexOf(' ');
+    values[count++] = ((space > 0) ? args.substring(0, space) : args).toFloat();
+    args = (space > 0) ? args.substring(space + 1) : "";
+    args.trim();
+  }
+
+  irTest->setPulse(values[0], (uint32_t)values[1]);
+  irTest->setSchedule((uint32_t)(values[2] * 1000));
+  irTest->setCapacity((uint32_t)values[3], values[4]);
+
+#if defined(ESP32)
+  bool started = irTest->startTask();
+#else
+  bool started = irTest->start();
+  if (started) {
+    irTest->update();
+  }
+#endif
+  if (!started) {
+    Serial.println("Failed to start the internal resistance test");
+    return false;
+  }
+  if (values[2] > 0) {
+    Serial.print("Measuring every ");
+    Serial.print(values[2], 0);
+    Serial.println(" s, 'ir log' prints the R-vs-SoC table");
+  } else {
+    Serial.println("Measuring, 'ir log' shows the result");
+  }
+  return true;
+}
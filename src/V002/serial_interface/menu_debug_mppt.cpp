@@ -0,0 +1,118 @@
+#include "menu_debug.h"
+#include "serial_core.h"
+#include "XY-SKxxx-mppt.h"
+
+// One tracker for the serial console, created on first use
+static XY_SKxxxMppt* mppt = nullptr;
+
+static void printMpptStatus() {
+  static const char* const algorithmNames[] = {"perturb and observe", "incremental conductance", "built-in"};
+  const MpptStats& stats = mppt->getStats();
+
+  Serial.println("\n==== MPPT ====");
+  Serial.print("State: ");
+  Serial.print(mppt->isRunning() ? "running" : "idle");
+  Serial.print(", algorithm: ");
+  Serial.println(algorithmNames[mppt->getAlgorithm()]);
+  Serial.print("Input: ");
+  Serial.print(stats.inputVoltage, 2);
+  Serial.print(" V, output: ");
+  Serial.print(stats.outputVoltage, 2);
+  Serial.print(" V ");
+  Serial.print(stats.outputCurrent, 3);
+  Serial.print(" A, I_SET: ");
+  Serial.print(stats.setCurrent, 3);
+  Serial.println(" A");
+  Serial.print("Power: ");
+  Serial.print(stats.power, 2);
+  Serial.print(" W, peak: ");
+  Serial.print(stats.peakPower, 2);
+  Serial.print(" W, average: ");
+  Serial.print(mppt->getAveragePower(), 2);
+  Serial.println(" W");
+  Serial.print("Harvested: ");
+  Serial.print(stats.energyWh, 4);
+  Serial.print(" Wh in ");
+  Serial.print(stats.elapsedMs / 1000.0f, 1);
+  Serial.println(" s");
+  Serial.print("Loop: ");
+  Serial.print(stats.loopRate, 1);
+  Serial.print(" Hz, iterations: ");
+  Serial.print(stats.iterations);
+  Serial.print(", writes: ");
+  Serial.print(stats.writes);
+  Serial.print(", reversals: ");
+  Serial.print(stats.reversals);
+  Serial.print(", failures: ");
+  Serial.println(stats.readFailures + stats.writeFailures);
+  Serial.print("Converged: ");
+  if (stats.converged) {
+    Serial.print("yes, after ");
+    Serial.print(stats.convergenceMs);
+    Serial.println(" ms");
+  } else {
+    Serial.println("no");
+  }
+}
+
+bool handleDebugMppt(const String& input, XY_SKxxx* ps) {
+  if (mppt == nullptr) {
+    mppt = new XY_SKxxxMppt(*ps);
+  }
+
+  if (input.startsWith("mppt stop")) {
+    mppt->stop();
+    Serial.println("MPPT stopped, I_SET keeps its last value");
+    return true;
+  }
+
+  if (input.startsWith("mppt status")) {
+    printMpptStatus();
+    return true;
+  }
+
+  if (mppt->isRunning()) {
+    Serial.println("MPPT is running, use 'mppt stop' first");
+    return false;
+  }
+
+  // mppt <po|ic|builtin> [interval ms] [step A]
+  String args = input.substring(input.indexOf(' ') + 1);
+  int space = args.indexOf(' ');
+  String algorithm = (space > 0) ? args.substring(0, space) : args;
+  args = (space > 0) ? args.substring(space + 1) : "";
+  args.trim();
+
+  if (algorithm == "po") {
+    mppt->setAlgorithm(MPPT_PERTURB_OBSERVE);
+  } else if (algorithm == "ic") {
+    mppt->setAlgorithm(MPPT_INCREMENTAL_CONDUCTANCE);
+  } else if (algorithm == "builtin") {
+    mppt->setAlgorithm(MPPT_BUILT_IN);
+  } else {
+    Serial.println("Use: mppt po|ic|builtin [interval_ms] [step_A] | mppt stop | mppt status");
+    return false;
+  }
+
+  if (args.length() > 0) {
+    space = args.indexOf(' ');
+    mppt->setLoopInterval(((space > 0) ? args.substring(0, space) : args).toInt());
+    if (space > 0) {
+      mppt->setStep(args.substring(space + 1).toFloat());
+    }
+  }
+
+#if defined(ESP32)
+  bool started = mppt->startTask();
+#else
+  bool started = mppt->start();
+#endif
+  if (!started) {
+    Serial.println("Failed to start MPPT (built-in mode needs a model with MPPT registers)");
+    return false;
+  }
+  Serial.print("MPPT started, one iteration every ");
+  Serial.print(mppt->getLoopInterval());
+  Serial.println(" ms");
+  return true;
+}
@@ -41,7 +41,7 @@ bool handleDebugRead(const String& input, XY_SKxxx* ps) {
   }
   
   uint16_t value;
-  if (ps->readRegisters(reg, 1, &value)) {
+  if (ps->readRegistersDirect(reg, 1, &value)) {
     if (isHex) {
       Serial.print("Register 0x");
       Serial.print(reg, HEX);
@@ -251,7 +251,7 @@ bool handleDebugRaw(const String& input, XY_SKxxx* ps) {
   
   uint16_t* results = new uint16_t[count];
   
-  if (ps->readRegisters(reg, count, results)) {
+  if (ps->readRegistersDirect(reg, count, results)) {
     Serial.print("Read registers starting at: ");
     Serial.print(reg);
     Serial.print(", count: ");
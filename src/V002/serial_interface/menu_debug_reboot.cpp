@@ -0,0 +1,121 @@
+#include "menu_debug.h"
+#include "serial_core.h"
+#include "XY-SKxxx-reboot.h"
+
+// One reboot monitor for the serial console, created on first use
+static XY_SKxxxRebootMonitor* rebootMonitor = nullptr;
+
+static const char* rebootReasonName(RebootReason reason) {
+  switch (reason) {
+    case REBOOT_COUNTER_BACKWARDS: return "output time went backwards";
+    case REBOOT_OUTPUT_DROPPED: return "output dropped during an outage";
+    default: return "manual";
+  }
+}
+
+static void onReboot(void* context, const RebootEvent& event) {
+  Serial.print("PSU reboot detected (");
+  Serial.print(rebootReasonName(event.reason));
+  Serial.print("), recovered in ");
+  Serial.print(event.recoveryMicros / 1000.0f, 1);
+  Serial.println(" ms");
+}
+
+static void printRebootStatus() {
+  const RebootStats& stats = rebootMonitor->getStats();
+
+  Serial.println("\n==== Reboot monitor ====");
+  Serial.print("State: ");
+  Serial.println(rebootMonitor->isRunning() ? (rebootMonitor->isLinkDown() ? "link down" : "running") : "idle");
+  Serial.print("Heartbeats: ");
+  Serial.print(stats.heartbeats);
+  Serial.print(", failed: ");
+  Serial.print(stats.heartbeatFailures);
+  Serial.print(", outages: ");
+  Serial.print(stats.outages);
+  Serial.print(", reboots: ");
+  Serial.print(stats.reboots);
+  Serial.print(", journal: ");
+  Serial.print(rebootMonitor->getJournalSize());
+  Serial.println(" registers");
+
+  for (uint8_t i = 0; i < rebootMonitor->getEventCount(); i++) {
+    const RebootEvent& event = rebootMonitor->getEvent(i);
+    Serial.printf("%lu s: %s, outage %lu ms, replay %.1f ms (%u regs%s), reload %.1f ms%s, total %.1f ms\n",
+                  (unsigned long)(event.timeMs / 1000), rebootReasonName(event.reason),
+                  (unsigned long)event.outageMs, event.replayMicros / 1000.0f, event.replayed,
+                  event.replayOk ? "" : ", failed", event.reloadMicros / 1000.0f,
+                  event.reloaded ? "" : " failed", event.recoveryMicros / 1000.0f);
+  }
+}
+
+bool handleDebugReboot(const String& input, XY_SKxxx* ps) {
+  if (rebootMonitor == nullptr) {
+    rebootMonitor = new XY_SKxxxRebootMonitor(*ps);
+    rebootMonitor->setRebootCallback(onReboot, nullptr);
+  }
+
+  if (input.startsWith("reboot stop")) {
+    rebootMonitor->stop();
+    Serial.println("Reboot monitor stopped");
+    return true;
+  }
+
+  if (input.startsWith("reboot status")) {
+    printRebootStatus();
+    return true;
+  }
+
+  if (input.startsWith("reboot journal")) {
+    // Setpoints, the M0 protections and the output state as they are now
+    rebootMonitor->clearJournal();
+    bool success = rebootMonitor->journalCurrent(REG_V_SET, 2) &&
+                   rebootMonitor->journalCurrent(REG_S_LVP, REG_S_INI - REG_S_LVP + 1) &&
+                   rebootMonitor->journalCurrent(REG_ONOFF, 1);
+    Serial.print(success ? "Journal holds " : "Failed to read the settings, journal holds ");
+    Serial.print(rebootMonitor->getJournalSize());
+    Serial.println(" registers");
+    return success;
+  }
+
+  if (input.startsWith("reboot now")) {
+    bool success = rebootMonitor->recover();
+    const RebootEvent& event = rebootMonitor->getEvent(rebootMonitor->getEventCount() - 1);
+    Serial.print(success ? "Recovered in " : "Recovery failed after ");
+    Serial.print(event.recoveryMicros / 1000.0f, 1);
+    Serial.println(" ms");
+    return success;
+  }
+
+  if (input.startsWith("reboot start")) {
+    if (rebootMonitor->isRunning()) {
+      Serial.println("The monitor is running, use 'reboot stop' first");
+      return false;
+    }
+
+    // reboot start [interval ms] [noreplay] [output]
+    String args = input.substring(12);
+    args.trim();
+    rebootMonitor->setReplay(args.indexOf("noreplay") < 0);
+    rebootMonitor->setReplayOutput(args.indexOf("output") >= 0);
+    uint32_t interval = args.toInt();
+    rebootMonitor->setHeartbeat(interval > 0 ? interval : 1000);
+
+#if defined(ESP32)
+    bool started = rebootMonitor->startTask();
+#else
+    bool started = rebootMonitor->start();
+#endif
+    if (!started) {
+      Serial.println("Failed to start the reboot monitor");
+      return false;
+    }
+    Serial.print("Heartbeat every ");
+    Serial.print(interval > 0 ? interval : 1000);
+    Serial.println(" ms, 'reboot status' shows the detections");
+    return true;
+  }
+
+  Serial.println("Usage: reboot start [interval_ms] [noreplay] [output] | journal | now | status | stop");
+  return false;
+}
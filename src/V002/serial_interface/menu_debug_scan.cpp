@@ -45,7 +45,7 @@ bool handleDebugScan(const String& input, XY_SKxxx* ps) {
   for (uint16_t addr = startAddr; addr <= endAddr; addr++) {
     uint16_t value;
     
-    if (ps->readRegister(addr, value)) {
+    if (ps->readRegistersDirect(addr, 1, &value)) {
       Serial.print("0x");
       if (addr < 0x1000) Serial.print("0");
       if (addr < 0x0100) Serial.print("0");
@@ -119,7 +119,7 @@ bool handleDebugCompare(const String& input, XY_SKxxx* ps) {
   // Read initial values
   for (uint16_t addr = startAddr; addr <= endAddr; addr++) {
     uint16_t value;
-    readSuccess[addr - startAddr] = ps->readRegister(addr, value);
+    readSuccess[addr - startAddr] = ps->readRegistersDirect(addr, 1, &value);
     
     if (readSuccess[addr - startAddr]) {
       initialValues[addr - startAddr] = value;
@@ -192,7 +192,7 @@ bool handleDebugCompare(const String& input, XY_SKxxx* ps) {
     }
     
     uint16_t newValue;
-    bool success = ps->readRegister(addr, newValue);
+    bool success = ps->readRegistersDirect(addr, 1, &newValue);
     
     if (success && newValue != initialValues[addr - startAddr]) {
       // Format register address
@@ -0,0 +1,133 @@
+#include "menu_debug.h"
+#include "serial_core.h"
+#include "XY-SKxxx-sequencer.h"
+
+// One sequencer for the serial console, created on first use
+static XY_SKxxxSequencer* sequencer = nullptr;
+
+// Space separated numbers after the sub-command, returns how many were parsed
+static uint8_t parseSequenceArgs(const String& input, float* args, uint8_t maxArgs) {
+  uint8_t count = 0;
+  int pos = input.indexOf(' ', input.indexOf(' ') + 1); // Skip "seq <sub>"
+  while (pos > 0 && count < maxArgs) {
+    int next = input.indexOf(' ', pos + 1);
+    String token = (next > 0) ? input.substring(pos + 1, next) : input.substring(pos + 1);
+    token.trim();
+    if (token.length() > 0) {
+      args[count++] = token.toFloat();
+    }
+    pos = next;
+  }
+  return count;
+}
+
+// CSV line per update: step, point, cycle, scheduled ms, jitter us, set V/I, read back V/I
+static void printSequenceSample(void* context, const SequenceSample& sample) {
+  Serial.printf("seq,%u,%u,%u,%lu,%ld,%.2f,%.3f,", sample.step, sample.point, sample.cycle,
+                (unsigned long)sample.scheduledMs, (long)sample.jitterMicros, sample.setVoltage, sample.setCurrent);
+  if (sample.readBack) {
+    Serial.printf("%.2f,%.3f\n", sample.voltage, sample.current);
+  } else {
+    Serial.println(",");
+  }
+}
+
+static void printSequenceStatus() {
+  static const char* const stateNames[] = {"idle", "running", "done", "stopped", "failed"};
+  const SequencerStats& stats = sequencer->getStats();
+
+  Serial.println("\n==== Sequencer ====");
+  Serial.print("State: ");
+  Serial.println(stateNames[sequencer->getState()]);
+  Serial.print("Steps: ");
+  Serial.print(sequencer->size());
+  Serial.print(", cycles done: ");
+  Serial.println(stats.cycles);
+  Serial.print("Updates: ");
+  Serial.print(stats.updates);
+  Serial.print(", write failures: ");
+  Serial.print(stats.writeFailures);
+  Serial.print(", read failures: ");
+  Serial.print(stats.readFailures);
+  Serial.print(", missed read backs: ");
+  Serial.println(stats.missedReadbacks);
+  if (stats.updates > 0) {
+    Serial.print("Jitter (us): min ");
+    Serial.print(stats.minJitterMicros);
+    Serial.print(", mean ");
+    Serial.print(sequencer->getMeanJitterMicros());
+    Serial.print(", max ");
+    Serial.println(stats.maxJitterMicros);
+  }
+}
+
+static bool startSequence() {
+#if defined(ESP32)
+  bool started = sequencer->startTask();
+#else
+  bool started = sequencer->start();
+#endif
+  if (!started) {
+    Serial.println("Failed to start: check the profile against the model limits");
+    return false;
+  }
+  Serial.print("Sequence started, ");
+  Serial.print(sequencer->getTotalDurationMs());
+  Serial.println(" ms per run");
+  Serial.println("seq,step,point,cycle,ms,jitter_us,set_v,set_i,v,i");
+  return true;
+}
+
+bool handleDebugSequence(const String& input, XY_SKxxx* ps) {
+  if (sequencer == nullptr) {
+    sequencer = new XY_SKxxxSequencer(*ps);
+    sequencer->setSampleCallback(printSequenceSample, nullptr);
+  }
+
+  float args[6];
+  uint8_t count = parseSequenceArgs(input, args, 6);
+
+  if (input.startsWith("seq stop")) {
+    sequencer->stop();
+    Serial.println("Sequence stopped, the output keeps its last setpoint");
+    return true;
+  }
+
+  if (input.startsWith("seq status")) {
+    printSequenceStatus();
+    return true;
+  }
+
+  if (sequencer->isRunning()) {
+    Serial.println("A sequence is running, use 'seq stop' first");
+    return false;
+  }
+
+  if (input.startsWith("seq ramp ")) {
+    // seq ramp <from> <to> <current> <ms> [repeat]
+    if (count < 4) {
+      Serial.println("Invalid format. Use: seq ramp [from V] [to V] [current A] [ms] [repeat]");
+      return false;
+    }
+    sequencer->clear();
+    sequencer->addPoint(args[0], args[2], 0);
+    sequencer->addRamp(args[1], args[2], (uint32_t)args[3]);
+    sequencer->setRepeat(count > 4 ? (uint16_t)args[4] : 1);
+    return startSequence();
+  }
+
+  if (input.startsWith("seq stair ")) {
+    // seq stair <start> <step> <count> <current> <dwell ms> [repeat]
+    if (count < 5 || args[2] < 1 || args[2] > SEQUENCER_MAX_STEPS) {
+      Serial.println("Invalid format. Use: seq stair [start V] [step V] [count] [current A] [dwell ms] [repeat]");
+      return false;
+    }
+    sequencer->clear();
+    sequencer->addStaircase(args[0], args[1], (uint8_t)args[2], args[3], (uint32_t)args[4]);
+    sequencer->setRepeat(count > 5 ? (uint16_t)args[5] : 1);
+    return startSequence();
+  }
+
+  Serial.println("Use: seq ramp | seq stair | seq stop | seq status");
+  return false;
+}
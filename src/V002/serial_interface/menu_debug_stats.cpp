@@ -0,0 +1,219 @@
+#include "menu_debug.h"
+#include "serial_core.h"
+
+// Print the RTU master transaction counters and timing
+static void printRtuStats(const xy_sk::RtuStats& stats) {
+  Serial.print("Transactions: ");
+  Serial.print(stats.transactions);
+  Serial.print(" (failed: ");
+  Serial.print(stats.failures);
+  Serial.print(", timeouts: ");
+  Serial.print(stats.timeouts);
+  Serial.print(", CRC errors: ");
+  Serial.print(stats.crcErrors);
+  Serial.print(", exceptions: ");
+  Serial.print(stats.exceptions);
+  Serial.println(")");
+  
+  if (stats.transactions == 0) {
+    return;
+  }
+  
+  Serial.print("CPU per transaction: ");
+  Serial.print(stats.totalCpuMicros / stats.transactions);
+  Serial.print(" us avg, ");
+  Serial.print(stats.lastCpuMicros);
+  Serial.println(" us last");
+  
+  Serial.print("Latency: ");
+  Serial.print(stats.totalLatencyMicros / stats.transactions);
+  Serial.print(" us avg, ");
+  Serial.print(stats.maxLatencyMicros);
+  Serial.print(" us max, ");
+  Serial.print(stats.lastLatencyMicros);
+  Serial.println(" us last");
+}
+
+// Print the adaptive response timeout state of every tracked slave
+static void printTimeoutStats(const xy_sk::RtuMaster& modbus) {
+  const xy_sk::AdaptiveTimeout& adaptive = modbus.adaptiveTimeout();
+  
+  Serial.print("Response timeout: ");
+  if (!adaptive.isEnabled()) {
+    Serial.print(modbus.getResponseTimeout());
+    Serial.println(" ms (fixed)");
+    return;
+  }
+  Serial.print("adaptive, ceiling ");
+  Serial.print(modbus.getResponseTimeout());
+  Serial.println(" ms");
+  
+  xy_sk::SlaveTimingStats slaveStats;
+  for (uint8_t i = 0; i < xy_sk::TIMEOUT_MAX_TRACKED_SLAVES; i++) {
+    if (!adaptive.getSlaveStats(i, slaveStats)) {
+      continue;
+    }
+    Serial.print("  Slave ");
+    Serial.print(slaveStats.slave);
+    Serial.print(": p99 reply delay ");
+    Serial.print(slaveStats.percentileMicros);
+    Serial.print(" us, timeout ");
+    Serial.print(slaveStats.lastTimeoutMicros / 1000.0f, 1);
+    Serial.print(" ms, samples ");
+    Serial.print(slaveStats.sampleCount);
+    if (slaveStats.consecutiveTimeouts > 0) {
+      Serial.print(", missed ");
+      Serial.print(slaveStats.consecutiveTimeouts);
+    }
+    Serial.println();
+  }
+}
+
+// Print per-slave traffic and throughput on the shared bus
+static void printSlaveBusStats(const xy_sk::RtuBus& bus) {
+  xy_sk::SlaveBusStats stats;
+  for (uint8_t i = 0; i < xy_sk::BUS_MAX_DEVICES; i++) {
+    if (!bus.getSlaveStats(i, stats)) {
+      continue;
+    }
+    unsigned long elapsed = millis() - stats.since;
+    Serial.print("  Slave ");
+    Serial.print(stats.slave);
+    Serial.print(": ");
+    Serial.print(stats.transactions);
+    Serial.print(" transactions (");
+    Serial.print(stats.failures);
+    Serial.print(" failed), ");
+    Serial.print(elapsed > 0 ? (stats.registers * 1000.0f) / elapsed : 0.0f, 1);
+    Serial.print(" regs/s, bus busy ");
+    Serial.print(elapsed > 0 ? stats.busMicros / (elapsed * 10.0f) : 0.0f, 1);
+    Serial.print("%, service turns ");
+    Serial.println(stats.serviceSteps);
+  }
+}
+
+// Print the retry policy counters
+static void printRetryStats(const xy_sk::RetryStats& stats) {
+  Serial.print("Operations: ");
+  Serial.print(stats.operations);
+  Serial.print(" (retries: ");
+  Serial.print(stats.retries);
+  Serial.print(", recovered: ");
+  Serial.print(stats.recovered);
+  Serial.print(", exhausted: ");
+  Serial.print(stats.exhausted);
+  Serial.print(", deadline: ");
+  Serial.print(stats.deadlineExceeded);
+  Serial.print(", fail-fast: ");
+  Serial.print(stats.failFast);
+  Serial.println(")");
+}
+
+bool handleDebugBusStats(const String& input, XY_SKxxx* ps) {
+  if (input.endsWith(" adaptive on") || input.endsWith(" adaptive off")) {
+    bool enable = input.endsWith(" on");
+    ps->modbus.adaptiveTimeout().setEnabled(enable);
+    ps->modbus.adaptiveTimeout().resetAll();
+    Serial.print("Adaptive response timeout ");
+    Serial.println(enable ? "enabled" : "disabled");
+    return true;
+  }
+  
+  Serial.println("\n==== Modbus RTU Statistics ====");
+  printRtuStats(ps->modbus.getStats());
+  printSlaveBusStats(ps->getBus());
+  printTimeoutStats(ps->modbus);
+  printRetryStats(ps->retryPolicy.getStats());
+  
+  if (input.endsWith(" reset")) {
+    ps->modbus.resetStats();
+    ps->getBus().resetSlaveStats();
+    ps->retryPolicy.resetStats();
+    Serial.println("Statistics reset");
+  }
+  return true;
+}
+
+bool handleDebugCacheStats(const String& input, XY_SKxxx* ps) {
+  Serial.println("\n==== Cache Statistics ====");
+  Serial.println("Field                  hits  stale  miss  refresh  redundant  reads  age <100ms/<1s/<5s/<30s/<5min/older");
+  
+  CacheFieldStats total;
+  memset(&total, 0, sizeof(total));
+  for (uint8_t i = 0; i < CACHE_FIELD_COUNT; i++) {
+    const CacheFieldStats& stats = ps->getCacheStats((CacheField)i);
+    if (stats.hits + stats.staleHits + stats.misses + stats.refreshes == 0) {
+      continue;
+    }
+    Serial.printf("%-22s %5lu %6lu %5lu %8lu %10lu %6lu ", XY_SKxxx::getCacheFieldName((CacheField)i),
+                  (unsigned long)stats.hits, (unsigned long)stats.staleHits, (unsigned long)stats.misses,
+                  (unsigned long)stats.refreshes, (unsigned long)stats.redundantRefreshes,
+                  (unsigned long)stats.busReads);
+    for (uint8_t b = 0; b < XY_SKXXX_CACHE_AGE_BUCKETS; b++) {
+      Serial.print(b == 0 ? " " : "/");
+      Serial.print(stats.ageHistogram[b]);
+    }
+    Serial.println();
+    
+    total.hits += stats.hits;
+    total.staleHits += stats.staleHits;
+    total.misses += stats.misses;
+    total.refreshes += stats.refreshes;
+    total.redundantRefreshes += stats.redundantRefreshes;
+    total.busReads += stats.busReads;
+  }
+  
+  Serial.print("Total: ");
+  Serial.print(total.hits + total.staleHits);
+  Serial.print(" served from cache (");
+  Serial.print(total.staleHits);
+  Serial.print(" stale), ");
+  Serial.print(total.refreshes);
+  Serial.print(" refreshes (");
+  Serial.print(total.redundantRefreshes);
+  Serial.print(" redundant), ");
+  Serial.print(total.busReads);
+  Serial.println(" read frames");
+  
+  if (input.endsWith(" reset")) {
+    ps->resetCacheStats();
+    Serial.println("Statistics reset");
+  }
+  return true;
+}
+
+bool handleDebugBench(const String& input, XY_SKxxx* ps) {
+  // Number of transactions, default 100
+  uint16_t count = 100;
+  int spacePos = input.indexOf(' ');
+  if (spacePos > 0 && !parseUInt16(input.substring(spacePos + 1), count)) {
+    Serial.println("Invalid format. Use: bench [count]");
+    return false;
+  }
+  if (count == 0) {
+    count = 1;
+  }
+  
+  Serial.print("\nRunning ");
+  Serial.print(count);
+  Serial.println(" block reads of VOUT/IOUT/POWER/UIN...");
+  
+  ps->modbus.resetStats();
+  unsigned long startTime = millis();
+  uint16_t values[4];
+  
+  for (uint16_t i = 0; i < count; i++) {
+    ps->readRegisters(REG_VOUT, 4, values);
+  }
+  
+  unsigned long elapsed = millis() - startTime;
+  
+  Serial.println("\n==== Benchmark Result ====");
+  printRtuStats(ps->modbus.getStats());
+  Serial.print("Wall time: ");
+  Serial.print(elapsed);
+  Serial.print(" ms (");
+  Serial.print(elapsed > 0 ? (count * 1000UL) / elapsed : count);
+  Serial.println(" transactions/s)");
+  return true;
+}
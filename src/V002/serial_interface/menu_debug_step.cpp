@@ -0,0 +1,124 @@
+#include "menu_debug.h"
+#include "serial_core.h"
+#include "XY-SKxxx-step.h"
+
+// One step response test for the serial console, created on first use
+static XY_SKxxxStepResponse* stepTest = nullptr;
+
+// "5,12,20" -> values, returns the count
+static uint8_t parseList(String list, float* values, uint8_t maxCount) {
+  uint8_t count = 0;
+  while (list.length() > 0 && count < maxCount) {
+    int comma = list.indexOf(',');
+    values[count++] = ((comma >= 0) ? list.substring(0, comma) : list).toFloat();
+    list = (comma >= 0) ? list.substring(comma + 1) : "";
+  }
+  return count;
+}
+
+static void printStepReport() {
+  Serial.println("\n==== Step response ====");
+  if (stepTest->isRunning()) {
+    Serial.print("Running step ");
+    Serial.print(stepTest->getCurrentStep() + 1);
+    Serial.print(" of ");
+    Serial.println(stepTest->getStepCount());
+  }
+  Serial.print("Tolerance band: ");
+  Serial.print(stepTest->getTolerance(), 1);
+  Serial.println(" %");
+  Serial.println("  step            limit    delay ms  rise ms  overshoot  settle ms  samples  interval ms");
+  for (uint8_t i = 0; i < stepTest->getResultCount(); i++) {
+    const StepResult& r = stepTest->getResult(i);
+    bool voltage = r.step.quantity == STEP_VOLTAGE;
+    Serial.printf("  %6.3f->%6.3f%s %6.3f%s ", r.step.from, r.step.to, voltage ? "V" : "A", r.step.limit,
+                  voltage ? "A" : "V");
+    if (!r.valid) {
+      Serial.printf(" no response (%.3f -> %.3f, %u samples, %u read failures)\n", r.initial, r.final, r.samples,
+                    r.readFailures);
+      continue;
+    }
+    Serial.printf(" %8.1f %8.1f %8.1f %% %9.1f%s %8u %12.2f\n", r.delayMs, r.riseMs, r.overshootPercent,
+                  r.settlingMs, r.settled ? " " : "+", r.samples, r.sampleIntervalMs);
+  }
+  Serial.println("  (+ = not settled within the capture time)");
+}
+
+bool handleDebugStep(const String& input, XY_SKxxx* ps) {
+  if (stepTest == nullptr) {
+    stepTest = new XY_SKxxxStepResponse(*ps);
+  }
+
+  if (input.startsWith("step stop")) {
+    stepTest->stop();
+#if !defined(ESP32)
+    stepTest->update();
+#endif
+    Serial.println("Step test stopped, setpoints restored");
+    return true;
+  }
+
+  if (input.startsWith("step report")) {
+    printStepReport();
+    return true;
+  }
+
+  if (stepTest->isRunning()) {
+    Serial.println("A step test is running, use 'step stop' first");
+    return false;
+  }
+
+  // step <v|i> <levels> [limits] [tolerance %] [capture ms]
+  String args[5];
+  uint8_t argCount = 0;
+  String rest = input.substring(input.indexOf(' ') + 1);
+  rest.trim();
+  while (rest.length() > 0 && argCount < 5) {
+    int space = rest.indexOf(' ');
+    args[argCount++] = (space > 0) ? rest.substring(0, space) : rest;
+    rest = (space > 0) ? rest.substring(space + 1) : "";
+    rest.trim();
+  }
+
+  StepQuantity quantity;
+  if (argCount >= 2 && args[0] == "v") {
+    quantity = STEP_VOLTAGE;
+  } else if (argCount >= 2 && args[0] == "i") {
+    quantity = STEP_CURRENT;
+  } else {
+    Serial.println("Use: step v|i [levels] [limits] [tolerance_%] [capture_ms] | step stop | step report");
+    Serial.println("     e.g. 'step v 5,12,24 0.5,2' steps 5-12-24-12-5 V at 0.5 A and at 2 A");
+    return false;
+  }
+
+  float levels[8];
+  float limits[4];
+  uint8_t levelCount = parseList(args[1], levels, 8);
+  uint8_t limitCount = (argCount > 2) ? parseList(args[2], limits, 4) : 0;
+  if (argCount > 3) {
+    stepTest->setTolerance(args[3].toFloat());
+  }
+  if (argCount > 4) {
+    stepTest->setCaptureTime((uint32_t)args[4].toInt());
+  }
+
+  stepTest->clearSteps();
+  if (stepTest->addMatrix(quantity, levels, levelCount, limits, limitCount) == 0) {
+    Serial.println("No valid steps: give at least two different levels within the model limits");
+    return false;
+  }
+
+#if defined(ESP32)
+  bool started = stepTest->startTask();
+#else
+  bool started = stepTest->start();
+#endif
+  if (!started) {
+    Serial.println("Failed to start the step test");
+    return false;
+  }
+  Serial.print("Step test started: ");
+  Serial.print(stepTest->getStepCount());
+  Serial.println(" steps, the output is switched on. 'step report' shows the results");
+  return true;
+}
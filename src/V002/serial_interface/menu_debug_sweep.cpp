@@ -0,0 +1,113 @@
+#include "menu_debug.h"
+#include "serial_core.h"
+#include "XY-SKxxx-sweep.h"
+
+// One sweep for the serial console, created on first use
+static XY_SKxxxIvSweep* sweep = nullptr;
+
+static void printSweepStatus() {
+  const IvSweepStats& stats = sweep->getStats();
+
+  Serial.println("\n==== I-V sweep ====");
+  Serial.print("State: ");
+  Serial.println(sweep->isRunning() ? "running" : (stats.aborted ? "aborted" : "stopped"));
+  Serial.print("Points: ");
+  Serial.print(stats.points);
+  Serial.print(" of ");
+  Serial.print(sweep->getPlannedPoints());
+  Serial.print(", not settled: ");
+  Serial.println(stats.unsettled);
+  Serial.print("Time: ");
+  Serial.print(stats.elapsedMs / 1000.0f, 1);
+  Serial.print(" s, reads: ");
+  Serial.print(stats.reads);
+  Serial.print(", read failures: ");
+  Serial.print(stats.readFailures);
+  Serial.print(", write failures: ");
+  Serial.println(stats.writeFailures);
+  if (stats.protection != 0) {
+    Serial.print("Aborted by protection status ");
+    Serial.println(stats.protection);
+  }
+}
+
+// CSV, ready to paste into a spreadsheet
+static void printSweepTable() {
+  Serial.println(sweep->getMode() == IV_SWEEP_VOLTAGE ? "v_set,v_out,i_out,p_out,u_in,mode,settled,settle_ms"
+                                                      : "i_set,v_out,i_out,p_out,u_in,mode,settled,settle_ms");
+  for (uint16_t i = 0; i < sweep->getPointCount(); i++) {
+    const IvPoint& point = sweep->getPoint(i);
+    Serial.printf("%.3f,%.3f,%.3f,%.2f,%.2f,%s,%d,%u\n", point.setpoint, point.voltage, point.current, point.power,
+                  point.inputVoltage, point.cvcc ? "CC" : "CV", point.settled ? 1 : 0, point.settleMs);
+  }
+}
+
+bool handleDebugSweep(const String& input, XY_SKxxx* ps) {
+  if (sweep == nullptr) {
+    sweep = new XY_SKxxxIvSweep(*ps);
+  }
+
+  if (input.startsWith("iv stop")) {
+    sweep->stop();
+#if !defined(ESP32)
+    sweep->update();
+#endif
+    Serial.println("Sweep stopped, setpoints restored");
+    return true;
+  }
+
+  if (input.startsWith("iv status")) {
+    printSweepStatus();
+    return true;
+  }
+
+  if (input.startsWith("iv table")) {
+    printSweepTable();
+    return true;
+  }
+
+  if (sweep->isRunning()) {
+    Serial.println("A sweep is running, use 'iv stop' first");
+    return false;
+  }
+
+  // iv <v|i> <start> <end> <points> [limit] [settle timeout ms]
+  String args = input.substring(input.indexOf(' ') + 1);
+  int space = args.indexOf(' ');
+  String mode = (space > 0) ? args.substring(0, space) : args;
+  float values[5] = {0, 0, 0, 0, 0};
+  uint8_t count = 0;
+  while (space > 0 && count < 5) {
+    args = args.substring(space + 1);
+    args.trim();
+    space = args.indexOf(' ');
+    values[count++] = ((space > 0) ? args.substring(0, space) : args).toFloat();
+  }
+
+  if ((mode != "v" && mode != "i") || count < 3) {
+    Serial.println("Use: iv v|i [start] [end] [points] [limit] [timeout_ms] | iv stop | iv status | iv table");
+    return false;
+  }
+  if (!sweep->configure(mode == "v" ? IV_SWEEP_VOLTAGE : IV_SWEEP_CURRENT, values[0], values[1],
+                        (uint16_t)values[2], values[3])) {
+    Serial.print("Invalid sweep: 2 to ");
+    Serial.print(IV_MAX_POINTS);
+    Serial.println(" points within the model limits");
+    return false;
+  }
+  if (count > 4) {
+    sweep->setSettling(3, 200, (uint32_t)values[4]);
+  }
+
+#if defined(ESP32)
+  bool started = sweep->startTask();
+#else
+  bool started = sweep->start();
+#endif
+  if (!started) {
+    Serial.println("Failed to start the sweep");
+    return false;
+  }
+  Serial.println("Sweep started, the output is switched on. 'iv table' prints the result as CSV");
+  return true;
+}
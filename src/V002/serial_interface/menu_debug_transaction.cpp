@@ -0,0 +1,77 @@
+#include "menu_debug.h"
+#include "serial_core.h"
+#include "XY-SKxxx-transaction.h"
+
+bool handleDebugTransaction(const String& input, XY_SKxxx* ps) {
+  // txn [reg1] [val1] [reg2] [val2] ... [verify], all hex
+  XY_SKxxxTransaction transaction(*ps);
+  bool verify = false;
+  bool haveRegister = false;
+  uint16_t reg = 0;
+
+  String args = input.substring(3);
+  args.trim();
+  while (args.length() > 0) {
+    int space = args.indexOf(' ');
+    String token = (space > 0) ? args.substring(0, space) : args;
+    args = (space > 0) ? args.substring(space + 1) : "";
+    args.trim();
+
+    if (token == "verify") {
+      verify = true;
+      continue;
+    }
+    uint16_t value;
+    if (!parseHex(token, value)) {
+      Serial.println("Invalid hex token: " + token);
+      return false;
+    }
+    if (!haveRegister) {
+      reg = value;
+      haveRegister = true;
+      continue;
+    }
+    if (!transaction.write(reg, value)) {
+      Serial.println("Too many registers in one transaction");
+      return false;
+    }
+    haveRegister = false;
+  }
+
+  if (haveRegister || transaction.size() == 0) {
+    Serial.println("Invalid format. Need register-value pairs.");
+    return false;
+  }
+
+  Serial.print("Writing ");
+  Serial.print(transaction.size());
+  Serial.print(" registers in ");
+  Serial.print(transaction.planFrames());
+  Serial.println(" frames");
+
+  bool success = transaction.commit(verify);
+  for (uint8_t i = 0; i < transaction.size(); i++) {
+    const TransactionWrite& write = transaction.getWrite(i);
+    Serial.print("Register 0x");
+    Serial.print(write.addr, HEX);
+    Serial.print(" = 0x");
+    Serial.print(write.value, HEX);
+    if (!write.written) {
+      Serial.println(" failed");
+    } else if (verify) {
+      Serial.println(write.verified ? " verified" : " read back differs");
+    } else {
+      Serial.println(" ok");
+    }
+  }
+
+  const TransactionResult& result = transaction.getResult();
+  Serial.print("Frames: ");
+  Serial.print(result.frames);
+  Serial.print(", failed: ");
+  Serial.print(result.failedFrames);
+  Serial.print(", time: ");
+  Serial.print(result.micros);
+  Serial.println(" us");
+  return success;
+}
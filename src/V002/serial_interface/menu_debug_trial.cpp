@@ -126,7 +126,7 @@ bool handleDebugWriteTrial(const String& input, XY_SKxxx* ps) {
   
   // Read current value first for reference
   uint16_t currentValue;
-  if (ps->readRegister(reg, currentValue)) {
+  if (ps->readRegistersDirect(reg, 1, &currentValue)) {
     Serial.print("Current value of register 0x");
     Serial.print(reg, HEX);
     Serial.print(": 0x");
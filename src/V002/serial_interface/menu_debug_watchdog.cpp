@@ -0,0 +1,145 @@
+#include "menu_debug.h"
+#include "serial_core.h"
+#include "XY-SKxxx-watchdog.h"
+
+// One watchdog for the serial console, created on first use
+static XY_SKxxxWatchdog* watchdog = nullptr;
+
+static const char* const ruleNames[] = {"current", "voltage", "power", "slew", "avgpower"};
+static const char* const ruleUnits[] = {"A", "V", "W", "A/s", "W"};
+
+// Runs in the task that read the sample, keep it short
+static void printWatchdogTrip(void* context, const WatchdogTrip& trip) {
+  Serial.printf("wd trip: rule %u (%s) %.3f > %.3f %s, output %s after %lu us\n", trip.rule, ruleNames[trip.type],
+                trip.value, trip.limit, ruleUnits[trip.type], trip.outputOff ? "off" : "OFF FAILED",
+                (unsigned long)trip.responseMicros);
+}
+
+static void printWatchdogStatus() {
+  const WatchdogStats& stats = watchdog->getStats();
+
+  Serial.println("\n==== Watchdog ====");
+  Serial.print("State: ");
+  Serial.println(!watchdog->isArmed() ? "disarmed" : (watchdog->isTripped() ? "TRIPPED" : "armed"));
+  for (uint8_t i = 0; i < watchdog->getRuleCount(); i++) {
+    WatchdogRuleType type = watchdog->getRuleType(i);
+    Serial.printf("Rule %u: %s > %.3f %s", i, ruleNames[type], watchdog->getRuleLimit(i), ruleUnits[type]);
+    if (type == RULE_AVERAGE_POWER) {
+      Serial.printf(" over %lu ms", (unsigned long)watchdog->getRuleTime(i));
+    } else if (watchdog->getRuleTime(i) > 0) {
+      Serial.printf(" for %lu ms", (unsigned long)watchdog->getRuleTime(i));
+    }
+    Serial.println();
+  }
+  Serial.print("Samples: ");
+  Serial.print(stats.samples);
+  Serial.print(", longest gap: ");
+  Serial.print(stats.maxSampleGapMicros);
+  Serial.print(" us, longest evaluation: ");
+  Serial.print(stats.maxEvaluateMicros);
+  Serial.println(" us");
+  Serial.print("Trips: ");
+  Serial.print(stats.trips);
+  Serial.print(", slowest sample-to-off: ");
+  Serial.print(stats.worstResponseMicros);
+  Serial.print(" us, worst case response: ");
+  Serial.print(watchdog->getWorstCaseResponseMicros());
+  Serial.println(" us");
+
+  for (uint8_t i = 0; i < watchdog->getTripCount(); i++) {
+    const WatchdogTrip& trip = watchdog->getTrip(i);
+    Serial.printf("  %lu ms: rule %u (%s) %.3f %s, detect %lu us, off %lu us%s\n", (unsigned long)trip.timeMs,
+                  trip.rule, ruleNames[trip.type], trip.value, ruleUnits[trip.type],
+                  (unsigned long)trip.detectMicros, (unsigned long)trip.responseMicros,
+                  trip.outputOff ? "" : " (write failed)");
+  }
+}
+
+bool handleDebugWatchdog(const String& input, XY_SKxxx* ps) {
+  if (watchdog == nullptr) {
+    watchdog = new XY_SKxxxWatchdog(*ps);
+    watchdog->setTripCallback(printWatchdogTrip, nullptr);
+  }
+
+  // wd <sub> [a] [b]
+  String args = input.substring(input.indexOf(' ') + 1);
+  int space = args.indexOf(' ');
+  String sub = (space > 0) ? args.substring(0, space) : args;
+  float a = 0.0f;
+  float b = 0.0f;
+  if (space > 0) {
+    args = args.substring(space + 1);
+    args.trim();
+    space = args.indexOf(' ');
+    a = ((space > 0) ? args.substring(0, space) : args).toFloat();
+    b = (space > 0) ? args.substring(space + 1).toFloat() : 0.0f;
+  }
+
+  if (sub == "status") {
+    printWatchdogStatus();
+    return true;
+  }
+
+  if (sub == "reset") {
+    watchdog->reset();
+    Serial.println("Watchdog latch cleared, turn the output back on to continue");
+    return true;
+  }
+
+  if (sub == "disarm") {
+#if defined(ESP32)
+    watchdog->stopTask();
+#endif
+    watchdog->disarm();
+    Serial.println("Watchdog disarmed");
+    return true;
+  }
+
+  if (sub == "arm") {
+    if (a > 0) {
+      watchdog->setPollInterval((uint32_t)a);
+    }
+#if defined(ESP32)
+    bool armed = watchdog->startTask();
+#else
+    bool armed = watchdog->arm();
+#endif
+    Serial.println(armed ? "Watchdog armed" : "Failed to arm: add rules first, or it is already armed");
+    return armed;
+  }
+
+  if (watchdog->isArmed()) {
+    Serial.println("Disarm the watchdog to change rules ('wd disarm')");
+    return false;
+  }
+
+  int8_t rule = -1;
+  if (sub == "clear") {
+    watchdog->clearRules();
+    Serial.println("Watchdog rules cleared");
+    return true;
+  } else if (sub == "current") {
+    rule = watchdog->addCurrentLimit(a, (uint32_t)b);
+  } else if (sub == "voltage") {
+    rule = watchdog->addVoltageLimit(a, (uint32_t)b);
+  } else if (sub == "power") {
+    rule = watchdog->addPowerLimit(a, (uint32_t)b);
+  } else if (sub == "slew") {
+    rule = watchdog->addCurrentSlewLimit(a);
+  } else if (sub == "avgpower") {
+    rule = watchdog->addAveragePowerLimit(a, (uint32_t)b);
+  } else {
+    Serial.println("Use: wd current|voltage|power [limit] [hold_ms] | wd slew [A/s] | wd avgpower [W] [window_ms]");
+    Serial.println("     wd arm [poll_ms] | wd disarm | wd reset | wd clear | wd status");
+    return false;
+  }
+
+  if (rule < 0) {
+    Serial.println("Invalid rule or no free rule slot");
+    return false;
+  }
+  Serial.print("Rule ");
+  Serial.print(rule);
+  Serial.println(" added");
+  return true;
+}
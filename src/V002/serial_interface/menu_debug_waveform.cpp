@@ -0,0 +1,136 @@
+#include "menu_debug.h"
+#include "serial_core.h"
+#include "XY-SKxxx-waveform.h"
+
+// One waveform generator for the serial console, created on first use
+static XY_SKxxxWaveform* waveform = nullptr;
+
+static void printWaveformStatus() {
+  const WaveformStats& stats = waveform->getStats();
+
+  Serial.println("\n==== Waveform ====");
+  Serial.print("State: ");
+  Serial.println(waveform->isRunning() ? "running" : "idle");
+  Serial.print("Target: ");
+  Serial.print(waveform->getTarget() == WAVE_VOLTAGE ? "voltage" : "current");
+  Serial.print(", points: ");
+  Serial.print(waveform->size());
+  Serial.print(", sample period: ");
+  Serial.print(waveform->getSamplePeriod());
+  Serial.print(" us (bus minimum about ");
+  Serial.print(waveform->getMinimumPeriodMicros());
+  Serial.println(" us)");
+  Serial.print("Writes: ");
+  Serial.print(stats.writes);
+  Serial.print(", failures: ");
+  Serial.print(stats.failures);
+  Serial.print(", skipped: ");
+  Serial.print(stats.skipped);
+  Serial.print(", periods: ");
+  Serial.println(stats.periods);
+  if (stats.writes + stats.failures > 0) {
+    Serial.print("Rate: ");
+    Serial.print(waveform->getWriteRate(), 1);
+    Serial.print(" writes/s, jitter (us): min ");
+    Serial.print(stats.minJitterMicros);
+    Serial.print(", mean ");
+    Serial.print(waveform->getMeanJitterMicros());
+    Serial.print(", max ");
+    Serial.println(stats.maxJitterMicros);
+  }
+}
+
+static bool startWaveform(uint32_t sampleMs, uint32_t cycles) {
+  waveform->setSamplePeriod(sampleMs * 1000UL);
+  waveform->setCycles(cycles);
+#if defined(ESP32)
+  bool started = waveform->startTimer();
+#else
+  bool started = waveform->start();
+#endif
+  if (!started) {
+    Serial.println("Failed to start waveform");
+    return false;
+  }
+  Serial.print("Waveform started: ");
+  Serial.print(waveform->size());
+  Serial.print(" points every ");
+  Serial.print(sampleMs);
+  Serial.println(" ms");
+  return true;
+}
+
+bool handleDebugWaveform(const String& input, XY_SKxxx* ps) {
+  if (waveform == nullptr) {
+    waveform = new XY_SKxxxWaveform(*ps);
+  }
+
+  if (input.startsWith("awg stop")) {
+    waveform->stop();
+    Serial.println("Waveform stopped, the previous setpoint is restored");
+    return true;
+  }
+
+  if (input.startsWith("awg status")) {
+    printWaveformStatus();
+    return true;
+  }
+
+  if (waveform->isRunning()) {
+    Serial.println("A waveform is running, use 'awg stop' first");
+    return false;
+  }
+
+  // awg <shape> [v|i] <a> <b> <points|values> <sample ms> [cycles]
+  String args = input.substring(input.indexOf(' ') + 1);
+  int shapeEnd = args.indexOf(' ');
+  String shape = args.substring(0, shapeEnd);
+  args = (shapeEnd > 0) ? args.substring(shapeEnd + 1) : "";
+  args.trim();
+
+  WaveformTarget target = WAVE_VOLTAGE;
+  if (args.startsWith("i ") || args.startsWith("v ")) {
+    target = args.startsWith("i ") ? WAVE_CURRENT : WAVE_VOLTAGE;
+    args = args.substring(2);
+  }
+  waveform->setTarget(target);
+
+  if (shape == "csv") {
+    // awg csv [v|i] <sample ms> <value,value,...> (cycles run until stopped)
+    int space = args.indexOf(' ');
+    if (space < 0 || !waveform->loadCsv(args.substring(space + 1).c_str())) {
+      Serial.println("Invalid format or value out of range. Use: awg csv [v|i] [sample_ms] [v1,v2,...]");
+      return false;
+    }
+    return startWaveform(args.substring(0, space).toInt(), 0);
+  }
+
+  float values[5] = {0, 0, 0, 0, 0};
+  uint8_t count = 0;
+  while (args.length() > 0 && count < 5) {
+    int space = args.indexOf(' ');
+    values[count++] = ((space > 0) ? args.substring(0, space) : args).toFloat();
+    args = (space > 0) ? args.substring(space + 1) : "";
+    args.trim();
+  }
+  if (count < 4) {
+    Serial.println("Invalid format. Use: awg sine [v|i] [offset] [amplitude] [points] [sample_ms] [cycles]");
+    Serial.println("                 or awg tri [v|i] [low] [high] [points] [sample_ms] [cycles]");
+    return false;
+  }
+
+  bool generated = false;
+  if (shape == "sine") {
+    generated = waveform->generateSine(values[0], values[1], (uint16_t)values[2]);
+  } else if (shape == "tri") {
+    generated = waveform->generateTriangle(values[0], values[1], (uint16_t)values[2]);
+  } else {
+    Serial.println("Use: awg sine | awg tri | awg csv | awg stop | awg status");
+    return false;
+  }
+  if (!generated) {
+    Serial.println("Waveform outside the model limits or too many points (max 256)");
+    return false;
+  }
+  return startWaveform((uint32_t)values[3], count > 4 ? (uint32_t)values[4] : 0);
+}
@@ -175,7 +175,14 @@ void displayDeviceInfo(XY_SKxxx* ps) {
   
   Serial.println("\n==== Device Information ====");
   Serial.print("Model: ");
-  Serial.println(model);
+  Serial.print(model);
+  Serial.print(" (");
+  Serial.print(ps->getModelInfo().name);
+  Serial.print(", ");
+  Serial.print(ps->getModelInfo().maxVoltage);
+  Serial.print(" V / ");
+  Serial.print(ps->getModelInfo().maxCurrent);
+  Serial.println(" A)");
   Serial.print("Firmware Version: ");
   Serial.println(version);
   
@@ -245,6 +252,12 @@ void displayDeviceStatus(XY_SKxxx* ps) {
     case MODE_CV:
       Serial.println("Constant Voltage (CV)");
       break;
+    case MODE_CR:
+      Serial.println("Constant Resistance (CR, emulated)");
+      Serial.print("CR Setting: ");
+      Serial.print(ps->getConstantResistance(), 3);
+      Serial.println(" ohm");
+      break;
   }
   
   // Front panel keys status - IMPORTANT ADDITION
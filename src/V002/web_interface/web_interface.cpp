@@ -26,6 +26,8 @@
 
 // Include XY-SKxxx header to access power supply functions
 #include "XY-SKxxx.h"
+#include "XY-SKxxx-queue.h"
+#include "XY-SKxxx-step.h"
 
 // Include WiFi WebSocket handler
 #include "../wifi_interface/wifi_websocket_handler.h"
@@ -39,10 +41,54 @@ extern void handleAddWifiNetworkCommand(AsyncWebSocketClient* client, DynamicJso
 // Forward declarations for functions used before definition
 bool isPSUKeyLocked(XY_SKxxx* powerSupply);
 void handleKeyLockRequest(AsyncWebSocketClient* client);
-void handleSetKeyLock(AsyncWebSocketClient* client, const JsonObject &json);
 
 AsyncWebSocket ws("/ws");
 
+// Bus work requested over the WebSocket runs from loop() through this queue,
+// so stale polls are dropped and repeated ones are merged before touching the bus
+static xy_sk::RequestQueue webRequestQueue;
+
+// Coalescing keys of queued WebSocket requests
+enum WebRequestKey : uint16_t {
+  WEB_KEY_STATUS = 1,             // getStatus / getData, per client
+  WEB_KEY_OPERATING_MODE = 2,     // getOperatingMode, per client
+  WEB_KEY_SET_VOLTAGE = 3,        // Latest setpoint wins
+  WEB_KEY_SET_CURRENT = 4,
+  WEB_KEY_OUTPUT = 5,             // powerOutput
+  WEB_KEY_KEY_LOCK = 6,           // setKeyLock
+  WEB_KEY_CONSTANT_VOLTAGE = 7,
+  WEB_KEY_CONSTANT_CURRENT = 8,
+  WEB_KEY_CONSTANT_POWER = 9,
+  WEB_KEY_CP_MODE = 10,           // setConstantPowerMode
+  WEB_KEY_KEY_LOCK_STATUS = 11,   // getKeyLockStatus, per client
+  WEB_KEY_STEP_TEST = 12          // startStepTest
+};
+
+const uint16_t WEB_KEY_ACTION_MASK = 0x000F;
+
+const unsigned long WEB_POLL_DEADLINE_MS = 1000;    // A status older than this is useless to the UI
+const unsigned long WEB_COMMAND_DEADLINE_MS = 3000; // Setpoint changes
+
+// Polls are answered to the client that sent them, so they only merge with
+// that client's earlier polls; changes reach everyone through the status push
+static uint16_t clientKey(WebRequestKey key, uint32_t clientId) {
+  return (uint16_t)(((clientId & 0x0FFF) << 4) | key);
+}
+
+// Step response test started over the WebSocket, created on first use.
+// The report goes to the client that started it once the test ends.
+static XY_SKxxxStepResponse* webStepTest = nullptr;
+static uint32_t webStepClient = 0;
+
+// Send to one client, or to every connected client when client is nullptr
+static void sendToClient(AsyncWebSocketClient* client, const String& response) {
+  if (client) {
+    client->text(response);
+  } else {
+    ws.textAll(response);
+  }
+}
+
 void notFound(AsyncWebServerRequest *request) {
   request->send(404, "text/plain", "Not found");
 }
@@ -90,12 +136,14 @@ bool handleFileRead(AsyncWebServerRequest *request) {
 }
 
 // Helper functions for XY-SKxxx power supply interface
-// These work with the existing library methods instead of modifying the library
+// These work with the existing library methods instead of modifying the library.
+// Their own register reads show whether the supply answers, none of them
+// spends a testConnection() round trip first.
 
 // Get voltage from power supply
 float getPSUVoltage(XY_SKxxx* powerSupply) {
   float voltage = 0.0, current = 0.0, power = 0.0;
-  if (powerSupply && powerSupply->testConnection()) {
+  if (powerSupply) {
     powerSupply->getOutput(voltage, current, power);
   }
   return voltage;
@@ -104,7 +152,7 @@ float getPSUVoltage(XY_SKxxx* powerSupply) {
 // Get current from power supply
 float getPSUCurrent(XY_SKxxx* powerSupply) {
   float voltage = 0.0, current = 0.0, power = 0.0;
-  if (powerSupply && powerSupply->testConnection()) {
+  if (powerSupply) {
     powerSupply->getOutput(voltage, current, power);
   }
   return current;
@@ -113,7 +161,7 @@ float getPSUCurrent(XY_SKxxx* powerSupply) {
 // Get power from power supply
 float getPSUPower(XY_SKxxx* powerSupply) {
   float voltage = 0.0, current = 0.0, power = 0.0;
-  if (powerSupply && powerSupply->testConnection()) {
+  if (powerSupply) {
     powerSupply->getOutput(voltage, current, power);
   }
   return power;
@@ -121,7 +169,7 @@ float getPSUPower(XY_SKxxx* powerSupply) {
 
 // Check if output is enabled - fixed implementation
 bool isPSUOutputEnabled(XY_SKxxx* powerSupply) {
-  if (powerSupply && powerSupply->testConnection()) {
+  if (powerSupply) {
     return powerSupply->isOutputEnabled(true); // Force refresh from device
   }
   return false;
@@ -129,7 +177,7 @@ bool isPSUOutputEnabled(XY_SKxxx* powerSupply) {
 
 // Set output state (on/off) - fixed implementation
 bool setPSUOutput(XY_SKxxx* powerSupply, bool enable) {
-  if (powerSupply && powerSupply->testConnection()) {
+  if (powerSupply) {
     if (enable) {
       return powerSupply->turnOutputOn();
     } else {
@@ -141,12 +189,13 @@ bool setPSUOutput(XY_SKxxx* powerSupply, bool enable) {
 
 // Get operating mode from power supply
 String getPSUOperatingMode(XY_SKxxx* powerSupply) {
-  if (powerSupply && powerSupply->testConnection()) {
+  if (powerSupply) {
     OperatingMode mode = powerSupply->getOperatingMode(true);
     switch (mode) {
       case MODE_CV: return "CV";
       case MODE_CC: return "CC";
       case MODE_CP: return "CP";
+      case MODE_CR: return "CR";
       default: return "Unknown";
     }
   }
@@ -155,7 +204,7 @@ String getPSUOperatingMode(XY_SKxxx* powerSupply) {
 
 // Get operating mode details including settings
 void getPSUOperatingModeDetails(XY_SKxxx* powerSupply, String& modeName, float& setValue) {
-  if (!powerSupply || !powerSupply->testConnection()) {
+  if (!powerSupply) {
     modeName = "Unknown";
     setValue = 0.0;
     return;
@@ -175,6 +224,10 @@ void getPSUOperatingModeDetails(XY_SKxxx* powerSupply, String& modeName, float&
       modeName = "Constant Power";
       setValue = powerSupply->getCachedConstantPower(false);
       break;
+    case MODE_CR:
+      modeName = "Constant Resistance";
+      setValue = powerSupply->getConstantResistance();
+      break;
     default:
       modeName = "Unknown";
       setValue = 0.0;
@@ -183,7 +236,10 @@ void getPSUOperatingModeDetails(XY_SKxxx* powerSupply, String& modeName, float&
 
 // Add a unified function to fetch complete PSU status
 void sendCompletePSUStatus(AsyncWebSocketClient* client) {
-  if (!client || !powerSupply || !powerSupply->testConnection()) {
+  // One read of the output block doubles as the connection test, a
+  // testConnection() per request would only add frames
+  float voltage = 0.0, current = 0.0, power = 0.0;
+  if (!powerSupply || !powerSupply->getOutput(voltage, current, power)) {
     return;
   }
   
@@ -191,11 +247,7 @@ void sendCompletePSUStatus(AsyncWebSocketClient* client) {
   DynamicJsonDocument responseDoc(1024);
   responseDoc["action"] = "statusResponse";
   
-  // Get basic readings
-  float voltage = getPSUVoltage(powerSupply);
-  float current = getPSUCurrent(powerSupply);
-  float power = getPSUPower(powerSupply);
-  bool outputEnabled = isPSUOutputEnabled(powerSupply);
+  bool outputEnabled = powerSupply->isOutputEnabled(true);
   
   // Add data to response
   responseDoc["connected"] = true;
@@ -231,7 +283,7 @@ void sendCompletePSUStatus(AsyncWebSocketClient* client) {
   // Send the response
   String response;
   serializeJson(responseDoc, response);
-  client->text(response);
+  sendToClient(client, response);
   
   // Also send specific operating mode information
   sendOperatingModeDetails(client);
@@ -239,7 +291,7 @@ void sendCompletePSUStatus(AsyncWebSocketClient* client) {
 
 // Function to specifically send operating mode details
 void sendOperatingModeDetails(AsyncWebSocketClient* client) {
-  if (!client || !powerSupply || !powerSupply->testConnection()) {
+  if (!powerSupply) {
     return;
   }
   
@@ -267,6 +319,11 @@ void sendOperatingModeDetails(AsyncWebSocketClient* client) {
       modeName = "Constant Power";
       setValue = powerSupply->getCachedConstantPower(false);
       break;
+    case MODE_CR:
+      modeCode = "CR";
+      modeName = "Constant Resistance";
+      setValue = powerSupply->getConstantResistance();
+      break;
     default:
       modeCode = "Unknown";
       modeName = "Unknown";
@@ -288,9 +345,334 @@ void sendOperatingModeDetails(AsyncWebSocketClient* client) {
     responseDoc["powerSet"] = powerSupply->getCachedConstantPower(false);
   }
   
+  String response;
+  serializeJson(responseDoc, response);
+  sendToClient(client, response);
+}
+
+// Queued status polls, arg is the WebSocket client id
+static void handleQueuedStatus(void* context, const xy_sk::BusRequest& request, xy_sk::RequestOutcome outcome) {
+  if (outcome != xy_sk::RequestOutcome::EXECUTE) {
+    return; // Merged into a newer poll or too old, the next poll gets fresh data
+  }
+  
+  // The client may have disconnected while the request was queued
+  AsyncWebSocketClient* client = ws.client(request.arg);
+  if (!client) {
+    return;
+  }
+  
+  switch (request.key & WEB_KEY_ACTION_MASK) {
+    case WEB_KEY_OPERATING_MODE:
+      sendOperatingModeDetails(client);
+      break;
+    case WEB_KEY_KEY_LOCK_STATUS:
+      handleKeyLockRequest(client);
+      break;
+    default:
+      sendCompletePSUStatus(client);
+      break;
+  }
+}
+
+// Queued setVoltage / setCurrent, arg is the WebSocket client id
+static void handleQueuedSetpoint(void* context, const xy_sk::BusRequest& request, xy_sk::RequestOutcome outcome) {
+  bool isVoltage = (request.key == WEB_KEY_SET_VOLTAGE);
+  const char* responseAction = isVoltage ? "setVoltageResponse" : "setCurrentResponse";
+  AsyncWebSocketClient* client = ws.client(request.arg);
+  
+  DynamicJsonDocument responseDoc(256);
+  responseDoc["action"] = responseAction;
+  
+  if (outcome != xy_sk::RequestOutcome::EXECUTE) {
+    responseDoc["success"] = false;
+    responseDoc["error"] = (outcome == xy_sk::RequestOutcome::SUPERSEDED) ? "Superseded by a newer setting" : "Request expired";
+  } else if (powerSupply) {
+    bool success = isVoltage ? powerSupply->setVoltage(request.value) : powerSupply->setCurrent(request.value);
+    
+    // Read current settings after change
+    responseDoc["success"] = success;
+    if (isVoltage) {
+      responseDoc["voltage"] = getPSUVoltage(powerSupply);
+    } else {
+      responseDoc["current"] = getPSUCurrent(powerSupply);
+    }
+  } else {
+    responseDoc["success"] = false;
+    responseDoc["error"] = "Power supply not connected";
+  }
+  
+  // The client may have disconnected while the request was queued
+  if (!client) {
+    return;
+  }
+  
   String response;
   serializeJson(responseDoc, response);
   client->text(response);
+  LOG_WS(WiFi.localIP(), client->remoteIP(), "WebSocket sent: " + response);
+}
+
+// Response action of a queued command
+static const char* commandResponseAction(uint16_t key) {
+  switch (key) {
+    case WEB_KEY_OUTPUT:           return "powerOutputResponse";
+    case WEB_KEY_KEY_LOCK:         return "keyLockResponse";
+    case WEB_KEY_CONSTANT_VOLTAGE: return "constantVoltageResponse";
+    case WEB_KEY_CONSTANT_CURRENT: return "constantCurrentResponse";
+    case WEB_KEY_CONSTANT_POWER:   return "constantPowerResponse";
+    default:                       return "constantPowerModeResponse";
+  }
+}
+
+// Queued output, key lock and CV/CC/CP commands; arg is the WebSocket client id
+// and value the new setting (0/1 for switches)
+static void handleQueuedCommand(void* context, const xy_sk::BusRequest& request, xy_sk::RequestOutcome outcome) {
+  AsyncWebSocketClient* client = ws.client(request.arg);
+  
+  DynamicJsonDocument responseDoc(256);
+  responseDoc["action"] = commandResponseAction(request.key);
+  
+  bool sendStatus = false;
+  if (outcome != xy_sk::RequestOutcome::EXECUTE) {
+    responseDoc["success"] = false;
+    responseDoc["error"] = (outcome == xy_sk::RequestOutcome::SUPERSEDED) ? "Superseded by a newer setting" : "Request expired";
+  } else if (!powerSupply) {
+    responseDoc["success"] = false;
+    responseDoc["error"] = "Power supply not connected";
+  } else {
+    bool enable = (request.value != 0.0f);
+    switch (request.key) {
+      case WEB_KEY_OUTPUT:
+        LOG_INFO("Power output command received. Setting output to: " + String(enable ? "ON" : "OFF"));
+        responseDoc["success"] = setPSUOutput(powerSupply, enable);
+        responseDoc["enabled"] = isPSUOutputEnabled(powerSupply);
+        break;
+      case WEB_KEY_KEY_LOCK:
+        LOG_INFO("Key lock command received. Setting keys to: " + String(enable ? "LOCKED" : "UNLOCKED"));
+        responseDoc["success"] = powerSupply->setKeyLock(enable);
+        responseDoc["locked"] = powerSupply->isKeyLocked(true);
+        break;
+      case WEB_KEY_CONSTANT_VOLTAGE:
+        responseDoc["success"] = powerSupply->setConstantVoltage(request.value);
+        responseDoc["voltage"] = request.value;
+        sendStatus = true;
+        break;
+      case WEB_KEY_CONSTANT_CURRENT:
+        responseDoc["success"] = powerSupply->setConstantCurrent(request.value);
+        responseDoc["current"] = request.value;
+        sendStatus = true;
+        break;
+      case WEB_KEY_CONSTANT_POWER:
+        responseDoc["success"] = powerSupply->setConstantPower(request.value);
+        responseDoc["power"] = request.value;
+        sendStatus = true;
+        break;
+      default:
+        responseDoc["success"] = powerSupply->setConstantPowerMode(enable);
+        responseDoc["enabled"] = powerSupply->isConstantPowerModeEnabled(true);
+        sendStatus = true;
+        break;
+    }
+  }
+  
+  if (!client) {
+    return;
+  }
+  
+  String response;
+  serializeJson(responseDoc, response);
+  client->text(response);
+  LOG_WS(WiFi.localIP(), client->remoteIP(), "WebSocket sent: " + response);
+  
+  // The dashboards listen for setKeyLockResponse
+  if (request.key == WEB_KEY_KEY_LOCK) {
+    responseDoc["action"] = "setKeyLockResponse";
+    response = "";
+    serializeJson(responseDoc, response);
+    client->text(response);
+  }
+  
+  // Updated status and operating mode for the client that changed them
+  if (sendStatus) {
+    sendCompletePSUStatus(client);
+  }
+}
+
+// Queue a command from a WebSocket client, answer it at once if the queue is full
+static void submitCommand(AsyncWebSocketClient* client, WebRequestKey key, float value) {
+  if (!webRequestQueue.submit(key, WEB_COMMAND_DEADLINE_MS, handleQueuedCommand, nullptr, client->id(), value)) {
+    String errorMsg = String("{\"action\":\"") + commandResponseAction(key) +
+                      "\",\"success\":false,\"error\":\"Request queue full\"}";
+    client->text(errorMsg);
+    LOG_WS(WiFi.localIP(), client->remoteIP(), "WebSocket sent: " + errorMsg);
+  }
+}
+
+// Set by the status subscriptions during a background poll, the push to
+// the clients happens afterwards from loop()
+static bool webStatusChanged = false;
+
+static void onPSUStatusChange(void* context, XY_SKxxx& device, StatusField field, float value) {
+  webStatusChanged = true;
+}
+
+void subscribeWebStatusUpdates(XY_SKxxx* psu) {
+  if (!psu) {
+    return;
+  }
+  
+  // Deadbands keep measurement noise from flooding the WebSocket
+  float deadbands[FIELD_COUNT] = {0};
+  deadbands[FIELD_OUTPUT_VOLTAGE] = 0.05f;
+  deadbands[FIELD_OUTPUT_CURRENT] = 0.01f;
+  deadbands[FIELD_OUTPUT_POWER] = 0.1f;
+  
+  // One field-set slot, the single-field slots stay free for other components
+  psu->subscribeFields(STATUS_FIELD_BIT(FIELD_OUTPUT_VOLTAGE) | STATUS_FIELD_BIT(FIELD_OUTPUT_CURRENT) |
+                       STATUS_FIELD_BIT(FIELD_OUTPUT_POWER) | STATUS_FIELD_BIT(FIELD_OUTPUT_ENABLED) |
+                       STATUS_FIELD_BIT(FIELD_KEY_LOCKED) | STATUS_FIELD_BIT(FIELD_PROTECTION_STATUS) |
+                       STATUS_FIELD_BIT(FIELD_CVCC_MODE) | STATUS_FIELD_BIT(FIELD_SET_VOLTAGE) |
+                       STATUS_FIELD_BIT(FIELD_SET_CURRENT) | STATUS_FIELD_BIT(FIELD_CP_MODE_ENABLED) |
+                       STATUS_FIELD_BIT(FIELD_CONSTANT_POWER),
+                       onPSUStatusChange, nullptr, deadbands);
+}
+
+// statusResponse built from the cache only, no bus traffic
+static void sendCachedPSUStatus() {
+  const DeviceStatus& status = powerSupply->getStatusSnapshot();
+  
+  DynamicJsonDocument responseDoc(1024);
+  responseDoc["action"] = "statusResponse";
+  responseDoc["connected"] = true;
+  responseDoc["outputEnabled"] = status.outputEnabled;
+  responseDoc["voltage"] = status.outputVoltage;
+  responseDoc["current"] = status.outputCurrent;
+  responseDoc["power"] = status.outputPower;
+  
+  OperatingMode mode = powerSupply->getOperatingMode(false);
+  switch (mode) {
+    case MODE_CC:
+      responseDoc["operatingMode"] = "CC";
+      responseDoc["operatingModeName"] = "Constant Current";
+      responseDoc["setValue"] = status.setCurrent;
+      break;
+    case MODE_CP:
+      responseDoc["operatingMode"] = "CP";
+      responseDoc["operatingModeName"] = "Constant Power";
+      responseDoc["setValue"] = status.constantPower;
+      break;
+    case MODE_CR:
+      responseDoc["operatingMode"] = "CR";
+      responseDoc["operatingModeName"] = "Constant Resistance";
+      responseDoc["setValue"] = powerSupply->getConstantResistance();
+      break;
+    default:
+      responseDoc["operatingMode"] = "CV";
+      responseDoc["operatingModeName"] = "Constant Voltage";
+      responseDoc["setValue"] = status.setVoltage;
+      break;
+  }
+  
+  responseDoc["voltageSet"] = status.setVoltage;
+  responseDoc["currentSet"] = status.setCurrent;
+  responseDoc["cpModeEnabled"] = status.cpModeEnabled;
+  responseDoc["powerSet"] = status.constantPower;
+  responseDoc["protectionStatus"] = status.protectionStatus;
+  responseDoc["keyLockEnabled"] = status.keyLocked;
+  
+  String response;
+  serializeJson(responseDoc, response);
+  ws.textAll(response);
+}
+
+// Step response report of the last run
+static void sendStepReport(AsyncWebSocketClient* client) {
+  DynamicJsonDocument responseDoc(8192);
+  responseDoc["action"] = "stepReport";
+  responseDoc["running"] = webStepTest && webStepTest->isRunning();
+  JsonArray results = responseDoc.createNestedArray("results");
+  
+  uint8_t count = webStepTest ? webStepTest->getResultCount() : 0;
+  for (uint8_t i = 0; i < count; i++) {
+    const StepResult& r = webStepTest->getResult(i);
+    JsonObject result = results.createNestedObject();
+    result["quantity"] = (r.step.quantity == STEP_VOLTAGE) ? "voltage" : "current";
+    result["from"] = r.step.from;
+    result["to"] = r.step.to;
+    result["limit"] = r.step.limit;
+    result["valid"] = r.valid;
+    result["settled"] = r.settled;
+    result["initial"] = r.initial;
+    result["final"] = r.final;
+    result["peak"] = r.peak;
+    result["delayMs"] = r.delayMs;
+    result["riseMs"] = r.riseMs;
+    result["overshootPercent"] = r.overshootPercent;
+    result["settlingMs"] = r.settlingMs;
+    result["samples"] = r.samples;
+    result["sampleIntervalMs"] = r.sampleIntervalMs;
+  }
+  
+  String response;
+  serializeJson(responseDoc, response);
+  sendToClient(client, response);
+}
+
+// Queued startStepTest, the matrix is already set up; arg is the WebSocket client id
+static void handleQueuedStepTest(void* context, const xy_sk::BusRequest& request, xy_sk::RequestOutcome outcome) {
+  AsyncWebSocketClient* client = ws.client(request.arg);
+  
+  DynamicJsonDocument responseDoc(256);
+  responseDoc["action"] = "startStepTestResponse";
+  
+  bool started = false;
+  if (outcome != xy_sk::RequestOutcome::EXECUTE) {
+    responseDoc["error"] = "Request expired";
+  } else if (!powerSupply) {
+    responseDoc["error"] = "Power supply not connected";
+  } else if (!webStepTest->startTask()) {
+    responseDoc["error"] = "Failed to start the step test";
+  } else {
+    started = true;
+    webStepClient = request.arg;
+    responseDoc["steps"] = webStepTest->getStepCount();
+  }
+  responseDoc["success"] = started;
+  
+  if (!client) {
+    return;
+  }
+  
+  String response;
+  serializeJson(responseDoc, response);
+  client->text(response);
+  LOG_WS(WiFi.localIP(), client->remoteIP(), "WebSocket sent: " + response);
+}
+
+// Called from loop(): run queued WebSocket requests on the bus
+void processWebRequestQueue() {
+  webRequestQueue.process(1);
+  
+  if (webStatusChanged && powerSupply) {
+    webStatusChanged = false;
+    if (ws.count() > 0) {
+      sendCachedPSUStatus();
+    }
+  }
+  
+  // Step test finished: report to the client that started it, if still connected
+  if (webStepClient != 0 && !webStepTest->isRunning()) {
+    AsyncWebSocketClient* client = ws.client(webStepClient);
+    webStepClient = 0;
+    if (client) {
+      sendStepReport(client);
+    }
+  }
+}
+
+const xy_sk::RequestQueueStats& getWebRequestQueueStats() {
+  return webRequestQueue.getStats();
 }
 
 // Add function to read key lock status from PSU
@@ -329,35 +711,6 @@ void handleKeyLockRequest(AsyncWebSocketClient* client) {
   client->text(response);
 }
 
-// Change parameter type to const JsonObject& to fix the binding error
-void handleSetKeyLock(AsyncWebSocketClient* client, const JsonObject &json) {
-  XY_SKxxx* psu = powerSupply;
-  if (!psu) {
-    DynamicJsonDocument doc(256);
-    doc["action"] = "setKeyLockResponse";
-    doc["success"] = false;
-    doc["error"] = "No PSU connected";
-    String response;
-    serializeJson(doc, response);
-    client->text(response);
-    return;
-  }
-  
-  bool lock = json["lock"] | false;
-  bool success = psu->setKeyLock(lock);
-  
-  DynamicJsonDocument doc(256);
-  doc["action"] = "setKeyLockResponse";
-  doc["success"] = success;
-  
-  // Always return the actual current state (which may differ if the operation failed)
-  doc["locked"] = psu->isKeyLocked(true);
-  
-  String response;
-  serializeJson(doc, response);
-  client->text(response);
-}
-
 // Add this function to handle the WiFi network addition
 void handleAddWifiNetworkWebSocketCommand(AsyncWebSocketClient* client, DynamicJsonDocument& doc) {
     if (!doc.containsKey("ssid") || !doc.containsKey("password")) {
@@ -494,8 +847,9 @@ void handleWebSocketMessage(AsyncWebSocket* server, AsyncWebSocketClient* client
     }
     
     if (action == "getData") {
-      // Simply call the comprehensive status function instead of duplicating the logic
-      sendCompletePSUStatus(client);
+      // Same as getStatus, a client's pending polls are merged into one bus read
+      webRequestQueue.submit(clientKey(WEB_KEY_STATUS, client->id()), WEB_POLL_DEADLINE_MS, handleQueuedStatus,
+                             nullptr, client->id());
     } 
     else if (action == "setConfig") {
       // Handle configuration settings
@@ -503,240 +857,93 @@ void handleWebSocketMessage(AsyncWebSocket* server, AsyncWebSocketClient* client
     }
     // Power supply control commands
     else if (action == "powerOutput") {
-      // Toggle power output on/off - ensure we get the correct current state first
-      if (powerSupply && powerSupply->testConnection()) {
-        bool enable = doc["enable"];
-        LOG_INFO("Power output command received. Setting output to: " + String(enable ? "ON" : "OFF"));
-        
-        bool success = setPSUOutput(powerSupply, enable);
-        
-        // Wait a moment for the command to take effect
-        delay(100);
-        
-        // Get current status after change
-        bool outputEnabled = isPSUOutputEnabled(powerSupply);
-        
-        LOG_INFO("Output status after command: " + String(outputEnabled ? "ON" : "OFF"));
-        
-        // Send response
-        DynamicJsonDocument responseDoc(256);
-        responseDoc["action"] = "powerOutputResponse";
-        responseDoc["success"] = success;
-        responseDoc["enabled"] = outputEnabled;
-        
-        String response;
-        serializeJson(responseDoc, response);
-        client->text(response);
-        LOG_WS(serverIP, clientIP, "WebSocket sent: " + response);
-      } else {
-        String errorMsg = "{\"action\":\"powerOutputResponse\",\"success\":false,\"error\":\"Power supply not connected\"}";
-        client->text(errorMsg);
-        LOG_WS(serverIP, clientIP, "WebSocket sent: " + errorMsg);
-      }
+      // Queued like every bus access, a newer switch command replaces a pending one
+      bool enable = doc["enable"];
+      submitCommand(client, WEB_KEY_OUTPUT, enable ? 1.0f : 0.0f);
     }
-    else if (action == "setVoltage") {
-      // Set voltage
-      if (powerSupply && powerSupply->testConnection()) {
-        float voltage = doc["voltage"];
-        bool success = powerSupply->setVoltage(voltage);
-        
-        // Read current settings after change
-        float v = getPSUVoltage(powerSupply);
-        
-        // Send response
-        DynamicJsonDocument responseDoc(256);
-        responseDoc["action"] = "setVoltageResponse";
-        responseDoc["success"] = success;
-        responseDoc["voltage"] = v;
-        
-        String response;
-        serializeJson(responseDoc, response);
-        client->text(response);
-        LOG_WS(serverIP, clientIP, "WebSocket sent: " + response);
-      } else {
-        String errorMsg = "{\"action\":\"setVoltageResponse\",\"success\":false,\"error\":\"Power supply not connected\"}";
+    else if (action == "setVoltage" || action == "setCurrent") {
+      // Queued, a newer setpoint replaces one that has not been written yet
+      bool isVoltage = (action == "setVoltage");
+      float value = isVoltage ? doc["voltage"] : doc["current"];
+      if (!webRequestQueue.submit(isVoltage ? WEB_KEY_SET_VOLTAGE : WEB_KEY_SET_CURRENT, WEB_COMMAND_DEADLINE_MS,
+                                  handleQueuedSetpoint, nullptr, client->id(), value)) {
+        String errorMsg = "{\"action\":\"" + action + "Response\",\"success\":false,\"error\":\"Request queue full\"}";
         client->text(errorMsg);
         LOG_WS(serverIP, clientIP, "WebSocket sent: " + errorMsg);
       }
     }
-    else if (action == "setCurrent") {
-      // Set current
-      if (powerSupply && powerSupply->testConnection()) {
-        float current = doc["current"];
-        bool success = powerSupply->setCurrent(current);
-        
-        // Read current settings after change
-        float c = getPSUCurrent(powerSupply);
-        
-        // Send response
-        DynamicJsonDocument responseDoc(256);
-        responseDoc["action"] = "setCurrentResponse";
-        responseDoc["success"] = success;
-        responseDoc["current"] = c;
-        
-        String response;
-        serializeJson(responseDoc, response);
-        client->text(response);
-        LOG_WS(serverIP, clientIP, "WebSocket sent: " + response);
-      } else {
-        String errorMsg = "{\"action\":\"setCurrentResponse\",\"success\":false,\"error\":\"Power supply not connected\"}";
-        client->text(errorMsg);
-        LOG_WS(serverIP, clientIP, "WebSocket sent: " + errorMsg);
+    // Step response characterization, runs in its own task
+    else if (action == "startStepTest") {
+      if (!powerSupply) {
+        client->text("{\"action\":\"startStepTestResponse\",\"success\":false,\"error\":\"Power supply not connected\"}");
+        return;
+      }
+      if (webStepTest == nullptr) {
+        webStepTest = new XY_SKxxxStepResponse(*powerSupply);
+      }
+      if (webStepTest->isRunning() || webRequestQueue.isPending(WEB_KEY_STEP_TEST)) {
+        client->text("{\"action\":\"startStepTestResponse\",\"success\":false,\"error\":\"A step test is running\"}");
+        return;
+      }
+      
+      // {"quantity":"voltage","levels":[5,12],"limits":[0.5,2],"tolerance":2,"captureMs":1000}
+      StepQuantity quantity = (doc["quantity"] == "current") ? STEP_CURRENT : STEP_VOLTAGE;
+      float levels[8];
+      float limits[4];
+      uint8_t levelCount = 0;
+      uint8_t limitCount = 0;
+      for (JsonVariant level : doc["levels"].as<JsonArray>()) {
+        if (levelCount < 8) levels[levelCount++] = level.as<float>();
+      }
+      for (JsonVariant limit : doc["limits"].as<JsonArray>()) {
+        if (limitCount < 4) limits[limitCount++] = limit.as<float>();
+      }
+      webStepTest->setTolerance(doc["tolerance"] | 2.0f);
+      webStepTest->setCaptureTime(doc["captureMs"] | 1000);
+      webStepTest->clearSteps();
+      if (webStepTest->addMatrix(quantity, levels, levelCount, limits, limitCount) == 0) {
+        client->text("{\"action\":\"startStepTestResponse\",\"success\":false,\"error\":\"No valid steps\"}");
+        return;
+      }
+      if (!webRequestQueue.submit(WEB_KEY_STEP_TEST, WEB_COMMAND_DEADLINE_MS, handleQueuedStepTest, nullptr,
+                                  client->id())) {
+        client->text("{\"action\":\"startStepTestResponse\",\"success\":false,\"error\":\"Request queue full\"}");
       }
     }
+    else if (action == "getStepReport") {
+      sendStepReport(client);
+    }
     else if (action == "getStatus") {
-      // No need for duplicate code, just call the unified function
-      sendCompletePSUStatus(client);
+      // A client's pending polls are merged into one bus read
+      webRequestQueue.submit(clientKey(WEB_KEY_STATUS, client->id()), WEB_POLL_DEADLINE_MS, handleQueuedStatus,
+                             nullptr, client->id());
     }
     // Key lock control
     else if (action == "setKeyLock") {
-      if (powerSupply && powerSupply->testConnection()) {
-        bool lock = doc["lock"];
-        LOG_INFO("Key lock command received. Setting keys to: " + String(lock ? "LOCKED" : "UNLOCKED"));
-        
-        bool success = powerSupply->setKeyLock(lock);
-        
-        // Get current status after change
-        bool keyLocked = powerSupply->isKeyLocked(true);
-        
-        // Send response
-        DynamicJsonDocument responseDoc(256);
-        responseDoc["action"] = "keyLockResponse";
-        responseDoc["success"] = success;
-        responseDoc["locked"] = keyLocked;
-        
-        String response;
-        serializeJson(responseDoc, response);
-        client->text(response);
-        LOG_WS(serverIP, clientIP, "WebSocket sent: " + response);
-      } else {
-        String errorMsg = "{\"action\":\"keyLockResponse\",\"success\":false,\"error\":\"Power supply not connected\"}";
-        client->text(errorMsg);
-        LOG_WS(serverIP, clientIP, "WebSocket sent: " + errorMsg);
-      }
+      bool lock = doc["lock"];
+      submitCommand(client, WEB_KEY_KEY_LOCK, lock ? 1.0f : 0.0f);
     }
     // Constant Voltage mode
     else if (action == "setConstantVoltage") {
-      if (powerSupply && powerSupply->testConnection()) {
-        float voltage = doc["voltage"];
-        bool success = powerSupply->setConstantVoltage(voltage);
-        
-        // Send response
-        DynamicJsonDocument responseDoc(256);
-        responseDoc["action"] = "constantVoltageResponse";
-        responseDoc["success"] = success;
-        responseDoc["voltage"] = voltage;
-        
-        String response;
-        serializeJson(responseDoc, response);
-        client->text(response);
-        LOG_WS(serverIP, clientIP, "WebSocket sent: " + response);
-        
-        // Wait a moment for the changes to take effect
-        delay(100);
-        
-        // Send updated status and operating mode
-        sendCompletePSUStatus(client);
-      } else {
-        String errorMsg = "{\"action\":\"constantVoltageResponse\",\"success\":false,\"error\":\"Power supply not connected\"}";
-        client->text(errorMsg);
-        LOG_WS(serverIP, clientIP, "WebSocket sent: " + errorMsg);
-      }
+      submitCommand(client, WEB_KEY_CONSTANT_VOLTAGE, doc["voltage"].as<float>());
     }
     // Constant Current mode
     else if (action == "setConstantCurrent") {
-      if (powerSupply && powerSupply->testConnection()) {
-        float current = doc["current"];
-        bool success = powerSupply->setConstantCurrent(current);
-        
-        // Send response
-        DynamicJsonDocument responseDoc(256);
-        responseDoc["action"] = "constantCurrentResponse";
-        responseDoc["success"] = success;
-        responseDoc["current"] = current;
-        
-        String response;
-        serializeJson(responseDoc, response);
-        client->text(response);
-        LOG_WS(serverIP, clientIP, "WebSocket sent: " + response);
-        
-        // Wait a moment for the changes to take effect
-        delay(100);
-        
-        // Send updated status and operating mode
-        sendCompletePSUStatus(client);
-      } else {
-        String errorMsg = "{\"action\":\"constantCurrentResponse\",\"success\":false,\"error\":\"Power supply not connected\"}";
-        client->text(errorMsg);
-        LOG_WS(serverIP, clientIP, "WebSocket sent: " + errorMsg);
-      }
+      submitCommand(client, WEB_KEY_CONSTANT_CURRENT, doc["current"].as<float>());
     }
     // Constant Power mode
     else if (action == "setConstantPower") {
-      if (powerSupply && powerSupply->testConnection()) {
-        float power = doc["power"];
-        bool success = powerSupply->setConstantPower(power);
-        
-        // Send response
-        DynamicJsonDocument responseDoc(256);
-        responseDoc["action"] = "constantPowerResponse";
-        responseDoc["success"] = success;
-        responseDoc["power"] = power;
-        
-        String response;
-        serializeJson(responseDoc, response);
-        client->text(response);
-        LOG_WS(serverIP, clientIP, "WebSocket sent: " + response);
-        
-        // Wait a moment for the changes to take effect
-        delay(100);
-        
-        // Send updated status and operating mode
-        sendCompletePSUStatus(client);
-      } else {
-        String errorMsg = "{\"action\":\"constantPowerResponse\",\"success\":false,\"error\":\"Power supply not connected\"}";
-        client->text(errorMsg);
-        LOG_WS(serverIP, clientIP, "WebSocket sent: " + errorMsg);
-      }
+      submitCommand(client, WEB_KEY_CONSTANT_POWER, doc["power"].as<float>());
     }
     // Constant Power mode toggle
     else if (action == "setConstantPowerMode") {
-      if (powerSupply && powerSupply->testConnection()) {
-        bool enable = doc["enable"];
-        bool success = powerSupply->setConstantPowerMode(enable);
-        
-        // Get current state after change
-        bool isEnabled = powerSupply->isConstantPowerModeEnabled(true);
-        
-        // Send response
-        DynamicJsonDocument responseDoc(256);
-        responseDoc["action"] = "constantPowerModeResponse";
-        responseDoc["success"] = success;
-        responseDoc["enabled"] = isEnabled;
-        
-        String response;
-        serializeJson(responseDoc, response);
-        client->text(response);
-        LOG_WS(serverIP, clientIP, "WebSocket sent: " + response);
-        
-        // Wait a moment for the changes to take effect
-        delay(100);
-        
-        // Send updated status and operating mode
-        sendCompletePSUStatus(client);
-      } else {
-        String errorMsg = "{\"action\":\"constantPowerModeResponse\",\"success\":false,\"error\":\"Power supply not connected\"}";
-        client->text(errorMsg);
-        LOG_WS(serverIP, clientIP, "WebSocket sent: " + errorMsg);
-      }
+      bool enable = doc["enable"];
+      submitCommand(client, WEB_KEY_CP_MODE, enable ? 1.0f : 0.0f);
     }
     // Add a specific action to get operating mode details
     else if (action == "getOperatingMode") {
-      sendOperatingModeDetails(client);
-    }
-    // Add a comprehensive status request action
-    else if (action == "getStatus") {
-      sendCompletePSUStatus(client);
+      webRequestQueue.submit(clientKey(WEB_KEY_OPERATING_MODE, client->id()), WEB_POLL_DEADLINE_MS,
+                             handleQueuedStatus, nullptr, client->id());
     }
     // Add a WebSocket handler for WiFi status
     else if (action == "getWifiStatus") {
@@ -801,14 +1008,8 @@ void handleWebSocketMessage(AsyncWebSocket* server, AsyncWebSocketClient* client
     
     // Handle incoming message...
     if (action == "getKeyLockStatus") {
-      handleKeyLockRequest(client);
-      return;
-    }
-    
-    // Handle key lock command - Fix this call by using as<JsonObject>()
-    if (action == "setKeyLock") {
-      // Convert doc to JsonObject to match function parameter
-      handleSetKeyLock(client, doc.as<JsonObject>());
+      webRequestQueue.submit(clientKey(WEB_KEY_KEY_LOCK_STATUS, client->id()), WEB_POLL_DEADLINE_MS,
+                             handleQueuedStatus, nullptr, client->id());
       return;
     }
     
@@ -1010,16 +1211,15 @@ void setupWebServer(AsyncWebServer* server) {
     server->on("/api/data", HTTP_GET, [](AsyncWebServerRequest *request){
       DynamicJsonDocument doc(1024);
       
-      // Add power supply status information instead of modbus data
-      if (powerSupply && powerSupply->testConnection()) {
-        float voltage = 0, current = 0, power = 0;
-        powerSupply->getOutput(voltage, current, power);
-        bool outputEnabled = powerSupply->isOutputEnabled(true);
-        
-        doc["outputEnabled"] = outputEnabled;
-        doc["voltage"] = voltage;
-        doc["current"] = current;
-        doc["power"] = power;
+      // Add power supply status information instead of modbus data. Answered
+      // from the status cache the background poll keeps fresh, this handler
+      // runs on the AsyncTCP task and must not touch the bus.
+      if (powerSupply) {
+        const DeviceStatus& status = powerSupply->getStatusSnapshot();
+        doc["outputEnabled"] = status.outputEnabled;
+        doc["voltage"] = status.outputVoltage;
+        doc["current"] = status.outputCurrent;
+        doc["power"] = status.outputPower;
       }
       
       String jsonString;
@@ -1114,6 +1314,52 @@ void setupWebServer(AsyncWebServer* server) {
       }
     });
 
+    // Cache hit/miss counters of the cached accessors
+    server->on("/api/cachestats", HTTP_GET, [](AsyncWebServerRequest *request){
+      DynamicJsonDocument doc(12288);
+      
+      if (powerSupply) {
+        JsonArray fields = doc.createNestedArray("fields");
+        for (uint8_t i = 0; i < CACHE_FIELD_COUNT; i++) {
+          const CacheFieldStats& stats = powerSupply->getCacheStats((CacheField)i);
+          if (stats.hits + stats.staleHits + stats.misses + stats.refreshes == 0) {
+            continue;
+          }
+          JsonObject field = fields.createNestedObject();
+          field["name"] = XY_SKxxx::getCacheFieldName((CacheField)i);
+          field["hits"] = stats.hits;
+          field["staleHits"] = stats.staleHits;
+          field["misses"] = stats.misses;
+          field["refreshes"] = stats.refreshes;
+          field["redundantRefreshes"] = stats.redundantRefreshes;
+          field["busReads"] = stats.busReads;
+          JsonArray ages = field.createNestedArray("ageHistogram");
+          for (uint8_t b = 0; b < XY_SKXXX_CACHE_AGE_BUCKETS; b++) {
+            ages.add(stats.ageHistogram[b]);
+          }
+        }
+        
+        // Upper end of each age bucket in ms, the last one is open
+        JsonArray limits = doc.createNestedArray("ageLimitsMs");
+        for (uint8_t b = 0; b < XY_SKXXX_CACHE_AGE_BUCKETS - 1; b++) {
+          limits.add(XY_SKxxx::getCacheAgeLimit(b));
+        }
+        
+      }
+      
+      String jsonString;
+      serializeJson(doc, jsonString);
+      request->send(200, "application/json", jsonString);
+    });
+
+    // Clearing the counters changes state, so it is not a GET
+    server->on("/api/cachestats/reset", HTTP_POST, [](AsyncWebServerRequest *request){
+      if (powerSupply) {
+        powerSupply->resetCacheStats();
+      }
+      request->send(200, "application/json", "{\"success\":true}");
+    });
+
     // Add a simple health check endpoint
     server->on("/health", HTTP_GET, [](AsyncWebServerRequest *request){
       request->send(200, "text/plain", "OK");
@@ -3,6 +3,7 @@
 
 #include <ESPAsyncWebServer.h>
 #include "XY-SKxxx.h"  // Keep this include to fix the compilation error
+#include "XY-SKxxx-queue.h"
 
 void setupWebServer(AsyncWebServer* server);
 void handleWebSocketMessage(AsyncWebSocket* webSocket, AsyncWebSocketClient* client, 
@@ -14,6 +15,13 @@ bool handleFileRead(AsyncWebServerRequest *request);
 void sendCompletePSUStatus(AsyncWebSocketClient* client);
 void sendOperatingModeDetails(AsyncWebSocketClient* client);
 
+// Queued WebSocket requests (deadlines and coalescing), call from loop()
+void processWebRequestQueue();
+const xy_sk::RequestQueueStats& getWebRequestQueueStats();
+
+// Push cached status to the WebSocket clients when the background poll sees a change
+void subscribeWebStatusUpdates(XY_SKxxx* psu);
+
 // PSU helper functions
 float getPSUVoltage(XY_SKxxx* powerSupply);
 float getPSUCurrent(XY_SKxxx* powerSupply);
@@ -0,0 +1,71 @@
+// Host stand-in for the Arduino core, just enough to build the XY-SKxxx
+// library for the native test environment (pio test -e native)
+#ifndef XY_SKXXX_TEST_ARDUINO_H
+#define XY_SKXXX_TEST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+
+#define PI 3.1415926535897932384626433832795
+#define SERIAL_8N1 0x800001c
+
+// Real time plus whatever delay() skipped, so timeouts and cache ages pass
+// without the tests having to sleep
+namespace arduino_test {
+inline const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+inline unsigned long skippedMicros = 0;
+}
+
+inline unsigned long micros() {
+  auto elapsed = std::chrono::steady_clock::now() - arduino_test::start;
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() +
+         arduino_test::skippedMicros;
+}
+inline unsigned long millis() { return micros() / 1000; }
+inline void delay(unsigned long ms) { arduino_test::skippedMicros += ms * 1000; }
+inline void delayMicroseconds(unsigned int us) { arduino_test::skippedMicros += us; }
+inline void yield() { arduino_test::skippedMicros += 50; }
+
+inline long random(long howBig) { return (howBig > 0) ? rand() % howBig : 0; }
+inline long random(long howSmall, long howBig) { return (howBig > howSmall) ? howSmall + rand() % (howBig - howSmall) : howSmall; }
+
+template <class T, class L, class H>
+T constrain(T value, L low, H high) { return (value < low) ? low : (value > high) ? high : value; }
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t value) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+      write(buffer[i]);
+    }
+    return size;
+  }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual void flush() {}
+};
+
+class HardwareSerial : public Stream {
+public:
+  virtual void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1) {}
+  virtual void end() {}
+  int available() override { return 0; }
+  int read() override { return -1; }
+  size_t write(uint8_t value) override { return 1; }
+  using Print::write;
+};
+
+inline HardwareSerial Serial1;
+
+#endif // XY_SKXXX_TEST_ARDUINO_H
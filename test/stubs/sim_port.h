@@ -0,0 +1,158 @@
+// Simulated XY-SK slaves behind a serial port, for the native tests
+//
+// A request is answered as soon as the master flushes it, so a transaction
+// completes without waiting. Every well-formed request is logged.
+#ifndef XY_SKXXX_TEST_SIM_PORT_H
+#define XY_SKXXX_TEST_SIM_PORT_H
+
+#include <Arduino.h>
+#include <deque>
+#include <map>
+#include <vector>
+#include "XY-SKxxx-rtu.h"
+
+#define SIM_REGISTERS 512
+
+struct SimSlave {
+  uint16_t regs[SIM_REGISTERS];
+  bool alive;
+
+  SimSlave() : alive(true) { memset(regs, 0, sizeof(regs)); }
+};
+
+struct SimRequest {
+  uint8_t slave;
+  uint8_t function;
+  uint16_t addr;   // First register of the request (the read range for FC23)
+  uint16_t count;
+};
+
+class SimPort : public HardwareSerial {
+public:
+  std::map<uint8_t, SimSlave> slaves;
+  std::vector<SimRequest> requests;
+  bool corruptReplies = false;  // Flip a CRC bit in every reply
+  int exceptionCode = -1;       // Answer every request with this exception code
+  int holeAddr = -1;            // FC03 ranges covering this register are rejected
+
+  int available() override { return (int)_rx.size(); }
+
+  int read() override {
+    if (_rx.empty()) {
+      return -1;
+    }
+    int value = _rx.front();
+    _rx.pop_front();
+    return value;
+  }
+
+  size_t write(uint8_t value) override {
+    _tx.push_back(value);
+    return 1;
+  }
+  using Print::write;
+
+  void flush() override {
+    process();
+    _tx.clear();
+  }
+
+  size_t countFunction(uint8_t function) const {
+    size_t count = 0;
+    for (const SimRequest& request : requests) {
+      count += (request.function == function) ? 1 : 0;
+    }
+    return count;
+  }
+
+private:
+  uint16_t word(size_t index) const { return (uint16_t)(_tx[index] << 8 | _tx[index + 1]); }
+
+  void reply(std::vector<uint8_t> frame) {
+    uint16_t crc = xy_sk::rtuCrc16(frame.data(), frame.size());
+    frame.push_back(crc & 0xFF);
+    frame.push_back(crc >> 8);
+    if (corruptReplies) {
+      frame.back() ^= 0x01;
+    }
+    _rx.insert(_rx.end(), frame.begin(), frame.end());
+  }
+
+  void process() {
+    if (_tx.size() < 8) {
+      return;
+    }
+    uint16_t crc = xy_sk::rtuCrc16(_tx.data(), _tx.size() - 2);
+    if ((crc & 0xFF) != _tx[_tx.size() - 2] || (crc >> 8) != _tx[_tx.size() - 1]) {
+      return;
+    }
+
+    uint8_t id = _tx[0];
+    uint8_t function = _tx[1];
+    uint16_t addr = word(2);
+    uint16_t count = word(4);
+    requests.push_back({id, function, addr, (function == 6) ? (uint16_t)1 : count});
+
+    for (auto& entry : slaves) {
+      if (id != 0 && entry.first != id) {
+        continue;
+      }
+      SimSlave& slave = entry.second;
+      if (!slave.alive) {
+        continue;
+      }
+
+      std::vector<uint8_t> frame = {entry.first, function};
+      bool rejected = false;
+      if (exceptionCode >= 0) {
+        frame[1] |= 0x80;
+        frame.push_back((uint8_t)exceptionCode);
+        rejected = true;
+      } else if (function == 3 || function == 4) {
+        bool hole = holeAddr >= addr && holeAddr < addr + count;
+        if (hole || addr + count > SIM_REGISTERS) {
+          rejected = true;
+        } else {
+          frame.push_back(count * 2);
+          for (uint16_t i = 0; i < count; i++) {
+            frame.push_back(slave.regs[addr + i] >> 8);
+            frame.push_back(slave.regs[addr + i] & 0xFF);
+          }
+        }
+      } else if (function == 6) {
+        if (addr >= SIM_REGISTERS) {
+          rejected = true;
+        } else {
+          slave.regs[addr] = count;
+          frame.insert(frame.end(), _tx.begin() + 2, _tx.begin() + 6);
+        }
+      } else if (function == 16) {
+        if (addr + count > SIM_REGISTERS) {
+          rejected = true;
+        } else {
+          for (uint16_t i = 0; i < count; i++) {
+            slave.regs[addr + i] = word(7 + 2 * i);
+          }
+          frame.insert(frame.end(), _tx.begin() + 2, _tx.begin() + 6);
+        }
+      } else {
+        frame[1] |= 0x80;
+        frame.push_back(0x01);  // Illegal function
+      }
+
+      if (rejected && exceptionCode < 0) {
+        frame.resize(2);
+        frame[1] |= 0x80;
+        frame.push_back(0x02);  // Illegal data address
+      }
+      if (id != 0) {
+        reply(frame);
+      }
+    }
+  }
+
+  std::vector<uint8_t> _tx;
+  std::deque<uint8_t> _rx;
+};
+
+#endif // XY_SKXXX_TEST_SIM_PORT_H
@@ -0,0 +1,95 @@
+// Per-transaction cost of the RTU master against the simulated slave
+//
+// The host time covers encoding, the simulated slave and decoding, so it is
+// an upper bound for the master's own share. The latency is the master's
+// own counter; the simulated slave answers at once, so there is no wire
+// time in it. Target figures come from 'bench' in the debug menu.
+#include <unity.h>
+#include <chrono>
+#include <stdio.h>
+#include "sim_port.h"
+
+using namespace xy_sk;
+
+#define BENCH_TRANSACTIONS 2000
+
+static SimPort* port;
+static RtuMaster* master;
+
+void setUp() {
+  port = new SimPort();
+  for (uint16_t i = 0; i < 32; i++) {
+    port->slaves[1].regs[i] = i * 100;
+  }
+  master = new RtuMaster();
+  master->begin(*port, 115200);
+  master->setResponseTimeout(20);
+}
+
+void tearDown() {
+  delete master;
+  delete port;
+}
+
+template <typename Transaction>
+static void bench(const char* name, Transaction transaction) {
+  double totalNanos = 0.0;
+  double maxNanos = 0.0;
+  master->resetStats();
+  for (int i = 0; i < BENCH_TRANSACTIONS; i++) {
+    auto start = std::chrono::steady_clock::now();
+    RtuStatus status = transaction(i);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    TEST_ASSERT_TRUE(status == RtuStatus::SUCCESS);
+
+    double nanos = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    totalNanos += nanos;
+    if (nanos > maxNanos) {
+      maxNanos = nanos;
+    }
+    // Keep the request log from growing over the run
+    port->requests.clear();
+  }
+
+  const RtuStats& stats = master->getStats();
+  TEST_ASSERT_EQUAL_UINT32(BENCH_TRANSACTIONS, stats.transactions);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.failures);
+
+  char line[160];
+  snprintf(line, sizeof(line), "%-10s host %7.0f ns mean %8.0f ns max, latency %5lu us mean %5lu us max",
+           name, totalNanos / BENCH_TRANSACTIONS, maxNanos,
+           (unsigned long)(stats.totalLatencyMicros / stats.transactions),
+           (unsigned long)stats.maxLatencyMicros);
+  TEST_MESSAGE(line);
+}
+
+void test_bench_read_one_register() {
+  uint16_t value;
+  bench("FC03 x1", [&](int) { return master->readHoldingRegisters(1, 0x02, 1, &value); });
+}
+
+void test_bench_read_status_block() {
+  uint16_t values[16];
+  bench("FC03 x16", [&](int) { return master->readHoldingRegisters(1, 0x00, 16, values); });
+  TEST_ASSERT_EQUAL_UINT16(1500, values[15]);
+}
+
+void test_bench_write_single_register() {
+  bench("FC06", [&](int i) { return master->writeSingleRegister(1, 0x00, (uint16_t)i); });
+  TEST_ASSERT_EQUAL_UINT16(BENCH_TRANSACTIONS - 1, port->slaves[1].regs[0x00]);
+}
+
+void test_bench_write_register_block() {
+  const uint16_t block[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  bench("FC16 x8", [&](int) { return master->writeMultipleRegisters(1, 0x50, 8, block); });
+  TEST_ASSERT_EQUAL_UINT16(8, port->slaves[1].regs[0x57]);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_bench_read_one_register);
+  RUN_TEST(test_bench_read_status_block);
+  RUN_TEST(test_bench_write_single_register);
+  RUN_TEST(test_bench_write_register_block);
+  return UNITY_END();
+}
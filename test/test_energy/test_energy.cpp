@@ -0,0 +1,140 @@
+// Torn read repair and reset tracking of the energy counters
+#include <unity.h>
+#include "sim_port.h"
+#include "XY-SKxxx.h"
+
+using namespace xy_sk;
+
+static SimPort* port;
+static RtuBus* bus;
+static XY_SKxxx* device;
+
+static void setAmpHours(uint32_t value) {
+  port->slaves[1].regs[REG_AH_LOW] = value & 0xFFFF;
+  port->slaves[1].regs[REG_AH_HIGH] = value >> 16;
+}
+
+static void setOutputTime(uint32_t seconds) {
+  port->slaves[1].regs[REG_OUT_H] = seconds / 3600;
+  port->slaves[1].regs[REG_OUT_M] = seconds / 60 % 60;
+  port->slaves[1].regs[REG_OUT_S] = seconds % 60;
+}
+
+// Counters as the device shows them one second after the last read
+static void advance(uint32_t ampHours, uint32_t seconds) {
+  delay(1000);
+  setAmpHours(ampHours);
+  setOutputTime(seconds);
+  TEST_ASSERT_TRUE(device->updateEnergyMeters(true));
+}
+
+void setUp() {
+  port = new SimPort();
+  port->slaves[1].regs[REG_MODEL] = 22873;
+  bus = new RtuBus();
+  bus->begin(*port, 115200);
+  device = new XY_SKxxx(*bus, 1);
+  device->begin();
+  device->getModel();
+}
+
+void tearDown() {
+  delete device;
+  delete bus;
+  delete port;
+}
+
+void test_first_read_takes_over_device_counters() {
+  port->requests.clear();
+  advance(0xFFFC, 59);
+  TEST_ASSERT_EQUAL(1, (int)port->countFunction(3));
+  TEST_ASSERT_EQUAL_UINT16(REG_AH_LOW, port->requests[0].addr);
+  const EnergyCounters& energy = device->getEnergyCounters();
+  TEST_ASSERT_EQUAL_UINT32(0xFFFC, (uint32_t)energy.ampHours);
+  TEST_ASSERT_EQUAL_UINT32(59, (uint32_t)energy.outputTime);
+  TEST_ASSERT_EQUAL_UINT32(1, energy.samples);
+}
+
+void test_carry_caught_half_done_is_repaired() {
+  advance(0xFFFC, 59);
+  // Low word and seconds rolled over, high word and minutes not yet
+  advance(0x0002, 0);
+  const EnergyCounters& energy = device->getEnergyCounters();
+  TEST_ASSERT_EQUAL_UINT32(0x10002, device->getStatusSnapshot().ampHours);
+  TEST_ASSERT_EQUAL_UINT32(60, device->getStatusSnapshot().outputTime);
+  TEST_ASSERT_EQUAL_UINT32(0x10002, (uint32_t)energy.ampHours);
+  TEST_ASSERT_EQUAL_UINT32(2, energy.repaired);
+
+  advance(0x10003, 61);
+  TEST_ASSERT_EQUAL_UINT32(2, energy.repaired);
+  TEST_ASSERT_EQUAL_UINT32(0x10003, (uint32_t)energy.ampHours);
+  TEST_ASSERT_EQUAL_UINT32(61, (uint32_t)energy.outputTime);
+}
+
+void test_carry_seen_before_the_low_word_is_repaired() {
+  advance(0x1FFFF, 3599);
+  // High word and hours already carried, low word and minutes not yet
+  advance(0x2FFFF, 3600 + 59 * 60 + 59);
+  TEST_ASSERT_EQUAL_UINT32(0x1FFFF, device->getStatusSnapshot().ampHours);
+  TEST_ASSERT_EQUAL_UINT32(3599, device->getStatusSnapshot().outputTime);
+  TEST_ASSERT_EQUAL_UINT32(2, device->getEnergyCounters().repaired);
+}
+
+void test_device_reset_keeps_the_totals() {
+  advance(0x20000, 3620);
+  advance(5, 1);
+  // Charge and time were both cleared
+  const EnergyCounters& energy = device->getEnergyCounters();
+  TEST_ASSERT_EQUAL_UINT32(2, energy.resets);
+  TEST_ASSERT_EQUAL_UINT32(0x20005, (uint32_t)energy.ampHours);
+  TEST_ASSERT_EQUAL_UINT32(3621, (uint32_t)energy.outputTime);
+}
+
+void test_reset_after_a_minute_is_not_a_carry() {
+  advance(0, 0);
+  delay(63000);
+  advance(0, 65);
+  advance(0, 3);
+  TEST_ASSERT_EQUAL_UINT32(3, device->getStatusSnapshot().outputTime);
+  TEST_ASSERT_EQUAL_UINT32(1, device->getEnergyCounters().resets);
+}
+
+void test_32_bit_wrap_continues_counting() {
+  advance(0xFFFFFFF0u, 0);
+  advance(0x10, 0);
+  advance(0x20, 0);
+  const EnergyCounters& energy = device->getEnergyCounters();
+  TEST_ASSERT_TRUE(energy.ampHours == 0xFFFFFFF0ull + 0x30);
+  TEST_ASSERT_EQUAL_UINT32(0, energy.resets);
+}
+
+void test_reset_makes_the_next_read_zero() {
+  advance(0x20, 10);
+  device->resetEnergyCounters();
+  const EnergyCounters& energy = device->getEnergyCounters();
+  TEST_ASSERT_EQUAL_UINT32(0, energy.samples);
+  TEST_ASSERT_EQUAL_UINT32(0, (uint32_t)energy.ampHours);
+
+  advance(0x25, 11);
+  TEST_ASSERT_EQUAL_UINT32(0, (uint32_t)energy.ampHours);
+  TEST_ASSERT_EQUAL_UINT32(0, (uint32_t)energy.outputTime);
+  TEST_ASSERT_EQUAL_UINT32(1, energy.samples);
+
+  advance(0x2A, 12);
+  TEST_ASSERT_EQUAL_UINT32(5, (uint32_t)energy.ampHours);
+  TEST_ASSERT_EQUAL_UINT32(1, (uint32_t)energy.outputTime);
+  TEST_ASSERT_EQUAL_UINT32(2, energy.samples);
+  TEST_ASSERT_EQUAL_UINT32(0, energy.resets);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_first_read_takes_over_device_counters);
+  RUN_TEST(test_carry_caught_half_done_is_repaired);
+  RUN_TEST(test_carry_seen_before_the_low_word_is_repaired);
+  RUN_TEST(test_device_reset_keeps_the_totals);
+  RUN_TEST(test_reset_after_a_minute_is_not_a_carry);
+  RUN_TEST(test_32_bit_wrap_continues_counting);
+  RUN_TEST(test_reset_makes_the_next_read_zero);
+  return UNITY_END();
+}
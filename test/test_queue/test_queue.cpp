@@ -0,0 +1,93 @@
+// Coalescing, expiry and capacity of the bus request queue
+#include <unity.h>
+#include <Arduino.h>
+#include <vector>
+#include "XY-SKxxx-queue.h"
+
+using namespace xy_sk;
+
+struct Handled {
+  uint32_t arg;
+  float value;
+  RequestOutcome outcome;
+};
+
+static RequestQueue* queue;
+static std::vector<Handled> handled;
+
+static void record(void* context, const BusRequest& request, RequestOutcome outcome) {
+  handled.push_back({request.arg, request.value, outcome});
+}
+
+void setUp() {
+  queue = new RequestQueue();
+  handled.clear();
+}
+
+void tearDown() {
+  delete queue;
+}
+
+void test_same_key_replaces_in_place() {
+  TEST_ASSERT_TRUE(queue->submit(1, 1000, record, nullptr, 1, 5.0f));
+  TEST_ASSERT_TRUE(queue->submit(2, 1000, record, nullptr, 2));
+  TEST_ASSERT_TRUE(queue->submit(1, 1000, record, nullptr, 3, 7.5f));
+  TEST_ASSERT_EQUAL_UINT8(2, queue->size());
+  TEST_ASSERT_TRUE(queue->isPending(1));
+
+  // The older request is told right away, the newer one runs in its slot
+  TEST_ASSERT_EQUAL(1, (int)handled.size());
+  TEST_ASSERT_TRUE(handled[0].outcome == RequestOutcome::SUPERSEDED);
+  TEST_ASSERT_EQUAL_UINT32(1, handled[0].arg);
+
+  TEST_ASSERT_EQUAL_UINT8(2, queue->process(4));
+  TEST_ASSERT_EQUAL(3, (int)handled.size());
+  TEST_ASSERT_EQUAL_UINT32(3, handled[1].arg);
+  TEST_ASSERT_EQUAL_FLOAT(7.5f, handled[1].value);
+  TEST_ASSERT_EQUAL_UINT32(2, handled[2].arg);
+  TEST_ASSERT_FALSE(queue->isPending(1));
+  TEST_ASSERT_EQUAL_UINT32(1, queue->getStats().coalesced);
+  TEST_ASSERT_EQUAL_UINT32(2, queue->getStats().executed);
+}
+
+void test_key_none_never_merges() {
+  TEST_ASSERT_TRUE(queue->submit(REQUEST_KEY_NONE, 1000, record, nullptr, 1));
+  TEST_ASSERT_TRUE(queue->submit(REQUEST_KEY_NONE, 1000, record, nullptr, 2));
+  TEST_ASSERT_EQUAL_UINT8(2, queue->size());
+  TEST_ASSERT_EQUAL_UINT32(0, queue->getStats().coalesced);
+}
+
+void test_expired_requests_never_execute() {
+  TEST_ASSERT_TRUE(queue->submit(1, 10, record, nullptr, 1));
+  TEST_ASSERT_TRUE(queue->submit(2, 1000, record, nullptr, 2));
+  delay(20);
+  TEST_ASSERT_EQUAL_UINT8(1, queue->process(1));
+  TEST_ASSERT_EQUAL(2, (int)handled.size());
+  TEST_ASSERT_TRUE(handled[0].outcome == RequestOutcome::EXPIRED);
+  TEST_ASSERT_TRUE(handled[1].outcome == RequestOutcome::EXECUTE);
+  TEST_ASSERT_EQUAL_UINT32(2, handled[1].arg);
+  TEST_ASSERT_EQUAL_UINT32(1, queue->getStats().expired);
+}
+
+void test_full_queue_rejects() {
+  for (uint16_t key = 1; key <= REQUEST_QUEUE_CAPACITY; key++) {
+    TEST_ASSERT_TRUE(queue->submit(key, 1000, record, nullptr, key));
+  }
+  TEST_ASSERT_FALSE(queue->submit(100, 1000, record, nullptr));
+  // A pending key still coalesces when the queue is full
+  TEST_ASSERT_TRUE(queue->submit(5, 1000, record, nullptr, 50));
+  TEST_ASSERT_EQUAL_UINT32(1, queue->getStats().rejected);
+  TEST_ASSERT_EQUAL_UINT8(REQUEST_QUEUE_CAPACITY, queue->getStats().highWater);
+
+  TEST_ASSERT_EQUAL_UINT8(REQUEST_QUEUE_CAPACITY, queue->process(REQUEST_QUEUE_CAPACITY));
+  TEST_ASSERT_EQUAL_UINT8(0, queue->size());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_same_key_replaces_in_place);
+  RUN_TEST(test_key_none_never_merges);
+  RUN_TEST(test_expired_requests_never_execute);
+  RUN_TEST(test_full_queue_rejects);
+  return UNITY_END();
+}
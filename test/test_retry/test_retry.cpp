@@ -0,0 +1,90 @@
+// Retry decisions, backoff and deadline of the retry policy
+#include <unity.h>
+#include <Arduino.h>
+#include "XY-SKxxx-retry.h"
+
+using namespace xy_sk;
+
+static RetryPolicy* policy;
+
+void setUp() {
+  policy = new RetryPolicy();
+}
+
+void tearDown() {
+  delete policy;
+}
+
+void test_status_classes() {
+  TEST_ASSERT_TRUE(classifyRtuStatus(RtuStatus::SUCCESS) == ErrorClass::NONE);
+  TEST_ASSERT_TRUE(classifyRtuStatus(RtuStatus::RESPONSE_TIMED_OUT) == ErrorClass::TIMEOUT);
+  TEST_ASSERT_TRUE(classifyRtuStatus(RtuStatus::INVALID_CRC) == ErrorClass::CORRUPTED);
+  TEST_ASSERT_TRUE(classifyRtuStatus(RtuStatus::ILLEGAL_DATA_ADDRESS) == ErrorClass::EXCEPTION);
+  TEST_ASSERT_TRUE(classifyRtuStatus(RtuStatus::UNKNOWN_EXCEPTION) == ErrorClass::EXCEPTION);
+  TEST_ASSERT_TRUE(classifyRtuStatus(RtuStatus::BUSY) == ErrorClass::LOCAL);
+}
+
+void test_reads_retry_transient_errors_until_exhausted() {
+  unsigned long backoff;
+  TEST_ASSERT_TRUE(policy->shouldRetry(OperationType::READ, RtuStatus::RESPONSE_TIMED_OUT, 1, 0, backoff));
+  TEST_ASSERT_TRUE(policy->shouldRetry(OperationType::READ, RtuStatus::INVALID_CRC, 2, 0, backoff));
+  TEST_ASSERT_FALSE(policy->shouldRetry(OperationType::READ, RtuStatus::RESPONSE_TIMED_OUT, 3, 0, backoff));
+  TEST_ASSERT_EQUAL_UINT32(0, backoff);
+  TEST_ASSERT_EQUAL_UINT32(2, policy->getStats().retries);
+  TEST_ASSERT_EQUAL_UINT32(1, policy->getStats().exhausted);
+}
+
+void test_writes_repeat_once_and_exceptions_fail_fast() {
+  unsigned long backoff;
+  TEST_ASSERT_TRUE(policy->shouldRetry(OperationType::WRITE, RtuStatus::RESPONSE_TIMED_OUT, 1, 0, backoff));
+  TEST_ASSERT_FALSE(policy->shouldRetry(OperationType::WRITE, RtuStatus::RESPONSE_TIMED_OUT, 2, 0, backoff));
+  TEST_ASSERT_FALSE(policy->shouldRetry(OperationType::READ, RtuStatus::ILLEGAL_DATA_ADDRESS, 1, 0, backoff));
+  TEST_ASSERT_FALSE(policy->shouldRetry(OperationType::READ, RtuStatus::SUCCESS, 1, 0, backoff));
+  TEST_ASSERT_EQUAL_UINT32(1, policy->getStats().failFast);
+}
+
+void test_backoff_doubles_with_equal_jitter_and_cap() {
+  policy->setBackoff(20, 60);
+  policy->setMaxAttempts(OperationType::READ, ErrorClass::TIMEOUT, 5);
+  const unsigned long expected[] = {20, 40, 60, 60};
+  for (uint8_t attempt = 1; attempt <= 4; attempt++) {
+    for (int i = 0; i < 50; i++) {
+      unsigned long backoff;
+      TEST_ASSERT_TRUE(policy->shouldRetry(OperationType::READ, RtuStatus::RESPONSE_TIMED_OUT, attempt, 0, backoff));
+      // Half fixed, half random
+      TEST_ASSERT_GREATER_OR_EQUAL(expected[attempt - 1] / 2, backoff);
+      TEST_ASSERT_LESS_OR_EQUAL(expected[attempt - 1], backoff);
+    }
+  }
+}
+
+void test_deadline_stops_retries_that_cannot_finish() {
+  policy->setDeadline(100);
+  unsigned long backoff;
+  TEST_ASSERT_FALSE(policy->shouldRetry(OperationType::READ, RtuStatus::RESPONSE_TIMED_OUT, 1, 95, backoff));
+  TEST_ASSERT_EQUAL_UINT32(1, policy->getStats().deadlineExceeded);
+  TEST_ASSERT_EQUAL_UINT32(40, policy->remainingBudget(60));
+  TEST_ASSERT_EQUAL_UINT32(1, policy->remainingBudget(150));
+
+  policy->setDeadline(0);
+  TEST_ASSERT_TRUE(policy->shouldRetry(OperationType::READ, RtuStatus::RESPONSE_TIMED_OUT, 1, 100000, backoff));
+}
+
+void test_outcomes_count_recoveries() {
+  policy->recordOutcome(true, 1);
+  policy->recordOutcome(true, 2);
+  policy->recordOutcome(false, 3);
+  TEST_ASSERT_EQUAL_UINT32(3, policy->getStats().operations);
+  TEST_ASSERT_EQUAL_UINT32(1, policy->getStats().recovered);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_status_classes);
+  RUN_TEST(test_reads_retry_transient_errors_until_exhausted);
+  RUN_TEST(test_writes_repeat_once_and_exceptions_fail_fast);
+  RUN_TEST(test_backoff_doubles_with_equal_jitter_and_cap);
+  RUN_TEST(test_deadline_stops_retries_that_cannot_finish);
+  RUN_TEST(test_outcomes_count_recoveries);
+  return UNITY_END();
+}
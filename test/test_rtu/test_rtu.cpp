@@ -0,0 +1,93 @@
+// CRC and frame decoding of the RTU master
+#include <unity.h>
+#include "sim_port.h"
+
+using namespace xy_sk;
+
+static SimPort* port;
+static RtuMaster* master;
+
+void setUp() {
+  port = new SimPort();
+  port->slaves[1].regs[0x16] = 22873;
+  master = new RtuMaster();
+  master->begin(*port, 115200);
+  master->setResponseTimeout(20);
+}
+
+void tearDown() {
+  delete master;
+  delete port;
+}
+
+void test_crc_matches_reference_frame() {
+  const uint8_t frame[] = {0x01, 0x03, 0x00, 0x00, 0x00, 0x01};
+  TEST_ASSERT_EQUAL_HEX16(0x0A84, rtuCrc16(frame, sizeof(frame)));
+}
+
+void test_read_and_write_frames_decode() {
+  uint16_t values[3] = {0};
+  TEST_ASSERT_TRUE(master->readHoldingRegisters(1, 0x16, 1, values) == RtuStatus::SUCCESS);
+  TEST_ASSERT_EQUAL_UINT16(22873, values[0]);
+
+  TEST_ASSERT_TRUE(master->writeSingleRegister(1, 0x00, 1234) == RtuStatus::SUCCESS);
+  TEST_ASSERT_EQUAL_UINT16(1234, port->slaves[1].regs[0x00]);
+
+  const uint16_t block[3] = {7, 8, 9};
+  TEST_ASSERT_TRUE(master->writeMultipleRegisters(1, 0x50, 3, block) == RtuStatus::SUCCESS);
+  TEST_ASSERT_TRUE(master->readHoldingRegisters(1, 0x50, 3, values) == RtuStatus::SUCCESS);
+  TEST_ASSERT_EQUAL_UINT16(9, values[2]);
+}
+
+void test_crc_error_leaves_buffer_untouched() {
+  uint16_t value = 0xBEEF;
+  port->corruptReplies = true;
+  TEST_ASSERT_TRUE(master->readHoldingRegisters(1, 0x16, 1, &value) == RtuStatus::INVALID_CRC);
+  TEST_ASSERT_EQUAL_HEX16(0xBEEF, value);
+  TEST_ASSERT_EQUAL_UINT32(1, master->getStats().crcErrors);
+}
+
+void test_exception_codes_map_to_status() {
+  uint16_t value = 0xBEEF;
+  TEST_ASSERT_TRUE(master->readHoldingRegisters(1, 600, 1, &value) == RtuStatus::ILLEGAL_DATA_ADDRESS);
+
+  port->exceptionCode = 0x06;
+  TEST_ASSERT_TRUE(master->readHoldingRegisters(1, 0, 1, &value) == RtuStatus::SLAVE_DEVICE_BUSY);
+
+  // Codes outside the standard range still count as exceptions
+  port->exceptionCode = 0x00;
+  TEST_ASSERT_TRUE(master->readHoldingRegisters(1, 0, 1, &value) == RtuStatus::UNKNOWN_EXCEPTION);
+  port->exceptionCode = 0xE2;
+  RtuStatus status = master->readHoldingRegisters(1, 0, 1, &value);
+  TEST_ASSERT_TRUE(status == RtuStatus::UNKNOWN_EXCEPTION);
+  TEST_ASSERT_TRUE(isRtuException(status));
+
+  TEST_ASSERT_EQUAL_UINT32(4, master->getStats().exceptions);
+  TEST_ASSERT_EQUAL_HEX16(0xBEEF, value);
+}
+
+void test_absent_slave_times_out() {
+  uint16_t value;
+  TEST_ASSERT_TRUE(master->readHoldingRegisters(9, 0, 1, &value) == RtuStatus::RESPONSE_TIMED_OUT);
+  TEST_ASSERT_EQUAL_UINT32(1, master->getStats().timeouts);
+}
+
+void test_broadcast_writes_only() {
+  port->slaves[2];
+  uint16_t value;
+  TEST_ASSERT_TRUE(master->writeSingleRegister(0, 0x12, 1) == RtuStatus::SUCCESS);
+  TEST_ASSERT_EQUAL_UINT16(1, port->slaves[1].regs[0x12]);
+  TEST_ASSERT_EQUAL_UINT16(1, port->slaves[2].regs[0x12]);
+  TEST_ASSERT_TRUE(master->readHoldingRegisters(0, 0, 1, &value) == RtuStatus::INVALID_REQUEST);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_crc_matches_reference_frame);
+  RUN_TEST(test_read_and_write_frames_decode);
+  RUN_TEST(test_crc_error_leaves_buffer_untouched);
+  RUN_TEST(test_exception_codes_map_to_status);
+  RUN_TEST(test_absent_slave_times_out);
+  RUN_TEST(test_broadcast_writes_only);
+  return UNITY_END();
+}
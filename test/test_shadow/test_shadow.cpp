@@ -0,0 +1,134 @@
+// Block planning of the register shadow
+#include <unity.h>
+#include "sim_port.h"
+#include "XY-SKxxx.h"
+#include "XY-SKxxx-cd-data-group.h"
+
+using namespace xy_sk;
+
+static SimPort* port;
+static RtuBus* bus;
+static XY_SKxxx* device;
+
+static size_t reads() {
+  return port->countFunction(3);
+}
+
+void setUp() {
+  port = new SimPort();
+  SimSlave& slave = port->slaves[1];
+  slave.regs[REG_MODEL] = 22873;
+  slave.regs[REG_ONOFF] = 1;
+  slave.regs[REG_V_SET] = 500;
+  slave.regs[REG_S_OVP] = 1234;
+  slave.regs[REG_CV_SET] = 500;
+  slave.regs[REG_SYS_STATUS] = 3;
+  bus = new RtuBus();
+  bus->begin(*port, 115200);
+  device = new XY_SKxxx(*bus, 1);
+  device->begin();
+  device->getModel();
+  port->requests.clear();
+}
+
+void tearDown() {
+  delete device;
+  delete bus;
+  delete port;
+}
+
+void test_status_and_settings_are_one_read_each() {
+  TEST_ASSERT_TRUE(device->updateDeviceState(true));
+  TEST_ASSERT_EQUAL(1, (int)reads());
+  TEST_ASSERT_EQUAL_UINT16(REG_LOCK, port->requests[0].addr);
+  TEST_ASSERT_EQUAL_UINT16(16, port->requests[0].count);
+  TEST_ASSERT_TRUE(device->isOutputEnabled());
+  TEST_ASSERT_EQUAL_UINT16(3, device->getSystemStatus());
+
+  port->requests.clear();
+  TEST_ASSERT_TRUE(device->updateDeviceSettings(true));
+  TEST_ASSERT_EQUAL(1, (int)reads());
+  TEST_ASSERT_EQUAL_UINT16(0, port->requests[0].addr);
+  TEST_ASSERT_EQUAL_UINT16(22, port->requests[0].count);
+  TEST_ASSERT_EQUAL_FLOAT(5.0f, device->getSetVoltage());
+}
+
+void test_settings_come_from_the_shadow() {
+  uint16_t value;
+  TEST_ASSERT_TRUE(device->updateDeviceSettings(true));
+  port->requests.clear();
+  TEST_ASSERT_TRUE(device->readRegister(REG_V_SET, value));
+  TEST_ASSERT_EQUAL_UINT16(500, value);
+  TEST_ASSERT_EQUAL(0, (int)reads());
+
+  // Measurements always go to the bus
+  TEST_ASSERT_TRUE(device->readRegister(REG_VOUT, value));
+  TEST_ASSERT_TRUE(device->readRegister(REG_VOUT, value));
+  TEST_ASSERT_EQUAL(2, (int)reads());
+
+  // Writes go through the shadow
+  port->requests.clear();
+  TEST_ASSERT_TRUE(device->setVoltage(7.0f));
+  TEST_ASSERT_TRUE(device->readRegister(REG_V_SET, value));
+  TEST_ASSERT_EQUAL_UINT16(700, value);
+  TEST_ASSERT_EQUAL(0, (int)reads());
+}
+
+void test_protection_settings_in_two_reads() {
+  TEST_ASSERT_TRUE(device->updateAllProtectionSettings(true));
+  TEST_ASSERT_EQUAL(2, (int)reads());
+  TEST_ASSERT_EQUAL_UINT16(REG_CV_SET, port->requests[0].addr);
+  TEST_ASSERT_EQUAL_UINT16(14, port->requests[0].count);
+  TEST_ASSERT_EQUAL_UINT16(REG_BTF, port->requests[1].addr);
+  TEST_ASSERT_EQUAL_FLOAT(12.34f, device->getCachedOverVoltageProtection());
+
+  port->requests.clear();
+  TEST_ASSERT_TRUE(device->updateVoltageCurrentProtection(false));
+  TEST_ASSERT_EQUAL(0, (int)reads());
+}
+
+void test_rejected_gap_falls_back_to_wanted_registers() {
+  const uint16_t wanted[2] = {0x13, 0x15};
+  port->holeAddr = 0x14;
+  TEST_ASSERT_TRUE(device->refreshShadow(wanted, 2));
+  TEST_ASSERT_EQUAL(3, (int)reads());
+  TEST_ASSERT_EQUAL_UINT16(3, port->requests[0].count);
+  TEST_ASSERT_EQUAL_UINT16(0x13, port->requests[1].addr);
+  TEST_ASSERT_EQUAL_UINT16(0x15, port->requests[2].addr);
+}
+
+void test_far_apart_registers_are_separate_reads() {
+  const uint16_t wanted[2] = {0x00, 0x5D};
+  TEST_ASSERT_TRUE(device->refreshShadow(wanted, 2));
+  TEST_ASSERT_EQUAL(2, (int)reads());
+}
+
+void test_memory_group_reads() {
+  uint16_t group[14];
+  TEST_ASSERT_TRUE(device->readMemoryGroup(MemoryGroup::M1, group, true));
+  TEST_ASSERT_EQUAL(1, (int)reads());
+
+  port->slaves[1].regs[0x60] = 777;
+  port->requests.clear();
+  TEST_ASSERT_TRUE(device->updateMemoryGroupCache(MemoryGroup::M1, true));
+  TEST_ASSERT_TRUE(device->getCachedMemoryGroup(MemoryGroup::M1, group, true));
+  TEST_ASSERT_EQUAL(2, (int)reads());
+  TEST_ASSERT_EQUAL_UINT16(777, group[0]);
+  TEST_ASSERT_TRUE(device->getCachedMemoryGroup(MemoryGroup::M1, group, false));
+  TEST_ASSERT_EQUAL(2, (int)reads());
+
+  // Calling a group replaces the active settings
+  TEST_ASSERT_TRUE(device->callMemoryGroup(MemoryGroup::M2));
+  TEST_ASSERT_EQUAL_UINT32(XY_SKXXX_SHADOW_FOREVER, device->getShadowAge(REG_S_OVP));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_status_and_settings_are_one_read_each);
+  RUN_TEST(test_settings_come_from_the_shadow);
+  RUN_TEST(test_protection_settings_in_two_reads);
+  RUN_TEST(test_rejected_gap_falls_back_to_wanted_registers);
+  RUN_TEST(test_far_apart_registers_are_separate_reads);
+  RUN_TEST(test_memory_group_reads);
+  return UNITY_END();
+}
@@ -0,0 +1,93 @@
+// Per-slave adaptive response timeout
+#include <unity.h>
+#include <Arduino.h>
+#include "XY-SKxxx-timeout.h"
+
+using namespace xy_sk;
+
+static const unsigned long FRAME_US = 1000;
+static const unsigned long CEILING_US = 1000000;
+
+static AdaptiveTimeout* timeout;
+
+static void learn(uint8_t slave, unsigned long turnaroundMicros, int samples) {
+  for (int i = 0; i < samples; i++) {
+    timeout->recordReply(slave, turnaroundMicros + FRAME_US, FRAME_US);
+  }
+}
+
+void setUp() {
+  timeout = new AdaptiveTimeout();
+}
+
+void tearDown() {
+  delete timeout;
+}
+
+void test_cold_slave_gets_turnaround_plus_frame() {
+  TEST_ASSERT_EQUAL_UINT32(200000 + FRAME_US, timeout->timeoutFor(1, FRAME_US, CEILING_US));
+  learn(1, 30000, 7);
+  TEST_ASSERT_EQUAL_UINT32(200000 + FRAME_US, timeout->timeoutFor(1, FRAME_US, CEILING_US));
+
+  timeout->setColdTurnaround(50);
+  TEST_ASSERT_EQUAL_UINT32(50000 + FRAME_US, timeout->timeoutFor(2, FRAME_US, CEILING_US));
+  // A cold slave slower than the allowance keeps its measured timeout
+  TEST_ASSERT_EQUAL_UINT32(60000 + FRAME_US, timeout->timeoutFor(1, FRAME_US, CEILING_US));
+}
+
+void test_learned_timeout_is_clamped() {
+  learn(1, 30000, 8);
+  TEST_ASSERT_EQUAL_UINT32(60000 + FRAME_US, timeout->timeoutFor(1, FRAME_US, CEILING_US));
+  TEST_ASSERT_EQUAL_UINT32(50000, timeout->timeoutFor(1, FRAME_US, 50000));
+
+  learn(2, 2000, 8);
+  TEST_ASSERT_EQUAL_UINT32(20000, timeout->timeoutFor(2, FRAME_US, CEILING_US));
+
+  SlaveTimingStats stats;
+  TEST_ASSERT_TRUE(timeout->getSlaveStats(0, stats));
+  TEST_ASSERT_EQUAL_UINT8(1, stats.slave);
+  TEST_ASSERT_EQUAL_UINT8(8, stats.sampleCount);
+  TEST_ASSERT_EQUAL_UINT32(30000, stats.percentileMicros);
+}
+
+void test_percentile_and_multiplier() {
+  timeout->configure(0, 1.0f, 0.5f, 8);
+  for (unsigned long ms = 10; ms >= 1; ms--) {
+    learn(1, ms * 1000, 1);
+  }
+  TEST_ASSERT_EQUAL_UINT32(5000 + FRAME_US, timeout->timeoutFor(1, FRAME_US, CEILING_US));
+
+  timeout->configure(0, 3.0f, 1.0f, 8);
+  learn(1, 1000, 1);
+  TEST_ASSERT_EQUAL_UINT32(30000 + FRAME_US, timeout->timeoutFor(1, FRAME_US, CEILING_US));
+}
+
+void test_ceiling_probe_every_eighth_timeout() {
+  learn(1, 30000, 8);
+  for (int i = 0; i < 7; i++) {
+    timeout->recordTimeout(1);
+    TEST_ASSERT_EQUAL_UINT32(60000 + FRAME_US, timeout->timeoutFor(1, FRAME_US, CEILING_US));
+  }
+  timeout->recordTimeout(1);
+  TEST_ASSERT_EQUAL_UINT32(CEILING_US, timeout->timeoutFor(1, FRAME_US, CEILING_US));
+
+  // One answer ends the streak
+  learn(1, 30000, 1);
+  TEST_ASSERT_EQUAL_UINT32(60000 + FRAME_US, timeout->timeoutFor(1, FRAME_US, CEILING_US));
+}
+
+void test_reset_forgets_history() {
+  learn(1, 30000, 8);
+  timeout->reset(1);
+  TEST_ASSERT_EQUAL_UINT32(200000 + FRAME_US, timeout->timeoutFor(1, FRAME_US, CEILING_US));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_cold_slave_gets_turnaround_plus_frame);
+  RUN_TEST(test_learned_timeout_is_clamped);
+  RUN_TEST(test_percentile_and_multiplier);
+  RUN_TEST(test_ceiling_probe_every_eighth_timeout);
+  RUN_TEST(test_reset_forgets_history);
+  return UNITY_END();
+}
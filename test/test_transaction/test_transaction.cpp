@@ -0,0 +1,115 @@
+// Run merging and verification of register write transactions
+#include <unity.h>
+#include "sim_port.h"
+#include "XY-SKxxx.h"
+#include "XY-SKxxx-transaction.h"
+
+using namespace xy_sk;
+
+// Register 0x52 ignores writes, for the verify pass
+class StickyPort : public SimPort {
+public:
+  bool sticky = false;
+
+  void flush() override {
+    SimPort::flush();
+    if (sticky) {
+      slaves[1].regs[0x52] = 7;
+    }
+  }
+};
+
+static StickyPort* port;
+static RtuBus* bus;
+static XY_SKxxx* device;
+static XY_SKxxxTransaction* transaction;
+
+static uint16_t reg(uint16_t addr) {
+  return port->slaves[1].regs[addr];
+}
+
+void setUp() {
+  port = new StickyPort();
+  port->slaves[1].regs[REG_MODEL] = 22873;
+  bus = new RtuBus();
+  bus->begin(*port, 115200);
+  device = new XY_SKxxx(*bus, 1);
+  device->begin();
+  transaction = new XY_SKxxxTransaction(*device);
+}
+
+void tearDown() {
+  delete transaction;
+  delete device;
+  delete bus;
+  delete port;
+}
+
+static void queueWrites() {
+  const uint16_t block[3] = {10, 11, 12};
+  transaction->write(0x12, 1);
+  transaction->write(0x01, 1500);
+  transaction->write(0x00, 1200);
+  transaction->write(0x01, 1600);
+  transaction->write(0x50, 3, block);
+}
+
+void test_adjacent_writes_merge_into_runs() {
+  queueWrites();
+  TEST_ASSERT_EQUAL_UINT8(6, transaction->size());
+  TEST_ASSERT_EQUAL_UINT8(3, transaction->planFrames());
+  // Sorted by address, the later write to a register wins
+  TEST_ASSERT_EQUAL_UINT16(0x00, transaction->getWrite(0).addr);
+  TEST_ASSERT_EQUAL_UINT16(1600, transaction->getWrite(1).value);
+
+  port->requests.clear();
+  TEST_ASSERT_TRUE(transaction->commit());
+  TEST_ASSERT_EQUAL(3, (int)port->requests.size());
+  TEST_ASSERT_EQUAL_UINT8(16, port->requests[0].function);
+  TEST_ASSERT_EQUAL_UINT16(2, port->requests[0].count);
+  TEST_ASSERT_EQUAL_UINT8(6, port->requests[1].function);
+  TEST_ASSERT_EQUAL_UINT8(16, port->requests[2].function);
+  TEST_ASSERT_EQUAL_UINT16(3, port->requests[2].count);
+
+  TEST_ASSERT_EQUAL_UINT16(1200, reg(0x00));
+  TEST_ASSERT_EQUAL_UINT16(1600, reg(0x01));
+  TEST_ASSERT_EQUAL_UINT16(1, reg(0x12));
+  TEST_ASSERT_EQUAL_UINT16(12, reg(0x52));
+}
+
+void test_verify_flags_registers_that_read_back_wrong() {
+  queueWrites();
+  port->sticky = true;
+  TEST_ASSERT_FALSE(transaction->commit(true));
+  TEST_ASSERT_EQUAL_UINT8(3, transaction->getResult().readFrames);
+  TEST_ASSERT_EQUAL_UINT8(1, transaction->getResult().mismatched);
+  TEST_ASSERT_FALSE(transaction->succeeded(0x52));
+  TEST_ASSERT_TRUE(transaction->succeeded(0x51));
+}
+
+void test_register_pairs_go_out_as_one_frame() {
+  port->requests.clear();
+  TEST_ASSERT_TRUE(device->setOverAmpHourProtection(5, 6));
+  TEST_ASSERT_EQUAL(1, (int)port->requests.size());
+  TEST_ASSERT_EQUAL_UINT8(16, port->requests[0].function);
+  TEST_ASSERT_EQUAL_UINT16(5, reg(REG_S_OAH_L));
+  TEST_ASSERT_EQUAL_UINT16(6, reg(REG_S_OAH_H));
+}
+
+void test_full_transaction_still_takes_rewrites() {
+  for (uint16_t i = 0; i < TRANSACTION_MAX_WRITES; i++) {
+    TEST_ASSERT_TRUE(transaction->write(i * 2, i));
+  }
+  TEST_ASSERT_FALSE(transaction->write(999, 1));
+  TEST_ASSERT_TRUE(transaction->write(0, 5));
+  TEST_ASSERT_EQUAL_UINT8(TRANSACTION_MAX_WRITES, transaction->planFrames());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_adjacent_writes_merge_into_runs);
+  RUN_TEST(test_verify_flags_registers_that_read_back_wrong);
+  RUN_TEST(test_register_pairs_go_out_as_one_frame);
+  RUN_TEST(test_full_transaction_still_takes_rewrites);
+  return UNITY_END();
+}